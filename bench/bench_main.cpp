@@ -0,0 +1,430 @@
+#include "benchmark.h"
+#include "fixtures.h"
+#include "../src/core/quickview.h"
+#include "../src/filesystem/file_analysis.h"
+#include "../src/filesystem/file_operations.h"
+#include "../src/filesystem/file_transfer.h"
+#include "../src/filesystem/image_handler.h"
+#include "../src/ui/display.h"
+#include "../src/ui/entry_labels.h"
+#include "../src/ui/memory/memory_terminal.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    // Screen the drawing benchmarks lay their windows out on, as QuickView would
+    const int SCREEN_WIDTH = 160;
+    const int SCREEN_HEIGHT = 50;
+
+    struct Fixture {
+        std::string name;
+        std::filesystem::path path;
+    };
+
+    // Complete fixtures of one kind ("entries_", "text_"), smallest first
+    std::vector<Fixture> findFixtures(const std::filesystem::path& root, const std::string& prefix) {
+        std::vector<std::pair<uintmax_t, Fixture>> found;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(root, ec)) {
+            std::string name = entry.path().filename().string();
+            if (name.compare(0, prefix.size(), prefix) != 0 || !Fixtures::isComplete(root, name)) continue;
+
+            uintmax_t size = 0;
+            if (entry.is_regular_file(ec)) {
+                size = entry.file_size(ec);
+            } else {
+                for (auto it = std::filesystem::directory_iterator(entry.path(), ec);
+                     it != std::filesystem::directory_iterator(); it.increment(ec)) {
+                    size++;
+                }
+            }
+            found.push_back({size, {name, entry.path()}});
+        }
+        std::sort(found.begin(), found.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<Fixture> fixtures;
+        for (auto& item : found) fixtures.push_back(item.second);
+        return fixtures;
+    }
+
+    // Directory entries in the order the filesystem returns them, as loadDirectory sees them before sorting
+    std::vector<std::filesystem::directory_entry> readUnsorted(const std::filesystem::path& path) {
+        std::vector<std::filesystem::directory_entry> entries;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
+            entries.push_back(entry);
+        }
+        return entries;
+    }
+
+    void benchmarkDirectories(BenchmarkRunner& runner, const std::filesystem::path& root) {
+        std::vector<Fixture> fixtures = findFixtures(root, "entries_");
+        if (Fixtures::isComplete(root, "bushy")) fixtures.push_back({"bushy", root / "bushy"});
+        if (Fixtures::isComplete(root, "deep")) {
+            std::filesystem::path deepest = root / "deep";
+            std::error_code ec;
+            for (int level = 0; ; level++) {
+                char name[32];
+                snprintf(name, sizeof(name), "level_%02d", level);
+                if (!std::filesystem::is_directory(deepest / name, ec)) break;
+                deepest /= name;
+            }
+            fixtures.push_back({"deep", deepest});
+        }
+
+        for (const Fixture& fixture : fixtures) {
+            std::vector<std::filesystem::directory_entry> entries;
+            if (runner.isSelected("FileOperations::loadDirectory", fixture.name)) {
+                FileOperations::loadDirectory(fixture.path, entries);
+                runner.run("FileOperations::loadDirectory", fixture.name, entries.size(), 0,
+                           [&] { FileOperations::loadDirectory(fixture.path, entries); });
+            }
+
+            if (runner.isSelected("FileOperations::sortEntries", fixture.name)) {
+                std::vector<std::filesystem::directory_entry> unsorted = readUnsorted(fixture.path);
+                runner.run("FileOperations::sortEntries", fixture.name, unsorted.size(), 0,
+                           [&] { FileOperations::sortEntries(entries); },
+                           [&] { entries = unsorted; });
+            }
+
+            std::vector<std::filesystem::directory_entry> preview;
+            runner.run("FileOperations::loadDirectoryPreview", fixture.name, 200, 0,
+                       [&] { FileOperations::loadDirectoryPreview(fixture.path, preview); });
+        }
+    }
+
+    // Index of a file in the listing QuickView shows for the current directory
+    int findEntry(const QuickView& app, const std::string& name) {
+        const auto& entries = app.getDirectoryEntries();
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].path().filename() == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    void benchmarkViewFile(BenchmarkRunner& runner, const std::filesystem::path& root) {
+        std::vector<Fixture> fixtures = findFixtures(root, "text_");
+        if (Fixtures::isComplete(root, "document.json")) fixtures.push_back({"document.json", root / "document.json"});
+        bool any = false;
+        for (const Fixture& fixture : fixtures) any = any || runner.isSelected("QuickView::viewFile", fixture.name);
+        if (!any) return;
+
+        // QuickView lists the directory it starts in
+        std::filesystem::path previous = std::filesystem::current_path();
+        std::filesystem::current_path(root);
+        {
+            QuickView app(std::make_unique<MemoryTerminal>(SCREEN_WIDTH, SCREEN_HEIGHT));
+            if (app.initialize()) {
+                app.waitForDirectory();
+                for (const Fixture& fixture : fixtures) {
+                    int index = findEntry(app, fixture.name);
+                    if (index < 0) continue;
+                    app.navigateHome();
+                    app.navigateDown(index);
+
+                    std::error_code ec;
+                    uintmax_t size = std::filesystem::file_size(fixture.path, ec);
+                    runner.run("QuickView::viewFile", fixture.name, 1, ec ? 0 : size,
+                               [&] { app.viewFile(); },
+                               [&] { app.setDisplayMode(QuickView::DisplayMode::NORMAL); });
+                }
+            }
+            app.shutdown();
+        }
+        std::filesystem::current_path(previous);
+    }
+
+    void benchmarkFileTransfer(BenchmarkRunner& runner, const std::filesystem::path& root) {
+        // Copies go to a scratch directory next to the fixtures, on the same filesystem
+        std::filesystem::path scratch = root / ".transfer";
+        std::error_code ec;
+        std::filesystem::remove_all(scratch, ec);
+        std::filesystem::create_directories(scratch, ec);
+        if (ec) return;
+
+        for (const Fixture& fixture : findFixtures(root, "text_")) {
+            std::filesystem::path target = scratch / fixture.name;
+            uintmax_t size = std::filesystem::file_size(fixture.path, ec);
+            runner.run("FileTransfer::copyFile", fixture.name, 1, ec ? 0 : size,
+                       [&] {
+                           TransferProgress progress;
+                           std::string error;
+                           FileTransfer::copyFile(fixture.path, target, progress, nullptr, error);
+                       },
+                       [&] { std::filesystem::remove(target, ec); });
+        }
+
+        if (Fixtures::isComplete(root, "bushy") && runner.isSelected("FileTransfer::run", "bushy")) {
+            FileJob job;
+            job.operation = FileJob::COPY;
+            job.sources.push_back(root / "bushy");
+            job.destination = scratch;
+            TransferProgress counted;
+            std::string error;
+            FileTransfer::run(job, counted, nullptr, error);
+            runner.run("FileTransfer::run", "bushy", counted.files_total.load(), counted.bytes_total.load(),
+                       [&] {
+                           TransferProgress progress;
+                           FileTransfer::run(job, progress, nullptr, error);
+                       },
+                       [&] { std::filesystem::remove_all(scratch / "bushy", ec); });
+
+            // Removal of the copy, made again before each iteration
+            FileJob removal;
+            removal.operation = FileJob::REMOVE;
+            removal.sources.push_back(scratch / "bushy");
+            runner.run("FileTransfer::run (remove)", "bushy", counted.files_total.load(), 0,
+                       [&] {
+                           TransferProgress progress;
+                           FileTransfer::run(removal, progress, nullptr, error);
+                       },
+                       [&] {
+                           TransferProgress progress;
+                           std::filesystem::remove_all(scratch / "bushy", ec);
+                           FileTransfer::run(job, progress, nullptr, error);
+                       });
+        }
+        std::filesystem::remove_all(scratch, ec);
+    }
+
+    std::vector<std::string> readLines(const std::filesystem::path& path, size_t max_lines) {
+        std::vector<std::string> lines;
+        std::ifstream in(path);
+        std::string line;
+        while (lines.size() < max_lines && std::getline(in, line)) lines.push_back(line);
+        return lines;
+    }
+
+    void benchmarkDisplay(BenchmarkRunner& runner, const std::filesystem::path& root) {
+        std::vector<Fixture> listings = findFixtures(root, "entries_");
+        if (listings.empty()) return;
+
+        // The 100k listing when it was generated, the smallest otherwise
+        Fixture listing = listings.front();
+        for (const Fixture& fixture : listings) {
+            if (fixture.name == "entries_100k") listing = fixture;
+        }
+        std::vector<std::filesystem::directory_entry> entries;
+        FileOperations::loadDirectory(listing.path, entries);
+        EntryLabels labels;
+        labels.reset(entries, listing.path);
+        BrowserTree tree;
+        tree.reset(entries.size());
+
+        int selected = static_cast<int>(entries.size() / 2);
+        int directory_index = -1;
+        int file_index = -1;
+        for (size_t i = 0; i < entries.size(); i++) {
+            std::error_code ec;
+            bool directory = entries[i].is_directory(ec);
+            if (directory && directory_index < 0 && entries[i].path().filename() != "..") directory_index = static_cast<int>(i);
+            if (!directory && file_index < 0) file_index = static_cast<int>(i);
+        }
+
+        // Same layout as QuickView::setupWindows
+        MemoryTerminal terminal(SCREEN_WIDTH, SCREEN_HEIGHT);
+        terminal.initialize();
+        int browser_width = SCREEN_WIDTH / 4;
+        int right_width = SCREEN_WIDTH - browser_width;
+        int available_height = SCREEN_HEIGHT - 1;
+        int info_height = std::min(std::max(available_height * 10 / 100, 9), available_height / 2);
+        int content_height = available_height - info_height;
+        ITerminal::WindowHandle status = terminal.createWindow(1, SCREEN_WIDTH, SCREEN_HEIGHT - 1, 0);
+        ITerminal::WindowHandle browser = terminal.createWindow(available_height, browser_width, 0, 0);
+        ITerminal::WindowHandle content = terminal.createWindow(content_height, right_width, 0, browser_width);
+        ITerminal::WindowHandle info = terminal.createWindow(info_height, right_width, content_height, browser_width);
+        ITerminal* term = &terminal;
+        uint64_t browser_rows = available_height - 2;
+        uint64_t content_rows = content_height - 2;
+
+        runner.run("Display::drawFileBrowser", listing.name, browser_rows, 0,
+                   [&] { Display::drawFileBrowser(term, browser, entries, labels, tree, selected, selected - 10, "", {}); });
+        runner.run("Display::drawStatusBar", listing.name, 1, 0,
+                   [&] { Display::drawStatusBar(term, status, entries, labels, selected, "Ready", "", "", SCREEN_WIDTH); });
+        runner.run("Display::drawInfoWindow", listing.name, 1, 0,
+                   [&] { Display::drawInfoWindow(term, info, entries, labels, selected, nullptr); });
+        if (directory_index >= 0) {
+            runner.run("Display::drawDirectoryInfo", listing.name, 1, 0,
+                       [&] { Display::drawDirectoryInfo(term, info, labels, directory_index); });
+            runner.run("Display::drawDirectoryContentsInWindow", listing.name, content_rows, 0,
+                       [&] { Display::drawDirectoryContentsInWindow(term, labels, directory_index, content); });
+        }
+        runner.run("Display::drawHelpContent", "", content_rows, 0,
+                   [&] { Display::drawHelpContent(term, content); });
+        runner.run("Display::drawAboutContent", "", content_rows, 0,
+                   [&] { Display::drawAboutContent(term, content); });
+
+        std::filesystem::path text = root / "text_1M.txt";
+        if (Fixtures::isComplete(root, "text_1M.txt")) {
+            TextPreview preview;
+            FileOperations::loadTextPreview(text, preview);
+            FileAnalysis analysis;
+            FileAnalyzer::analyze(text, analysis, nullptr);
+            std::vector<std::string> lines = readLines(text, 20000);
+
+            if (file_index >= 0) {
+                runner.run("Display::drawFileInfo", "text_1M.txt", 1, 0,
+                           [&] { Display::drawFileInfo(term, info, entries[file_index], labels, file_index, &analysis); });
+            }
+            runner.run("Display::drawFilePreview", "text_1M.txt", content_rows, 0,
+                       [&] { Display::drawFilePreview(term, content, text, &preview); });
+            runner.run("Display::drawNormalContent", "text_1M.txt", content_rows, 0,
+                       [&] { Display::drawNormalContent(term, content, entries, labels, file_index, &preview, nullptr); });
+            runner.run("Display::drawFileViewContent", "text_1M.txt", content_rows, 0,
+                       [&] { Display::drawFileViewContent(term, content, lines, 10000, "text_1M.txt"); });
+
+            if (Fixtures::isComplete(root, "edited_1M.txt")) {
+                DiffView diff;
+                if (diff.open(text, root / "edited_1M.txt")) {
+                    diff.jumpToHunk(true, static_cast<int>(content_rows));
+                    runner.run("Display::drawDiffViewContent", "text_1M.txt", content_rows, 0,
+                               [&] { Display::drawDiffViewContent(term, content, diff); });
+                }
+            }
+        }
+
+        if (Fixtures::isComplete(root, "image.ppm")) {
+            ImagePreview image;
+            ImageHandler::loadImagePreview(root / "image.ppm", right_width - 2, static_cast<int>(content_rows) * 2, image);
+            runner.run("Display::drawImagePreview", "image.ppm", content_rows, 0,
+                       [&] { Display::drawImagePreview(term, content, root / "image.ppm", &image); });
+        }
+
+        if (Fixtures::isComplete(root, "document.json")) {
+            JsonTree tree;
+            if (tree.open(root / "document.json")) {
+                // Open the records array and a few records
+                tree.moveSelection(1, static_cast<int>(content_rows));
+                tree.expandSelected();
+                for (int i = 0; i < 5; i++) {
+                    tree.moveSelection(1, static_cast<int>(content_rows));
+                    tree.expandSelected();
+                }
+                runner.run("Display::drawJsonViewContent", "document.json", content_rows, 0,
+                           [&] { Display::drawJsonViewContent(term, content, tree); });
+            }
+        }
+
+        // Duplicate groups and tree differences made up from the listing
+        DuplicateView duplicates;
+        std::vector<DuplicateGroup> groups;
+        for (size_t i = 0; i + 2 < entries.size() && groups.size() < 1000; i += 3) {
+            DuplicateGroup group;
+            group.size = 4096 * (i + 1);
+            for (size_t copy = 0; copy < 3; copy++) group.copies.push_back({entries[i + copy].path()});
+            groups.push_back(std::move(group));
+        }
+        duplicates.setGroups(listing.path, std::move(groups));
+        duplicates.moveSelection(500, static_cast<int>(content_rows));
+        runner.run("Display::drawDuplicateViewContent", listing.name, content_rows, 0,
+                   [&] { Display::drawDuplicateViewContent(term, content, duplicates, nullptr); });
+
+        CompareView compare;
+        compare.reset(listing.path, listing.path);
+        std::vector<TreeDifference> differences;
+        for (size_t i = 0; i < entries.size() && differences.size() < 5000; i++) {
+            TreeDifference difference;
+            difference.relative_path = "changed/" + entries[i].path().filename().string();
+            difference.kind = static_cast<TreeDifference::Kind>(i % 3);
+            difference.left_size = i;
+            difference.right_size = i * 2;
+            differences.push_back(std::move(difference));
+        }
+        compare.addDifferences(std::move(differences), static_cast<int>(content_rows));
+        runner.run("Display::drawCompareViewContent", listing.name, content_rows, 0,
+                   [&] { Display::drawCompareViewContent(term, content, compare, nullptr); });
+
+        terminal.shutdown();
+    }
+
+    void printUsage() {
+        std::cerr << "Usage: quickView_bench [options] FIXTURE_DIR\n"
+                     "  --generate           Create missing fixtures in FIXTURE_DIR first\n"
+                     "  --entries=LIST       Directory sizes to generate (default 1k,100k; up to 1m)\n"
+                     "  --text=LIST          Text file sizes to generate (default 1M,100M; up to 10G)\n"
+                     "  --filter=TEXT        Run benchmarks whose name/fixture contains TEXT\n"
+                     "  --iterations=N       Run each benchmark at least N times (default 5)\n"
+                     "  --min-time=SECONDS   Run each benchmark at least this long (default 1)\n"
+                     "  --csv                Write CSV instead of JSON\n";
+    }
+}
+
+/**
+ * @brief Benchmarks of directory loading, file viewing and drawing
+ *
+ * Runs against the fixtures in FIXTURE_DIR, creating missing ones with
+ * --generate, and writes one record per benchmark to stdout as JSON (or CSV
+ * with --csv): iterations, per-iteration p50/p99/mean/min/max in nanoseconds,
+ * and items and bytes per second. Progress goes to stderr.
+ */
+int main(int argc, char* argv[]) {
+    std::filesystem::path root;
+    bool generate = false;
+    bool csv = false;
+    Fixtures::Options options;
+    std::string filter;
+    uint64_t iterations = 5;
+    double min_seconds = 1.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--generate") == 0) {
+            generate = true;
+        } else if (strncmp(argv[i], "--entries=", 10) == 0) {
+            if (!Fixtures::parseList(argv[i] + 10, options.entry_counts)) {
+                std::cerr << "Invalid entry counts: " << argv[i] + 10 << std::endl;
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--text=", 7) == 0) {
+            if (!Fixtures::parseList(argv[i] + 7, options.text_sizes)) {
+                std::cerr << "Invalid text sizes: " << argv[i] + 7 << std::endl;
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else if (strncmp(argv[i], "--iterations=", 13) == 0) {
+            iterations = strtoull(argv[i] + 13, nullptr, 10);
+        } else if (strncmp(argv[i], "--min-time=", 11) == 0) {
+            min_seconds = strtod(argv[i] + 11, nullptr);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (argv[i][0] != '-' && root.empty()) {
+            root = argv[i];
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (root.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        root = std::filesystem::absolute(root);
+        if (generate) {
+            std::string error;
+            if (!Fixtures::generate(root, options, error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+
+        BenchmarkRunner runner(iterations, min_seconds, filter);
+        benchmarkDirectories(runner, root);
+        benchmarkViewFile(runner, root);
+        benchmarkDisplay(runner, root);
+        benchmarkFileTransfer(runner, root);
+
+        if (csv) {
+            runner.writeCsv(std::cout);
+        } else {
+            runner.writeJson(std::cout);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
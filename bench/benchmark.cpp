@@ -0,0 +1,115 @@
+#include "benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+    // Upper bound so that sub-microsecond benchmarks do not run forever
+    const uint64_t MAX_ITERATIONS = 1000000;
+
+    // Nearest-rank percentile of sorted samples
+    double percentile(const std::vector<double>& sorted, double fraction) {
+        size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+        return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+
+    double perSecond(uint64_t amount, double mean_ns) {
+        return mean_ns > 0 ? amount * 1e9 / mean_ns : 0;
+    }
+
+    void writeJsonString(std::ostream& out, const std::string& text) {
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+        out << '"';
+    }
+}
+
+BenchmarkRunner::BenchmarkRunner(uint64_t min_iterations, double min_seconds, const std::string& filter)
+    : min_iterations_(std::max<uint64_t>(1, min_iterations))
+    , min_seconds_(min_seconds)
+    , filter_(filter)
+{
+}
+
+bool BenchmarkRunner::isSelected(const std::string& name, const std::string& fixture) const {
+    return filter_.empty() || (name + "/" + fixture).find(filter_) != std::string::npos;
+}
+
+void BenchmarkRunner::run(const std::string& name, const std::string& fixture, uint64_t items, uint64_t bytes,
+                          const std::function<void()>& body, const std::function<void()>& setup) {
+    if (!isSelected(name, fixture)) return;
+    std::cerr << name << "/" << fixture << std::flush;
+
+    using Clock = std::chrono::steady_clock;
+    if (setup) setup();
+    body();
+
+    std::vector<double> samples;
+    auto deadline = Clock::now() + std::chrono::duration<double>(min_seconds_);
+    while (samples.size() < MAX_ITERATIONS &&
+           (samples.size() < min_iterations_ || Clock::now() < deadline)) {
+        if (setup) setup();
+        auto start = Clock::now();
+        body();
+        auto end = Clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    Result result;
+    result.name = name;
+    result.fixture = fixture;
+    result.iterations = samples.size();
+    result.items = items;
+    result.bytes = bytes;
+    double total = 0;
+    for (double sample : samples) total += sample;
+    std::sort(samples.begin(), samples.end());
+    result.mean_ns = total / samples.size();
+    result.p50_ns = percentile(samples, 0.50);
+    result.p99_ns = percentile(samples, 0.99);
+    result.min_ns = samples.front();
+    result.max_ns = samples.back();
+    results_.push_back(result);
+
+    std::cerr << ": p50 " << std::fixed << std::setprecision(1) << result.p50_ns / 1000 << " us, p99 "
+              << result.p99_ns / 1000 << " us, " << result.iterations << " iterations" << std::endl;
+}
+
+void BenchmarkRunner::writeJson(std::ostream& out) const {
+    out << "{\"benchmarks\":[";
+    for (size_t i = 0; i < results_.size(); i++) {
+        const Result& result = results_[i];
+        out << (i > 0 ? ",\n" : "\n") << "{\"name\":";
+        writeJsonString(out, result.name);
+        out << ",\"fixture\":";
+        writeJsonString(out, result.fixture);
+        out << std::fixed << std::setprecision(0)
+            << ",\"iterations\":" << result.iterations
+            << ",\"items\":" << result.items
+            << ",\"bytes\":" << result.bytes
+            << ",\"p50_ns\":" << result.p50_ns
+            << ",\"p99_ns\":" << result.p99_ns
+            << ",\"mean_ns\":" << result.mean_ns
+            << ",\"min_ns\":" << result.min_ns
+            << ",\"max_ns\":" << result.max_ns
+            << ",\"items_per_second\":" << perSecond(result.items, result.mean_ns)
+            << ",\"bytes_per_second\":" << perSecond(result.bytes, result.mean_ns) << "}";
+    }
+    out << "\n]}" << std::endl;
+}
+
+void BenchmarkRunner::writeCsv(std::ostream& out) const {
+    out << "name,fixture,iterations,items,bytes,p50_ns,p99_ns,mean_ns,min_ns,max_ns,items_per_second,bytes_per_second\n";
+    out << std::fixed << std::setprecision(0);
+    for (const Result& result : results_) {
+        out << result.name << "," << result.fixture << "," << result.iterations << "," << result.items << ","
+            << result.bytes << "," << result.p50_ns << "," << result.p99_ns << "," << result.mean_ns << ","
+            << result.min_ns << "," << result.max_ns << "," << perSecond(result.items, result.mean_ns) << ","
+            << perSecond(result.bytes, result.mean_ns) << "\n";
+    }
+}
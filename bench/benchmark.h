@@ -0,0 +1,73 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Times repeated runs of a piece of code and reports latency percentiles
+ * Each benchmark runs once untimed to warm caches, then repeatedly until both
+ * the minimum number of iterations and the minimum time are reached. Every
+ * iteration is timed on its own, so p50 and p99 describe single calls rather
+ * than averages over batches.
+ */
+class BenchmarkRunner {
+public:
+    struct Result {
+        std::string name;
+        std::string fixture;
+        uint64_t iterations = 0;
+        uint64_t items = 0;         // Work per iteration: entries, rows or lines
+        uint64_t bytes = 0;         // Bytes processed per iteration, 0 when not meaningful
+        double p50_ns = 0;
+        double p99_ns = 0;
+        double mean_ns = 0;
+        double min_ns = 0;
+        double max_ns = 0;
+    };
+
+    /**
+     * @param min_iterations Iterations each benchmark runs at least
+     * @param min_seconds Time each benchmark runs at least
+     * @param filter Run only benchmarks whose "name/fixture" contains this text; empty runs all
+     */
+    BenchmarkRunner(uint64_t min_iterations, double min_seconds, const std::string& filter);
+
+    /**
+     * @brief Time a benchmark unless the filter excludes it
+     * @param name What is measured, such as "FileOperations::loadDirectory"
+     * @param fixture Input it runs on
+     * @param items Work done per iteration, for the throughput
+     * @param bytes Bytes processed per iteration, or 0
+     * @param body Code to time; called once per iteration
+     * @param setup Untimed preparation before each iteration, may be empty
+     */
+    void run(const std::string& name, const std::string& fixture, uint64_t items, uint64_t bytes,
+             const std::function<void()>& body, const std::function<void()>& setup = nullptr);
+
+    /**
+     * @brief Check whether a benchmark would run, to skip building its input
+     */
+    bool isSelected(const std::string& name, const std::string& fixture) const;
+
+    /**
+     * @brief Write all results as a JSON document
+     */
+    void writeJson(std::ostream& out) const;
+
+    /**
+     * @brief Write all results as CSV with a header line
+     */
+    void writeCsv(std::ostream& out) const;
+
+private:
+    uint64_t min_iterations_;
+    double min_seconds_;
+    std::string filter_;
+    std::vector<Result> results_;
+};
+
+#endif // BENCHMARK_H
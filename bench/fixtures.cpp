@@ -0,0 +1,293 @@
+#include "fixtures.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    const int DEEP_LEVELS = 64;
+    const int DEEP_FILES = 4;
+    const int BUSHY_LEVELS = 6;
+    const int BUSHY_FANOUT = 4;
+
+    const char* const WORDS[] = {
+        "alpha", "Bravo", "charlie", "Delta", "echo", "foxtrot", "Golf", "hotel",
+        "india", "Juliet", "kilo", "lima", "Mike", "november", "oscar", "Papa",
+        "quebec", "romeo", "Sierra", "tango", "uniform", "victor", "Whiskey", "xray"
+    };
+    const size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+    // Small fixed-seed generator; std::mt19937 would do, but its output differs per standard library
+    struct Random {
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+
+        uint32_t next() {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<uint32_t>(state >> 33);
+        }
+
+        const char* word() { return WORDS[next() % WORD_COUNT]; }
+    };
+
+    std::filesystem::path markerPath(const std::filesystem::path& root, const std::string& name) {
+        return root / ("." + name + ".complete");
+    }
+
+    bool markComplete(const std::filesystem::path& root, const std::string& name, std::string& error) {
+        std::ofstream marker(markerPath(root, name));
+        if (!marker) {
+            error = "Cannot write " + markerPath(root, name).string();
+            return false;
+        }
+        return true;
+    }
+
+    bool createEmptyFile(const std::filesystem::path& path, std::string& error) {
+        FILE* file = fopen(path.string().c_str(), "w");
+        if (!file) {
+            error = "Cannot create " + path.string();
+            return false;
+        }
+        fclose(file);
+        return true;
+    }
+
+    bool createDirectory(const std::filesystem::path& path, std::string& error) {
+        std::error_code ec;
+        std::filesystem::create_directories(path, ec);
+        if (ec) {
+            error = "Cannot create " + path.string() + ": " + ec.message();
+            return false;
+        }
+        return true;
+    }
+
+    // Names mix case and share prefixes so that the case-insensitive sort has work to do
+    bool generateEntries(const std::filesystem::path& directory, uint64_t count, std::string& error) {
+        if (!createDirectory(directory, error)) return false;
+
+        Random random;
+        char name[96];
+        for (uint64_t i = 0; i < count; i++) {
+            const char* first = random.word();
+            const char* second = random.word();
+            bool is_directory = random.next() % 10 == 0;
+            snprintf(name, sizeof(name), "%s_%s_%07llu%s", first, second,
+                     static_cast<unsigned long long>(i), is_directory ? "" : ".txt");
+            if (is_directory) {
+                std::error_code ec;
+                std::filesystem::create_directory(directory / name, ec);
+                if (ec) {
+                    error = "Cannot create " + (directory / name).string() + ": " + ec.message();
+                    return false;
+                }
+            } else if (!createEmptyFile(directory / name, error)) {
+                return false;
+            }
+            if (i > 0 && i % 100000 == 0) {
+                std::cerr << "  " << i << " of " << count << " entries" << std::endl;
+            }
+        }
+        return true;
+    }
+
+    bool generateDeep(const std::filesystem::path& root, std::string& error) {
+        std::filesystem::path directory = root;
+        char name[32];
+        for (int level = 0; level < DEEP_LEVELS; level++) {
+            snprintf(name, sizeof(name), "level_%02d", level);
+            directory /= name;
+            if (!createDirectory(directory, error)) return false;
+            for (int file = 0; file < DEEP_FILES; file++) {
+                snprintf(name, sizeof(name), "file_%d.txt", file);
+                if (!createEmptyFile(directory / name, error)) return false;
+            }
+        }
+        return true;
+    }
+
+    bool generateBushy(const std::filesystem::path& directory, int levels, std::string& error) {
+        if (!createDirectory(directory, error)) return false;
+        char name[32];
+        for (int file = 0; file < BUSHY_FANOUT; file++) {
+            snprintf(name, sizeof(name), "file_%d.txt", file);
+            if (!createEmptyFile(directory / name, error)) return false;
+        }
+        if (levels == 0) return true;
+        for (int child = 0; child < BUSHY_FANOUT; child++) {
+            snprintf(name, sizeof(name), "dir_%d", child);
+            if (!generateBushy(directory / name, levels - 1, error)) return false;
+        }
+        return true;
+    }
+
+    // Lines of 4 to 15 words, numbered so that every line is distinct
+    bool generateText(const std::filesystem::path& path, uint64_t size, int edit_every, std::string& error) {
+        FILE* file = fopen(path.string().c_str(), "wb");
+        if (!file) {
+            error = "Cannot create " + path.string();
+            return false;
+        }
+
+        Random random;
+        std::vector<char> buffer;
+        buffer.reserve(1 << 20);
+        uint64_t written = 0;
+        uint64_t next_report = 1ull << 30;
+        char line[256];
+        for (uint64_t number = 1; written < size; number++) {
+            int length = snprintf(line, sizeof(line), "%08llu", static_cast<unsigned long long>(number));
+            int words = 4 + static_cast<int>(random.next() % 12);
+            for (int i = 0; i < words; i++) {
+                length += snprintf(line + length, sizeof(line) - length, " %s", random.word());
+            }
+            if (edit_every > 0 && number % edit_every == 0) {
+                length += snprintf(line + length, sizeof(line) - length, " edited");
+            }
+            line[length++] = '\n';
+
+            buffer.insert(buffer.end(), line, line + length);
+            written += length;
+            if (buffer.size() >= (1 << 20) - sizeof(line)) {
+                if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) break;
+                buffer.clear();
+            }
+            if (written >= next_report) {
+                std::cerr << "  " << (written >> 30) << " GB of " << path.filename().string() << std::endl;
+                next_report += 1ull << 30;
+            }
+        }
+        bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        ok = fclose(file) == 0 && ok;
+        if (!ok) error = "Cannot write " + path.string();
+        return ok;
+    }
+
+    // Array of records nested three levels deep
+    bool generateJson(const std::filesystem::path& path, std::string& error) {
+        std::ofstream out(path);
+        if (!out) {
+            error = "Cannot create " + path.string();
+            return false;
+        }
+        Random random;
+        out << "{\n  \"name\": \"fixture\",\n  \"records\": [\n";
+        for (int i = 0; i < 5000; i++) {
+            out << "    {\"id\": " << i << ", \"label\": \"" << random.word() << " " << random.word()
+                << "\", \"active\": " << (random.next() % 2 ? "true" : "false")
+                << ", \"tags\": [\"" << random.word() << "\", \"" << random.word() << "\"]"
+                << ", \"position\": {\"x\": " << random.next() % 1000 << ", \"y\": " << random.next() % 1000
+                << ", \"history\": [" << random.next() % 100 << ", " << random.next() % 100 << "]}}"
+                << (i + 1 < 5000 ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        if (!out) error = "Cannot write " + path.string();
+        return static_cast<bool>(out);
+    }
+
+    bool generateImage(const std::filesystem::path& path, std::string& error) {
+        const int width = 640;
+        const int height = 480;
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            error = "Cannot create " + path.string();
+            return false;
+        }
+        out << "P6\n" << width << " " << height << "\n255\n";
+        std::vector<char> row(width * 3);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                row[x * 3] = static_cast<char>(x * 255 / width);
+                row[x * 3 + 1] = static_cast<char>(y * 255 / height);
+                row[x * 3 + 2] = static_cast<char>((x + y) % 256);
+            }
+            out.write(row.data(), row.size());
+        }
+        if (!out) error = "Cannot write " + path.string();
+        return static_cast<bool>(out);
+    }
+
+    template <typename Generate>
+    bool ensure(const std::filesystem::path& root, const std::string& name, std::string& error, Generate generate) {
+        if (Fixtures::isComplete(root, name)) return true;
+
+        std::cerr << "Generating " << name << std::endl;
+        std::error_code ec;
+        std::filesystem::remove_all(root / name, ec);
+        return generate() && markComplete(root, name, error);
+    }
+}
+
+namespace Fixtures {
+    bool parseList(const std::string& text, std::vector<uint64_t>& values) {
+        values.clear();
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t end = text.find(',', start);
+            if (end == std::string::npos) end = text.size();
+            std::string item = text.substr(start, end - start);
+            start = end + 1;
+
+            char* suffix;
+            unsigned long long value = strtoull(item.c_str(), &suffix, 10);
+            if (suffix == item.c_str()) return false;
+            switch (*suffix) {
+                case '\0': break;
+                case 'k': value *= 1000ull; break;
+                case 'm': value *= 1000ull * 1000; break;
+                case 'g': value *= 1000ull * 1000 * 1000; break;
+                case 'K': value *= 1024ull; break;
+                case 'M': value *= 1024ull * 1024; break;
+                case 'G': value *= 1024ull * 1024 * 1024; break;
+                default: return false;
+            }
+            if (*suffix != '\0' && suffix[1] != '\0') return false;
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
+
+    std::string formatAmount(uint64_t value, bool binary) {
+        const uint64_t unit = binary ? 1024 : 1000;
+        const char* suffixes = binary ? "KMG" : "kmg";
+        for (int i = 2; i >= 0; i--) {
+            uint64_t scale = unit;
+            for (int j = 0; j < i; j++) scale *= unit;
+            if (value >= scale && value % scale == 0) {
+                return std::to_string(value / scale) + suffixes[i];
+            }
+        }
+        return std::to_string(value);
+    }
+
+    bool generate(const std::filesystem::path& root, const Options& options, std::string& error) {
+        if (!createDirectory(root, error)) return false;
+
+        for (uint64_t count : options.entry_counts) {
+            std::string name = "entries_" + formatAmount(count, false);
+            if (!ensure(root, name, error, [&] { return generateEntries(root / name, count, error); })) return false;
+        }
+        if (!ensure(root, "deep", error, [&] { return generateDeep(root / "deep", error); })) return false;
+        if (!ensure(root, "bushy", error, [&] { return generateBushy(root / "bushy", BUSHY_LEVELS - 1, error); })) {
+            return false;
+        }
+
+        for (uint64_t size : options.text_sizes) {
+            std::string name = "text_" + formatAmount(size, true) + ".txt";
+            if (!ensure(root, name, error, [&] { return generateText(root / name, size, 0, error); })) return false;
+        }
+        if (!ensure(root, "edited_1M.txt", error,
+                    [&] { return generateText(root / "edited_1M.txt", 1024 * 1024, 500, error); })) {
+            return false;
+        }
+        if (!ensure(root, "document.json", error, [&] { return generateJson(root / "document.json", error); })) {
+            return false;
+        }
+        return ensure(root, "image.ppm", error, [&] { return generateImage(root / "image.ppm", error); });
+    }
+
+    bool isComplete(const std::filesystem::path& root, const std::string& name) {
+        std::error_code ec;
+        return std::filesystem::exists(markerPath(root, name), ec) && std::filesystem::exists(root / name, ec);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef FIXTURES_H
+#define FIXTURES_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Synthetic directory trees and files for the benchmarks
+ * Everything is generated from a fixed seed, so two runs of the generator
+ * produce identical fixtures and benchmark results stay comparable. Fixtures
+ * that already exist are left alone; a marker file next to each one records
+ * that it was completed.
+ *
+ * Layout below the fixture root:
+ *     entries_<N>/     N entries with mixed-case names, one in ten a directory
+ *     deep/            A chain of 64 nested directories with a few files in each
+ *     bushy/           A tree six levels deep with four subdirectories and four files per directory
+ *     text_<SIZE>.txt  Text files of roughly 60-byte lines
+ *     edited_1M.txt    text_1M.txt with every 500th line changed, for the diff view
+ *     document.json    A JSON document of about 1 MB
+ *     image.ppm        A 640x480 color gradient
+ */
+namespace Fixtures {
+    struct Options {
+        std::vector<uint64_t> entry_counts{1000, 100000};
+        std::vector<uint64_t> text_sizes{1024 * 1024, 100 * 1024 * 1024};
+    };
+
+    /**
+     * @brief Parse a comma-separated list of counts or sizes
+     * Accepts suffixes k, m and g (powers of 1000 for counts) or K, M and G (powers of 1024 for sizes).
+     * @param text List such as "1k,100k,1m" or "1M,1G"
+     * @param values Receives the parsed numbers
+     * @return false if an item is not a number with an optional suffix
+     */
+    bool parseList(const std::string& text, std::vector<uint64_t>& values);
+
+    /**
+     * @brief Name of a count or size with its suffix, as used in fixture names ("100k", "10G")
+     */
+    std::string formatAmount(uint64_t value, bool binary);
+
+    /**
+     * @brief Create the fixtures that do not exist yet
+     * @param root Directory to create them in
+     * @param options Which entry counts and text sizes to create
+     * @param error Receives a description on failure
+     * @return true if all requested fixtures exist afterwards
+     */
+    bool generate(const std::filesystem::path& root, const Options& options, std::string& error);
+
+    /**
+     * @brief Check whether a fixture was generated completely
+     * @param root Fixture root
+     * @param name Fixture file or directory name
+     */
+    bool isComplete(const std::filesystem::path& root, const std::string& name);
+}
+
+#endif // FIXTURES_H
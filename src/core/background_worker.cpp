@@ -0,0 +1,82 @@
+#include "background_worker.h"
+
+BackgroundWorker::BackgroundWorker(size_t thread_count)
+    : stopping_(false)
+    , pending_(0)
+{
+    if (thread_count == 0) {
+        thread_count = std::thread::hardware_concurrency();
+        if (thread_count < 2) thread_count = 2;
+    }
+
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        threads_.emplace_back(&BackgroundWorker::workerLoop, this);
+    }
+}
+
+BackgroundWorker::~BackgroundWorker() {
+    stop();
+}
+
+void BackgroundWorker::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(task_mutex_);
+        if (stopping_) return;
+        tasks_.push_back(std::move(task));
+    }
+    pending_++;
+    task_available_.notify_one();
+}
+
+bool BackgroundWorker::drainCompletions() {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+        ready.swap(completions_);
+    }
+
+    bool ran = false;
+    for (auto& completion : ready) {
+        if (completion) {
+            completion();
+            ran = true;
+        }
+        pending_--;
+    }
+    return ran;
+}
+
+void BackgroundWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(task_mutex_);
+        if (stopping_) return;
+        stopping_ = true;
+        tasks_.clear();
+    }
+    task_available_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+void BackgroundWorker::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(task_mutex_);
+            task_available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_) return;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        Completion completion = task();
+        {
+            std::lock_guard<std::mutex> lock(completion_mutex_);
+            completions_.push_back(std::move(completion));
+        }
+        if (notify_) notify_();
+    }
+}
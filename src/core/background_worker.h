@@ -0,0 +1,89 @@
+#ifndef BACKGROUND_WORKER_H
+#define BACKGROUND_WORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Thread pool whose results are applied on the UI thread
+ * A task runs on a worker thread and returns a completion. The completion is
+ * queued and only runs when the UI thread calls drainCompletions(), so
+ * application state is never touched from a worker.
+ */
+class BackgroundWorker {
+public:
+    // Runs on the UI thread; may be empty when the task was cancelled
+    using Completion = std::function<void()>;
+    // Runs on a worker thread
+    using Task = std::function<Completion()>;
+
+    /**
+     * @brief Start the worker threads
+     * @param thread_count Number of threads (0 selects one per core, at least two)
+     */
+    explicit BackgroundWorker(size_t thread_count = 0);
+
+    /**
+     * @brief Stop and join all worker threads
+     */
+    ~BackgroundWorker();
+
+    BackgroundWorker(const BackgroundWorker&) = delete;
+    BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+    /**
+     * @brief Queue a task for a worker thread
+     * @param task Work to run; its returned completion is queued for the UI thread
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Run all queued completions on the calling (UI) thread
+     * @return true if any completion ran
+     */
+    bool drainCompletions();
+
+    /**
+     * @brief Check whether tasks are queued, running or awaiting their completion
+     * @return true if the UI should keep polling for results
+     */
+    bool hasPendingWork() const { return pending_.load() > 0; }
+
+    /**
+     * @brief Set a callback that a worker runs after queueing a completion
+     * Lets the UI thread sleep until there is something to drain. Set it
+     * before submitting work; it runs on worker threads.
+     * @param notify Thread-safe callback, for example EventLoop::wake()
+     */
+    void setCompletionNotifier(std::function<void()> notify) { notify_ = std::move(notify); }
+
+    /**
+     * @brief Stop accepting work and join the worker threads
+     */
+    void stop();
+
+    size_t getThreadCount() const { return threads_.size(); }
+
+private:
+    std::vector<std::thread> threads_;
+    std::deque<Task> tasks_;
+    std::mutex task_mutex_;
+    std::condition_variable task_available_;
+    bool stopping_;
+
+    std::vector<Completion> completions_;
+    std::mutex completion_mutex_;
+    std::function<void()> notify_;
+
+    // Submitted tasks whose completion has not been drained yet
+    std::atomic<int> pending_;
+
+    void workerLoop();
+};
+
+#endif // BACKGROUND_WORKER_H
@@ -0,0 +1,72 @@
+#include "browser_tree.h"
+
+BrowserTree::BrowserTree()
+    : next_id_(0)
+{
+}
+
+void BrowserTree::reset(size_t count) {
+    rows_.resize(count);
+    for (Row& row : rows_) {
+        row.id = next_id_++;
+        row.descendants = 0;
+        row.depth = 0;
+        row.state = State::COLLAPSED;
+    }
+}
+
+int BrowserTree::findRow(uint32_t id) const {
+    for (size_t i = 0; i < rows_.size(); i++) {
+        if (rows_[i].id == id) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int BrowserTree::findParent(size_t index) const {
+    uint16_t depth = rows_[index].depth;
+    if (depth == 0) return -1;
+
+    // The parent is the nearest row above that is one level up
+    for (size_t i = index; i-- > 0; ) {
+        if (rows_[i].depth < depth) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void BrowserTree::setLoading(size_t index) {
+    rows_[index].state = State::LOADING;
+}
+
+void BrowserTree::insertChildren(size_t index, size_t count) {
+    Row child;
+    child.descendants = 0;
+    child.depth = static_cast<uint16_t>(rows_[index].depth + 1);
+    child.state = State::COLLAPSED;
+    rows_.insert(rows_.begin() + index + 1, count, child);
+    for (size_t i = index + 1; i <= index + count; i++) {
+        rows_[i].id = next_id_++;
+    }
+
+    rows_[index].state = State::EXPANDED;
+    rows_[index].descendants += static_cast<uint32_t>(count);
+    addToAncestors(index, static_cast<long>(count));
+}
+
+size_t BrowserTree::collapse(size_t index) {
+    if (rows_[index].state == State::COLLAPSED) return 0;
+
+    // Expanded rows inside the subtree go with it
+    size_t count = rows_[index].descendants;
+    rows_.erase(rows_.begin() + index + 1, rows_.begin() + index + 1 + count);
+
+    rows_[index].state = State::COLLAPSED;
+    rows_[index].descendants = 0;
+    addToAncestors(index, -static_cast<long>(count));
+    return count;
+}
+
+void BrowserTree::addToAncestors(size_t index, long delta) {
+    for (int parent = findParent(index); parent >= 0; parent = findParent(parent)) {
+        rows_[parent].descendants = static_cast<uint32_t>(rows_[parent].descendants + delta);
+    }
+}
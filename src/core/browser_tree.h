@@ -0,0 +1,82 @@
+#ifndef BROWSER_TREE_H
+#define BROWSER_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Tree structure of the file browser rows
+ * The browser keeps every visible row, at any depth, in one flat array in
+ * display order, so selecting, scrolling, paging and home/end are index
+ * arithmetic however many rows are expanded. This class keeps one Row per
+ * entry of that array: its depth, whether it is expanded, and the number of
+ * visible rows in its subtree. Collapsing a directory removes exactly that
+ * many rows after it, and expanding one adds its children right after it;
+ * the subtree sizes of its ancestors are updated on the way up.
+ */
+class BrowserTree {
+public:
+    enum class State : uint8_t {
+        COLLAPSED,      // Children not shown (also every file)
+        LOADING,        // Expanded, children still being read
+        EXPANDED
+    };
+
+    struct Row {
+        uint32_t id;            // Stable while the row exists, to find it again after rows move
+        uint32_t descendants;   // Visible rows below it in its subtree
+        uint16_t depth;         // 0 for entries of the listed directory
+        State state;
+    };
+
+    BrowserTree();
+
+    /**
+     * @brief Start over with a flat listing
+     * @param count Number of entries, all at depth 0
+     */
+    void reset(size_t count);
+
+    size_t size() const { return rows_.size(); }
+    const Row& getRow(size_t index) const { return rows_[index]; }
+
+    /**
+     * @brief Find a row by id
+     * @return Its index, or -1 when it no longer exists
+     */
+    int findRow(uint32_t id) const;
+
+    /**
+     * @brief Find the directory a row is listed in
+     * @return Index of the parent row, or -1 at depth 0
+     */
+    int findParent(size_t index) const;
+
+    /**
+     * @brief Mark a collapsed row as waiting for its children
+     */
+    void setLoading(size_t index);
+
+    /**
+     * @brief Insert the children of a loading row right after it and mark it expanded
+     * @param index Row being expanded
+     * @param count Number of children, inserted at index + 1
+     */
+    void insertChildren(size_t index, size_t count);
+
+    /**
+     * @brief Collapse a row, removing its subtree
+     * @param index Row to collapse
+     * @return Number of rows removed after it
+     */
+    size_t collapse(size_t index);
+
+private:
+    std::vector<Row> rows_;
+    uint32_t next_id_;          // Never reused, so a stale id finds nothing
+
+    void addToAncestors(size_t index, long delta);
+};
+
+#endif // BROWSER_TREE_H
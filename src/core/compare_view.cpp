@@ -0,0 +1,199 @@
+#include "compare_view.h"
+#include "../utils/utils.h"
+#include <algorithm>
+
+namespace {
+    const char KIND_MARKERS[] = {'+', '-', '~'};
+
+    // Order paths component by component, so a directory's contents follow it directly
+    bool pathLess(const std::string& a, const std::string& b) {
+        size_t length = std::min(a.length(), b.length());
+        for (size_t i = 0; i < length; i++) {
+            if (a[i] == b[i]) continue;
+            if (a[i] == '/') return true;
+            if (b[i] == '/') return false;
+            return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[i]);
+        }
+        return a.length() < b.length();
+    }
+
+    bool differenceLess(const TreeDifference& a, const TreeDifference& b) {
+        return pathLess(a.relative_path, b.relative_path);
+    }
+
+    bool isInside(const std::string& path, const std::string& directory) {
+        return path.length() > directory.length() && path[directory.length()] == '/' &&
+               path.compare(0, directory.length(), directory) == 0;
+    }
+}
+
+CompareView::CompareView()
+    : counts_{0, 0, 0}
+    , selected_row_(0)
+    , scroll_offset_(0)
+{
+}
+
+void CompareView::reset(const std::filesystem::path& left, const std::filesystem::path& right) {
+    left_root_ = left;
+    right_root_ = right;
+    differences_.clear();
+    counts_[0] = counts_[1] = counts_[2] = 0;
+    collapsed_.clear();
+    rows_.clear();
+    selected_row_ = 0;
+    scroll_offset_ = 0;
+}
+
+void CompareView::addDifferences(std::vector<TreeDifference> found, int page_size) {
+    if (found.empty()) return;
+
+    std::string selected_path = rows_.empty() ? std::string() : rowPath(rows_[selected_row_]);
+
+    // Sort only the new batch, then merge it into the already sorted list
+    std::sort(found.begin(), found.end(), differenceLess);
+    size_t middle = differences_.size();
+    for (auto& difference : found) {
+        counts_[difference.kind]++;
+        differences_.push_back(std::move(difference));
+    }
+    std::inplace_merge(differences_.begin(), differences_.begin() + middle, differences_.end(), differenceLess);
+
+    buildRows();
+    if (selected_path.empty()) {
+        selected_row_ = 0;
+        scroll_offset_ = 0;
+    } else {
+        selectPath(selected_path, page_size);
+    }
+}
+
+const TreeDifference* CompareView::getDifference(size_t index) const {
+    int32_t difference = rows_[index].difference;
+    return difference < 0 ? nullptr : &differences_[difference];
+}
+
+std::string CompareView::formatRow(size_t index, size_t max_width) const {
+    const Row& row = rows_[index];
+    std::string text(row.depth * 2, ' ');
+
+    if (row.difference < 0) {
+        text += "  " + row.path.substr(row.name_offset) + "/";
+        if (collapsed_.count(row.path)) text += " ...";
+    } else {
+        const TreeDifference& difference = differences_[row.difference];
+        text += KIND_MARKERS[difference.kind];
+        text += ' ';
+        text += difference.relative_path.substr(row.name_offset);
+        // Sizes are only known for regular files; links and special files report 0
+        if (difference.directory) {
+            text += "/";
+        } else if (difference.kind == TreeDifference::ADDED && difference.right_size > 0) {
+            text += " (" + Utils::formatSize(difference.right_size) + ")";
+        } else if (difference.kind == TreeDifference::REMOVED && difference.left_size > 0) {
+            text += " (" + Utils::formatSize(difference.left_size) + ")";
+        } else if (difference.kind == TreeDifference::CHANGED && difference.left_size != difference.right_size) {
+            text += " (" + Utils::formatSize(difference.left_size) + " -> " +
+                    Utils::formatSize(difference.right_size) + ")";
+        }
+    }
+
+    if (text.length() > max_width) {
+        text = max_width > 3 ? text.substr(0, max_width - 3) + "..." : text.substr(0, max_width);
+    }
+    return text;
+}
+
+bool CompareView::toggleSelected(int page_size) {
+    if (rows_.empty() || rows_[selected_row_].difference >= 0) return false;
+
+    std::string path = rows_[selected_row_].path;
+    if (!collapsed_.erase(path)) {
+        collapsed_.insert(path);
+    }
+    buildRows();
+    selectPath(path, page_size);
+    return true;
+}
+
+void CompareView::moveSelection(int delta, int page_size) {
+    if (rows_.empty()) return;
+
+    long target = static_cast<long>(selected_row_) + delta;
+    target = std::max(0L, std::min(target, static_cast<long>(rows_.size()) - 1));
+    selected_row_ = static_cast<int>(target);
+    ensureVisible(page_size);
+}
+
+void CompareView::selectFirst() {
+    selected_row_ = 0;
+    scroll_offset_ = 0;
+}
+
+void CompareView::selectLast(int page_size) {
+    if (rows_.empty()) return;
+    selected_row_ = static_cast<int>(rows_.size()) - 1;
+    ensureVisible(page_size);
+}
+
+std::string CompareView::rowPath(const Row& row) const {
+    return row.difference < 0 ? row.path : differences_[row.difference].relative_path;
+}
+
+void CompareView::buildRows() {
+    rows_.clear();
+
+    // Directories enclosing the current difference, outermost first
+    std::vector<std::string> open;
+    size_t hidden_depth = SIZE_MAX;     // Depth of the outermost collapsed directory in `open`
+
+    for (int32_t index = 0; index < (int32_t)differences_.size(); index++) {
+        const std::string& path = differences_[index].relative_path;
+
+        while (!open.empty() && !isInside(path, open.back())) {
+            open.pop_back();
+        }
+        if (open.size() <= hidden_depth) {
+            hidden_depth = SIZE_MAX;
+        }
+
+        // Add rows for enclosing directories that have none yet
+        size_t start = open.empty() ? 0 : open.back().length() + 1;
+        for (size_t slash = path.find('/', start); slash != std::string::npos; slash = path.find('/', start)) {
+            std::string directory = path.substr(0, slash);
+            if (hidden_depth == SIZE_MAX) {
+                rows_.push_back({-1, static_cast<uint32_t>(open.size()), start, directory});
+                if (collapsed_.count(directory)) {
+                    hidden_depth = open.size();
+                }
+            }
+            open.push_back(std::move(directory));
+            start = slash + 1;
+        }
+
+        if (hidden_depth == SIZE_MAX) {
+            rows_.push_back({index, static_cast<uint32_t>(open.size()), start, std::string()});
+        }
+    }
+}
+
+void CompareView::selectPath(const std::string& path, int page_size) {
+    for (size_t i = 0; i < rows_.size(); i++) {
+        if (rowPath(rows_[i]) == path) {
+            selected_row_ = static_cast<int>(i);
+            ensureVisible(page_size);
+            return;
+        }
+    }
+    selected_row_ = std::min(selected_row_, std::max(0, static_cast<int>(rows_.size()) - 1));
+    ensureVisible(page_size);
+}
+
+void CompareView::ensureVisible(int page_size) {
+    if (page_size < 1) page_size = 1;
+    if (selected_row_ < scroll_offset_) {
+        scroll_offset_ = selected_row_;
+    } else if (selected_row_ >= scroll_offset_ + page_size) {
+        scroll_offset_ = selected_row_ - page_size + 1;
+    }
+}
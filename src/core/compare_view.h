@@ -0,0 +1,102 @@
+#ifndef COMPARE_VIEW_H
+#define COMPARE_VIEW_H
+
+#include "../filesystem/directory_compare.h"
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Browsable tree of the differences between two directories
+ * Differences arrive in batches while the comparison runs and are kept sorted
+ * so that every entry follows its parent directory. Directories that only
+ * contain differences get a row of their own and can be collapsed.
+ */
+class CompareView {
+public:
+    /**
+     * @brief One visible line of the tree
+     */
+    struct Row {
+        int32_t difference;     // Index into the differences, -1 for a directory that holds some
+        uint32_t depth;         // Nesting level below the roots
+        size_t name_offset;     // Start of the last path component
+        std::string path;       // Relative path of the directory row (empty for difference rows)
+    };
+
+    CompareView();
+
+    /**
+     * @brief Start a new, empty comparison
+     * @param left Old tree
+     * @param right New tree
+     */
+    void reset(const std::filesystem::path& left, const std::filesystem::path& right);
+
+    /**
+     * @brief Merge a batch of streamed differences into the tree
+     * The selection stays on the same entry.
+     * @param found New differences, in any order
+     * @param page_size Number of visible rows
+     */
+    void addDifferences(std::vector<TreeDifference> found, int page_size);
+
+    const std::filesystem::path& getLeftRoot() const { return left_root_; }
+    const std::filesystem::path& getRightRoot() const { return right_root_; }
+    size_t getDifferenceCount() const { return differences_.size(); }
+    size_t getCount(TreeDifference::Kind kind) const { return counts_[kind]; }
+    size_t getRowCount() const { return rows_.size(); }
+    int getSelectedRow() const { return selected_row_; }
+    int getScrollOffset() const { return scroll_offset_; }
+
+    /**
+     * @brief Get the difference shown on a row
+     * @param index Row index
+     * @return The difference, or nullptr for a directory row
+     */
+    const TreeDifference* getDifference(size_t index) const;
+
+    /**
+     * @brief Render a row as display text
+     * @param index Row index
+     * @param max_width Maximum number of characters to produce
+     * @return Indented, truncated row text
+     */
+    std::string formatRow(size_t index, size_t max_width) const;
+
+    /**
+     * @brief Collapse or expand the directory row under the selection
+     * @param page_size Number of visible rows
+     * @return true if a directory row was selected
+     */
+    bool toggleSelected(int page_size);
+
+    /**
+     * @brief Move the selection and keep it on screen
+     * @param delta Rows to move (negative moves up)
+     * @param page_size Number of visible rows
+     */
+    void moveSelection(int delta, int page_size);
+
+    void selectFirst();
+    void selectLast(int page_size);
+
+private:
+    std::filesystem::path left_root_;
+    std::filesystem::path right_root_;
+    std::vector<TreeDifference> differences_;
+    size_t counts_[3];
+    std::set<std::string> collapsed_;
+    std::vector<Row> rows_;
+    int selected_row_;
+    int scroll_offset_;
+
+    std::string rowPath(const Row& row) const;
+    void buildRows();
+    void selectPath(const std::string& path, int page_size);
+    void ensureVisible(int page_size);
+};
+
+#endif // COMPARE_VIEW_H
@@ -0,0 +1,134 @@
+#include "diff_view.h"
+#include <algorithm>
+
+namespace {
+    // Unchanged rows kept above a hunk when jumping to it
+    const int HUNK_CONTEXT = 3;
+    const size_t TAB_WIDTH = 4;
+}
+
+DiffView::DiffView()
+    : row_count_(0)
+    , scroll_offset_(0)
+    , current_hunk_(-1)
+{
+}
+
+bool DiffView::open(const std::filesystem::path& left, const std::filesystem::path& right) {
+    left_path_ = left;
+    right_path_ = right;
+    hunks_.clear();
+    hunk_rows_.clear();
+    row_count_ = 0;
+    scroll_offset_ = 0;
+    current_hunk_ = -1;
+
+    if (!left_file_.open(left)) {
+        error_ = left.filename().string() + ": " + left_file_.getError();
+        return false;
+    }
+    if (!right_file_.open(right)) {
+        error_ = right.filename().string() + ": " + right_file_.getError();
+        return false;
+    }
+
+    left_lines_.build(left_file_.data(), left_file_.size());
+    right_lines_.build(right_file_.data(), right_file_.size());
+    hunks_ = LineDiff::diff(left_lines_.getHashes(), right_lines_.getHashes());
+
+    // Each hunk takes as many rows as its longer side; unchanged lines take one row each
+    size_t row = 0;
+    size_t left_line = 0;
+    for (const auto& hunk : hunks_) {
+        row += hunk.a_begin - left_line;
+        hunk_rows_.push_back(row);
+        row += std::max(hunk.a_count, hunk.b_count);
+        left_line = hunk.a_begin + hunk.a_count;
+    }
+    row_count_ = row + (left_lines_.getLineCount() - left_line);
+    return true;
+}
+
+DiffView::Row DiffView::getRow(size_t index) const {
+    // Find the last hunk starting at or before this row
+    auto it = std::upper_bound(hunk_rows_.begin(), hunk_rows_.end(), index);
+    if (it == hunk_rows_.begin()) {
+        return {static_cast<long>(index), static_cast<long>(index), false};
+    }
+
+    size_t hunk_index = (it - hunk_rows_.begin()) - 1;
+    const LineDiff::Hunk& hunk = hunks_[hunk_index];
+    size_t offset = index - hunk_rows_[hunk_index];
+    size_t hunk_height = std::max(hunk.a_count, hunk.b_count);
+
+    if (offset < hunk_height) {
+        long left = offset < hunk.a_count ? static_cast<long>(hunk.a_begin + offset) : -1;
+        long right = offset < hunk.b_count ? static_cast<long>(hunk.b_begin + offset) : -1;
+        return {left, right, true};
+    }
+
+    offset -= hunk_height;
+    return {static_cast<long>(hunk.a_begin + hunk.a_count + offset),
+            static_cast<long>(hunk.b_begin + hunk.b_count + offset), false};
+}
+
+std::string DiffView::formatLine(bool right, long line, size_t max_width) const {
+    if (line < 0) return std::string();
+
+    const char* begin;
+    size_t length;
+    (right ? right_lines_ : left_lines_).getLine(static_cast<size_t>(line), begin, length);
+    if (length > 0 && begin[length - 1] == '\r') length--;
+
+    std::string text;
+    for (size_t i = 0; i < length && text.length() < max_width; i++) {
+        unsigned char c = static_cast<unsigned char>(begin[i]);
+        if (c == '\t') {
+            text.append(TAB_WIDTH - text.length() % TAB_WIDTH, ' ');
+        } else if (c < 0x20 || c == 0x7F) {
+            text += '?';
+        } else {
+            text += static_cast<char>(c);
+        }
+    }
+    if (text.length() > max_width) {
+        text.resize(max_width);
+    }
+    return text;
+}
+
+void DiffView::scroll(int delta, int page_size) {
+    long max_offset = std::max(0L, static_cast<long>(row_count_) - page_size);
+    long target = static_cast<long>(scroll_offset_) + delta;
+    scroll_offset_ = static_cast<int>(std::max(0L, std::min(target, max_offset)));
+}
+
+void DiffView::scrollToStart() {
+    scroll_offset_ = 0;
+}
+
+void DiffView::scrollToEnd(int page_size) {
+    scroll_offset_ = static_cast<int>(std::max(0L, static_cast<long>(row_count_) - page_size));
+}
+
+bool DiffView::jumpToHunk(bool forward, int page_size) {
+    if (hunks_.empty()) return false;
+
+    // Step from the current hunk while it is on screen, otherwise from the top row
+    long target;
+    bool current_visible = current_hunk_ >= 0 &&
+                           hunk_rows_[current_hunk_] >= (size_t)scroll_offset_ &&
+                           hunk_rows_[current_hunk_] < (size_t)scroll_offset_ + page_size;
+    if (current_visible) {
+        target = current_hunk_ + (forward ? 1 : -1);
+    } else {
+        auto it = std::lower_bound(hunk_rows_.begin(), hunk_rows_.end(), (size_t)scroll_offset_);
+        target = (it - hunk_rows_.begin()) - (forward ? 0 : 1);
+    }
+    if (target < 0 || target >= (long)hunks_.size()) return false;
+
+    current_hunk_ = static_cast<int>(target);
+    scroll_offset_ = 0;
+    scroll(static_cast<int>(hunk_rows_[target]) - HUNK_CONTEXT, page_size);
+    return true;
+}
@@ -0,0 +1,98 @@
+#ifndef DIFF_VIEW_H
+#define DIFF_VIEW_H
+
+#include "../filesystem/mapped_file.h"
+#include "../filesystem/line_index.h"
+#include "../utils/line_diff.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Side-by-side line diff of two memory-mapped files
+ * Both files are indexed and hashed in parallel, then diffed by line hash.
+ * Display rows are not stored: each one is located from the hunk list when
+ * it is drawn, so only the visible part of the diff is ever formatted.
+ */
+class DiffView {
+public:
+    /**
+     * @brief Lines shown on one display row
+     */
+    struct Row {
+        long left;          // Line in the left file, -1 for a filler row
+        long right;         // Line in the right file, -1 for a filler row
+        bool changed;       // Row belongs to a hunk
+    };
+
+    DiffView();
+
+    /**
+     * @brief Map both files and diff them
+     * @param left Old file, shown on the left
+     * @param right New file, shown on the right
+     * @return true if successful, false otherwise (see getError())
+     */
+    bool open(const std::filesystem::path& left, const std::filesystem::path& right);
+
+    const std::string& getError() const { return error_; }
+    const std::filesystem::path& getLeftPath() const { return left_path_; }
+    const std::filesystem::path& getRightPath() const { return right_path_; }
+    size_t getLeftLineCount() const { return left_lines_.getLineCount(); }
+    size_t getRightLineCount() const { return right_lines_.getLineCount(); }
+    size_t getHunkCount() const { return hunks_.size(); }
+    size_t getRowCount() const { return row_count_; }
+    int getScrollOffset() const { return scroll_offset_; }
+    int getCurrentHunk() const { return current_hunk_; }
+
+    /**
+     * @brief Locate the lines on a display row
+     * @param index Row index
+     * @return Lines of both files on that row
+     */
+    Row getRow(size_t index) const;
+
+    /**
+     * @brief Render a line as display text
+     * @param right true for the right file, false for the left
+     * @param line Line number, -1 for a filler row
+     * @param max_width Maximum number of characters to produce
+     * @return Line text with tabs expanded and control characters replaced
+     */
+    std::string formatLine(bool right, long line, size_t max_width) const;
+
+    /**
+     * @brief Scroll the view
+     * @param delta Rows to move (negative moves up)
+     * @param page_size Number of visible rows
+     */
+    void scroll(int delta, int page_size);
+
+    void scrollToStart();
+    void scrollToEnd(int page_size);
+
+    /**
+     * @brief Scroll to the next or previous hunk
+     * @param forward true for the next hunk, false for the previous one
+     * @param page_size Number of visible rows
+     * @return true if there was a hunk to move to
+     */
+    bool jumpToHunk(bool forward, int page_size);
+
+private:
+    MappedFile left_file_;
+    MappedFile right_file_;
+    LineIndex left_lines_;
+    LineIndex right_lines_;
+    std::filesystem::path left_path_;
+    std::filesystem::path right_path_;
+    std::string error_;
+
+    std::vector<LineDiff::Hunk> hunks_;
+    std::vector<size_t> hunk_rows_;     // First display row of each hunk
+    size_t row_count_;
+    int scroll_offset_;
+    int current_hunk_;
+};
+
+#endif // DIFF_VIEW_H
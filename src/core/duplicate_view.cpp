@@ -0,0 +1,96 @@
+#include "duplicate_view.h"
+#include "../utils/utils.h"
+#include <algorithm>
+
+DuplicateView::DuplicateView()
+    : reclaimable_bytes_(0)
+    , selected_row_(0)
+    , scroll_offset_(0)
+{
+}
+
+void DuplicateView::setGroups(const std::filesystem::path& root, std::vector<DuplicateGroup> groups) {
+    root_ = root;
+    groups_ = std::move(groups);
+    reclaimable_bytes_ = DuplicateFinder::reclaimableBytes(groups_);
+    selected_row_ = 0;
+    scroll_offset_ = 0;
+
+    rows_.clear();
+    for (uint32_t group = 0; group < groups_.size(); group++) {
+        rows_.push_back({group, -1, 0});
+        const auto& copies = groups_[group].copies;
+        for (int32_t copy = 0; copy < (int32_t)copies.size(); copy++) {
+            for (uint32_t link = 0; link < copies[copy].size(); link++) {
+                rows_.push_back({group, copy, link});
+            }
+        }
+    }
+
+    // Start on the first path rather than a header
+    if (rows_.size() > 1) {
+        selected_row_ = 1;
+    }
+}
+
+std::string DuplicateView::formatRow(size_t index, size_t max_width) const {
+    const Row& row = rows_[index];
+    const DuplicateGroup& group = groups_[row.group];
+
+    std::string text;
+    if (row.copy < 0) {
+        text = std::to_string(group.copies.size()) + " copies of " + Utils::formatSize(group.size) +
+               " (" + Utils::formatSize(group.size * (group.copies.size() - 1)) + " reclaimable)";
+    } else {
+        const std::filesystem::path& path = group.copies[row.copy][row.link];
+        std::string relative = path.lexically_relative(root_).string();
+        if (relative.empty()) relative = path.string();
+
+        // Further links to the same inode share its row marker
+        text = row.link == 0 ? "  " : "  = ";
+        text += relative;
+        if (row.link > 0) text += " (hard link)";
+    }
+
+    if (text.length() > max_width) {
+        text = max_width > 3 ? text.substr(0, max_width - 3) + "..." : text.substr(0, max_width);
+    }
+    return text;
+}
+
+bool DuplicateView::getSelectedPath(std::filesystem::path& path) const {
+    if (rows_.empty() || isHeaderRow(selected_row_)) return false;
+
+    const Row& row = rows_[selected_row_];
+    path = groups_[row.group].copies[row.copy][row.link];
+    return true;
+}
+
+void DuplicateView::moveSelection(int delta, int page_size) {
+    if (rows_.empty()) return;
+
+    long target = static_cast<long>(selected_row_) + delta;
+    target = std::max(0L, std::min(target, static_cast<long>(rows_.size()) - 1));
+    selected_row_ = static_cast<int>(target);
+    ensureVisible(page_size);
+}
+
+void DuplicateView::selectFirst() {
+    selected_row_ = 0;
+    scroll_offset_ = 0;
+}
+
+void DuplicateView::selectLast(int page_size) {
+    if (rows_.empty()) return;
+    selected_row_ = static_cast<int>(rows_.size()) - 1;
+    ensureVisible(page_size);
+}
+
+void DuplicateView::ensureVisible(int page_size) {
+    if (page_size < 1) page_size = 1;
+    if (selected_row_ < scroll_offset_) {
+        scroll_offset_ = selected_row_;
+    } else if (selected_row_ >= scroll_offset_ + page_size) {
+        scroll_offset_ = selected_row_ - page_size + 1;
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef DUPLICATE_VIEW_H
+#define DUPLICATE_VIEW_H
+
+#include "../filesystem/duplicate_finder.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Browsable list of duplicate groups
+ * Each group is a header row followed by one row per path. Paths are shown
+ * relative to the searched directory.
+ */
+class DuplicateView {
+public:
+    /**
+     * @brief One visible line of the list
+     */
+    struct Row {
+        uint32_t group;     // Index into the groups
+        int32_t copy;       // Copy within the group, -1 for the group header
+        uint32_t link;      // Hard link within the copy
+    };
+
+    DuplicateView();
+
+    /**
+     * @brief Replace the list with new search results
+     * @param root Directory that was searched
+     * @param groups Duplicate groups, in display order
+     */
+    void setGroups(const std::filesystem::path& root, std::vector<DuplicateGroup> groups);
+
+    const std::filesystem::path& getRoot() const { return root_; }
+    size_t getGroupCount() const { return groups_.size(); }
+    uint64_t getReclaimableBytes() const { return reclaimable_bytes_; }
+    size_t getRowCount() const { return rows_.size(); }
+    int getSelectedRow() const { return selected_row_; }
+    int getScrollOffset() const { return scroll_offset_; }
+
+    /**
+     * @brief Check whether a row is a group header
+     * @param index Row index
+     * @return true for header rows
+     */
+    bool isHeaderRow(size_t index) const { return rows_[index].copy < 0; }
+
+    /**
+     * @brief Render a row as display text
+     * @param index Row index
+     * @param max_width Maximum number of characters to produce
+     * @return Indented, truncated row text
+     */
+    std::string formatRow(size_t index, size_t max_width) const;
+
+    /**
+     * @brief Get the file on the selected row
+     * @param path Receives the full path
+     * @return true if a path row is selected, false on a header row or an empty list
+     */
+    bool getSelectedPath(std::filesystem::path& path) const;
+
+    /**
+     * @brief Move the selection and keep it on screen
+     * @param delta Rows to move (negative moves up)
+     * @param page_size Number of visible rows
+     */
+    void moveSelection(int delta, int page_size);
+
+    void selectFirst();
+    void selectLast(int page_size);
+
+private:
+    std::filesystem::path root_;
+    std::vector<DuplicateGroup> groups_;
+    std::vector<Row> rows_;
+    uint64_t reclaimable_bytes_;
+    int selected_row_;
+    int scroll_offset_;
+
+    void ensureVisible(int page_size);
+};
+
+#endif // DUPLICATE_VIEW_H
@@ -0,0 +1,294 @@
+#include "json_tree.h"
+#include "../utils/utils.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // Children listed per expansion; the rest sit behind a placeholder row
+    const size_t CHILD_CHUNK = 1000;
+
+    inline bool isJsonWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    inline char displayChar(char c) {
+        return (static_cast<unsigned char>(c) < 32 || c == 127) ? '.' : c;
+    }
+}
+
+JsonTree::JsonTree()
+    : selected_row_(0)
+    , scroll_offset_(0)
+{
+}
+
+bool JsonTree::open(const std::filesystem::path& path) {
+    rows_.clear();
+    selected_row_ = 0;
+    scroll_offset_ = 0;
+    path_ = path;
+
+    if (!file_.open(path)) {
+        error_ = file_.getError();
+        return false;
+    }
+
+    file_.adviseSequential();
+    if (!index_.build(file_.data(), file_.size())) {
+        error_ = "Invalid JSON: " + index_.getError();
+        file_.close();
+        return false;
+    }
+
+    uint64_t limit = file_.size();
+    uint64_t start = skipWhitespace(0, limit);
+    if (start >= limit) {
+        error_ = "Empty JSON document";
+        file_.close();
+        return false;
+    }
+
+    // Root row: the top-level container (or scalar), expanded one level
+    Row root{};
+    root.value_begin = start;
+    root.container = index_.getContainers().empty() ? -1 : 0;
+    rows_.push_back(root);
+    if (root.container == 0) {
+        expandSelected();
+    }
+    return true;
+}
+
+uint64_t JsonTree::skipWhitespace(uint64_t pos, uint64_t limit) const {
+    const char* data = file_.data();
+    while (pos < limit && isJsonWhitespace(data[pos])) pos++;
+    return pos;
+}
+
+uint64_t JsonTree::skipString(uint64_t pos, uint64_t limit) const {
+    const char* data = file_.data();
+    uint64_t search = pos + 1;
+    while (search < limit) {
+        const void* found = memchr(data + search, '"', limit - search);
+        if (!found) break;
+        uint64_t quote = static_cast<const char*>(found) - data;
+
+        // The quote is escaped only if preceded by an odd number of backslashes
+        uint64_t backslashes = 0;
+        while (quote - backslashes > pos + 1 && data[quote - backslashes - 1] == '\\') backslashes++;
+        if (backslashes % 2 == 0) return quote + 1;
+        search = quote + 1;
+    }
+    return limit;
+}
+
+uint64_t JsonTree::skipScalar(uint64_t pos, uint64_t limit) const {
+    const char* data = file_.data();
+    while (pos < limit) {
+        char c = data[pos];
+        if (c == ',' || c == ']' || c == '}' || isJsonWhitespace(c)) break;
+        pos++;
+    }
+    return pos;
+}
+
+void JsonTree::listChildren(size_t insert_at, int32_t parent, uint64_t start,
+                            int32_t next_container, uint32_t first_element, uint16_t depth) {
+    const auto& containers = index_.getContainers();
+    const char* data = file_.data();
+    const JsonIndex::Container& owner = containers[parent];
+    const bool is_object = data[owner.open] == '{';
+    const uint64_t limit = owner.close;
+
+    std::vector<Row> children;
+    uint64_t pos = start;
+    uint32_t element = first_element;
+
+    while (true) {
+        pos = skipWhitespace(pos, limit);
+        if (pos >= limit) break;
+
+        if (children.size() >= CHILD_CHUNK) {
+            Row more{};
+            more.resume = pos;
+            more.resume_container = next_container;
+            more.container = parent;
+            more.element = element;
+            more.depth = depth;
+            more.more = true;
+            children.push_back(more);
+            break;
+        }
+
+        Row row{};
+        row.depth = depth;
+        row.element = element++;
+        row.container = -1;
+
+        if (is_object) {
+            if (data[pos] != '"') break;  // Malformed member, stop listing
+            uint64_t key_end = skipString(pos, limit);
+            row.key_begin = pos;
+            row.key_length = key_end - pos;
+            pos = skipWhitespace(key_end, limit);
+            if (pos < limit && data[pos] == ':') {
+                pos = skipWhitespace(pos + 1, limit);
+            }
+            if (pos >= limit) break;
+        }
+
+        row.value_begin = pos;
+        char c = data[pos];
+        if ((c == '{' || c == '[') && next_container < static_cast<int32_t>(containers.size()) &&
+            containers[next_container].open == pos) {
+            // Nested containers appear in index order, so the next sibling follows this subtree
+            row.container = next_container;
+            pos = containers[next_container].close + 1;
+            next_container = static_cast<int32_t>(containers[next_container].end);
+        } else if (c == '"') {
+            pos = skipString(pos, limit);
+        } else {
+            pos = skipScalar(pos, limit);
+        }
+        children.push_back(row);
+
+        pos = skipWhitespace(pos, limit);
+        if (pos < limit && data[pos] == ',') {
+            pos++;
+        } else {
+            break;
+        }
+    }
+
+    rows_.insert(rows_.begin() + insert_at, children.begin(), children.end());
+}
+
+bool JsonTree::expandSelected() {
+    if (rows_.empty()) return false;
+
+    size_t index = static_cast<size_t>(selected_row_);
+    Row row = rows_[index];
+
+    if (row.more) {
+        rows_.erase(rows_.begin() + index);
+        listChildren(index, row.container, row.resume, row.resume_container, row.element, row.depth);
+        return true;
+    }
+
+    if (row.container < 0 || row.expanded) return false;
+
+    const auto& container = index_.getContainers()[row.container];
+    rows_[index].expanded = true;
+    listChildren(index + 1, row.container, container.open + 1, row.container + 1, 0,
+                 static_cast<uint16_t>(row.depth + 1));
+    return true;
+}
+
+void JsonTree::collapseSelected(int page_size) {
+    if (rows_.empty()) return;
+
+    size_t index = static_cast<size_t>(selected_row_);
+    Row& row = rows_[index];
+
+    if (row.container >= 0 && row.expanded && !row.more) {
+        size_t end = index + 1;
+        while (end < rows_.size() && rows_[end].depth > row.depth) end++;
+        rows_.erase(rows_.begin() + index + 1, rows_.begin() + end);
+        row.expanded = false;
+        return;
+    }
+
+    // Already collapsed: move to the parent row
+    for (size_t i = index; i-- > 0;) {
+        if (rows_[i].depth < row.depth) {
+            selected_row_ = static_cast<int>(i);
+            ensureVisible(page_size);
+            return;
+        }
+    }
+}
+
+void JsonTree::moveSelection(int delta, int page_size) {
+    if (rows_.empty()) return;
+
+    long target = static_cast<long>(selected_row_) + delta;
+    target = std::max(0L, std::min(target, static_cast<long>(rows_.size()) - 1));
+    selected_row_ = static_cast<int>(target);
+    ensureVisible(page_size);
+}
+
+void JsonTree::selectFirst() {
+    selected_row_ = 0;
+    scroll_offset_ = 0;
+}
+
+void JsonTree::selectLast(int page_size) {
+    if (rows_.empty()) return;
+    selected_row_ = static_cast<int>(rows_.size()) - 1;
+    ensureVisible(page_size);
+}
+
+void JsonTree::ensureVisible(int page_size) {
+    if (page_size < 1) page_size = 1;
+    if (selected_row_ < scroll_offset_) {
+        scroll_offset_ = selected_row_;
+    } else if (selected_row_ >= scroll_offset_ + page_size) {
+        scroll_offset_ = selected_row_ - page_size + 1;
+    }
+}
+
+std::string JsonTree::formatRow(size_t index, size_t max_width) const {
+    const Row& row = rows_[index];
+    const char* data = file_.data();
+
+    std::string text(static_cast<size_t>(row.depth) * 2, ' ');
+
+    if (row.more) {
+        text += "  ... more (Enter to load)";
+        if (text.length() > max_width) text.resize(max_width);
+        return text;
+    }
+
+    text += row.container >= 0 ? (row.expanded ? "- " : "+ ") : "  ";
+
+    // Member name without its quotes, or the element position inside arrays
+    if (row.key_length >= 2) {
+        uint64_t name_length = std::min<uint64_t>(row.key_length - 2, max_width);
+        for (uint64_t i = 0; i < name_length; i++) {
+            text += displayChar(data[row.key_begin + 1 + i]);
+        }
+        text += ": ";
+    } else if (row.depth > 0) {
+        text += std::to_string(row.element) + ": ";
+    }
+
+    if (row.container >= 0) {
+        const auto& container = index_.getContainers()[row.container];
+        bool is_object = data[container.open] == '{';
+        text += is_object ? "{...}" : "[...]";
+        text += " (" + Utils::formatSize(container.close - container.open + 1) + ")";
+    } else if (text.length() < max_width) {
+        // Copy only what fits; long strings are never scanned to their end
+        uint64_t limit = file_.size();
+        uint64_t pos = row.value_begin;
+        bool is_string = data[pos] == '"';
+        bool escaped = false;
+        while (pos < limit && text.length() < max_width) {
+            char c = data[pos];
+            if (is_string) {
+                text += displayChar(c);
+                if (pos > row.value_begin && !escaped && c == '"') break;
+                escaped = !escaped && c == '\\';
+            } else {
+                if (c == ',' || c == ']' || c == '}' || isJsonWhitespace(c)) break;
+                text += c;
+            }
+            pos++;
+        }
+    }
+
+    if (text.length() > max_width) {
+        text.resize(max_width);
+    }
+    return text;
+}
@@ -0,0 +1,100 @@
+#ifndef JSON_TREE_H
+#define JSON_TREE_H
+
+#include "../filesystem/mapped_file.h"
+#include "../filesystem/json_index.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Collapsible tree view over a memory-mapped JSON document
+ * Only visible rows are materialized. Expanding a node scans its children
+ * directly from the mapped bytes, using the structural index to skip nested
+ * containers, and large containers are listed in chunks.
+ */
+class JsonTree {
+public:
+    /**
+     * @brief One visible line of the tree
+     */
+    struct Row {
+        uint64_t key_begin;         // Offset of the member name's opening quote
+        uint64_t key_length;        // Length of the quoted name, 0 for array elements
+        uint64_t value_begin;       // Offset of the value's first byte
+        uint64_t resume;            // Placeholder rows: offset to continue listing from
+        int32_t container;          // Container index, or the parent's for placeholder rows; -1 for scalars
+        int32_t resume_container;   // Placeholder rows: next child container index
+        uint32_t element;           // Position among siblings
+        uint16_t depth;             // Nesting level
+        bool expanded;              // Children rows follow this row
+        bool more;                  // Placeholder for children not yet listed
+    };
+
+    JsonTree();
+
+    /**
+     * @brief Map and index a JSON file
+     * @param path Path to the file
+     * @return true if successful, false otherwise (see getError())
+     */
+    bool open(const std::filesystem::path& path);
+
+    const std::string& getError() const { return error_; }
+    const std::filesystem::path& getPath() const { return path_; }
+    size_t getFileSize() const { return file_.size(); }
+    size_t getContainerCount() const { return index_.getContainers().size(); }
+    size_t getRowCount() const { return rows_.size(); }
+    const Row& getRow(size_t index) const { return rows_[index]; }
+    int getSelectedRow() const { return selected_row_; }
+    int getScrollOffset() const { return scroll_offset_; }
+
+    /**
+     * @brief Render a row as display text
+     * @param index Row index
+     * @param max_width Maximum number of characters to produce
+     * @return Indented, truncated row text
+     */
+    std::string formatRow(size_t index, size_t max_width) const;
+
+    /**
+     * @brief Move the selection and keep it on screen
+     * @param delta Rows to move (negative moves up)
+     * @param page_size Number of visible rows
+     */
+    void moveSelection(int delta, int page_size);
+
+    void selectFirst();
+    void selectLast(int page_size);
+
+    /**
+     * @brief Expand the selected container or load the next chunk of a placeholder
+     * @return true if rows were added
+     */
+    bool expandSelected();
+
+    /**
+     * @brief Collapse the selected container, or jump to its parent if already collapsed
+     * @param page_size Number of visible rows
+     */
+    void collapseSelected(int page_size);
+
+private:
+    MappedFile file_;
+    JsonIndex index_;
+    std::filesystem::path path_;
+    std::string error_;
+    std::vector<Row> rows_;
+    int selected_row_;
+    int scroll_offset_;
+
+    uint64_t skipWhitespace(uint64_t pos, uint64_t limit) const;
+    uint64_t skipString(uint64_t pos, uint64_t limit) const;
+    uint64_t skipScalar(uint64_t pos, uint64_t limit) const;
+    void listChildren(size_t insert_at, int32_t parent, uint64_t start,
+                      int32_t next_container, uint32_t first_element, uint16_t depth);
+    void ensureVisible(int page_size);
+};
+
+#endif // JSON_TREE_H
@@ -0,0 +1,161 @@
+#include "keystroke_monitor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    const char* const HEADER = "# quickView keystrokes";
+
+    double microseconds(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+        return std::chrono::duration<double, std::micro>(to - from).count();
+    }
+
+    // Nearest-rank percentile
+    double percentile(std::vector<double> values, double fraction) {
+        if (values.empty()) return 0;
+        std::sort(values.begin(), values.end());
+        size_t rank = static_cast<size_t>(std::ceil(fraction * values.size()));
+        return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+}
+
+KeystrokeMonitor::KeystrokeMonitor()
+    : recording_(nullptr)
+    , next_key_(0)
+    , first_undrawn_(0)
+{
+}
+
+KeystrokeMonitor::~KeystrokeMonitor() {
+    if (recording_) {
+        fclose(recording_);
+    }
+}
+
+bool KeystrokeMonitor::load(const std::filesystem::path& path, std::vector<Key>& keys, int& width, int& height,
+                            std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "Cannot read " + path.string();
+        return false;
+    }
+
+    keys.clear();
+    width = 0;
+    height = 0;
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        if (line.compare(0, strlen(HEADER), HEADER) == 0) {
+            sscanf(line.c_str() + strlen(HEADER), " %dx%d", &width, &height);
+            continue;
+        }
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream fields(line);
+        Key key;
+        if (!(fields >> key.offset_us >> key.key)) {
+            error = path.string() + ":" + std::to_string(line_number) + ": expected OFFSET_US KEY";
+            return false;
+        }
+        keys.push_back(key);
+    }
+    if (width <= 0 || height <= 0) {
+        error = path.string() + " is not a keystroke recording";
+        return false;
+    }
+    return true;
+}
+
+bool KeystrokeMonitor::startRecording(const std::filesystem::path& path, int width, int height, std::string& error) {
+    recording_ = fopen(path.string().c_str(), "w");
+    if (!recording_) {
+        error = "Cannot write " + path.string();
+        return false;
+    }
+    fprintf(recording_, "%s %dx%d\n", HEADER, width, height);
+    recording_start_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+void KeystrokeMonitor::startReplay(const std::vector<Key>& keys, std::chrono::steady_clock::time_point start) {
+    replay_keys_ = keys;
+    latencies_.assign(keys.size(), Latency());
+    for (size_t i = 0; i < keys.size(); i++) {
+        latencies_[i].pressed = start + std::chrono::microseconds(keys[i].offset_us);
+    }
+    next_key_ = 0;
+    first_undrawn_ = 0;
+}
+
+void KeystrokeMonitor::keyRead(int key) {
+    if (!recording_) return;
+    auto offset = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - recording_start_);
+    fprintf(recording_, "%lld %d\n", static_cast<long long>(offset.count()), key);
+}
+
+void KeystrokeMonitor::beginKeys() {
+    applying_ = std::chrono::steady_clock::now();
+}
+
+void KeystrokeMonitor::endKeys(size_t count) {
+    auto now = std::chrono::steady_clock::now();
+    size_t end = std::min(latencies_.size(), next_key_ + count);
+    for (; next_key_ < end; next_key_++) {
+        latencies_[next_key_].applying = applying_;
+        latencies_[next_key_].applied = now;
+    }
+}
+
+void KeystrokeMonitor::frameDone(std::chrono::steady_clock::time_point draw_start,
+                                 std::chrono::steady_clock::time_point draw_end,
+                                 std::chrono::steady_clock::time_point flush_end) {
+    for (; first_undrawn_ < next_key_; first_undrawn_++) {
+        Latency& latency = latencies_[first_undrawn_];
+        latency.draw_start = draw_start;
+        latency.draw_end = draw_end;
+        latency.flush_end = flush_end;
+        latency.done = true;
+    }
+}
+
+void KeystrokeMonitor::writeReport(std::ostream& out) const {
+    const char* const PHASES[] = {"input", "update", "wait", "draw", "flush", "total"};
+    std::vector<double> phases[6];
+
+    out << "key  time (ms)  code  input  update  wait  draw  flush  total (us)\n";
+    out << std::fixed;
+    for (size_t i = 0; i < latencies_.size(); i++) {
+        const Latency& latency = latencies_[i];
+        if (!latency.done) continue;
+
+        double values[6] = {
+            microseconds(latency.pressed, latency.applying),
+            microseconds(latency.applying, latency.applied),
+            microseconds(latency.applied, latency.draw_start),
+            microseconds(latency.draw_start, latency.draw_end),
+            microseconds(latency.draw_end, latency.flush_end),
+            microseconds(latency.pressed, latency.flush_end)
+        };
+        out << i + 1 << "  " << std::setprecision(1) << replay_keys_[i].offset_us / 1000.0 << "  "
+            << replay_keys_[i].key << std::setprecision(0);
+        for (int phase = 0; phase < 6; phase++) {
+            phases[phase].push_back(values[phase]);
+            out << "  " << values[phase];
+        }
+        out << "\n";
+    }
+
+    out << "phase  p50  p99  max (us)\n";
+    for (int phase = 0; phase < 6; phase++) {
+        double maximum = phases[phase].empty() ? 0 : *std::max_element(phases[phase].begin(), phases[phase].end());
+        out << PHASES[phase] << "  " << percentile(phases[phase], 0.50) << "  "
+            << percentile(phases[phase], 0.99) << "  " << maximum << "\n";
+    }
+    out << phases[5].size() << " of " << latencies_.size() << " keys reached a frame" << std::endl;
+}
@@ -0,0 +1,118 @@
+#ifndef KEYSTROKE_MONITOR_H
+#define KEYSTROKE_MONITOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Records typed keys with their timing, and measures the latency of replayed ones
+ * A recording is a text file: a "# quickView keystrokes WIDTHxHEIGHT" header,
+ * then one "OFFSET_US KEY" line per key, the offset counted from the start of
+ * the recording and the key a character or ITerminal::KeyCode.
+ *
+ * During a replay each key is followed from the moment it is pressed until the
+ * frame showing its effect has been flushed, split into
+ *     input   until Input::handleInput starts applying it
+ *     update  applying it to the model (a run of the same key is applied at once and shares this)
+ *     wait    until the next frame starts, which the frame rate cap can delay
+ *     draw    building the frame
+ *     flush   sending it to the terminal
+ */
+class KeystrokeMonitor {
+public:
+    struct Key {
+        int64_t offset_us;      // Time since the recording started
+        int key;
+    };
+
+    KeystrokeMonitor();
+    ~KeystrokeMonitor();
+
+    KeystrokeMonitor(const KeystrokeMonitor&) = delete;
+    KeystrokeMonitor& operator=(const KeystrokeMonitor&) = delete;
+
+    /**
+     * @brief Read a recording
+     * @param path Recording file
+     * @param keys Receives the keys in order
+     * @param width Receives the screen width it was recorded at
+     * @param height Receives the screen height
+     * @param error Receives a description on failure
+     * @return true if the file was read
+     */
+    static bool load(const std::filesystem::path& path, std::vector<Key>& keys, int& width, int& height,
+                     std::string& error);
+
+    /**
+     * @brief Start writing every key read to a recording; the clock starts now
+     * @param path Recording file, replaced if it exists
+     * @param width Screen width, stored in the header
+     * @param height Screen height
+     * @param error Receives a description on failure
+     * @return true if the file could be created
+     */
+    bool startRecording(const std::filesystem::path& path, int width, int height, std::string& error);
+
+    /**
+     * @brief Measure the given keys, pressed at their offsets from start
+     */
+    void startReplay(const std::vector<Key>& keys, std::chrono::steady_clock::time_point start);
+
+    /**
+     * @brief Note a key read from the terminal (recording)
+     */
+    void keyRead(int key);
+
+    /**
+     * @brief Note that the next keys start being applied (replay)
+     */
+    void beginKeys();
+
+    /**
+     * @brief Note that keys have been applied since beginKeys() (replay)
+     * @param count Number of keys applied
+     */
+    void endKeys(size_t count);
+
+    /**
+     * @brief Note a finished frame; the keys applied since the last one are complete (replay)
+     * @param draw_start When the frame was started
+     * @param draw_end When it was drawn and flushing began
+     * @param flush_end When it had been sent
+     */
+    void frameDone(std::chrono::steady_clock::time_point draw_start,
+                   std::chrono::steady_clock::time_point draw_end,
+                   std::chrono::steady_clock::time_point flush_end);
+
+    /**
+     * @brief Write one line per replayed key and the p50, p99 and maximum of every phase
+     */
+    void writeReport(std::ostream& out) const;
+
+private:
+    struct Latency {
+        std::chrono::steady_clock::time_point pressed;
+        std::chrono::steady_clock::time_point applying;
+        std::chrono::steady_clock::time_point applied;
+        std::chrono::steady_clock::time_point draw_start;
+        std::chrono::steady_clock::time_point draw_end;
+        std::chrono::steady_clock::time_point flush_end;
+        bool done = false;
+    };
+
+    FILE* recording_;
+    std::chrono::steady_clock::time_point recording_start_;
+
+    std::vector<Key> replay_keys_;
+    std::vector<Latency> latencies_;
+    std::chrono::steady_clock::time_point applying_;
+    size_t next_key_;           // First replayed key not applied yet
+    size_t first_undrawn_;      // First applied key no frame has shown yet
+};
+
+#endif // KEYSTROKE_MONITOR_H
@@ -3,21 +3,47 @@
 #include "../ui/input.h"
 #include "../filesystem/file_operations.h"
 #include "../filesystem/image_handler.h"
+#include "../image/image_scaler.h"
 #include "../utils/utils.h"
+#include "../utils/log.h"
+#include "../utils/trace.h"
 #include "../platform/terminal_interface.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <memory>
+#include <chrono>
+#include <thread>
 
-QuickView::QuickView(bool debug_mode)
-    : terminal_(createTerminal())
+namespace {
+    double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Quiet period after the last window change before the windows are rebuilt
+    const std::chrono::milliseconds RESIZE_DEBOUNCE(50);
+
+    // How often the counters of a running search are checked
+    const std::chrono::milliseconds PROGRESS_INTERVAL(50);
+
+    // How often the progress of a file job is rewritten in the status bar
+    const std::chrono::milliseconds JOB_STATUS_INTERVAL(250);
+
+    // Check whether path is directory or lies below it, comparing names only
+    bool isBelow(const std::filesystem::path& path, const std::filesystem::path& directory) {
+        return std::mismatch(directory.begin(), directory.end(), path.begin(), path.end()).first == directory.end();
+    }
+}
+
+QuickView::QuickView(std::unique_ptr<ITerminal> terminal)
+    : terminal_(terminal ? std::move(terminal) : createTerminal())
     , status_window_(nullptr)
     , content_window_(nullptr)
     , info_window_(nullptr)
     , file_browser_window_(nullptr)
     , running(false)
-    , debug_enabled(debug_mode)
     , needs_redraw(true)
+    , frame_interval(std::chrono::microseconds(1000000 / 60))
     , screen_height(0)
     , screen_width(0)
     , status_message("Ready")
@@ -25,14 +51,53 @@ QuickView::QuickView(bool debug_mode)
     , current_directory(std::filesystem::current_path())
     , selected_file_index(0)
     , file_scroll_offset(0)
+    , directory_listed(false)
+    , directory_scanning(false)
+    , directory_generation(0)
+    , start_line(0)
+    , startup_begin(std::chrono::steady_clock::now())
     , file_view_scroll_offset(0)
+    , duplicate_generation(0)
+    , duplicate_progress_drawn(0)
+    , diff_from_compare(false)
+    , diff_generation(0)
+    , compare_generation(0)
+    , compare_progress_drawn(0)
+    , jump_selected(0)
+    , quit_pending(false)
+    , job_operation(FileJob::COPY)
+    , job_generation(0)
+    , job_stage(-1)
+    , job_stage_files(0)
+    , image_preview_cache(32)
+    , analysis_cache(256)
+    , preview_generation(0)
+    , event_loop(terminal_->getInputDescriptor())
+    , keystroke_monitor(nullptr)
+    , resize_timer(-1)
+    , progress_timer(-1)
+    , progress_timer_running(false)
 {
+    listingChanged();
 }
 
 QuickView::~QuickView() {
     shutdown();
 }
 
+void QuickView::setStartPath(const std::filesystem::path& path, int line) {
+    std::filesystem::path absolute = std::filesystem::absolute(path).lexically_normal();
+    std::error_code ec;
+    if (std::filesystem::is_directory(absolute, ec)) {
+        current_directory = absolute;
+        start_file.clear();
+    } else {
+        current_directory = absolute.parent_path();
+        start_file = absolute;
+        start_line = line;
+    }
+}
+
 bool QuickView::initialize() {
     // Initialize terminal
     if (!terminal_->initialize()) {
@@ -43,29 +108,83 @@ bool QuickView::initialize() {
     // Enable terminal optimizations
     terminal_->enableOptimizations();
 
-    // Debug output to stderr (won't interfere with terminal)
-    Utils::debugPrint(debug_enabled, "Terminal initialized successfully\n");
+    // Finished background work wakes the event loop
+    background_worker.setCompletionNotifier([this] { event_loop.wake(); });
+    resize_timer = event_loop.createTimer();
+    progress_timer = event_loop.createTimer();
+    LOG_DEBUG("Event loop %s", event_loop.isActive() ? "active" : "unavailable, polling");
+
+    // External "open with" handlers
+    ProcessLauncher::installSignalHandler();
+    std::filesystem::path handler_config = ProcessLauncher::getDefaultConfigPath();
+    if (!handler_config.empty() && launcher.loadHandlers(handler_config)) {
+        LOG_DEBUG("Loaded handlers from %s", handler_config);
+    }
+
+    // Visited directories, searched by the jump prompt
+    if (!history_path.empty() && !directory_history.open(history_path)) {
+        Log::warning("No directory history: %s", directory_history.getError());
+    }
+
+    LOG_DEBUG("Terminal initialized successfully");
 
     // Get screen dimensions
     terminal_->getScreenSize(screen_width, screen_height);
-    Utils::debugPrint(debug_enabled, "Screen dimensions: %dx%d\n", screen_width, screen_height);
+    LOG_DEBUG("Screen dimensions: %dx%d", screen_width, screen_height);
 
     // Setup windows
     setupWindows();
 
-    // Load initial directory
-    loadDirectory(current_directory);
-
     running = true;
 
-    // Start with help screen displayed
-    current_display_mode = DisplayMode::HELP;
-    setStatusMessage("Help screen - Press any key to start browsing files");
+    // A file given on the command line opens without reading its directory
+    if (!start_file.empty() && !ImageHandler::isImageFile(start_file) && openFileView(start_file)) {
+        if (current_display_mode == DisplayMode::FILE_VIEW && start_line > 1) {
+            int last = std::max(0, (int)file_content_lines.size() - getContentPageSize());
+            file_view_scroll_offset = std::min(start_line - 1, last);
+        }
+        LOG_DEBUG("Initialization complete, entering main loop");
+        return true;
+    }
+
+    // The listing is read while the first frame is drawn
+    bool browse = !start_file.empty();
+    scanDirectory(current_directory, start_file);
+    start_file.clear();
 
-    Utils::debugPrint(debug_enabled, "Initialization complete, entering main loop\n");
+    if (browse) {
+        // A file the viewer does not take is selected in its directory instead
+        current_display_mode = DisplayMode::NORMAL;
+    } else {
+        // Start with help screen displayed
+        current_display_mode = DisplayMode::HELP;
+        setStatusMessage("Help screen - Press any key to start browsing files");
+    }
+
+    LOG_DEBUG("Initialization complete, entering main loop");
     return true;
 }
 
+void QuickView::waitForDirectory() {
+    while (directory_scanning) {
+        if (!background_worker.drainCompletions()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    needs_redraw = true;
+}
+
+void QuickView::setDisplayMode(DisplayMode mode) {
+    current_display_mode = mode;
+
+    // Leaving a file opened at startup lists its directory with the file selected
+    bool viewing = mode == DisplayMode::FILE_VIEW || mode == DisplayMode::JSON_VIEW;
+    if (!viewing && !directory_listed && !directory_scanning) {
+        scanDirectory(current_directory, start_file);
+        start_file.clear();
+    }
+}
+
 void QuickView::run() {
     if (!running) {
         std::cerr << "Error: Application not initialized" << std::endl;
@@ -73,25 +192,124 @@ void QuickView::run() {
     }
 
     // Main application loop
-    Utils::debugPrint(debug_enabled, "Entering main loop, running = %s\n", running ? "true" : "false");
+    LOG_DEBUG("Entering main loop");
     
     // Initial draw
+    requestPreview();
     drawInterface();
     updateDisplay();
+    Log::info("First frame %.1f ms after startup", millisecondsSince(startup_begin));
     
+    auto next_frame = std::chrono::steady_clock::now() + frame_interval;
+    bool input_pending = false;
     while (running) {
-        Utils::debugPrint(debug_enabled, "Loop iteration starting...\n");
-        Input::handleInput(this);
-        
-        // Only redraw if something changed
+        LOG_TRACE("Loop iteration starting...");
+
+        // Sleep until something happens; with a redraw pending, wait no longer than the start of the next frame
+        int timeout = -1;
         if (needs_redraw) {
+            auto wait = std::chrono::ceil<std::chrono::milliseconds>(next_frame - std::chrono::steady_clock::now());
+            timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(0, wait.count()));
+        }
+        if (event_loop.isActive()) {
+            input_pending = processEvents(input_pending ? 0 : timeout, input_pending);
+        } else {
+            pollTerminal(timeout);
+        }
+
+
+        // Only redraw if something changed, and no more often than the frame rate allows
+        auto now = std::chrono::steady_clock::now();
+        if (needs_redraw && running && now >= next_frame) {
+            requestPreview();
             drawInterface();
+            auto drawn = std::chrono::steady_clock::now();
             updateDisplay();
+            if (keystroke_monitor) {
+                keystroke_monitor->frameDone(now, drawn, std::chrono::steady_clock::now());
+            }
             needs_redraw = false;
+            next_frame = now + frame_interval;
+        }
+        LOG_TRACE("Loop iteration complete");
+    }
+    LOG_DEBUG("Exited main loop");
+}
+
+bool QuickView::processEvents(int timeout_ms, bool input_pending) {
+    unsigned events = event_loop.wait(timeout_ms, expired_timers);
+
+    bool more_input = false;
+    if ((events & EventLoop::INPUT) || input_pending) {
+        terminal_->setInputTimeout(0);
+        more_input = Input::handleInput(this);
+    }
+    if (events & EventLoop::RESIZE) {
+        // Rebuilding the windows is costly, so a drag-resize only rebuilds them once it pauses
+        event_loop.startTimer(resize_timer, RESIZE_DEBOUNCE);
+    }
+    if (events & EventLoop::CHILD) {
+        ProcessLauncher::notifyChildExited();
+        reapHandlers();
+    }
+    if ((events & EventLoop::WAKE) && background_worker.drainCompletions()) {
+        needs_redraw = true;
+    }
+    for (int timer : expired_timers) {
+        if (timer == resize_timer) {
+            terminal_->updateScreenSize();
+            resizeHandler();
+        } else if (timer == progress_timer) {
+            pollDuplicateProgress();
+            pollCompareProgress();
+            pollJobProgress();
         }
-        Utils::debugPrint(debug_enabled, "Loop iteration complete\n");
     }
-    Utils::debugPrint(debug_enabled, "Exited main loop\n");
+
+    // The progress timer only runs while there is a search or a file job to watch
+    bool searching = duplicate_progress || compare_progress || job_progress;
+    if (searching != progress_timer_running) {
+        if (searching) {
+            event_loop.startTimer(progress_timer, PROGRESS_INTERVAL, PROGRESS_INTERVAL);
+        } else {
+            event_loop.stopTimer(progress_timer);
+        }
+        progress_timer_running = searching;
+    }
+    return more_input;
+}
+
+void QuickView::pollTerminal(int timeout_ms) {
+    // Without an event loop nothing wakes getKey() when work finishes, so poll
+    // while background results are outstanding
+    if (timeout_ms < 0 && background_worker.hasPendingWork()) {
+        timeout_ms = 20;
+    }
+    terminal_->setInputTimeout(timeout_ms);
+    Input::handleInput(this);
+
+    // Apply finished background work
+    if (background_worker.drainCompletions()) {
+        needs_redraw = true;
+    }
+    reapHandlers();
+    pollDuplicateProgress();
+    pollCompareProgress();
+    pollJobProgress();
+}
+
+void QuickView::writeTrace() {
+    std::string error;
+    if (Trace::write(error)) {
+        setStatusMessage("Trace written to " + Trace::getOutputPath());
+    } else {
+        setStatusError(error);
+    }
+}
+
+void QuickView::setFrameRate(int fps) {
+    frame_interval = fps > 0 ? std::chrono::steady_clock::duration(std::chrono::seconds(1)) / fps
+                             : std::chrono::steady_clock::duration::zero();
 }
 
 void QuickView::setupWindows() {
@@ -99,13 +317,14 @@ void QuickView::setupWindows() {
     terminal_->clearScreen();
     terminal_->refreshScreen();
 
-    Utils::debugPrint(debug_enabled, "Setting up windows...\n");
+    LOG_DEBUG("Setting up windows...");
 
     // Calculate window dimensions
     int file_browser_width = screen_width / 4;  // 25% of screen width
     int right_side_width = screen_width - file_browser_width;  // 75% of screen width
     int available_height = screen_height - 1;  // Exclude status bar
-    int info_window_height = (available_height * 10) / 100;  // 10% of available height
+    int info_window_height = std::max((available_height * 10) / 100, 9);  // 10% of available height, room for the analysis
+    info_window_height = std::min(info_window_height, available_height / 2);
     int content_window_height = available_height - info_window_height;  // 90% of available height
 
     // Create status window (bottom line)
@@ -120,15 +339,17 @@ void QuickView::setupWindows() {
     // Create info window (right side bottom, 75% width, 10% height)
     info_window_ = terminal_->createWindow(info_window_height, right_side_width, content_window_height, file_browser_width);
 
-    Utils::debugPrint(debug_enabled, "Windows created successfully\n");
+    LOG_DEBUG("Windows created successfully");
 }
 
 void QuickView::drawInterface() {
-    Utils::debugPrint(debug_enabled, "Drawing interface...\n");
+    Trace::Span span("QuickView::drawInterface");
+    LOG_TRACE("Drawing interface...");
 
     // Draw file browser
-    Display::drawFileBrowser(getTerminal(), getFileBrowserWindow(), getDirectoryEntries(), getSelectedFileIndex(),
-                            getFileScrollOffset(), getCurrentDirectory());
+    Display::drawFileBrowser(getTerminal(), getFileBrowserWindow(), getDirectoryEntries(), entry_labels,
+                            browser_tree, getSelectedFileIndex(), getFileScrollOffset(), getMarkedPath(),
+                            getSelection());
 
     // Draw content based on display mode
     switch (current_display_mode) {
@@ -144,27 +365,52 @@ void QuickView::drawInterface() {
                                        getDirectoryEntries().empty() ? "" :
                                        getDirectoryEntries()[getSelectedFileIndex()].path().filename().string());
             break;
+        case DisplayMode::JSON_VIEW:
+            Display::drawJsonViewContent(getTerminal(), getContentWindow(), getJsonTree());
+            break;
+        case DisplayMode::DIFF_VIEW:
+            if (getDiffView()) {
+                Display::drawDiffViewContent(getTerminal(), getContentWindow(), *getDiffView());
+            }
+            break;
+        case DisplayMode::COMPARE_VIEW:
+            Display::drawCompareViewContent(getTerminal(), getContentWindow(), getCompareView(),
+                                            getCompareProgress());
+            break;
+        case DisplayMode::DUPLICATE_VIEW:
+            Display::drawDuplicateViewContent(getTerminal(), getContentWindow(), getDuplicateView(),
+                                              getDuplicateProgress());
+            break;
+        case DisplayMode::JUMP_VIEW:
+            Display::drawJumpViewContent(getTerminal(), getContentWindow(), getJumpQuery(), getJumpMatches(),
+                                         getJumpSelected(), directory_history.isOpen());
+            break;
         case DisplayMode::NORMAL:
         default:
-            Display::drawNormalContent(getTerminal(), getContentWindow(), getDirectoryEntries(), getSelectedFileIndex());
+            Display::drawNormalContent(getTerminal(), getContentWindow(), getDirectoryEntries(), entry_labels,
+                                       getSelectedFileIndex(), getCurrentPreview(), getCurrentImagePreview());
             break;
     }
 
     // Draw info window
-    Display::drawInfoWindow(getTerminal(), getInfoWindow(), getDirectoryEntries(), getSelectedFileIndex());
+    Display::drawInfoWindow(getTerminal(), getInfoWindow(), getDirectoryEntries(), entry_labels,
+                            getSelectedFileIndex(), getCurrentAnalysis());
 
     // Draw status bar
-    Display::drawStatusBar(getTerminal(), getStatusWindow(), getDirectoryEntries(), getSelectedFileIndex(),
-                          getCurrentDirectory(), getStatusMessage(), getScreenWidth());
+    Display::drawStatusBar(getTerminal(), getStatusWindow(), getDirectoryEntries(), entry_labels,
+                          getSelectedFileIndex(), getStatusMessage(), getStatusError(), getJobStatus(),
+                          getScreenWidth());
 
-    Utils::debugPrint(debug_enabled, "Interface drawn\n");
+    LOG_TRACE("Interface drawn");
 }
 
 void QuickView::updateDisplay() {
+    Trace::Span span("QuickView::updateDisplay");
     terminal_->refreshWindow(getFileBrowserWindow());
     terminal_->refreshWindow(getContentWindow());
     terminal_->refreshWindow(getInfoWindow());
     terminal_->refreshWindow(getStatusWindow());
+    terminal_->updateScreen();
 }
 
 void QuickView::setStatusMessage(const std::string& message) {
@@ -172,25 +418,113 @@ void QuickView::setStatusMessage(const std::string& message) {
     needs_redraw = true;
 }
 
+void QuickView::setStatusError(const std::string& message) {
+    status_error = message;
+    needs_redraw = true;
+}
+
+void QuickView::clearStatusError() {
+    if (!status_error.empty()) {
+        status_error.clear();
+        needs_redraw = true;
+    }
+}
+
 void QuickView::loadDirectory(const std::filesystem::path& path) {
+    Trace::Span span("QuickView::loadDirectory");
     // Show immediate feedback
     setStatusMessage("Loading directory...");
     needs_redraw = true;
     drawInterface();
     updateDisplay();
     
-    std::string result = FileOperations::loadDirectory(path, directory_entries, debug_enabled);
+    std::string result = FileOperations::loadDirectory(path, directory_entries);
     
+    // A scan still running in the background is now stale
+    directory_generation++;
+    directory_scanning = false;
+    directory_listed = true;
     current_directory = path;
+    listingChanged();
     selected_file_index = 0;
     file_scroll_offset = 0;
     needs_redraw = true;
+    directory_history.visit(current_directory);
     
     // Update status with result
     setStatusMessage(result);
 }
 
+void QuickView::scanDirectory(const std::filesystem::path& path, const std::filesystem::path& select) {
+    // Reading the same directory again, after a file job for instance, keeps the directories expanded
+    std::vector<std::filesystem::path> expanded;
+    if (path == current_directory && directory_listed) {
+        for (size_t i = 0; i < directory_entries.size(); i++) {
+            if (browser_tree.getRow(i).state != BrowserTree::State::COLLAPSED) {
+                expanded.push_back(directory_entries[i].path());
+            }
+        }
+    }
+
+    uint64_t generation = ++directory_generation;
+    directory_scanning = true;
+    directory_listed = false;
+    current_directory = path;
+    directory_entries.clear();
+    listingChanged();
+    selected_file_index = 0;
+    file_scroll_offset = 0;
+    needs_redraw = true;
+
+    auto requested = std::chrono::steady_clock::now();
+    background_worker.submit([this, path, select, generation, requested, expanded]() -> BackgroundWorker::Completion {
+        Trace::Span span("QuickView::scanDirectory");
+        auto entries = std::make_shared<std::vector<std::filesystem::directory_entry>>();
+        std::string result = FileOperations::loadDirectory(path, *entries);
+
+        return [this, generation, entries, result, select, requested, expanded]() {
+            if (generation != directory_generation) return;
+
+            directory_entries = std::move(*entries);
+            listingChanged();
+            directory_scanning = false;
+            directory_listed = true;
+            directory_history.visit(current_directory);
+            if (!select.empty()) selectEntry(select.filename());
+
+            // Entries inside expanded directories are selected once their directory is open again
+            reexpand_paths = expanded;
+            if (!expanded.empty() && select.parent_path() != current_directory) reselect_path = select;
+            reexpandRows(0, directory_entries.size());
+            needs_redraw = true;
+
+            // The help screen keeps its own status line until it is dismissed
+            if (current_display_mode == DisplayMode::NORMAL) setStatusMessage(result);
+            LOG_DEBUG("Listed %s: %zu entries in %.1f ms", current_directory, directory_entries.size(),
+                      millisecondsSince(requested));
+        };
+    });
+}
+
 void QuickView::shutdown() {
+    // A file job cut short leaves its destination partly written; record what was left behind
+    if (running_job) {
+        const char* verb = running_job->operation == FileJob::COPY ? "copying"
+                         : running_job->operation == FileJob::MOVE ? "moving" : "removing";
+        Log::warning("Quit while %s %zu entries into %s; the job was cancelled unfinished", verb,
+                     running_job->sources.size(), running_job->destination);
+        for (const auto& source : running_job->sources) {
+            Log::warning("Left unfinished: %s", source);
+        }
+    }
+    if (!queued_jobs.empty()) Log::warning("Quit with %zu file jobs queued and never started", queued_jobs.size());
+
+    // Stop background work before tearing down the state it reports into
+    duplicate_generation++;
+    compare_generation++;
+    job_generation++;
+    background_worker.stop();
+
     // Clean up windows
     if (status_window_) {
         terminal_->destroyWindow(status_window_);
@@ -221,11 +555,11 @@ void QuickView::shutdown() {
 }
 
 // Navigation methods
-void QuickView::navigateUp() {
+void QuickView::navigateUp(int count) {
     if (directory_entries.empty()) return;
 
     if (selected_file_index > 0) {
-        selected_file_index--;
+        selected_file_index = std::max(0, selected_file_index - count);
 
         // Adjust scroll offset if needed
         if (selected_file_index < file_scroll_offset) {
@@ -235,11 +569,12 @@ void QuickView::navigateUp() {
     }
 }
 
-void QuickView::navigateDown() {
+void QuickView::navigateDown(int count) {
     if (directory_entries.empty()) return;
 
-    if (selected_file_index < directory_entries.size() - 1) {
-        selected_file_index++;
+    int last = static_cast<int>(directory_entries.size()) - 1;
+    if (selected_file_index < last) {
+        selected_file_index = std::min(last, selected_file_index + count);
 
         // Adjust scroll offset if needed
         int max_y, max_x;
@@ -253,7 +588,7 @@ void QuickView::navigateDown() {
     }
 }
 
-void QuickView::navigatePageUp() {
+void QuickView::navigatePageUp(int pages) {
     if (directory_entries.empty()) return;
 
     // Get window dimensions to calculate page size
@@ -262,7 +597,7 @@ void QuickView::navigatePageUp() {
     int page_size = max_y - 4;  // Account for borders and header
 
     // Move selection up by page size
-    selected_file_index -= page_size;
+    selected_file_index -= page_size * pages;
     if (selected_file_index < 0) {
         selected_file_index = 0;
     }
@@ -277,7 +612,7 @@ void QuickView::navigatePageUp() {
     setStatusMessage("Page up in file list");
 }
 
-void QuickView::navigatePageDown() {
+void QuickView::navigatePageDown(int pages) {
     if (directory_entries.empty()) return;
 
     // Get window dimensions to calculate page size
@@ -286,7 +621,7 @@ void QuickView::navigatePageDown() {
     int page_size = max_y - 4;  // Account for borders and header
 
     // Move selection down by page size
-    selected_file_index += page_size;
+    selected_file_index += page_size * pages;
     if (selected_file_index >= directory_entries.size()) {
         selected_file_index = directory_entries.size() - 1;
     }
@@ -367,7 +702,141 @@ void QuickView::enterDirectory() {
     // For files, the status bar will automatically show the file info
 }
 
+void QuickView::expandSelected() {
+    if (directory_entries.empty() || selected_file_index >= (int)directory_entries.size()) return;
+
+    const BrowserTree::Row& row = browser_tree.getRow(selected_file_index);
+    if (row.state == BrowserTree::State::EXPANDED) {
+        // Already open: step onto its first child
+        if (row.descendants > 0) navigateDown();
+        return;
+    }
+    if (row.state == BrowserTree::State::LOADING) return;
+
+    expandRow(selected_file_index, true);
+}
+
+void QuickView::expandRow(int index, bool announce) {
+    const auto& entry = directory_entries[index];
+    std::error_code ec;
+    if (!entry.is_directory(ec) || ec || entry.path().filename() == "..") return;
+
+    // The children are read in the background and inserted when they arrive
+    uint32_t id = browser_tree.getRow(index).id;
+    std::filesystem::path path = entry.path();
+    browser_tree.setLoading(index);
+    if (announce) setStatusMessage("Expanding " + path.filename().string() + "...");
+    background_worker.submit([this, id, path, announce]() -> BackgroundWorker::Completion {
+        Trace::Span span("QuickView::expandSelected");
+        auto children = std::make_shared<std::vector<std::filesystem::directory_entry>>();
+        FileOperations::loadDirectory(path, *children);
+        children->erase(std::remove_if(children->begin(), children->end(),
+                                       [](const std::filesystem::directory_entry& child) {
+                                           return child.path().filename() == "..";
+                                       }),
+                        children->end());
+        return [this, id, children, announce]() { insertChildren(id, *children, announce); };
+    });
+}
+
+void QuickView::insertChildren(uint32_t id, std::vector<std::filesystem::directory_entry>& children, bool announce) {
+    // The listing may have been replaced, or the directory collapsed, while its children were read
+    int index = browser_tree.findRow(id);
+    if (index < 0 || browser_tree.getRow(index).state != BrowserTree::State::LOADING) return;
+
+    size_t count = children.size();
+    directory_entries.insert(directory_entries.begin() + index + 1,
+                             std::make_move_iterator(children.begin()), std::make_move_iterator(children.end()));
+    entry_labels.insert(index + 1, count);
+    browser_tree.insertChildren(index, count);
+    type_ahead.reset(directory_entries);
+
+    // Rows below the directory moved down; keep the same ones selected and on screen
+    if (selected_file_index > index) selected_file_index += static_cast<int>(count);
+    if (file_scroll_offset > index) file_scroll_offset += static_cast<int>(count);
+    reexpandRows(index + 1, index + 1 + count);
+
+    int max_y, max_x;
+    terminal_->getWindowSize(file_browser_window_, max_x, max_y);
+    int display_height = max_y - 4;  // Account for borders and header
+    if (selected_file_index >= file_scroll_offset + display_height) {
+        file_scroll_offset = selected_file_index - display_height + 1;
+    }
+    needs_redraw = true;
+    if (!announce) return;
+
+    std::string name = directory_entries[index].path().filename().string();
+    setStatusMessage(count == 0 ? name + " is empty" : name + ": " + std::to_string(count) + " entries");
+}
+
+void QuickView::reexpandRows(size_t begin, size_t end) {
+    for (size_t i = begin; i < end && (!reexpand_paths.empty() || !reselect_path.empty()); i++) {
+        const std::filesystem::path& path = directory_entries[i].path();
+        if (path == reselect_path) {
+            selected_file_index = static_cast<int>(i);
+            reselect_path.clear();
+        }
+        auto found = std::find(reexpand_paths.begin(), reexpand_paths.end(), path);
+        if (found == reexpand_paths.end()) continue;
+        reexpand_paths.erase(found);
+        expandRow(static_cast<int>(i), false);
+    }
+}
+
+void QuickView::collapseSelected() {
+    if (directory_entries.empty() || selected_file_index >= (int)directory_entries.size()) return;
+
+    int index = selected_file_index;
+    if (browser_tree.getRow(index).state == BrowserTree::State::COLLAPSED) {
+        // Step onto the directory it is listed in
+        int parent = browser_tree.findParent(index);
+        if (parent < 0) return;
+        selected_file_index = parent;
+        if (parent < file_scroll_offset) file_scroll_offset = parent;
+        needs_redraw = true;
+        return;
+    }
+
+    // A directory still loading just stops waiting; its children are dropped when they arrive
+    size_t count = browser_tree.collapse(index);
+    directory_entries.erase(directory_entries.begin() + index + 1, directory_entries.begin() + index + 1 + count);
+    entry_labels.erase(index + 1, count);
+    type_ahead.reset(directory_entries);
+
+    if (file_scroll_offset > index) {
+        file_scroll_offset = std::max(index, file_scroll_offset - static_cast<int>(count));
+    }
+    needs_redraw = true;
+}
+
+void QuickView::typeAhead(char c) {
+    if (directory_entries.empty()) return;
+
+    std::string typed = type_ahead.getPrefix() + c;
+    int index = type_ahead.type(c, std::chrono::steady_clock::now());
+    if (index < 0) {
+        setStatusMessage("No name starts with \"" + typed + "\"");
+        return;
+    }
+    selected_file_index = index;
+
+    // Center the entry when it is off screen
+    int max_y, max_x;
+    terminal_->getWindowSize(file_browser_window_, max_x, max_y);
+    int display_height = std::max(1, max_y - 4);
+    if (selected_file_index < file_scroll_offset || selected_file_index >= file_scroll_offset + display_height) {
+        file_scroll_offset = std::max(0, selected_file_index - display_height / 2);
+    }
+    needs_redraw = true;
+    setStatusMessage("Jump to: " + type_ahead.getPrefix());
+}
+
+bool QuickView::isTypingAhead() const {
+    return type_ahead.isActive(std::chrono::steady_clock::now());
+}
+
 void QuickView::viewFile() {
+    Trace::Span span("QuickView::viewFile");
     if (directory_entries.empty() || selected_file_index >= directory_entries.size()) {
         setStatusMessage("No file selected");
         return;
@@ -382,20 +851,35 @@ void QuickView::viewFile() {
         return;
     }
 
-    // Check if it's an image file
+    // Images the built-in decoders handle are already shown in the content pane
+    if (ImageHandler::canPreview(selected_entry.path())) {
+        if (!current_image_preview) {
+            setStatusMessage("Image preview is still loading");
+        } else if (!current_image_preview->error.empty()) {
+            setStatusMessage("Cannot decode image: " + current_image_preview->error);
+        } else {
+            setStatusMessage(current_image_preview->format + " image, " +
+                             std::to_string(current_image_preview->source_width) + "x" +
+                             std::to_string(current_image_preview->source_height) + " pixels");
+        }
+        return;
+    }
+
+    // Other images open in an external viewer while browsing continues
     if (ImageHandler::isImageFile(selected_entry.path())) {
-        // Launch default image viewer and continue browsing
-        ImageHandler::launchImageViewer(selected_entry.path(), debug_enabled);
-        setStatusMessage("Image opened in default viewer");
+        launchHandler(selected_entry.path());
+        return;
+    }
 
-        // Force a complete screen refresh to prevent display corruption from external command
-        terminal_->forceCompleteRedraw();
-        setupWindows();
+    openFileView(selected_entry.path());
+}
 
-        // Redraw the entire interface after refresh
-        drawInterface();
-        updateDisplay();
-        return;
+bool QuickView::openFileView(const std::filesystem::path& path) {
+    // JSON documents open in the tree view, which handles files of any size
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".json") {
+        return openJsonView(path);
     }
 
     // Clear previous content
@@ -403,19 +887,19 @@ void QuickView::viewFile() {
     file_view_scroll_offset = 0;
 
     try {
-        std::ifstream file(selected_entry.path());
+        std::ifstream file(path);
         if (!file.is_open()) {
             setStatusMessage("Error: Cannot open file");
-            return;
+            return false;
         }
 
         // Check file size to avoid loading huge files
-        auto file_size = std::filesystem::file_size(selected_entry.path());
+        auto file_size = std::filesystem::file_size(path);
         const size_t MAX_FILE_SIZE = 10 * 1024 * 1024;  // 10MB limit
 
         if (file_size > MAX_FILE_SIZE) {
             setStatusMessage("Error: File too large to view (>10MB)");
-            return;
+            return false;
         }
 
         // Read file line by line
@@ -425,17 +909,7 @@ void QuickView::viewFile() {
 
         while (std::getline(file, line) && line_count < MAX_LINES) {
             // Replace tabs with spaces for better display
-            std::string display_line;
-            for (char c : line) {
-                if (c == '\t') {
-                    display_line += "    ";  // 4 spaces for tab
-                } else if (c >= 32 || c == '\n') {  // Printable characters
-                    display_line += c;
-                } else {
-                    display_line += '.';  // Replace non-printable with dot
-                }
-            }
-            file_content_lines.push_back(display_line);
+            file_content_lines.push_back(FileOperations::toDisplayLine(line.data(), line.size()));
             line_count++;
         }
 
@@ -449,14 +923,269 @@ void QuickView::viewFile() {
         current_display_mode = DisplayMode::FILE_VIEW;
         needs_redraw = true;
         setStatusMessage("File view - Press any key to return");
+        return true;
 
     } catch (const std::exception& e) {
         setStatusMessage("Error reading file: " + std::string(e.what()));
-        Utils::debugPrint(debug_enabled, "Error reading file %s: %s\n", selected_entry.path().string().c_str(), e.what());
+        Log::warning("Error reading file %s: %s", path, e.what());
+        return false;
     }
 }
 
+bool QuickView::openJsonView(const std::filesystem::path& path) {
+    // Show immediate feedback while the structural index is built
+    setStatusMessage("Indexing JSON...");
+    drawInterface();
+    updateDisplay();
+
+    if (!json_tree.open(path)) {
+        Log::warning("JSON view failed for %s: %s", path, json_tree.getError());
+        setStatusMessage("Error: " + json_tree.getError());
+        return false;
+    }
+
+    LOG_DEBUG("Indexed %s: %zu containers", path, json_tree.getContainerCount());
+
+    current_display_mode = DisplayMode::JSON_VIEW;
+    needs_redraw = true;
+    setStatusMessage("JSON view - " + std::to_string(json_tree.getContainerCount()) + " containers indexed");
+    return true;
+}
+
+void QuickView::openWithHandler() {
+    if (directory_entries.empty() || selected_file_index >= (int)directory_entries.size()) {
+        return;
+    }
+
+    const auto& selected_entry = directory_entries[selected_file_index];
+    std::error_code ec;
+    if (!selected_entry.is_regular_file(ec) || ec) {
+        setStatusError("Cannot open: not a regular file");
+        return;
+    }
+    launchHandler(selected_entry.path());
+}
+
+void QuickView::launchHandler(const std::filesystem::path& path) {
+    std::string error;
+    if (launcher.open(path, error)) {
+        LOG_DEBUG("Started handler for %s", path);
+        setStatusMessage("Opened " + path.filename().string());
+    } else {
+        Log::warning("Handler failed: %s", error);
+        setStatusError(error);
+    }
+}
+
+void QuickView::reapHandlers() {
+    std::vector<std::string> failures;
+    if (launcher.reapChildren(failures) && !failures.empty()) {
+        setStatusError(failures.back());
+    }
+}
+
+void QuickView::requestPreview() {
+    if (directory_entries.empty() || selected_file_index >= (int)directory_entries.size()) {
+        preview_path.clear();
+        current_preview.reset();
+        current_image_preview.reset();
+        current_analysis.reset();
+        return;
+    }
+
+    const auto& selected_entry = directory_entries[selected_file_index];
+    if (selected_entry.path() == preview_path) {
+        return;  // Already loaded or in flight
+    }
+
+    // A new generation makes every older request stale
+    preview_path = selected_entry.path();
+    current_preview.reset();
+    current_image_preview.reset();
+    current_analysis.reset();
+    uint64_t generation = ++preview_generation;
+
+    std::error_code ec;
+    if (!selected_entry.is_regular_file(ec) || ec) {
+        return;
+    }
+
+    // The preview is queued first so it shows before a long analysis finishes
+    std::filesystem::path path = preview_path;
+    if (ImageHandler::canPreview(path)) {
+        requestImagePreview(path, generation);
+        requestAnalysis(path, generation);
+        return;
+    }
+
+    background_worker.submit([this, path, generation]() -> BackgroundWorker::Completion {
+        // Skip requests the cursor has already moved past
+        if (generation != preview_generation.load()) return nullptr;
+
+        std::shared_ptr<const TextPreview> result;
+        FileKey key;
+        if (!FileKey::fromPath(path, key)) {
+            auto failed = std::make_shared<TextPreview>();
+            failed->error = "Cannot access file";
+            result = failed;
+        } else if (!(result = preview_cache.find(key))) {
+            if (generation != preview_generation.load()) return nullptr;
+
+            auto loaded = std::make_shared<TextPreview>();
+            if (FileOperations::loadTextPreview(path, *loaded)) {
+                preview_cache.insert(key, loaded);
+            }
+            result = loaded;
+        }
+
+        return [this, generation, result]() {
+            if (generation == preview_generation.load()) {
+                current_preview = result;
+                needs_redraw = true;
+            }
+        };
+    });
+    requestAnalysis(path, generation);
+}
+
+void QuickView::requestImagePreview(const std::filesystem::path& path, uint64_t generation) {
+    // Fit inside the content pane below the title; each cell shows two pixel rows
+    int max_y, max_x;
+    terminal_->getWindowSize(content_window_, max_x, max_y);
+    int box_width = std::max(1, max_x - 4);
+    int box_height = std::max(1, max_y - 4) * 2;
+
+    background_worker.submit([this, path, generation, box_width, box_height]() -> BackgroundWorker::Completion {
+        if (generation != preview_generation.load()) return nullptr;
+
+        std::shared_ptr<const ImagePreview> result;
+        FileKey key;
+        if (!FileKey::fromPath(path, key)) {
+            auto failed = std::make_shared<ImagePreview>();
+            failed->error = "Cannot access file";
+            result = failed;
+        } else {
+            // A cached image scaled for a different pane size counts as a miss
+            result = image_preview_cache.find(key);
+            if (result && result->error.empty()) {
+                int width, height;
+                ImageScaler::fitWithin(result->source_width, result->source_height,
+                                       box_width, box_height, width, height);
+                if (width != result->width || height != result->height) result = nullptr;
+            }
+
+            if (!result) {
+                if (generation != preview_generation.load()) return nullptr;
+
+                auto loaded = std::make_shared<ImagePreview>();
+                if (ImageHandler::loadImagePreview(path, box_width, box_height, *loaded)) {
+                    image_preview_cache.insert(key, loaded);
+                }
+                result = loaded;
+            }
+        }
+
+        return [this, generation, result]() {
+            if (generation == preview_generation.load()) {
+                current_image_preview = result;
+                needs_redraw = true;
+            }
+        };
+    });
+}
+
+void QuickView::requestAnalysis(const std::filesystem::path& path, uint64_t generation) {
+    background_worker.submit([this, path, generation]() -> BackgroundWorker::Completion {
+        if (generation != preview_generation.load()) return nullptr;
+
+        std::shared_ptr<const FileAnalysis> result;
+        FileKey key;
+        if (!FileKey::fromPath(path, key)) {
+            auto failed = std::make_shared<FileAnalysis>();
+            failed->error = "Cannot access file";
+            result = failed;
+        } else if (!(result = analysis_cache.find(key))) {
+            // Reading stops as soon as the selection moves on
+            auto analysis = std::make_shared<FileAnalysis>();
+            bool complete = FileAnalyzer::analyze(path, *analysis, [this, generation]() {
+                return generation != preview_generation.load();
+            });
+            if (generation != preview_generation.load()) return nullptr;
+
+            if (complete) {
+                analysis_cache.insert(key, analysis);
+            }
+            result = analysis;
+        }
+
+        return [this, generation, result]() {
+            if (generation == preview_generation.load()) {
+                current_analysis = result;
+                needs_redraw = true;
+            }
+        };
+    });
+}
+
+void QuickView::computeSelectedSha256() {
+    if (!current_analysis) {
+        setStatusMessage("Analysis still running");
+        return;
+    }
+    if (!current_analysis->error.empty()) {
+        setStatusError("Cannot hash: " + current_analysis->error);
+        return;
+    }
+    if (!current_analysis->sha256.empty()) {
+        return;
+    }
+
+    std::filesystem::path path = preview_path;
+    uint64_t generation = preview_generation.load();
+    std::shared_ptr<const FileAnalysis> analysis = current_analysis;
+    setStatusMessage("Computing SHA-256 of " + path.filename().string());
+
+    background_worker.submit([this, path, generation, analysis]() -> BackgroundWorker::Completion {
+        FileKey before;
+        bool have_key = FileKey::fromPath(path, before);
+
+        std::string digest;
+        std::string error;
+        bool complete = FileAnalyzer::computeSha256(path, digest, error, [this, generation]() {
+            return generation != preview_generation.load();
+        });
+        if (generation != preview_generation.load()) return nullptr;
+
+        if (!complete) {
+            return [this, error]() { setStatusError("SHA-256 failed: " + error); };
+        }
+
+        // Cache the digest with the rest of the analysis, unless the file changed meanwhile
+        auto updated = std::make_shared<FileAnalysis>(*analysis);
+        updated->sha256 = digest;
+        FileKey after;
+        if (have_key && FileKey::fromPath(path, after) && after == before && after.size == updated->size) {
+            analysis_cache.insert(after, updated);
+        }
+
+        return [this, generation, updated]() {
+            if (generation == preview_generation.load()) {
+                current_analysis = updated;
+                setStatusMessage("SHA-256 computed");
+            }
+        };
+    });
+}
+
+int QuickView::getContentPageSize() {
+    int max_y, max_x;
+    terminal_->getWindowSize(content_window_, max_x, max_y);
+    int page_size = max_y - 5;  // Account for borders, title, and bottom margin
+    return page_size > 0 ? page_size : 1;
+}
+
 void QuickView::resizeHandler() {
+    Trace::Span span("QuickView::resizeHandler");
     // Handle terminal resize
     terminal_->getScreenSize(screen_width, screen_height);
 
@@ -470,6 +1199,9 @@ void QuickView::resizeHandler() {
     setupWindows();
     needs_redraw = true;
 
+    // Image previews are scaled to the pane, so reload for the new size
+    preview_path.clear();
+
     setStatusMessage("Terminal resized");
 }
 
@@ -553,3 +1285,694 @@ void QuickView::scrollFileViewEnd() {
     needs_redraw = true;
     setStatusMessage("End of file");
 }
+
+
+// JSON tree view methods
+void QuickView::jsonViewMove(int delta) {
+    json_tree.moveSelection(delta, getContentPageSize());
+    needs_redraw = true;
+}
+
+void QuickView::jsonViewPageUp() {
+    jsonViewMove(-getContentPageSize());
+}
+
+void QuickView::jsonViewPageDown() {
+    jsonViewMove(getContentPageSize());
+}
+
+void QuickView::jsonViewHome() {
+    json_tree.selectFirst();
+    needs_redraw = true;
+    setStatusMessage("Top of document");
+}
+
+void QuickView::jsonViewEnd() {
+    json_tree.selectLast(getContentPageSize());
+    needs_redraw = true;
+    setStatusMessage("End of visible rows");
+}
+
+void QuickView::jsonViewExpand() {
+    if (json_tree.expandSelected()) {
+        needs_redraw = true;
+        setStatusMessage(std::to_string(json_tree.getRowCount()) + " rows visible");
+    }
+}
+
+void QuickView::jsonViewCollapse() {
+    json_tree.collapseSelected(getContentPageSize());
+    needs_redraw = true;
+}
+
+void QuickView::findDuplicates() {
+    std::filesystem::path root = current_directory;
+    uint64_t generation = ++duplicate_generation;
+    auto progress = std::make_shared<DuplicateProgress>();
+    duplicate_progress = progress;
+    duplicate_view.setGroups(root, {});
+    current_display_mode = DisplayMode::DUPLICATE_VIEW;
+    needs_redraw = true;
+    setStatusMessage("Searching for duplicates in " + root.string());
+
+    background_worker.submit([this, root, generation, progress]() -> BackgroundWorker::Completion {
+        auto started = std::chrono::steady_clock::now();
+        auto groups = std::make_shared<std::vector<DuplicateGroup>>();
+        bool complete = DuplicateFinder::find(root, *groups, *progress, [this, generation]() {
+            return generation != duplicate_generation.load();
+        });
+        if (!complete) return nullptr;
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        uint64_t files = progress->files_found.load();
+        uint64_t bytes = progress->bytes_hashed.load();
+
+        return [this, root, generation, groups, elapsed, files, bytes]() {
+            if (generation != duplicate_generation.load()) return;
+
+            LOG_DEBUG("Duplicate search: %llu files, %llu bytes hashed in %lld ms",
+                      static_cast<unsigned long long>(files), static_cast<unsigned long long>(bytes),
+                      static_cast<long long>(elapsed));
+            duplicate_progress.reset();
+            duplicate_view.setGroups(root, std::move(*groups));
+            needs_redraw = true;
+            setStatusMessage(std::to_string(duplicate_view.getGroupCount()) + " duplicate groups, " +
+                             Utils::formatSize(duplicate_view.getReclaimableBytes()) + " reclaimable");
+        };
+    });
+}
+
+void QuickView::pollDuplicateProgress() {
+    if (!duplicate_progress || current_display_mode != DisplayMode::DUPLICATE_VIEW) return;
+
+    // Redraw only when the counters have moved
+    uint64_t snapshot = duplicate_progress->files_found.load() + duplicate_progress->files_hashed.load() +
+                        duplicate_progress->bytes_hashed.load() + duplicate_progress->stage.load();
+    if (snapshot != duplicate_progress_drawn) {
+        duplicate_progress_drawn = snapshot;
+        needs_redraw = true;
+    }
+}
+
+void QuickView::duplicateViewMove(int delta) {
+    duplicate_view.moveSelection(delta, getContentPageSize());
+    needs_redraw = true;
+}
+
+void QuickView::duplicateViewPageUp() {
+    duplicateViewMove(-getContentPageSize());
+}
+
+void QuickView::duplicateViewPageDown() {
+    duplicateViewMove(getContentPageSize());
+}
+
+void QuickView::duplicateViewHome() {
+    duplicate_view.selectFirst();
+    needs_redraw = true;
+}
+
+void QuickView::duplicateViewEnd() {
+    duplicate_view.selectLast(getContentPageSize());
+    needs_redraw = true;
+}
+
+void QuickView::duplicateViewReveal() {
+    std::filesystem::path path;
+    if (!duplicate_view.getSelectedPath(path)) return;
+
+    current_display_mode = DisplayMode::NORMAL;
+    selectPath(path);
+}
+
+void QuickView::closeDuplicateView() {
+    // Leaving the view abandons a search that is still running
+    if (duplicate_progress) {
+        duplicate_generation++;
+        duplicate_progress.reset();
+        setStatusMessage("Duplicate search cancelled");
+    }
+    current_display_mode = DisplayMode::NORMAL;
+    needs_redraw = true;
+}
+
+void QuickView::openJumpView() {
+    jump_query.clear();
+    updateJumpMatches();
+    current_display_mode = DisplayMode::JUMP_VIEW;
+    needs_redraw = true;
+    setStatusMessage("Jump - type part of a visited directory, Enter to open it");
+}
+
+void QuickView::jumpViewType(char c) {
+    jump_query += c;
+    updateJumpMatches();
+}
+
+void QuickView::jumpViewErase() {
+    if (jump_query.empty()) return;
+    jump_query.pop_back();
+    updateJumpMatches();
+}
+
+void QuickView::jumpViewMove(int delta) {
+    if (jump_matches.empty()) return;
+    int last = static_cast<int>(jump_matches.size()) - 1;
+    jump_selected = std::max(0, std::min(last, jump_selected + delta));
+    needs_redraw = true;
+}
+
+void QuickView::jumpViewOpen() {
+    if (jump_matches.empty()) return;
+    std::filesystem::path target = jump_matches[jump_selected].path;
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(target, ec)) {
+        // Forget directories that have gone away
+        directory_history.remove(target);
+        updateJumpMatches();
+        setStatusError("No longer a directory: " + target.string());
+        return;
+    }
+
+    // Straight to the target; the directories on the way are never read
+    current_display_mode = DisplayMode::NORMAL;
+    loadDirectory(target);
+}
+
+void QuickView::closeJumpView() {
+    current_display_mode = DisplayMode::NORMAL;
+    needs_redraw = true;
+    setStatusMessage("Use arrows to navigate, Enter to select, 'v' to view files, 'h' for help, 'q' to quit");
+}
+
+void QuickView::updateJumpMatches() {
+    // One more than fits, since the current directory is left out
+    size_t rows = static_cast<size_t>(std::max(1, getContentPageSize()));
+    jump_matches = directory_history.find(jump_query, rows + 1);
+    jump_matches.erase(std::remove_if(jump_matches.begin(), jump_matches.end(),
+                                      [this](const DirectoryHistory::Match& match) {
+                                          return match.path == current_directory;
+                                      }),
+                       jump_matches.end());
+    if (jump_matches.size() > rows) jump_matches.resize(rows);
+    jump_selected = 0;
+    needs_redraw = true;
+}
+
+void QuickView::listingChanged() {
+    entry_labels.reset(directory_entries, current_directory);
+    type_ahead.reset(directory_entries);
+    browser_tree.reset(directory_entries.size());
+    reexpand_paths.clear();
+    reselect_path.clear();
+}
+
+void QuickView::selectPath(const std::filesystem::path& path) {
+    loadDirectory(path.parent_path());
+    selectEntry(path.filename());
+}
+
+void QuickView::selectEntry(const std::filesystem::path& filename) {
+    for (size_t i = 0; i < directory_entries.size(); i++) {
+        if (directory_entries[i].path().filename() != filename) continue;
+
+        selected_file_index = (int)i;
+
+        // Scroll so the entry lands mid-window when it is below the first page
+        int max_y, max_x;
+        terminal_->getWindowSize(file_browser_window_, max_x, max_y);
+        int display_height = std::max(1, max_y - 4);
+        if (selected_file_index >= display_height) {
+            file_scroll_offset = selected_file_index - display_height / 2;
+        }
+        break;
+    }
+    needs_redraw = true;
+}
+
+void QuickView::markSelected() {
+    if (directory_entries.empty() || selected_file_index >= (int)directory_entries.size()) {
+        return;
+    }
+
+    const auto& selected_entry = directory_entries[selected_file_index];
+    if (selected_entry.path() == marked_path) {
+        marked_path.clear();
+        setStatusMessage("Mark cleared");
+    } else {
+        marked_path = selected_entry.path();
+        setStatusMessage("Marked " + marked_path.filename().string() + " - select another file and press 'c' to compare");
+    }
+    needs_redraw = true;
+}
+
+void QuickView::compareWithMarked() {
+    if (marked_path.empty()) {
+        setStatusError("Nothing marked: press 'm' on a file or directory first");
+        return;
+    }
+    if (directory_entries.empty() || selected_file_index >= (int)directory_entries.size()) {
+        return;
+    }
+
+    std::filesystem::path left = marked_path;
+    std::filesystem::path right = directory_entries[selected_file_index].path();
+    std::error_code ec;
+    bool directories = std::filesystem::is_directory(left, ec) && std::filesystem::is_directory(right, ec);
+    if (!directories &&
+        (!std::filesystem::is_regular_file(left, ec) || !std::filesystem::is_regular_file(right, ec))) {
+        setStatusError("Cannot compare: the marked and the selected entry must both be files or both be directories");
+        return;
+    }
+    if (left == right) {
+        setStatusError("Select a different entry to compare with " + left.filename().string());
+        return;
+    }
+
+    if (directories) {
+        startDirectoryCompare(left, right);
+    } else {
+        diff_from_compare = false;
+        startFileDiff(left, right);
+    }
+}
+
+void QuickView::startFileDiff(const std::filesystem::path& left, const std::filesystem::path& right) {
+    setStatusMessage("Comparing " + left.filename().string() + " with " + right.filename().string() + "...");
+
+    // The result only opens over the view it was started from, and only for the latest diff
+    uint64_t generation = ++diff_generation;
+    DisplayMode started_in = current_display_mode;
+    bool from_compare = diff_from_compare;
+    background_worker.submit([this, left, right, generation, started_in, from_compare]() -> BackgroundWorker::Completion {
+        auto started = std::chrono::steady_clock::now();
+        auto view = std::make_shared<DiffView>();
+        bool opened = view->open(left, right);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+
+        return [this, view, opened, elapsed, generation, started_in, from_compare]() {
+            if (generation != diff_generation || current_display_mode != started_in) return;
+            if (!opened) {
+                setStatusError("Cannot compare: " + view->getError());
+                return;
+            }
+
+            LOG_DEBUG("Diff of %zu and %zu lines: %zu hunks in %lld ms",
+                      view->getLeftLineCount(), view->getRightLineCount(), view->getHunkCount(),
+                      static_cast<long long>(elapsed));
+            diff_view = view;
+            diff_from_compare = from_compare;
+            diff_view->jumpToHunk(true, getContentPageSize());
+            current_display_mode = DisplayMode::DIFF_VIEW;
+            needs_redraw = true;
+            setStatusMessage(view->getHunkCount() == 0 ? "Files are identical"
+                                                       : std::to_string(view->getHunkCount()) + " hunks");
+        };
+    });
+}
+
+void QuickView::diffViewScroll(int delta) {
+    if (!diff_view) return;
+    diff_view->scroll(delta, getContentPageSize());
+    needs_redraw = true;
+}
+
+void QuickView::diffViewPageUp() {
+    diffViewScroll(-getContentPageSize());
+}
+
+void QuickView::diffViewPageDown() {
+    diffViewScroll(getContentPageSize());
+}
+
+void QuickView::diffViewHome() {
+    if (!diff_view) return;
+    diff_view->scrollToStart();
+    needs_redraw = true;
+}
+
+void QuickView::diffViewEnd() {
+    if (!diff_view) return;
+    diff_view->scrollToEnd(getContentPageSize());
+    needs_redraw = true;
+}
+
+void QuickView::diffViewJumpToHunk(bool forward) {
+    if (!diff_view) return;
+    if (diff_view->jumpToHunk(forward, getContentPageSize())) {
+        needs_redraw = true;
+    } else {
+        setStatusMessage(forward ? "No more hunks" : "No earlier hunks");
+    }
+}
+
+void QuickView::closeDiffView() {
+    // A diff opened from a directory comparison returns to it
+    current_display_mode = diff_from_compare ? DisplayMode::COMPARE_VIEW : DisplayMode::NORMAL;
+    diff_from_compare = false;
+    needs_redraw = true;
+}
+
+void QuickView::startDirectoryCompare(const std::filesystem::path& left, const std::filesystem::path& right) {
+    uint64_t generation = ++compare_generation;
+    auto progress = std::make_shared<TreeCompareProgress>();
+    compare_progress = progress;
+    compare_progress_drawn = 0;
+    compare_view.reset(left, right);
+    current_display_mode = DisplayMode::COMPARE_VIEW;
+    needs_redraw = true;
+    setStatusMessage("Comparing " + left.string() + " with " + right.string());
+
+    background_worker.submit([this, left, right, generation, progress]() -> BackgroundWorker::Completion {
+        auto started = std::chrono::steady_clock::now();
+        bool complete = DirectoryCompare::compare(left, right, *progress, [this, generation]() {
+            return generation != compare_generation.load();
+        });
+        if (!complete) return nullptr;
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+
+        return [this, generation, progress, elapsed]() {
+            if (generation != compare_generation.load()) return;
+
+            // Collect whatever was found after the last poll
+            pollCompareProgress();
+            LOG_DEBUG("Directory compare: %llu directories, %llu files, %llu read in %lld ms",
+                      static_cast<unsigned long long>(progress->directories.load()),
+                      static_cast<unsigned long long>(progress->files_compared.load()),
+                      static_cast<unsigned long long>(progress->files_read.load()),
+                      static_cast<long long>(elapsed));
+            compare_progress.reset();
+            needs_redraw = true;
+            setStatusMessage(compare_view.getDifferenceCount() == 0 ? "Directories are identical"
+                             : std::to_string(compare_view.getDifferenceCount()) + " differences");
+        };
+    });
+}
+
+void QuickView::pollCompareProgress() {
+    if (!compare_progress) return;
+
+    // Differences are merged in as they stream in, even while a diff opened from the view is shown
+    std::vector<TreeDifference> found;
+    if (compare_progress->takeDifferences(found)) {
+        compare_view.addDifferences(std::move(found), getContentPageSize());
+        needs_redraw = true;
+    }
+    if (current_display_mode != DisplayMode::COMPARE_VIEW) return;
+
+    uint64_t snapshot = compare_progress->directories.load() + compare_progress->files_compared.load() +
+                        compare_progress->bytes_read.load();
+    if (snapshot != compare_progress_drawn) {
+        compare_progress_drawn = snapshot;
+        needs_redraw = true;
+    }
+}
+
+void QuickView::compareViewMove(int delta) {
+    compare_view.moveSelection(delta, getContentPageSize());
+    needs_redraw = true;
+}
+
+void QuickView::compareViewPageUp() {
+    compareViewMove(-getContentPageSize());
+}
+
+void QuickView::compareViewPageDown() {
+    compareViewMove(getContentPageSize());
+}
+
+void QuickView::compareViewHome() {
+    compare_view.selectFirst();
+    needs_redraw = true;
+}
+
+void QuickView::compareViewEnd() {
+    compare_view.selectLast(getContentPageSize());
+    needs_redraw = true;
+}
+
+void QuickView::compareViewOpen() {
+    if (compare_view.getRowCount() == 0) return;
+
+    if (compare_view.toggleSelected(getContentPageSize())) {
+        needs_redraw = true;
+        return;
+    }
+
+    const TreeDifference* difference = compare_view.getDifference(compare_view.getSelectedRow());
+    std::filesystem::path left = compare_view.getLeftRoot() / difference->relative_path;
+    std::filesystem::path right = compare_view.getRightRoot() / difference->relative_path;
+
+    // Changed files open in the diff view; anything else is shown in the file browser
+    std::error_code ec;
+    if (difference->kind == TreeDifference::CHANGED &&
+        std::filesystem::is_regular_file(std::filesystem::symlink_status(left, ec)) &&
+        std::filesystem::is_regular_file(std::filesystem::symlink_status(right, ec))) {
+        diff_from_compare = true;
+        startFileDiff(left, right);
+        return;
+    }
+
+    current_display_mode = DisplayMode::NORMAL;
+    selectPath(difference->kind == TreeDifference::REMOVED ? left : right);
+}
+
+void QuickView::closeCompareView() {
+    // Leaving the view abandons a comparison that is still running
+    if (compare_progress) {
+        compare_generation++;
+        compare_progress.reset();
+        setStatusMessage("Directory comparison cancelled");
+    }
+    current_display_mode = DisplayMode::NORMAL;
+    needs_redraw = true;
+}
+
+void QuickView::toggleSelection() {
+    if (directory_entries.empty() || selected_file_index >= (int)directory_entries.size()) return;
+
+    const std::filesystem::path& path = directory_entries[selected_file_index].path();
+    if (path.filename() != "..") {
+        // The selection survives changing directory, so entries can be gathered and then copied elsewhere
+        if (!selection.erase(path)) selection.insert(path);
+        updateJobStatus();
+    }
+    navigateDown();
+    needs_redraw = true;
+}
+
+void QuickView::queueSelection(FileJob::Operation operation) {
+    if (selection.empty()) {
+        setStatusError("Nothing selected: press Space on the entries to copy or move first");
+        return;
+    }
+
+    FileJob job;
+    job.operation = operation;
+    job.sources.assign(selection.begin(), selection.end());
+    job.destination = current_directory;
+    queued_jobs.push_back(std::move(job));
+    selection.clear();
+    startNextJob();
+    updateJobStatus();
+    needs_redraw = true;
+}
+
+void QuickView::requestRemoval() {
+    pending_removal.assign(selection.begin(), selection.end());
+    if (pending_removal.empty()) {
+        if (directory_entries.empty() || selected_file_index >= (int)directory_entries.size()) return;
+        const std::filesystem::path& path = directory_entries[selected_file_index].path();
+        if (path.filename() == "..") return;
+        pending_removal.push_back(path);
+    }
+
+    // The question stays up until the next key, which answers it
+    std::string what = pending_removal.size() == 1 ? pending_removal.front().filename().string()
+                                                   : std::to_string(pending_removal.size()) + " entries";
+    setStatusError("Remove " + what + " and everything below? Press y to confirm");
+}
+
+void QuickView::confirmRemoval(bool confirmed) {
+    if (confirmed) {
+        FileJob job;
+        job.operation = FileJob::REMOVE;
+        job.sources = std::move(pending_removal);
+        for (const auto& path : job.sources) {
+            selection.erase(path);
+        }
+        queued_jobs.push_back(std::move(job));
+        startNextJob();
+        updateJobStatus();
+        needs_redraw = true;
+    } else {
+        setStatusMessage("Nothing removed");
+    }
+    pending_removal.clear();
+}
+
+void QuickView::cancelJobs() {
+    if (!job_progress && queued_jobs.empty()) {
+        setStatusError("No file job is running");
+        return;
+    }
+
+    // The running job stops at its next chunk or entry and reports what it got done
+    queued_jobs.clear();
+    job_generation++;
+    updateJobStatus();
+    needs_redraw = true;
+}
+
+void QuickView::requestQuit() {
+    if (!job_progress && queued_jobs.empty()) {
+        running = false;
+        setStatusMessage("Goodbye!");
+        return;
+    }
+
+    // The question stays up until the next key, which answers it
+    quit_pending = true;
+    setStatusError("Quitting cancels the unfinished file job and leaves it partly done. Press y to quit anyway");
+}
+
+void QuickView::confirmQuit(bool confirmed) {
+    quit_pending = false;
+    if (confirmed) {
+        running = false;
+        setStatusMessage("Goodbye!");
+    } else {
+        setStatusMessage("Still running");
+    }
+}
+
+void QuickView::startNextJob() {
+    if (job_progress || queued_jobs.empty()) return;
+
+    auto job = std::make_shared<FileJob>(std::move(queued_jobs.front()));
+    queued_jobs.pop_front();
+    auto progress = std::make_shared<TransferProgress>();
+    uint64_t generation = job_generation.load();
+    job_progress = progress;
+    running_job = job;
+    job_operation = job->operation;
+    job_stage = -1;
+
+    background_worker.submit([this, job, progress, generation]() -> BackgroundWorker::Completion {
+        Trace::Span span("QuickView::startNextJob");
+        auto started = std::chrono::steady_clock::now();
+        std::string error;
+        bool complete = FileTransfer::run(*job, *progress, [this, generation]() {
+            return generation != job_generation.load();
+        }, error);
+        double elapsed = millisecondsSince(started);
+
+        return [this, job, progress, complete, error, elapsed]() {
+            finishJob(*job, *progress, complete, error, elapsed);
+        };
+    });
+}
+
+void QuickView::finishJob(const FileJob& job, const TransferProgress& progress, bool complete,
+                          const std::string& error, double elapsed_ms) {
+    uint64_t files = progress.files_done.load();
+    uint64_t bytes = progress.bytes_done.load();
+    uint64_t errors = progress.errors.load();
+    const char* verb = job.operation == FileJob::COPY ? "Copied" : job.operation == FileJob::MOVE ? "Moved" : "Removed";
+    Log::info("%s %llu entries (%.0f/s), %llu bytes (%llu cloned files) in %.1f ms, %llu errors%s",
+              verb, static_cast<unsigned long long>(files), elapsed_ms > 0 ? files * 1000.0 / elapsed_ms : 0.0,
+              static_cast<unsigned long long>(bytes),
+              static_cast<unsigned long long>(progress.files_cloned.load()), elapsed_ms,
+              static_cast<unsigned long long>(errors), complete ? "" : ", cancelled");
+
+    std::string summary = std::string(verb) + " " + std::to_string(files) + " entries";
+    if (bytes > 0) summary += ", " + Utils::formatSize(bytes);
+    if (!complete) {
+        setStatusError(summary + " before the job was cancelled");
+    } else if (errors > 0) {
+        setStatusError(summary + "; " + std::to_string(errors) + (errors == 1 ? " failure: " : " failures, first: ") +
+                       error);
+    } else {
+        setStatusMessage(summary);
+    }
+    job_progress.reset();
+    running_job.reset();
+
+    // Show the result if the listing is one the job changed
+    bool affected = isBelow(job.destination, current_directory);
+    for (const auto& source : job.sources) {
+        affected = affected || isBelow(source.parent_path(), current_directory);
+    }
+    if (affected && directory_listed) {
+        std::filesystem::path select;
+        if (selected_file_index < (int)directory_entries.size()) select = directory_entries[selected_file_index].path();
+        scanDirectory(current_directory, select);
+    }
+
+    // The result stays next to the file details until the selection changes or another job starts
+    startNextJob();
+    updateJobStatus();
+    if (!job_progress && complete && errors == 0) job_status = summary;
+    needs_redraw = true;
+}
+
+void QuickView::pollJobProgress() {
+    if (!job_progress) return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - job_status_updated < JOB_STATUS_INTERVAL) return;
+    std::string previous = job_status;
+    updateJobStatus();
+    if (job_status != previous) needs_redraw = true;
+}
+
+void QuickView::updateJobStatus() {
+    job_status_updated = std::chrono::steady_clock::now();
+    if (!job_progress) {
+        job_status = selection.empty() ? std::string() : std::to_string(selection.size()) + " selected";
+        return;
+    }
+
+    const TransferProgress& progress = *job_progress;
+    const char* verb = job_operation == FileJob::COPY ? "Copying" : job_operation == FileJob::MOVE ? "Moving" : "Removing";
+    uint64_t files_done = progress.files_done.load();
+    uint64_t bytes_done = progress.bytes_done.load();
+    uint64_t bytes_total = progress.bytes_total.load();
+
+    // Rates are measured from the start of the current stage, so that a scan does not dilute them
+    int stage = progress.stage.load();
+    if (stage != job_stage) {
+        job_stage = stage;
+        job_stage_started = job_status_updated;
+        job_stage_files = files_done;
+    }
+    double seconds = std::chrono::duration<double>(job_status_updated - job_stage_started).count();
+
+    std::string status = verb;
+    switch (stage) {
+        case TransferProgress::SCANNING:
+            status += ": scanning, " + std::to_string(progress.files_total.load()) + " entries";
+            break;
+        case TransferProgress::COPYING:
+            if (bytes_total > 0) status += " " + std::to_string(std::min<uint64_t>(bytes_done * 100 / bytes_total, 100)) + "%";
+            status += " " + std::to_string(files_done) + "/" + std::to_string(progress.files_total.load()) + ", " +
+                      Utils::formatSize(bytes_done) + " of " + Utils::formatSize(bytes_total);
+            if (seconds > 0) status += ", " + Utils::formatSize(static_cast<uint64_t>(bytes_done / seconds)) + "/s";
+            break;
+        case TransferProgress::REMOVING:
+            status += job_operation == FileJob::REMOVE ? ": " : ", removing sources: ";
+            status += std::to_string(files_done - job_stage_files) + " entries";
+            if (seconds > 0) status += ", " + std::to_string(static_cast<uint64_t>((files_done - job_stage_files) / seconds)) + "/s";
+            break;
+        default:
+            status += ": " + std::to_string(files_done) + " entries";
+            break;
+    }
+    if (!queued_jobs.empty()) status += " (+" + std::to_string(queued_jobs.size()) + " queued)";
+    job_status = status;
+}
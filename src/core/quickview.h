@@ -2,10 +2,31 @@
 #define QUICKVIEW_H
 
 #include "../platform/terminal_interface.h"
+#include "json_tree.h"
+#include "duplicate_view.h"
+#include "diff_view.h"
+#include "compare_view.h"
+#include "background_worker.h"
+#include "browser_tree.h"
+#include "keystroke_monitor.h"
+#include "../filesystem/preview_cache.h"
+#include "../filesystem/file_operations.h"
+#include "../filesystem/image_handler.h"
+#include "../filesystem/file_analysis.h"
+#include "../filesystem/directory_history.h"
+#include "../filesystem/file_transfer.h"
+#include "../platform/process_launcher.h"
+#include "../platform/event_loop.h"
+#include "../ui/entry_labels.h"
+#include "../ui/type_ahead.h"
 #include <string>
 #include <vector>
+#include <deque>
+#include <set>
 #include <memory>
 #include <filesystem>
+#include <atomic>
+#include <chrono>
 
 /**
  * @brief Main application class for quickView file browser
@@ -17,31 +38,73 @@ public:
         NORMAL,
         HELP,
         ABOUT,
-        FILE_VIEW
+        FILE_VIEW,
+        JSON_VIEW,
+        DUPLICATE_VIEW,
+        DIFF_VIEW,
+        COMPARE_VIEW,
+        JUMP_VIEW
     };
 
     /**
      * @brief Constructor - initializes the application
-     * @param debug_mode Enable debug output to stderr
+     * @param terminal Terminal to draw on; the platform terminal when null
      */
-    QuickView(bool debug_mode = false);
+    explicit QuickView(std::unique_ptr<ITerminal> terminal = nullptr);
 
     /**
      * @brief Destructor - cleans up resources
      */
     ~QuickView();
 
+    /**
+     * @brief Choose what is shown at startup; call before initialize()
+     * A directory is listed instead of the working directory. A file opens
+     * straight in the viewer and its directory is only listed on leaving it.
+     * @param path Directory or file
+     * @param line Line of the file to scroll to, counted from 1; 0 for the top
+     */
+    void setStartPath(const std::filesystem::path& path, int line = 0);
+
     /**
      * @brief Initialize the application
+     * The first frame does not wait for the directory listing, which is read
+     * by a background worker.
      * @return true if successful, false otherwise
      */
     bool initialize();
 
+    /**
+     * @brief Block until the directory being listed in the background has been read
+     * For scripted runs that must see the listing before the first key.
+     */
+    void waitForDirectory();
+
     /**
      * @brief Run the main application loop
      */
     void run();
 
+    /**
+     * @brief Cap how often the screen is redrawn
+     * Input arriving faster is applied in batches, one frame per batch.
+     * @param fps Frames per second; 0 redraws after every batch of input
+     */
+    void setFrameRate(int fps);
+
+    /**
+     * @brief Record visited directories in a database that the jump prompt searches; call before initialize()
+     * @param path Database file, or an empty path to keep no history
+     */
+    void setHistoryPath(const std::filesystem::path& path) { history_path = path; }
+
+    /**
+     * @brief Report keys and frames to a monitor that records or measures them
+     * @param monitor Monitor that outlives the main loop, or nullptr
+     */
+    void setKeystrokeMonitor(KeystrokeMonitor* monitor) { keystroke_monitor = monitor; }
+    KeystrokeMonitor* getKeystrokeMonitor() const { return keystroke_monitor; }
+
     /**
      * @brief Shutdown the application
      */
@@ -49,21 +112,30 @@ public:
 
     // Public accessors for input handling
     DisplayMode getCurrentDisplayMode() const { return current_display_mode; }
-    void setDisplayMode(DisplayMode mode) { current_display_mode = mode; }
+    void setDisplayMode(DisplayMode mode);
     void setRunning(bool running) { this->running = running; }
+    bool isRunning() const { return running; }
     void setNeedsRedraw(bool needs_redraw) { this->needs_redraw = needs_redraw; }
-    bool isDebugEnabled() const { return debug_enabled; }
     void setStatusMessage(const std::string& message);
+    void setStatusError(const std::string& message);
+    void clearStatusError();
 
-    // Navigation methods
-    void navigateUp();
-    void navigateDown();
-    void navigatePageUp();
-    void navigatePageDown();
+    // Navigation methods; a count repeats the move, as when keys were coalesced
+    void navigateUp(int count = 1);
+    void navigateDown(int count = 1);
+    void navigatePageUp(int pages = 1);
+    void navigatePageDown(int pages = 1);
     void navigateHome();
     void navigateEnd();
     void enterDirectory();
+    void expandSelected();
+    void collapseSelected();
+    void typeAhead(char c);
+    bool isTypingAhead() const;
     void viewFile();
+    void openWithHandler();
+    void computeSelectedSha256();
+    void writeTrace();
 
     // File view scrolling methods
     void scrollFileViewUp();
@@ -73,6 +145,62 @@ public:
     void scrollFileViewHome();
     void scrollFileViewEnd();
 
+    // JSON tree view methods
+    void jsonViewMove(int delta);
+    void jsonViewPageUp();
+    void jsonViewPageDown();
+    void jsonViewHome();
+    void jsonViewEnd();
+    void jsonViewExpand();
+    void jsonViewCollapse();
+
+    // Duplicate finder methods
+    void findDuplicates();
+    void duplicateViewMove(int delta);
+    void duplicateViewPageUp();
+    void duplicateViewPageDown();
+    void duplicateViewHome();
+    void duplicateViewEnd();
+    void duplicateViewReveal();
+    void closeDuplicateView();
+
+    // Compare methods
+    void markSelected();
+    void compareWithMarked();
+    void diffViewScroll(int delta);
+    void diffViewPageUp();
+    void diffViewPageDown();
+    void diffViewHome();
+    void diffViewEnd();
+    void diffViewJumpToHunk(bool forward);
+    void closeDiffView();
+    void compareViewMove(int delta);
+    void compareViewPageUp();
+    void compareViewPageDown();
+    void compareViewHome();
+    void compareViewEnd();
+    void compareViewOpen();
+    void closeCompareView();
+
+    // Directory jump methods
+    void openJumpView();
+    void jumpViewType(char c);
+    void jumpViewErase();
+    void jumpViewMove(int delta);
+    void jumpViewOpen();
+    void closeJumpView();
+
+    // File job methods
+    void toggleSelection();
+    void queueSelection(FileJob::Operation operation);
+    void requestRemoval();
+    bool isConfirmingRemoval() const { return !pending_removal.empty(); }
+    void confirmRemoval(bool confirmed);
+    void cancelJobs();
+    void requestQuit();
+    bool isConfirmingQuit() const { return quit_pending; }
+    void confirmQuit(bool confirmed);
+
     // Window management
     void resizeHandler();
 
@@ -88,11 +216,12 @@ private:
 
     // Application state
     bool running;
-    bool debug_enabled;
     bool needs_redraw;
+    std::chrono::steady_clock::duration frame_interval;     // Minimum time between redraws
     int screen_height;
     int screen_width;
     std::string status_message;
+    std::string status_error;
 
     // Display mode
     DisplayMode current_display_mode;
@@ -100,18 +229,122 @@ private:
     // File browser state
     std::filesystem::path current_directory;
     std::vector<std::filesystem::directory_entry> directory_entries;
+    EntryLabels entry_labels;       // Display strings of directory_entries
+    TypeAhead type_ahead;           // Jumps to the entry whose name is being typed
+    BrowserTree browser_tree;       // Depth and subtree of each entry; expanded directories list their children in place
     int selected_file_index;
     int file_scroll_offset;
+    std::vector<std::filesystem::path> reexpand_paths;  // Expanded before a rescan; opened again as they appear
+    std::filesystem::path reselect_path;                // Selected before a rescan, inside one of those
+    bool directory_listed;          // False until current_directory has been read
+    bool directory_scanning;        // A background scan of current_directory is running
+    uint64_t directory_generation;  // Bumped by every load; stale scans are dropped
+    std::filesystem::path start_file;   // File opened at startup before its directory is listed
+    int start_line;
+    std::chrono::steady_clock::time_point startup_begin;
 
     // File viewing state
     std::vector<std::string> file_content_lines;
     int file_view_scroll_offset;
 
+    // JSON tree view state
+    JsonTree json_tree;
+
+    // Duplicate finder state; progress is set while a search runs
+    DuplicateView duplicate_view;
+    std::shared_ptr<DuplicateProgress> duplicate_progress;
+    std::atomic<uint64_t> duplicate_generation;
+    uint64_t duplicate_progress_drawn;
+
+    // Compare state: the entry marked with 'm', the last diff and the last directory comparison
+    std::filesystem::path marked_path;
+    std::shared_ptr<DiffView> diff_view;
+    bool diff_from_compare;
+    uint64_t diff_generation;       // Bumped by every diff started; stale results are dropped
+    CompareView compare_view;
+    std::shared_ptr<TreeCompareProgress> compare_progress;
+    std::atomic<uint64_t> compare_generation;
+    uint64_t compare_progress_drawn;
+
+    // Visited directories and the jump prompt searching them
+    std::filesystem::path history_path;
+    DirectoryHistory directory_history;
+    std::string jump_query;
+    std::vector<DirectoryHistory::Match> jump_matches;
+    int jump_selected;
+
+    // File jobs: entries selected with Space, jobs waiting their turn and the one running
+    std::set<std::filesystem::path> selection;
+    std::vector<std::filesystem::path> pending_removal;    // Entries to remove once confirmed
+    std::deque<FileJob> queued_jobs;
+    std::shared_ptr<TransferProgress> job_progress;     // Set while a job runs
+    std::shared_ptr<const FileJob> running_job;         // The job job_progress belongs to
+    bool quit_pending;                                  // Quitting would cut a job short and waits for 'y'
+    FileJob::Operation job_operation;
+    std::atomic<uint64_t> job_generation;               // Bumped to cancel the running job
+    int job_stage;                                      // Stage seen by the last status update
+    std::chrono::steady_clock::time_point job_stage_started;
+    uint64_t job_stage_files;                           // Entries done when the stage started
+    std::chrono::steady_clock::time_point job_status_updated;
+    std::string job_status;                             // Progress, or the selection size, for the status bar
+
+    // External "open with" handlers
+    ProcessLauncher launcher;
+
+    // Selected file preview state (loaded by background_worker)
+    PreviewCache<TextPreview> preview_cache;
+    PreviewCache<ImagePreview> image_preview_cache;
+    std::shared_ptr<const TextPreview> current_preview;
+    std::shared_ptr<const ImagePreview> current_image_preview;
+    PreviewCache<FileAnalysis> analysis_cache;
+    std::shared_ptr<const FileAnalysis> current_analysis;
+    std::filesystem::path preview_path;
+    std::atomic<uint64_t> preview_generation;
+
+    // Waits for input, signals, timers and finished background work at once; created
+    // before the worker threads so they inherit its blocked signals
+    EventLoop event_loop;
+    KeystrokeMonitor* keystroke_monitor;
+    int resize_timer;               // Window changes are applied once the size settles
+    int progress_timer;             // Samples search progress while a search runs
+    bool progress_timer_running;
+    std::vector<int> expired_timers;
+
+    // Background tasks; declared last so workers stop before the state they use is destroyed
+    BackgroundWorker background_worker;
+
     // Private methods
     void setupWindows();
     void drawInterface();
     void updateDisplay();
     void loadDirectory(const std::filesystem::path& path);
+    void scanDirectory(const std::filesystem::path& path, const std::filesystem::path& select);
+    bool openFileView(const std::filesystem::path& path);
+    bool openJsonView(const std::filesystem::path& path);
+    int getContentPageSize();
+    void requestPreview();
+    void requestImagePreview(const std::filesystem::path& path, uint64_t generation);
+    void requestAnalysis(const std::filesystem::path& path, uint64_t generation);
+    void launchHandler(const std::filesystem::path& path);
+    void reapHandlers();
+    bool processEvents(int timeout_ms, bool input_pending);
+    void pollTerminal(int timeout_ms);
+    void pollDuplicateProgress();
+    void pollCompareProgress();
+    void pollJobProgress();
+    void startNextJob();
+    void finishJob(const FileJob& job, const TransferProgress& progress, bool complete, const std::string& error,
+                   double elapsed_ms);
+    void updateJobStatus();
+    void startFileDiff(const std::filesystem::path& left, const std::filesystem::path& right);
+    void startDirectoryCompare(const std::filesystem::path& left, const std::filesystem::path& right);
+    void selectPath(const std::filesystem::path& path);
+    void selectEntry(const std::filesystem::path& filename);
+    void listingChanged();
+    void expandRow(int index, bool announce);
+    void insertChildren(uint32_t id, std::vector<std::filesystem::directory_entry>& children, bool announce);
+    void reexpandRows(size_t begin, size_t end);
+    void updateJumpMatches();
 
 public:
     // Public accessors for the refactored modules
@@ -120,9 +353,25 @@ public:
     int getFileScrollOffset() const { return file_scroll_offset; }
     const std::filesystem::path& getCurrentDirectory() const { return current_directory; }
     const std::string& getStatusMessage() const { return status_message; }
+    const std::string& getStatusError() const { return status_error; }
     int getScreenWidth() const { return screen_width; }
     const std::vector<std::string>& getFileContentLines() const { return file_content_lines; }
     int getFileViewScrollOffset() const { return file_view_scroll_offset; }
+    const JsonTree& getJsonTree() const { return json_tree; }
+    const DuplicateView& getDuplicateView() const { return duplicate_view; }
+    const DuplicateProgress* getDuplicateProgress() const { return duplicate_progress.get(); }
+    const std::filesystem::path& getMarkedPath() const { return marked_path; }
+    const std::set<std::filesystem::path>& getSelection() const { return selection; }
+    const std::string& getJobStatus() const { return job_status; }
+    const DiffView* getDiffView() const { return diff_view.get(); }
+    const CompareView& getCompareView() const { return compare_view; }
+    const TreeCompareProgress* getCompareProgress() const { return compare_progress.get(); }
+    const std::string& getJumpQuery() const { return jump_query; }
+    const std::vector<DirectoryHistory::Match>& getJumpMatches() const { return jump_matches; }
+    int getJumpSelected() const { return jump_selected; }
+    const TextPreview* getCurrentPreview() const { return current_preview.get(); }
+    const ImagePreview* getCurrentImagePreview() const { return current_image_preview.get(); }
+    const FileAnalysis* getCurrentAnalysis() const { return current_analysis.get(); }
 
     // Window accessors
     ITerminal::WindowHandle getFileBrowserWindow() const { return file_browser_window_; }
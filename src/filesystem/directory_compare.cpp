@@ -0,0 +1,189 @@
+#include "directory_compare.h"
+#include "file_key.h"
+#include "../utils/work_stack.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+    const size_t READ_CHUNK = 1 << 20;
+
+    enum class EntryType { DIRECTORY, REGULAR, SYMLINK, OTHER };
+
+    struct Entry {
+        std::string name;
+        EntryType type;
+    };
+
+    size_t defaultThreadCount() {
+        // Listing and reading mostly wait on the disk, so use a few threads even on small machines
+        size_t thread_count = std::thread::hardware_concurrency();
+        return std::max<size_t>(thread_count, 4);
+    }
+
+    // List a directory sorted by name; an unreadable directory lists as empty
+    std::vector<Entry> listDirectory(const std::filesystem::path& path) {
+        std::vector<Entry> entries;
+        std::error_code ec;
+        std::filesystem::directory_iterator it(path, std::filesystem::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            std::error_code status_ec;
+            std::filesystem::file_status status = it->symlink_status(status_ec);
+            if (status_ec) continue;
+
+            EntryType type = EntryType::OTHER;
+            if (std::filesystem::is_symlink(status)) {
+                type = EntryType::SYMLINK;
+            } else if (std::filesystem::is_directory(status)) {
+                type = EntryType::DIRECTORY;
+            } else if (std::filesystem::is_regular_file(status)) {
+                type = EntryType::REGULAR;
+            }
+            entries.push_back({it->path().filename().string(), type});
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.name < b.name; });
+        return entries;
+    }
+
+    uint64_t fileSize(const std::filesystem::path& path) {
+        FileKey key;
+        return FileKey::fromPath(path, key) ? key.size : 0;
+    }
+
+    // Read both files in lockstep and stop at the first differing chunk
+    bool sameContents(const std::filesystem::path& left, const std::filesystem::path& right,
+                      std::vector<char>& left_buffer, std::vector<char>& right_buffer,
+                      TreeCompareProgress& progress, const DirectoryCompare::CancelCheck& cancelled) {
+        std::ifstream left_file(left, std::ios::binary);
+        std::ifstream right_file(right, std::ios::binary);
+        if (!left_file.is_open() || !right_file.is_open()) return false;
+
+        while (left_file && right_file) {
+            if (cancelled && cancelled()) return false;
+
+            left_file.read(left_buffer.data(), left_buffer.size());
+            right_file.read(right_buffer.data(), right_buffer.size());
+            std::streamsize count = left_file.gcount();
+            if (count != right_file.gcount()) return false;
+            progress.bytes_read += 2 * static_cast<uint64_t>(count);
+            if (memcmp(left_buffer.data(), right_buffer.data(), static_cast<size_t>(count)) != 0) return false;
+        }
+        return !left_file.bad() && !right_file.bad() && left_file.eof() && right_file.eof();
+    }
+}
+
+void TreeCompareProgress::addDifferences(std::vector<TreeDifference>& found) {
+    if (found.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::move(found.begin(), found.end(), std::back_inserter(pending_));
+    found.clear();
+}
+
+bool TreeCompareProgress::takeDifferences(std::vector<TreeDifference>& found) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    found.swap(pending_);
+    pending_.clear();
+    return !found.empty();
+}
+
+namespace DirectoryCompare {
+    bool compare(const std::filesystem::path& left, const std::filesystem::path& right,
+                 TreeCompareProgress& progress, const CancelCheck& cancelled, size_t thread_count) {
+        if (thread_count == 0) {
+            thread_count = defaultThreadCount();
+        }
+
+        std::vector<std::vector<char>> left_buffers(thread_count, std::vector<char>(READ_CHUNK));
+        std::vector<std::vector<char>> right_buffers(thread_count, std::vector<char>(READ_CHUNK));
+
+        // Each work item is a directory present on both sides, relative to the roots
+        auto compareDirectory = [&](std::string& relative, size_t worker, std::vector<std::string>& more) {
+            std::filesystem::path left_directory = relative.empty() ? left : left / relative;
+            std::filesystem::path right_directory = relative.empty() ? right : right / relative;
+            std::vector<Entry> left_entries = listDirectory(left_directory);
+            std::vector<Entry> right_entries = listDirectory(right_directory);
+            progress.directories++;
+
+            std::vector<TreeDifference> found;
+            auto report = [&](const std::string& name, TreeDifference::Kind kind, bool directory,
+                              uint64_t left_size, uint64_t right_size) {
+                found.push_back({relative.empty() ? name : relative + "/" + name, kind, directory,
+                                 left_size, right_size});
+            };
+
+            // Merge the two sorted listings by name
+            size_t l = 0;
+            size_t r = 0;
+            while (l < left_entries.size() || r < right_entries.size()) {
+                if (cancelled && cancelled()) break;
+
+                int order = l == left_entries.size() ? 1 :
+                            r == right_entries.size() ? -1 :
+                            left_entries[l].name.compare(right_entries[r].name);
+                if (order < 0) {
+                    const Entry& entry = left_entries[l++];
+                    bool directory = entry.type == EntryType::DIRECTORY;
+                    uint64_t size = entry.type == EntryType::REGULAR ? fileSize(left_directory / entry.name) : 0;
+                    report(entry.name, TreeDifference::REMOVED, directory, size, 0);
+                    continue;
+                }
+                if (order > 0) {
+                    const Entry& entry = right_entries[r++];
+                    bool directory = entry.type == EntryType::DIRECTORY;
+                    uint64_t size = entry.type == EntryType::REGULAR ? fileSize(right_directory / entry.name) : 0;
+                    report(entry.name, TreeDifference::ADDED, directory, 0, size);
+                    continue;
+                }
+
+                const Entry& left_entry = left_entries[l++];
+                const Entry& right_entry = right_entries[r++];
+                const std::string& name = left_entry.name;
+                std::filesystem::path left_path = left_directory / name;
+                std::filesystem::path right_path = right_directory / name;
+
+                if (left_entry.type != right_entry.type) {
+                    report(name, TreeDifference::CHANGED, right_entry.type == EntryType::DIRECTORY,
+                           left_entry.type == EntryType::REGULAR ? fileSize(left_path) : 0,
+                           right_entry.type == EntryType::REGULAR ? fileSize(right_path) : 0);
+                } else if (left_entry.type == EntryType::DIRECTORY) {
+                    more.push_back(relative.empty() ? name : relative + "/" + name);
+                } else if (left_entry.type == EntryType::SYMLINK) {
+                    std::error_code left_ec, right_ec;
+                    if (std::filesystem::read_symlink(left_path, left_ec) !=
+                        std::filesystem::read_symlink(right_path, right_ec) || left_ec || right_ec) {
+                        report(name, TreeDifference::CHANGED, false, 0, 0);
+                    }
+                } else if (left_entry.type == EntryType::REGULAR) {
+                    progress.files_compared++;
+
+                    // Size first, then mtime; only files that may still match are read
+                    FileKey left_key, right_key;
+                    bool have_keys = FileKey::fromPath(left_path, left_key) && FileKey::fromPath(right_path, right_key);
+                    bool changed;
+                    if (!have_keys || left_key.size != right_key.size) {
+                        changed = true;
+                    } else if (left_key.mtime_ns == right_key.mtime_ns) {
+                        changed = false;
+                    } else {
+                        progress.files_read++;
+                        changed = !sameContents(left_path, right_path, left_buffers[worker], right_buffers[worker],
+                                                progress, cancelled);
+                    }
+                    if (changed && !(cancelled && cancelled())) {
+                        report(name, TreeDifference::CHANGED, false, left_key.size, right_key.size);
+                    }
+                }
+            }
+
+            progress.addDifferences(found);
+        };
+
+        WorkStack<std::string> stack;
+        bool complete = stack.run({std::string()}, thread_count, compareDirectory, cancelled) &&
+                        !(cancelled && cancelled());
+        progress.done = true;
+        return complete;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef DIRECTORY_COMPARE_H
+#define DIRECTORY_COMPARE_H
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief One entry that differs between two directory trees
+ */
+struct TreeDifference {
+    enum Kind { ADDED, REMOVED, CHANGED };
+
+    std::string relative_path;      // Path below both roots, '/' separated
+    Kind kind = CHANGED;
+    bool directory = false;         // Entry is a directory (on the side where it exists)
+    uint64_t left_size = 0;         // Size in the left tree, 0 when absent or a directory
+    uint64_t right_size = 0;        // Size in the right tree, 0 when absent or a directory
+};
+
+/**
+ * @brief Counters and streamed results of a running comparison, safe to use from any thread
+ * Differences are appended as they are found; the UI thread collects the new
+ * ones with takeDifferences() while the walk continues.
+ */
+class TreeCompareProgress {
+public:
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> directories{0};       // Directory pairs listed
+    std::atomic<uint64_t> files_compared{0};    // File pairs present on both sides
+    std::atomic<uint64_t> files_read{0};        // File pairs whose contents had to be compared
+    std::atomic<uint64_t> bytes_read{0};        // Bytes read from both sides
+
+    /**
+     * @brief Publish differences found by a worker
+     * @param found Differences to append; cleared on return
+     */
+    void addDifferences(std::vector<TreeDifference>& found);
+
+    /**
+     * @brief Move out every difference published since the last call
+     * @param found Receives the new differences
+     * @return true if there were any
+     */
+    bool takeDifferences(std::vector<TreeDifference>& found);
+
+private:
+    std::mutex mutex_;
+    std::vector<TreeDifference> pending_;
+};
+
+/**
+ * @brief Parallel recursive comparison of two directory trees
+ * Both trees are walked together by a pool of threads, one directory pair per
+ * work item. Entries are matched by name; files of equal size are compared
+ * byte by byte unless their modification times already match.
+ */
+namespace DirectoryCompare {
+    // Returns true when the comparison should stop
+    using CancelCheck = std::function<bool()>;
+
+    /**
+     * @brief Compare two directory trees
+     * Symbolic links are not followed; two links differ when their targets do.
+     * A directory present on only one side is reported once, without its contents.
+     * @param left Old tree
+     * @param right New tree
+     * @param progress Receives counters and the differences as they are found
+     * @param cancelled Polled between directories and between reads
+     * @param thread_count Walker threads (0 selects one per core, at least four)
+     * @return true if the comparison completed, false if it was cancelled
+     */
+    bool compare(const std::filesystem::path& left, const std::filesystem::path& right,
+                 TreeCompareProgress& progress, const CancelCheck& cancelled, size_t thread_count = 0);
+}
+
+#endif // DIRECTORY_COMPARE_H
@@ -0,0 +1,439 @@
+#include "directory_history.h"
+#include "../utils/log.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+    const char MAGIC[8] = {'Q', 'V', 'D', 'I', 'R', 'S', '1', '\n'};
+
+    // Sum of ranks above which every rank is scaled down, as in z
+    const float MAX_TOTAL_RANK = 9000;
+    const float AGING_FACTOR = 0.9f;
+
+    // The file starts at this size and doubles when full
+    const size_t MIN_FILE_SIZE = 16 * 1024;
+
+    struct Header {
+        char magic[8];
+        uint32_t used;          // Bytes of records after the header
+        uint32_t generation;    // Bumped when records move, so that other processes re-index
+        float total_rank;
+        uint32_t reserved[3];
+    };
+
+    // Followed by the path, padded so the next record stays aligned
+    struct Record {
+        float rank;             // Visits, scaled down as the database ages
+        uint32_t last_visit;    // Unix time
+        uint16_t length;        // Path bytes
+        uint16_t reserved;
+    };
+
+    size_t recordSize(size_t length) {
+        return sizeof(Record) + ((length + 3) & ~static_cast<size_t>(3));
+    }
+
+    // Recent visits count more, in z's hour, day and week steps
+    double frecency(const Record& record, std::time_t now) {
+        std::time_t age = now - static_cast<std::time_t>(record.last_visit);
+        if (age < 3600) return record.rank * 4.0;
+        if (age < 86400) return record.rank * 2.0;
+        if (age < 604800) return record.rank * 0.5;
+        return record.rank * 0.25;
+    }
+
+    bool isBoundary(char c) {
+        return c == '/' || c == '_' || c == '-' || c == '.' || c == ' ';
+    }
+
+    /**
+     * @brief Rate how well the words of a query match a folded path
+     * @return 0 when they do not match, otherwise at least 1
+     */
+    double matchQuality(const std::string& path, const std::vector<std::string>& words) {
+        if (words.empty()) return 1;
+
+        size_t last_component = path.find_last_of('/');
+        last_component = last_component == std::string::npos ? 0 : last_component + 1;
+
+        size_t position = 0;
+        size_t letters = 0;
+        double bonus = 0;
+        for (size_t i = 0; i < words.size(); i++) {
+            const std::string& word = words[i];
+            letters += word.size();
+
+            // A whole word is best, and the last one preferably in the last component
+            size_t found = i + 1 == words.size() ? path.rfind(word) : path.find(word, position);
+            if (found != std::string::npos && found >= position) {
+                bonus += word.size();
+                if (found == 0 || isBoundary(path[found - 1])) bonus += 1;
+                position = found + word.size();
+                continue;
+            }
+
+            // Otherwise its letters in order with gaps
+            for (char c : word) {
+                size_t next = path.find(c, position);
+                if (next == std::string::npos) return 0;
+                if (next > 0 && (next == position || isBoundary(path[next - 1]))) bonus += 0.5;
+                position = next + 1;
+            }
+        }
+
+        double quality = 1 + bonus / (letters + words.size());
+        return position > last_component ? quality * 2 : quality;
+    }
+
+    void foldCase(std::string& text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    }
+
+    // Holds the advisory lock on the database file for a change or lookup
+    class FileLock {
+    public:
+        explicit FileLock(int fd) : fd_(fd) {
+#ifndef _WIN32
+            while (flock(fd_, LOCK_EX) != 0 && errno == EINTR) {}
+#endif
+        }
+        ~FileLock() {
+#ifndef _WIN32
+            flock(fd_, LOCK_UN);
+#endif
+        }
+        FileLock(const FileLock&) = delete;
+        FileLock& operator=(const FileLock&) = delete;
+
+    private:
+        int fd_;
+    };
+}
+
+DirectoryHistory::DirectoryHistory()
+    : data_(nullptr)
+    , mapped_size_(0)
+    , fd_(-1)
+    , indexed_generation_(0)
+    , indexed_used_(0)
+{
+}
+
+DirectoryHistory::~DirectoryHistory() {
+    close();
+}
+
+std::filesystem::path DirectoryHistory::getDefaultPath() {
+    const char* state_home = std::getenv("XDG_STATE_HOME");
+    if (state_home && *state_home) {
+        return std::filesystem::path(state_home) / "quickview" / "directories";
+    }
+#ifdef _WIN32
+    const char* home = std::getenv("LOCALAPPDATA");
+    if (home && *home) {
+        return std::filesystem::path(home) / "quickview" / "directories";
+    }
+#else
+    const char* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::filesystem::path(home) / ".local" / "state" / "quickview" / "directories";
+    }
+#endif
+    return std::filesystem::path();
+}
+
+bool DirectoryHistory::open(const std::filesystem::path& path) {
+    close();
+    error_.clear();
+
+#ifdef _WIN32
+    (void)path;
+    error_ = "Directory history is not supported on this platform";
+    return false;
+#else
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ < 0) {
+        error_ = "Cannot open " + path.string() + ": " + strerror(errno);
+        return false;
+    }
+
+    FileLock lock(fd_);
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        error_ = "Cannot read " + path.string() + ": " + strerror(errno);
+        close();
+        return false;
+    }
+
+    bool created = st.st_size == 0;
+    size_t size = created ? MIN_FILE_SIZE : static_cast<size_t>(st.st_size);
+    if (created && ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        error_ = "Cannot write " + path.string() + ": " + strerror(errno);
+        close();
+        return false;
+    }
+    if (!remap(size)) {
+        close();
+        return false;
+    }
+
+    Header* header = reinterpret_cast<Header*>(data_);
+    if (created) {
+        memset(header, 0, sizeof(Header));
+        memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    } else if (size < sizeof(Header) || memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error_ = path.string() + " is not a quickView directory history";
+        close();
+        return false;
+    }
+
+    index_.clear();
+    indexed_generation_ = header->generation;
+    indexed_used_ = 0;
+    indexFrom(0);
+    LOG_DEBUG("Directory history %s: %zu directories", path, index_.size());
+    return true;
+#endif
+}
+
+void DirectoryHistory::close() {
+#ifndef _WIN32
+    if (data_) {
+        munmap(data_, mapped_size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+    data_ = nullptr;
+    mapped_size_ = 0;
+    fd_ = -1;
+    index_.clear();
+}
+
+bool DirectoryHistory::remap(size_t size) {
+#ifdef _WIN32
+    (void)size;
+    return false;
+#else
+    if (data_) {
+        munmap(data_, mapped_size_);
+        data_ = nullptr;
+        mapped_size_ = 0;
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        error_ = std::string("Cannot map directory history: ") + strerror(errno);
+        Log::warning("%s", error_);
+        return false;
+    }
+    data_ = static_cast<char*>(mapping);
+    mapped_size_ = size;
+    return true;
+#endif
+}
+
+bool DirectoryHistory::reserve(size_t bytes) {
+    const Header* header = reinterpret_cast<const Header*>(data_);
+    size_t needed = sizeof(Header) + header->used + bytes;
+    if (needed <= mapped_size_) return true;
+    if (needed > UINT32_MAX) return false;
+
+#ifdef _WIN32
+    return false;
+#else
+    size_t size = std::max(needed, mapped_size_ * 2);
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        error_ = std::string("Cannot grow directory history: ") + strerror(errno);
+        Log::warning("%s", error_);
+        return false;
+    }
+    return remap(size);
+#endif
+}
+
+void DirectoryHistory::sync() {
+#ifndef _WIN32
+    // Another process may have grown the file
+    struct stat st;
+    if (fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) > mapped_size_ &&
+        !remap(static_cast<size_t>(st.st_size))) {
+        return;
+    }
+#endif
+
+    const Header* header = reinterpret_cast<const Header*>(data_);
+    if (header->generation != indexed_generation_) {
+        // Records were moved by a compaction elsewhere
+        index_.clear();
+        indexed_generation_ = header->generation;
+        indexed_used_ = 0;
+    }
+    if (header->used > indexed_used_) {
+        indexFrom(indexed_used_);
+    }
+}
+
+void DirectoryHistory::indexFrom(uint32_t offset) {
+    Header* header = reinterpret_cast<Header*>(data_);
+    char* records = data_ + sizeof(Header);
+    size_t used = std::min<size_t>(header->used, mapped_size_ - sizeof(Header));
+
+    while (offset + sizeof(Record) <= used) {
+        const Record* record = reinterpret_cast<const Record*>(records + offset);
+        size_t size = recordSize(record->length);
+        if (offset + size > used) break;
+        index_[std::string(records + offset + sizeof(Record), record->length)] = offset;
+        offset += static_cast<uint32_t>(size);
+    }
+
+    // A torn or damaged tail is dropped
+    if (offset != header->used) {
+        Log::warning("Directory history damaged after %u bytes, truncating", offset);
+        header->used = offset;
+    }
+    indexed_used_ = offset;
+}
+
+void DirectoryHistory::visit(const std::filesystem::path& directory, std::time_t now) {
+    if (!data_) return;
+    std::string key = directory.string();
+    if (key.empty() || key.size() > UINT16_MAX) return;
+
+    FileLock lock(fd_);
+    sync();
+    if (!data_) return;
+
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        Record* record = reinterpret_cast<Record*>(data_ + sizeof(Header) + found->second);
+        record->rank += 1;
+        record->last_visit = static_cast<uint32_t>(now);
+    } else {
+        size_t size = recordSize(key.size());
+        if (!reserve(size)) return;
+
+        Header* header = reinterpret_cast<Header*>(data_);
+        uint32_t offset = header->used;
+        char* start = data_ + sizeof(Header) + offset;
+        memset(start, 0, size);
+        Record* record = reinterpret_cast<Record*>(start);
+        record->rank = 1;
+        record->last_visit = static_cast<uint32_t>(now);
+        record->length = static_cast<uint16_t>(key.size());
+        memcpy(start + sizeof(Record), key.data(), key.size());
+
+        header->used = offset + static_cast<uint32_t>(size);
+        indexed_used_ = header->used;
+        index_.emplace(std::move(key), offset);
+    }
+
+    Header* header = reinterpret_cast<Header*>(data_);
+    header->total_rank += 1;
+    if (header->total_rank > MAX_TOTAL_RANK) {
+        compact(AGING_FACTOR);
+    }
+}
+
+void DirectoryHistory::remove(const std::filesystem::path& directory) {
+    if (!data_) return;
+
+    FileLock lock(fd_);
+    sync();
+    if (!data_) return;
+
+    auto found = index_.find(directory.string());
+    if (found == index_.end()) return;
+
+    // A rank of zero is below the threshold that compaction keeps
+    Record* record = reinterpret_cast<Record*>(data_ + sizeof(Header) + found->second);
+    record->rank = 0;
+    compact(1.0f);
+}
+
+void DirectoryHistory::compact(float factor) {
+    Header* header = reinterpret_cast<Header*>(data_);
+    char* records = data_ + sizeof(Header);
+
+    uint32_t read = 0;
+    uint32_t write = 0;
+    float total = 0;
+    index_.clear();
+    while (read < indexed_used_) {
+        Record* record = reinterpret_cast<Record*>(records + read);
+        uint32_t size = static_cast<uint32_t>(recordSize(record->length));
+        record->rank *= factor;
+        if (record->rank >= 1) {
+            total += record->rank;
+            if (write != read) memmove(records + write, records + read, size);
+            index_[std::string(records + write + sizeof(Record), record->length)] = write;
+            write += size;
+        }
+        read += size;
+    }
+
+    header->used = write;
+    header->total_rank = total;
+    header->generation++;
+    indexed_generation_ = header->generation;
+    indexed_used_ = write;
+}
+
+std::vector<DirectoryHistory::Match> DirectoryHistory::find(const std::string& query, size_t max_results,
+                                                            std::time_t now) {
+    std::vector<Match> matches;
+    if (!data_ || max_results == 0) return matches;
+
+    std::vector<std::string> words;
+    size_t start = 0;
+    while (start < query.size()) {
+        size_t end = query.find(' ', start);
+        if (end == std::string::npos) end = query.size();
+        if (end > start) {
+            words.push_back(query.substr(start, end - start));
+            foldCase(words.back());
+        }
+        start = end + 1;
+    }
+
+    FileLock lock(fd_);
+    sync();
+    if (!data_) return matches;
+
+    const char* records = data_ + sizeof(Header);
+    std::string folded;
+    for (const auto& entry : index_) {
+        folded = entry.first;
+        foldCase(folded);
+        double quality = matchQuality(folded, words);
+        if (quality <= 0) continue;
+
+        const Record* record = reinterpret_cast<const Record*>(records + entry.second);
+        matches.push_back({entry.first, frecency(*record, now) * quality});
+    }
+
+    auto better = [](const Match& a, const Match& b) {
+        return a.score != b.score ? a.score > b.score : a.path < b.path;
+    };
+    if (matches.size() > max_results) {
+        std::partial_sort(matches.begin(), matches.begin() + max_results, matches.end(), better);
+        matches.resize(max_results);
+    } else {
+        std::sort(matches.begin(), matches.end(), better);
+    }
+    return matches;
+}
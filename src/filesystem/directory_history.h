@@ -0,0 +1,108 @@
+#ifndef DIRECTORY_HISTORY_H
+#define DIRECTORY_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Persistent record of visited directories, ranked by frecency
+ * The database is a small file mapped read-write into memory: a header, then
+ * one record per directory holding its rank, the time of the last visit and
+ * the path. A visit updates its record in place, so recording one costs a
+ * hash lookup and a few stores. Ranks age as in z: once their sum passes a
+ * limit every rank is scaled down and directories that fall below one visit
+ * are dropped, which keeps the file at a few hundred records.
+ *
+ * Several quickView processes may share the file. Changes are made under an
+ * advisory lock, and each process picks up records the others appended, or
+ * re-reads the whole file after another one has compacted it.
+ */
+class DirectoryHistory {
+public:
+    struct Match {
+        std::filesystem::path path;
+        double score;
+    };
+
+    DirectoryHistory();
+    ~DirectoryHistory();
+
+    DirectoryHistory(const DirectoryHistory&) = delete;
+    DirectoryHistory& operator=(const DirectoryHistory&) = delete;
+
+    /**
+     * @brief Get the database location: $XDG_STATE_HOME/quickview/directories, or below ~/.local/state
+     * @return Path, or an empty path when no home directory is known
+     */
+    static std::filesystem::path getDefaultPath();
+
+    /**
+     * @brief Open the database, creating it and its directory if needed
+     * @param path Database file
+     * @return true if successful, false otherwise (see getError())
+     */
+    bool open(const std::filesystem::path& path);
+
+    /**
+     * @brief Unmap the database; changes are already in the file
+     */
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    const std::string& getError() const { return error_; }
+
+    /**
+     * @brief Record a visit to a directory
+     * @param directory Absolute path
+     * @param now Time of the visit
+     */
+    void visit(const std::filesystem::path& directory, std::time_t now = std::time(nullptr));
+
+    /**
+     * @brief Forget a directory, for example one that no longer exists
+     * @param directory Path as it was recorded
+     */
+    void remove(const std::filesystem::path& directory);
+
+    /**
+     * @brief Find the best directories for a query
+     * Words of the query must appear in the path in order, each either as a
+     * substring or with gaps, ignoring case. Tighter matches and matches in
+     * the last path component score higher; the match quality multiplies the
+     * frecency of the directory. An empty query ranks by frecency alone.
+     * @param query Typed text
+     * @param max_results Number of matches to return at most
+     * @param now Current time, for the recency weight
+     * @return Matches, best first
+     */
+    std::vector<Match> find(const std::string& query, size_t max_results, std::time_t now = std::time(nullptr));
+
+    /**
+     * @brief Number of recorded directories
+     */
+    size_t size() const { return index_.size(); }
+
+private:
+    char* data_;                // Mapping of the whole file
+    size_t mapped_size_;
+    std::string error_;
+    int fd_;
+
+    // Offset of each record by path, valid for the header generation and used size seen last
+    std::unordered_map<std::string, uint32_t> index_;
+    uint32_t indexed_generation_;
+    uint32_t indexed_used_;
+
+    void sync();
+    bool remap(size_t size);
+    bool reserve(size_t bytes);
+    void indexFrom(uint32_t offset);
+    void compact(float factor);
+};
+
+#endif // DIRECTORY_HISTORY_H
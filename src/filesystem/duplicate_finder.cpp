@@ -0,0 +1,332 @@
+#include "duplicate_finder.h"
+#include "file_key.h"
+#include "../utils/hash.h"
+#include "../utils/work_stack.h"
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace {
+    const uint64_t EDGE_SIZE = 4096;
+    const size_t READ_CHUNK = 1 << 20;
+
+    struct FileRecord {
+        uint64_t size;
+        uint64_t device;
+        uint64_t inode;
+        uint32_t directory;     // Index into the walked directory list
+        std::string name;
+    };
+
+    // One inode of a candidate size; records [first, first + links) are its hard links
+    struct Candidate {
+        size_t first;
+        size_t links;
+        uint64_t size;
+        uint64_t hash;
+        bool complete;          // The hash covers the whole file
+        bool failed;            // Unreadable, or changed while it was read
+    };
+
+    size_t defaultThreadCount() {
+        // Hashing mostly waits on the disk, so use a few threads even on small machines
+        size_t thread_count = std::thread::hardware_concurrency();
+        return std::max<size_t>(thread_count, 4);
+    }
+
+    // Run body(index, worker) for every index, spread over thread_count threads
+    void parallelFor(size_t count, size_t thread_count, const std::function<void(size_t, size_t)>& body,
+                     const DuplicateFinder::CancelCheck& cancelled) {
+        const size_t BATCH = 16;
+        std::atomic<size_t> next{0};
+
+        auto work = [&](size_t worker) {
+            for (;;) {
+                if (cancelled && cancelled()) return;
+
+                size_t begin = next.fetch_add(BATCH);
+                if (begin >= count) return;
+                size_t end = std::min(count, begin + BATCH);
+                for (size_t i = begin; i < end; i++) {
+                    body(i, worker);
+                }
+            }
+        };
+
+        thread_count = std::min(thread_count, (count + BATCH - 1) / BATCH);
+        std::vector<std::thread> threads;
+        for (size_t worker = 1; worker < thread_count; worker++) {
+            threads.emplace_back(work, worker);
+        }
+        work(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Lists a directory tree with several threads sharing a stack of unlisted directories
+     */
+    class TreeWalker {
+    public:
+        TreeWalker(DuplicateProgress& progress, const DuplicateFinder::CancelCheck& cancelled)
+            : progress_(progress)
+            , cancelled_(cancelled)
+        {
+        }
+
+        bool run(const std::filesystem::path& root, size_t thread_count,
+                 std::vector<std::filesystem::path>& directories, std::vector<FileRecord>& files) {
+            directories_ = {root};
+
+            std::vector<std::vector<FileRecord>> found(thread_count);
+            WorkStack<Directory> stack;
+            bool complete = stack.run({{0, root}}, thread_count,
+                                      [&](Directory& directory, size_t worker, std::vector<Directory>& more) {
+                listDirectory(directory, found[worker], more);
+            }, cancelled_);
+
+            directories.swap(directories_);
+            files.clear();
+            for (auto& worker_files : found) {
+                std::move(worker_files.begin(), worker_files.end(), std::back_inserter(files));
+            }
+            return complete;
+        }
+
+    private:
+        struct Directory {
+            uint32_t index;
+            std::filesystem::path path;
+        };
+
+        DuplicateProgress& progress_;
+        const DuplicateFinder::CancelCheck& cancelled_;
+        std::mutex mutex_;
+        std::vector<std::filesystem::path> directories_;
+
+        void listDirectory(const Directory& directory, std::vector<FileRecord>& files, std::vector<Directory>& more) {
+            std::error_code ec;
+            std::filesystem::directory_iterator it(directory.path, std::filesystem::directory_options::skip_permission_denied, ec);
+            for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+                // symlink_status() comes from the directory listing where the platform provides it
+                std::error_code status_ec;
+                std::filesystem::file_status status = it->symlink_status(status_ec);
+                if (status_ec) continue;
+
+                if (std::filesystem::is_directory(status)) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    more.push_back({static_cast<uint32_t>(directories_.size()), it->path()});
+                    directories_.push_back(it->path());
+                } else if (std::filesystem::is_regular_file(status)) {
+                    progress_.files_found++;
+
+                    FileKey key;
+                    if (FileKey::fromPath(it->path(), key) && key.size > 0) {
+                        files.push_back({key.size, key.device, key.inode, directory.index,
+                                         it->path().filename().string()});
+                    }
+                }
+            }
+        }
+    };
+
+    // Hash the first and last EDGE_SIZE bytes, or the whole file when that covers it
+    bool hashEdges(const std::filesystem::path& path, uint64_t size, std::vector<char>& buffer,
+                   uint64_t& hash, DuplicateProgress& progress) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+
+        size_t length = static_cast<size_t>(std::min(size, 2 * EDGE_SIZE));
+        if (size <= 2 * EDGE_SIZE) {
+            file.read(buffer.data(), length);
+        } else {
+            file.read(buffer.data(), EDGE_SIZE);
+            file.seekg(static_cast<std::streamoff>(size - EDGE_SIZE));
+            file.read(buffer.data() + EDGE_SIZE, EDGE_SIZE);
+        }
+        if (!file || file.gcount() <= 0) return false;
+
+        hash = Xxh3Hasher::hash(buffer.data(), length);
+        progress.bytes_hashed += length;
+        return true;
+    }
+
+    bool hashWhole(const std::filesystem::path& path, uint64_t size, std::vector<char>& buffer,
+                   uint64_t& hash, DuplicateProgress& progress, const DuplicateFinder::CancelCheck& cancelled) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+
+        Xxh3Hasher hasher;
+        uint64_t total = 0;
+        while (file) {
+            if (cancelled && cancelled()) return false;
+
+            file.read(buffer.data(), buffer.size());
+            std::streamsize count = file.gcount();
+            if (count > 0) {
+                hasher.update(buffer.data(), static_cast<size_t>(count));
+                total += static_cast<uint64_t>(count);
+                progress.bytes_hashed += static_cast<uint64_t>(count);
+            }
+        }
+        if (file.bad() || total != size) return false;
+
+        hash = hasher.digest();
+        return true;
+    }
+
+    bool sameContentKey(const Candidate& a, const Candidate& b) {
+        return a.size == b.size && a.hash == b.hash;
+    }
+
+    // Drop failed candidates and those whose (size, hash) matches no other candidate
+    void keepMatching(std::vector<Candidate>& candidates) {
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [](const Candidate& c) { return c.failed; }),
+                         candidates.end());
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            if (a.size != b.size) return a.size > b.size;
+            if (a.hash != b.hash) return a.hash < b.hash;
+            return a.first < b.first;
+        });
+
+        size_t kept = 0;
+        for (size_t begin = 0; begin < candidates.size();) {
+            size_t end = begin + 1;
+            while (end < candidates.size() && sameContentKey(candidates[end], candidates[begin])) end++;
+            if (end - begin >= 2) {
+                for (size_t i = begin; i < end; i++) {
+                    candidates[kept++] = candidates[i];
+                }
+            }
+            begin = end;
+        }
+        candidates.resize(kept);
+    }
+}
+
+namespace DuplicateFinder {
+    bool find(const std::filesystem::path& root, std::vector<DuplicateGroup>& groups,
+              DuplicateProgress& progress, const CancelCheck& cancelled, size_t thread_count) {
+        groups.clear();
+        if (thread_count == 0) {
+            thread_count = defaultThreadCount();
+        }
+
+        // Stage 1: walk the tree
+        progress.stage = DuplicateProgress::WALKING;
+        std::vector<std::filesystem::path> directories;
+        std::vector<FileRecord> files;
+        TreeWalker walker(progress, cancelled);
+        if (!walker.run(root, thread_count, directories, files)) {
+            return false;
+        }
+
+        // Stage 2: group by size; links to one inode are sorted next to each other
+        progress.stage = DuplicateProgress::GROUPING;
+        std::sort(files.begin(), files.end(), [](const FileRecord& a, const FileRecord& b) {
+            if (a.size != b.size) return a.size > b.size;
+            if (a.device != b.device) return a.device < b.device;
+            return a.inode < b.inode;
+        });
+
+        std::vector<Candidate> candidates;
+        for (size_t begin = 0; begin < files.size();) {
+            size_t end = begin + 1;
+            while (end < files.size() && files[end].size == files[begin].size) end++;
+
+            size_t first_candidate = candidates.size();
+            for (size_t i = begin; i < end;) {
+                size_t links = 1;
+                while (i + links < end && files[i + links].device == files[i].device &&
+                       files[i + links].inode == files[i].inode) {
+                    links++;
+                }
+                candidates.push_back({i, links, files[i].size, 0, false, false});
+                i += links;
+            }
+
+            // A size shared only by hard links has no duplicate to find
+            if (candidates.size() - first_candidate < 2) {
+                candidates.resize(first_candidate);
+            }
+            begin = end;
+        }
+
+        auto pathOf = [&](size_t record) {
+            return directories[files[record].directory] / files[record].name;
+        };
+
+        // Stage 3: hash the first and last 4 KB
+        progress.stage = DuplicateProgress::PARTIAL_HASH;
+        progress.files_hashed = 0;
+        progress.files_to_hash = candidates.size();
+        std::vector<std::vector<char>> buffers(thread_count, std::vector<char>(2 * EDGE_SIZE));
+        parallelFor(candidates.size(), thread_count, [&](size_t index, size_t worker) {
+            Candidate& candidate = candidates[index];
+            candidate.failed = !hashEdges(pathOf(candidate.first), candidate.size, buffers[worker],
+                                          candidate.hash, progress);
+            candidate.complete = candidate.size <= 2 * EDGE_SIZE;
+            progress.files_hashed++;
+        }, cancelled);
+        if (cancelled && cancelled()) return false;
+        keepMatching(candidates);
+
+        // Stage 4: hash the survivors in full
+        progress.stage = DuplicateProgress::FULL_HASH;
+        progress.files_hashed = 0;
+        progress.files_to_hash = std::count_if(candidates.begin(), candidates.end(),
+                                               [](const Candidate& c) { return !c.complete; });
+        for (auto& buffer : buffers) {
+            buffer.resize(READ_CHUNK);
+        }
+        parallelFor(candidates.size(), thread_count, [&](size_t index, size_t worker) {
+            Candidate& candidate = candidates[index];
+            if (candidate.complete) return;
+
+            candidate.failed = !hashWhole(pathOf(candidate.first), candidate.size, buffers[worker],
+                                          candidate.hash, progress, cancelled);
+            candidate.complete = true;
+            progress.files_hashed++;
+        }, cancelled);
+        if (cancelled && cancelled()) return false;
+        keepMatching(candidates);
+
+        // Equal size and full XXH3 hash make a group
+        for (size_t begin = 0; begin < candidates.size();) {
+            size_t end = begin + 1;
+            while (end < candidates.size() && sameContentKey(candidates[end], candidates[begin])) end++;
+
+            DuplicateGroup group;
+            group.size = candidates[begin].size;
+            for (size_t i = begin; i < end; i++) {
+                std::vector<std::filesystem::path> links;
+                for (size_t link = 0; link < candidates[i].links; link++) {
+                    links.push_back(pathOf(candidates[i].first + link));
+                }
+                std::sort(links.begin(), links.end());
+                group.copies.push_back(std::move(links));
+            }
+            std::sort(group.copies.begin(), group.copies.end());
+            groups.push_back(std::move(group));
+            begin = end;
+        }
+
+        std::stable_sort(groups.begin(), groups.end(), [](const DuplicateGroup& a, const DuplicateGroup& b) {
+            return a.size * (a.copies.size() - 1) > b.size * (b.copies.size() - 1);
+        });
+
+        progress.stage = DuplicateProgress::DONE;
+        return true;
+    }
+
+    uint64_t reclaimableBytes(const std::vector<DuplicateGroup>& groups) {
+        uint64_t total = 0;
+        for (const auto& group : groups) {
+            total += group.size * (group.copies.size() - 1);
+        }
+        return total;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef DUPLICATE_FINDER_H
+#define DUPLICATE_FINDER_H
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Files with identical contents
+ * Hard links to one inode are a single copy, so they are listed together
+ * and never reported as duplicates of each other.
+ */
+struct DuplicateGroup {
+    uint64_t size = 0;                                          // Size of each copy in bytes
+    std::vector<std::vector<std::filesystem::path>> copies;     // One entry per inode, holding all of its links
+};
+
+/**
+ * @brief Counters published by a running search, safe to read from any thread
+ */
+struct DuplicateProgress {
+    enum Stage { WALKING, GROUPING, PARTIAL_HASH, FULL_HASH, DONE };
+
+    std::atomic<int> stage{WALKING};
+    std::atomic<uint64_t> files_found{0};     // Regular files seen by the walk
+    std::atomic<uint64_t> files_hashed{0};    // Files hashed in the current stage
+    std::atomic<uint64_t> files_to_hash{0};   // Files the current stage will hash
+    std::atomic<uint64_t> bytes_hashed{0};    // Bytes read by both hash stages
+};
+
+/**
+ * @brief Pipelined duplicate search: size, then first and last 4 KB, then the whole file
+ * Every stage only sees the files that survived the one before it, and each
+ * stage is spread over a pool of threads.
+ */
+namespace DuplicateFinder {
+    // Returns true when the search should stop
+    using CancelCheck = std::function<bool()>;
+
+    /**
+     * @brief Find duplicate files below a directory
+     * Symbolic links are not followed and empty files are ignored. Groups are
+     * sorted by the space their extra copies take, largest first.
+     * @param root Directory to search
+     * @param groups Receives the duplicate groups
+     * @param progress Updated as the search runs
+     * @param cancelled Polled between files and between reads
+     * @param thread_count Threads per stage (0 selects one per core, at least four)
+     * @return true if the search completed, false if it was cancelled
+     */
+    bool find(const std::filesystem::path& root, std::vector<DuplicateGroup>& groups,
+              DuplicateProgress& progress, const CancelCheck& cancelled, size_t thread_count = 0);
+
+    /**
+     * @brief Bytes that deleting all but one copy of each group would free
+     * @param groups Duplicate groups
+     * @return Reclaimable bytes
+     */
+    uint64_t reclaimableBytes(const std::vector<DuplicateGroup>& groups);
+}
+
+#endif // DUPLICATE_FINDER_H
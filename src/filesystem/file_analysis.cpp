@@ -0,0 +1,189 @@
+#include "file_analysis.h"
+#include "../utils/hash.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUICKVIEW_ANALYSIS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const size_t READ_CHUNK = 1 << 20;
+
+    // Read a file front to back in large chunks
+    bool readChunks(const std::filesystem::path& file_path, std::string& error,
+                    const FileAnalyzer::CancelCheck& cancelled,
+                    const std::function<void(const char*, size_t)>& consume) {
+        std::ifstream file(file_path, std::ios::binary);
+        if (!file.is_open()) {
+            error = "Cannot open file";
+            return false;
+        }
+
+        std::vector<char> buffer(READ_CHUNK);
+        while (file) {
+            if (cancelled && cancelled()) return false;
+
+            file.read(buffer.data(), buffer.size());
+            std::streamsize count = file.gcount();
+            if (count > 0) {
+                consume(buffer.data(), static_cast<size_t>(count));
+            }
+        }
+        if (file.bad()) {
+            error = "Read error";
+            return false;
+        }
+        return true;
+    }
+
+    // Incremental UTF-8 validator (rejects overlong forms, surrogates and values past U+10FFFF)
+    class Utf8Validator {
+    public:
+        void update(const unsigned char* data, size_t size) {
+            if (!valid_) return;
+
+            size_t i = 0;
+            while (i < size) {
+#ifdef QUICKVIEW_ANALYSIS_SSE2
+                // Skip whole blocks of ASCII between sequences
+                if (needed_ == 0 && i + 16 <= size) {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    if (_mm_movemask_epi8(bytes) == 0) {
+                        i += 16;
+                        continue;
+                    }
+                }
+#endif
+                if (!step(data[i++])) {
+                    valid_ = false;
+                    return;
+                }
+            }
+        }
+
+        bool isValid() const { return valid_ && needed_ == 0; }
+        bool isAscii() const { return ascii_; }
+
+    private:
+        int needed_ = 0;
+        unsigned char low_ = 0x80;
+        unsigned char high_ = 0xBF;
+        bool valid_ = true;
+        bool ascii_ = true;
+
+        bool step(unsigned char byte) {
+            if (needed_ > 0) {
+                if (byte < low_ || byte > high_) return false;
+                low_ = 0x80;
+                high_ = 0xBF;
+                needed_--;
+                return true;
+            }
+
+            if (byte < 0x80) return true;
+            ascii_ = false;
+            if (byte >= 0xC2 && byte <= 0xDF) {
+                needed_ = 1;
+            } else if (byte >= 0xE0 && byte <= 0xEF) {
+                needed_ = 2;
+                if (byte == 0xE0) low_ = 0xA0;
+                if (byte == 0xED) high_ = 0x9F;
+            } else if (byte >= 0xF0 && byte <= 0xF4) {
+                needed_ = 3;
+                if (byte == 0xF0) low_ = 0x90;
+                if (byte == 0xF4) high_ = 0x8F;
+            } else {
+                return false;
+            }
+            return true;
+        }
+    };
+}
+
+namespace FileAnalyzer {
+    uint64_t countNewlines(const char* data, size_t size) {
+        uint64_t count = 0;
+        size_t i = 0;
+#ifdef QUICKVIEW_ANALYSIS_SSE2
+        // Each match subtracts -1 from a byte counter; flush before the counters can wrap
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i zero = _mm_setzero_si128();
+        while (i + 16 <= size) {
+            size_t blocks = std::min<size_t>((size - i) / 16, 255);
+            __m128i counters = zero;
+            for (size_t b = 0; b < blocks; b++, i += 16) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(bytes, newline));
+            }
+            uint64_t sums[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), _mm_sad_epu8(counters, zero));
+            count += sums[0] + sums[1];
+        }
+#endif
+        for (; i < size; i++) {
+            count += data[i] == '\n';
+        }
+        return count;
+    }
+
+    bool analyze(const std::filesystem::path& file_path, FileAnalysis& analysis, const CancelCheck& cancelled) {
+        analysis = FileAnalysis();
+
+        Xxh3Hasher hasher;
+        Utf8Validator utf8;
+        unsigned char head[3] = {0, 0, 0};
+        bool has_nul = false;
+        char last_byte = '\n';
+
+        bool ok = readChunks(file_path, analysis.error, cancelled, [&](const char* data, size_t size) {
+            if (analysis.size < sizeof(head)) {
+                size_t count = std::min(size, sizeof(head) - static_cast<size_t>(analysis.size));
+                memcpy(head + analysis.size, data, count);
+            }
+            analysis.size += size;
+
+            hasher.update(data, size);
+            analysis.line_count += countNewlines(data, size);
+            if (!has_nul && memchr(data, 0, size)) has_nul = true;
+            utf8.update(reinterpret_cast<const unsigned char*>(data), size);
+            last_byte = data[size - 1];
+        });
+        if (!ok) return false;
+
+        analysis.xxh3 = hasher.digest();
+        if (last_byte != '\n') analysis.line_count++;
+
+        // Byte order marks decide first; UTF-16 text is full of NUL bytes
+        if (analysis.size >= 2 && head[0] == 0xFF && head[1] == 0xFE) {
+            analysis.encoding = "UTF-16LE";
+        } else if (analysis.size >= 2 && head[0] == 0xFE && head[1] == 0xFF) {
+            analysis.encoding = "UTF-16BE";
+        } else if (has_nul) {
+            analysis.binary = true;
+        } else if (utf8.isAscii()) {
+            analysis.encoding = "ASCII";
+        } else if (utf8.isValid()) {
+            bool bom = analysis.size >= 3 && head[0] == 0xEF && head[1] == 0xBB && head[2] == 0xBF;
+            analysis.encoding = bom ? "UTF-8 with BOM" : "UTF-8";
+        } else {
+            analysis.encoding = "8-bit";
+        }
+        return true;
+    }
+
+    bool computeSha256(const std::filesystem::path& file_path, std::string& digest, std::string& error,
+                       const CancelCheck& cancelled) {
+        Sha256Hasher hasher;
+        bool ok = readChunks(file_path, error, cancelled, [&](const char* data, size_t size) {
+            hasher.update(data, size);
+        });
+        if (!ok) return false;
+
+        digest = hasher.finish();
+        return true;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef FILE_ANALYSIS_H
+#define FILE_ANALYSIS_H
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief Content statistics for the info panel
+ */
+struct FileAnalysis {
+    uint64_t size = 0;          // Bytes read
+    uint64_t line_count = 0;    // Newlines, plus one for an unterminated last line
+    uint64_t xxh3 = 0;          // XXH3-64 of the whole file
+    std::string sha256;         // Hex digest, empty until requested
+    std::string encoding;       // "ASCII", "UTF-8", "UTF-8 with BOM", "UTF-16LE", "UTF-16BE" or "8-bit"
+    bool binary = false;        // Contains NUL bytes outside a UTF-16 file
+    std::string error;          // Set when the file could not be read
+};
+
+/**
+ * @brief Whole-file analysis with large sequential reads
+ */
+namespace FileAnalyzer {
+    // Returns true when the caller no longer needs the result
+    using CancelCheck = std::function<bool()>;
+
+    /**
+     * @brief Hash the file, count lines and classify its encoding in a single pass
+     * @param file_path Path to the file
+     * @param analysis Receives the results
+     * @param cancelled Polled between reads; analysis stops early when it returns true
+     * @return true if the whole file was analyzed, false on error or cancellation
+     */
+    bool analyze(const std::filesystem::path& file_path, FileAnalysis& analysis, const CancelCheck& cancelled);
+
+    /**
+     * @brief Compute the SHA-256 digest of a file
+     * @param file_path Path to the file
+     * @param digest Receives the lowercase hex digest
+     * @param error Receives a description on failure
+     * @param cancelled Polled between reads
+     * @return true if successful, false on error or cancellation
+     */
+    bool computeSha256(const std::filesystem::path& file_path, std::string& digest, std::string& error,
+                       const CancelCheck& cancelled);
+
+    /**
+     * @brief Count newline bytes in a buffer
+     * @param data Bytes to scan
+     * @param size Number of bytes
+     * @return Number of '\n' bytes
+     */
+    uint64_t countNewlines(const char* data, size_t size);
+}
+
+#endif // FILE_ANALYSIS_H
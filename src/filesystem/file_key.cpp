@@ -0,0 +1,36 @@
+#include "file_key.h"
+#include <functional>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+bool FileKey::fromPath(const std::filesystem::path& path, FileKey& key) {
+#ifdef _WIN32
+    // No inode numbers through the standard library: hash the path instead
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto write_time = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+
+    key.device = 0;
+    key.inode = std::hash<std::wstring>{}(path.native());
+    key.mtime_ns = static_cast<int64_t>(write_time.time_since_epoch().count());
+    key.size = static_cast<uint64_t>(size);
+    return true;
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+
+    key.device = static_cast<uint64_t>(st.st_dev);
+    key.inode = static_cast<uint64_t>(st.st_ino);
+#ifdef __APPLE__
+    key.mtime_ns = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    key.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    key.size = static_cast<uint64_t>(st.st_size);
+    return true;
+#endif
+}
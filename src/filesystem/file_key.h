@@ -0,0 +1,47 @@
+#ifndef FILE_KEY_H
+#define FILE_KEY_H
+
+#include <filesystem>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Identity of a file's current contents (device, inode, mtime and size)
+ * Two keys compare equal only if they name the same file and it has not been
+ * modified in between, which makes them suitable as cache keys.
+ */
+struct FileKey {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    int64_t mtime_ns = 0;
+    uint64_t size = 0;
+
+    bool operator==(const FileKey& other) const {
+        return device == other.device && inode == other.inode &&
+               mtime_ns == other.mtime_ns && size == other.size;
+    }
+    bool operator!=(const FileKey& other) const { return !(*this == other); }
+
+    /**
+     * @brief Stat a file and build its key
+     * @param path Path to the file
+     * @param key Receives the key
+     * @return true if the file could be stat'ed
+     */
+    static bool fromPath(const std::filesystem::path& path, FileKey& key);
+};
+
+/**
+ * @brief Hash functor so FileKey can key unordered containers
+ */
+struct FileKeyHash {
+    size_t operator()(const FileKey& key) const {
+        uint64_t h = key.inode * 0x9E3779B97F4A7C15ull;
+        h ^= key.device + 0x7F4A7C159E3779B9ull + (h << 6) + (h >> 2);
+        h ^= static_cast<uint64_t>(key.mtime_ns) + (h << 6) + (h >> 2);
+        h ^= key.size + (h << 6) + (h >> 2);
+        return static_cast<size_t>(h);
+    }
+};
+
+#endif // FILE_KEY_H
@@ -1,12 +1,13 @@
 #include "file_operations.h"
-#include "../utils/utils.h"
+#include "../utils/log.h"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <fstream>
 
 namespace FileOperations {
     std::string loadDirectory(const std::filesystem::path& path, 
-                             std::vector<std::filesystem::directory_entry>& entries,
-                             bool debug_enabled) {
+                             std::vector<std::filesystem::directory_entry>& entries) {
         try {
             entries.clear();
             entries.reserve(1000); // Reserve space to avoid reallocations
@@ -20,7 +21,7 @@ namespace FileOperations {
             std::error_code ec;
             for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
                 if (ec) {
-                    Utils::debugPrint(debug_enabled, "Error reading directory entry: %s\n", ec.message().c_str());
+                    Log::warning("Error reading directory entry: %s", ec.message());
                     continue;
                 }
                 
@@ -31,40 +32,44 @@ namespace FileOperations {
                 }
             }
             
-            // Fast sort with optimized comparator
-            std::sort(entries.begin(), entries.end(),
-                      [debug_enabled](const std::filesystem::directory_entry& a, const std::filesystem::directory_entry& b) {
-                          // Cache the directory status to avoid repeated filesystem calls
-                          std::error_code ec_a, ec_b;
-                          bool a_is_dir = a.is_directory(ec_a);
-                          bool b_is_dir = b.is_directory(ec_b);
-                          
-                          // Handle errors gracefully
-                          if (ec_a || ec_b) {
-                              return a.path().filename().string() < b.path().filename().string();
-                          }
-                          
-                          // Directories come first
-                          if (a_is_dir && !b_is_dir) return true;
-                          if (!a_is_dir && b_is_dir) return false;
-                          
-                          // Within same type, sort alphabetically (case-insensitive)
-                          std::string name_a = a.path().filename().string();
-                          std::string name_b = b.path().filename().string();
-                          std::transform(name_a.begin(), name_a.end(), name_a.begin(), ::tolower);
-                          std::transform(name_b.begin(), name_b.end(), name_b.begin(), ::tolower);
-                          return name_a < name_b;
-                      });
-            
-            Utils::debugPrint(debug_enabled, "Loaded directory: %s (%zu entries)\n", path.string().c_str(), entries.size());
+            sortEntries(entries);
+
+            LOG_DEBUG("Loaded directory: %s (%zu entries)", path, entries.size());
             
             return "Loaded " + std::to_string(entries.size()) + " entries";
             
         } catch (const std::exception& e) {
-            Utils::debugPrint(debug_enabled, "Error loading directory %s: %s\n", path.string().c_str(), e.what());
+            Log::warning("Error loading directory %s: %s", path, e.what());
             return "Error loading directory: " + std::string(e.what());
         }
     }
+
+    void sortEntries(std::vector<std::filesystem::directory_entry>& entries) {
+        // Fast sort with optimized comparator
+        std::sort(entries.begin(), entries.end(),
+                  [](const std::filesystem::directory_entry& a, const std::filesystem::directory_entry& b) {
+                      // Cache the directory status to avoid repeated filesystem calls
+                      std::error_code ec_a, ec_b;
+                      bool a_is_dir = a.is_directory(ec_a);
+                      bool b_is_dir = b.is_directory(ec_b);
+
+                      // Handle errors gracefully
+                      if (ec_a || ec_b) {
+                          return a.path().filename().string() < b.path().filename().string();
+                      }
+
+                      // Directories come first
+                      if (a_is_dir && !b_is_dir) return true;
+                      if (!a_is_dir && b_is_dir) return false;
+
+                      // Within same type, sort alphabetically (case-insensitive)
+                      std::string name_a = a.path().filename().string();
+                      std::string name_b = b.path().filename().string();
+                      std::transform(name_a.begin(), name_a.end(), name_a.begin(), ::tolower);
+                      std::transform(name_b.begin(), name_b.end(), name_b.begin(), ::tolower);
+                      return name_a < name_b;
+                  });
+    }
     
     bool loadDirectoryPreview(const std::filesystem::path& dir_path,
                              std::vector<std::filesystem::directory_entry>& preview_entries,
@@ -111,4 +116,57 @@ namespace FileOperations {
             return false;
         }
     }
+
+    std::string toDisplayLine(const char* data, size_t length) {
+        std::string display_line;
+        display_line.reserve(length);
+        for (size_t i = 0; i < length; i++) {
+            char c = data[i];
+            if (c == '\t') {
+                display_line += "    ";  // 4 spaces for tab
+            } else if (c >= 32) {  // Printable characters
+                display_line += c;
+            } else if (c != '\r') {
+                display_line += '.';  // Replace non-printable with dot
+            }
+        }
+        return display_line;
+    }
+
+    bool loadTextPreview(const std::filesystem::path& file_path,
+                        TextPreview& preview,
+                        size_t max_bytes,
+                        size_t max_lines) {
+        preview = TextPreview();
+
+        std::ifstream file(file_path, std::ios::binary);
+        if (!file.is_open()) {
+            preview.error = "Cannot open file";
+            return false;
+        }
+
+        // One bounded read; a preview never needs more than a screenful
+        std::string buffer(max_bytes, '\0');
+        file.read(&buffer[0], static_cast<std::streamsize>(max_bytes));
+        size_t length = static_cast<size_t>(file.gcount());
+        buffer.resize(length);
+        preview.truncated = length == max_bytes && file.peek() != std::char_traits<char>::eof();
+
+        if (memchr(buffer.data(), '\0', length) != nullptr) {
+            preview.binary = true;
+            return true;
+        }
+
+        size_t line_start = 0;
+        while (line_start < length && preview.lines.size() < max_lines) {
+            const char* newline = static_cast<const char*>(memchr(buffer.data() + line_start, '\n', length - line_start));
+            size_t line_end = newline ? static_cast<size_t>(newline - buffer.data()) : length;
+            preview.lines.push_back(toDisplayLine(buffer.data() + line_start, line_end - line_start));
+            line_start = line_end + 1;
+        }
+        if (line_start < length) {
+            preview.truncated = true;
+        }
+        return true;
+    }
 }
@@ -5,6 +5,16 @@
 #include <vector>
 #include <string>
 
+/**
+ * @brief First screenful of a text file, shown in the content pane
+ */
+struct TextPreview {
+    std::vector<std::string> lines;
+    bool binary = false;      // File contains NUL bytes; no lines are kept
+    bool truncated = false;   // File continues past the bytes that were read
+    std::string error;        // Set when the file could not be read
+};
+
 /**
  * @brief File and directory operations
  */
@@ -13,12 +23,17 @@ namespace FileOperations {
      * @brief Load directory contents into a vector
      * @param path Directory path to load
      * @param entries Vector to store directory entries
-     * @param debug_enabled Whether debug output is enabled
      * @return Status message describing the result
      */
     std::string loadDirectory(const std::filesystem::path& path, 
-                             std::vector<std::filesystem::directory_entry>& entries,
-                             bool debug_enabled);
+                             std::vector<std::filesystem::directory_entry>& entries);
+
+    /**
+     * @brief Sort entries the way the file browser lists them
+     * Directories first, then case-insensitive by name.
+     * @param entries Entries to sort in place
+     */
+    void sortEntries(std::vector<std::filesystem::directory_entry>& entries);
     
     /**
      * @brief Load directory contents for preview (limited entries)
@@ -30,6 +45,27 @@ namespace FileOperations {
     bool loadDirectoryPreview(const std::filesystem::path& dir_path,
                              std::vector<std::filesystem::directory_entry>& preview_entries,
                              int max_entries = 200);
+
+    /**
+     * @brief Convert raw bytes to a printable line (tabs expanded, control characters as '.')
+     * @param data Line bytes without the newline
+     * @param length Number of bytes
+     * @return Display line
+     */
+    std::string toDisplayLine(const char* data, size_t length);
+
+    /**
+     * @brief Read the beginning of a file for preview with a single bounded read
+     * @param file_path File to read
+     * @param preview Receives the preview lines or error
+     * @param max_bytes Maximum number of bytes to read
+     * @param max_lines Maximum number of lines to keep
+     * @return true if successful, false on error
+     */
+    bool loadTextPreview(const std::filesystem::path& file_path,
+                        TextPreview& preview,
+                        size_t max_bytes = 16 * 1024,
+                        size_t max_lines = 200);
 }
 
 #endif // FILE_OPERATIONS_H
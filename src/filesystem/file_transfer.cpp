@@ -0,0 +1,750 @@
+#include "file_transfer.h"
+#include "../utils/work_stack.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
+namespace {
+    // Bytes per copy_file_range or read call; a job can be cancelled between chunks
+    const size_t COPY_CHUNK = 8 << 20;
+    const size_t BUFFER_SIZE = 1 << 20;
+
+    size_t defaultThreadCount() {
+        // Copying mostly waits on the disks, so use a few threads even on small machines
+        size_t thread_count = std::thread::hardware_concurrency();
+        return std::max<size_t>(thread_count, 4);
+    }
+
+    struct CopyItem {
+        std::filesystem::path source;
+        std::filesystem::path target;
+        size_t root = 0;            // Index of the job source it belongs to
+    };
+
+    // Counts failures, keeps the first message and remembers which job sources had any
+    class Failures {
+    public:
+        Failures(TransferProgress& progress, size_t roots)
+            : progress_(progress), failed_(roots, false) {}
+
+        void add(size_t root, const std::string& message) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            progress_.errors++;
+            if (first_.empty()) first_ = message;
+            failed_[root] = true;
+        }
+
+        bool failed(size_t root) const { return failed_[root]; }
+        const std::string& first() const { return first_; }
+
+    private:
+        TransferProgress& progress_;
+        std::mutex mutex_;
+        std::vector<bool> failed_;
+        std::string first_;
+    };
+
+    std::string describe(const std::filesystem::path& path, const std::string& reason) {
+        return path.string() + ": " + reason;
+    }
+
+    bool isCancelled(const FileTransfer::CancelCheck& cancelled) {
+        return cancelled && cancelled();
+    }
+
+    // Check whether path is root or lies below it
+    bool isWithin(const std::filesystem::path& path, const std::filesystem::path& root) {
+        std::error_code ec;
+        std::filesystem::path inner = std::filesystem::weakly_canonical(path, ec);
+        if (ec) inner = path.lexically_normal();
+        std::filesystem::path outer = std::filesystem::weakly_canonical(root, ec);
+        if (ec) outer = root.lexically_normal();
+        return std::mismatch(outer.begin(), outer.end(), inner.begin(), inner.end()).first == outer.end();
+    }
+
+    // Rename an entry on one filesystem, failing with file_exists rather than replacing the target
+    void renameNoReplace(const std::filesystem::path& source, const std::filesystem::path& target,
+                         std::error_code& ec) {
+#if defined(__linux__) && defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 28)
+        if (renameat2(AT_FDCWD, source.c_str(), AT_FDCWD, target.c_str(), RENAME_NOREPLACE) == 0) {
+            ec.clear();
+            return;
+        }
+        if (errno != EINVAL && errno != ENOSYS) {
+            ec = std::error_code(errno, std::generic_category());
+            return;
+        }
+        // The kernel or the filesystem cannot refuse to replace: check just before renaming instead
+#endif
+        if (std::filesystem::exists(std::filesystem::symlink_status(target, ec))) {
+            ec = std::make_error_code(std::errc::file_exists);
+            return;
+        }
+        std::filesystem::rename(source, target, ec);
+    }
+
+#ifndef _WIN32
+    std::string describe(const std::filesystem::path& path, int error_number) {
+        return describe(path, std::error_code(error_number, std::generic_category()).message());
+    }
+
+    bool writeAll(int out, const char* data, size_t length, off_t offset, int& error_number) {
+        while (length > 0) {
+            ssize_t written = pwrite(out, data, length, offset);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                error_number = errno;
+                return false;
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+            offset += written;
+        }
+        return true;
+    }
+
+    // Copy a byte range at the same offset, in the kernel where it can and through a buffer otherwise.
+    // Returns false on failure (error_number set) or when cancelled (error_number left at 0).
+    bool copyRange(int in, int out, off_t offset, off_t end, bool& kernel_copy, std::vector<char>& buffer,
+                   TransferProgress& progress, const FileTransfer::CancelCheck& cancelled, int& error_number) {
+        while (offset < end) {
+            if (isCancelled(cancelled)) return false;
+
+            size_t chunk = static_cast<size_t>(std::min<off_t>(end - offset, COPY_CHUNK));
+            ssize_t copied = -1;
+#ifdef __linux__
+            if (kernel_copy) {
+                off_t in_offset = offset;
+                off_t out_offset = offset;
+                copied = copy_file_range(in, &in_offset, out, &out_offset, chunk, 0);
+                if (copied < 0) {
+                    if (errno == EINTR) continue;
+                    if (errno != EXDEV && errno != ENOSYS && errno != EOPNOTSUPP && errno != EINVAL) {
+                        error_number = errno;
+                        return false;
+                    }
+                    // Not possible between these two files; the rest goes through user space
+                    kernel_copy = false;
+                }
+            }
+#else
+            kernel_copy = false;
+#endif
+            if (!kernel_copy) {
+                if (buffer.empty()) buffer.resize(BUFFER_SIZE);
+                copied = pread(in, buffer.data(), std::min(chunk, buffer.size()), offset);
+                if (copied < 0) {
+                    if (errno == EINTR) continue;
+                    error_number = errno;
+                    return false;
+                }
+                if (!writeAll(out, buffer.data(), static_cast<size_t>(copied), offset, error_number)) return false;
+            }
+
+            // The source shrank while it was being copied
+            if (copied == 0) break;
+            offset += copied;
+            progress.bytes_done += static_cast<uint64_t>(copied);
+        }
+        return true;
+    }
+
+    bool copyData(int in, int out, const struct stat& status, TransferProgress& progress,
+                  const FileTransfer::CancelCheck& cancelled, int& error_number) {
+        bool kernel_copy = true;
+        std::vector<char> buffer;
+        off_t size = status.st_size;
+        off_t offset = 0;
+
+#ifdef SEEK_HOLE
+        // Fewer blocks allocated than the size needs means holes: copy only the extents holding data
+        if (static_cast<off_t>(status.st_blocks) * 512 < size) {
+            while (offset < size) {
+                off_t data = lseek(in, offset, SEEK_DATA);
+                if (data < 0) {
+                    // ENXIO: only a hole is left. Anything else: no hole support, copy the rest in full
+                    if (errno != ENXIO) break;
+                    data = size;
+                }
+                off_t hole = data < size ? lseek(in, data, SEEK_HOLE) : size;
+                if (hole < 0) hole = size;
+
+                progress.bytes_done += static_cast<uint64_t>(data - offset);
+                if (!copyRange(in, out, data, hole, kernel_copy, buffer, progress, cancelled, error_number)) {
+                    return false;
+                }
+                offset = hole;
+            }
+        }
+#endif
+        if (!copyRange(in, out, offset, size, kernel_copy, buffer, progress, cancelled, error_number)) return false;
+
+        // Leaves a trailing hole as a hole
+        if (ftruncate(out, size) != 0) {
+            error_number = errno;
+            return false;
+        }
+        return true;
+    }
+
+    // Names unlinked per work item when a large directory is emptied by several threads
+    const size_t REMOVE_BATCH = 4096;
+
+    const int DIRECTORY_FLAGS = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+
+    // A directory being removed. Its descriptor normally stays open until
+    // everything below it is gone; whichever thread finishes the last piece of
+    // work below it then removes it from its parent. When the process runs out
+    // of descriptors, those of the directories above that no thread is using
+    // are closed, and reopened once they are needed again.
+    struct RemoveNode {
+        std::shared_ptr<RemoveNode> parent;     // Null for a directory the job sources are listed in
+        std::string name;                       // Name in the parent; the full path without one
+        size_t root = 0;                        // Job source it belongs to
+        std::mutex mutex;                       // Guards fd and users
+        int fd = -1;                            // -1 before it is opened and while it is closed
+        size_t users = 0;                       // Threads using fd at the moment
+        dev_t device = 0;                       // Identity a reopened descriptor must match
+        ino_t inode = 0;
+        std::atomic<size_t> pending{1};         // Work items on it or below it, its own listing included
+        std::atomic<bool> failed{false};        // Something below it stays, so it cannot be removed
+
+        ~RemoveNode() {
+            if (fd >= 0) close(fd);
+        }
+    };
+
+    struct RemoveItem {
+        std::shared_ptr<RemoveNode> directory;
+        std::vector<std::string> names;         // Non-directories to unlink in it; empty to list it
+    };
+
+    std::filesystem::path pathOf(const RemoveNode& node) {
+        return node.parent ? pathOf(*node.parent) / node.name : std::filesystem::path(node.name);
+    }
+
+    // Close the descriptors no thread is using among node and the directories above it.
+    // Returns false when there was none to close.
+    bool closeIdle(RemoveNode* node) {
+        bool closed = false;
+        for (; node; node = node->parent.get()) {
+            std::lock_guard<std::mutex> lock(node->mutex);
+            if (node->fd >= 0 && node->users == 0) {
+                close(node->fd);
+                node->fd = -1;
+                closed = true;
+            }
+        }
+        return closed;
+    }
+
+    // Call open, which returns a descriptor, until it succeeds or fails for a reason other than
+    // running out of descriptors; idle ones from near upwards are closed before each new attempt
+    template <typename Open>
+    int openRetrying(RemoveNode* near, const Open& open) {
+        for (;;) {
+            int fd = open();
+            if (fd >= 0 || (errno != EMFILE && errno != ENFILE) || !closeIdle(near)) return fd;
+        }
+    }
+
+    void putDescriptor(RemoveNode& node) {
+        std::lock_guard<std::mutex> lock(node.mutex);
+        node.users--;
+    }
+
+    // Take a use of a directory's descriptor, to be given back with putDescriptor(). A closed
+    // descriptor is reopened through ".." of child_fd when given, as fts does, since that needs
+    // neither the path nor the directories above; otherwise from the parent.
+    // Returns -1 with errno set when it cannot be reopened.
+    int takeDescriptor(RemoveNode& node, int child_fd = -1) {
+        std::lock_guard<std::mutex> lock(node.mutex);
+        if (node.fd < 0) {
+            int fd = -1;
+            if (child_fd >= 0) {
+                fd = openRetrying(node.parent.get(), [&] { return openat(child_fd, "..", DIRECTORY_FLAGS); });
+            } else if (node.parent) {
+                int parent_fd = takeDescriptor(*node.parent);
+                if (parent_fd < 0) return -1;
+                fd = openRetrying(node.parent.get(), [&] {
+                    return openat(parent_fd, node.name.c_str(), DIRECTORY_FLAGS | O_NOFOLLOW);
+                });
+                int error_number = errno;
+                putDescriptor(*node.parent);
+                errno = error_number;
+            } else {
+                fd = openRetrying(nullptr, [&] { return open(node.name.c_str(), DIRECTORY_FLAGS); });
+            }
+            if (fd < 0) return -1;
+
+            // The directory was moved or replaced while it was closed
+            struct stat status;
+            if (fstat(fd, &status) != 0 || status.st_dev != node.device || status.st_ino != node.inode) {
+                close(fd);
+                errno = ENOENT;
+                return -1;
+            }
+            node.fd = fd;
+        }
+        node.users++;
+        return node.fd;
+    }
+
+    void unlinkNames(RemoveNode& directory, int fd, const std::vector<std::string>& names,
+                     TransferProgress& progress, Failures& failures, const FileTransfer::CancelCheck& cancelled) {
+        for (size_t i = 0; i < names.size(); i++) {
+            if (i % 256 == 0 && isCancelled(cancelled)) {
+                directory.failed = true;
+                return;
+            }
+            if (unlinkat(fd, names[i].c_str(), 0) == 0) {
+                progress.files_done++;
+            } else {
+                failures.add(directory.root, describe(pathOf(directory) / names[i], errno));
+                directory.failed = true;
+            }
+        }
+    }
+
+    // Finish one piece of work on a directory, removing it and then its parents as they become empty
+    void release(RemoveNode* node, TransferProgress& progress, Failures& failures) {
+        while (node->parent && --node->pending == 0) {
+            RemoveNode& parent = *node->parent;
+            int parent_fd = node->failed ? -1 : takeDescriptor(parent, node->fd);
+            int error_number = errno;
+            {
+                std::lock_guard<std::mutex> lock(node->mutex);
+                if (node->fd >= 0) close(node->fd);
+                node->fd = -1;
+            }
+
+            if (node->failed) {
+                parent.failed = true;
+            } else if (parent_fd < 0) {
+                failures.add(node->root, describe(pathOf(parent), error_number));
+                parent.failed = true;
+            } else {
+                if (unlinkat(parent_fd, node->name.c_str(), AT_REMOVEDIR) == 0) {
+                    progress.files_done++;
+                } else {
+                    failures.add(node->root, describe(pathOf(*node), errno));
+                    parent.failed = true;
+                }
+                putDescriptor(parent);
+            }
+            node = &parent;
+        }
+    }
+
+    // List a directory: subdirectories become work items of their own, other entries are unlinked
+    void removeDirectory(RemoveItem& item, std::vector<RemoveItem>& more, TransferProgress& progress,
+                         Failures& failures, const FileTransfer::CancelCheck& cancelled) {
+        RemoveNode& node = *item.directory;
+        if (!item.names.empty()) {
+            int fd = takeDescriptor(node);
+            if (fd < 0) {
+                failures.add(node.root, describe(pathOf(node), errno));
+                node.failed = true;
+            } else {
+                unlinkNames(node, fd, item.names, progress, failures, cancelled);
+                putDescriptor(node);
+            }
+            release(&node, progress, failures);
+            return;
+        }
+
+        // O_NOFOLLOW: a directory replaced by a link since it was listed is not entered
+        int fd = -1;
+        int parent_fd = takeDescriptor(*node.parent);
+        if (parent_fd >= 0) {
+            fd = openRetrying(node.parent.get(), [&] {
+                return openat(parent_fd, node.name.c_str(), DIRECTORY_FLAGS | O_NOFOLLOW);
+            });
+            int error_number = errno;
+            putDescriptor(*node.parent);
+            errno = error_number;
+        }
+        struct stat status;
+        if (fd >= 0 && fstat(fd, &status) != 0) {
+            close(fd);
+            fd = -1;
+        }
+        int list_fd = -1;
+        if (fd >= 0) {
+            node.device = status.st_dev;
+            node.inode = status.st_ino;
+            {
+                std::lock_guard<std::mutex> lock(node.mutex);
+                node.fd = fd;
+                node.users = 1;
+            }
+            list_fd = openRetrying(node.parent.get(), [&] { return fcntl(fd, F_DUPFD_CLOEXEC, 0); });
+        }
+        DIR* dir = list_fd >= 0 ? fdopendir(list_fd) : nullptr;
+        if (!dir) {
+            failures.add(node.root, describe(pathOf(node), errno));
+            if (list_fd >= 0) close(list_fd);
+            if (fd >= 0) putDescriptor(node);
+            node.failed = true;
+            release(&node, progress, failures);
+            return;
+        }
+
+        // Names are collected before anything is unlinked, so that the listing is not read while it changes
+        std::vector<std::string> names;
+        while (struct dirent* entry = readdir(dir)) {
+            const char* name = entry->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+            bool directory = entry->d_type == DT_DIR;
+            if (entry->d_type == DT_UNKNOWN) {
+                struct stat entry_status;
+                directory = fstatat(fd, name, &entry_status, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(entry_status.st_mode);
+            }
+            if (directory) {
+                auto child = std::make_shared<RemoveNode>();
+                child->parent = item.directory;
+                child->name = name;
+                child->root = node.root;
+                node.pending++;
+                more.push_back({std::move(child), {}});
+            } else {
+                names.push_back(name);
+            }
+        }
+        closedir(dir);
+
+        // A large directory is emptied by several threads, one batch of names each
+        if (names.size() > REMOVE_BATCH) {
+            for (size_t begin = 0; begin < names.size(); begin += REMOVE_BATCH) {
+                size_t end = std::min(begin + REMOVE_BATCH, names.size());
+                node.pending++;
+                more.push_back({item.directory, std::vector<std::string>(names.begin() + begin, names.begin() + end)});
+            }
+        } else {
+            unlinkNames(node, fd, names, progress, failures, cancelled);
+        }
+        putDescriptor(node);
+        release(&node, progress, failures);
+    }
+
+    void copyAttributes(int out, const struct stat& status) {
+        // Mode and times as cp -p keeps them; ownership stays with the user copying
+        fchmod(out, status.st_mode & 07777);
+#ifdef __APPLE__
+        struct timespec times[2] = {status.st_atimespec, status.st_mtimespec};
+#else
+        struct timespec times[2] = {status.st_atim, status.st_mtim};
+#endif
+        futimens(out, times);
+    }
+#endif
+
+    // Add up the entries and bytes below the roots, for the percentage shown while copying
+    void scan(const std::vector<CopyItem>& roots, TransferProgress& progress,
+              const FileTransfer::CancelCheck& cancelled, size_t thread_count) {
+        std::vector<std::filesystem::path> initial;
+        for (const CopyItem& root : roots) {
+            initial.push_back(root.source);
+        }
+
+        WorkStack<std::filesystem::path> stack;
+        stack.run(std::move(initial), thread_count,
+                  [&](std::filesystem::path& path, size_t, std::vector<std::filesystem::path>& more) {
+            std::error_code ec;
+            std::filesystem::file_status status = std::filesystem::symlink_status(path, ec);
+            if (ec) return;
+            progress.files_total++;
+            if (std::filesystem::is_regular_file(status)) {
+                uint64_t size = std::filesystem::file_size(path, ec);
+                if (!ec) progress.bytes_total += size;
+            } else if (std::filesystem::is_directory(status)) {
+                std::filesystem::directory_iterator it(path, ec);
+                for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+                    more.push_back(it->path());
+                }
+            }
+        }, cancelled);
+    }
+
+    // Remove the given job sources with everything below them
+    void removeTrees(const FileJob& job, const std::vector<size_t>& sources, TransferProgress& progress,
+                     Failures& failures, const FileTransfer::CancelCheck& cancelled, size_t thread_count) {
+        progress.stage = TransferProgress::REMOVING;
+#ifdef _WIN32
+        for (size_t i : sources) {
+            if (isCancelled(cancelled)) return;
+            std::error_code ec;
+            std::uintmax_t removed = std::filesystem::remove_all(job.sources[i], ec);
+            if (ec) {
+                failures.add(i, describe(job.sources[i], ec.message()));
+            } else {
+                progress.files_done += removed;
+            }
+        }
+#else
+        // Everything is opened relative to the directory a source is listed in, opened once per directory
+        std::vector<std::shared_ptr<RemoveNode>> listed;
+        std::vector<RemoveItem> initial;
+        for (size_t i : sources) {
+            if (isCancelled(cancelled)) return;
+            std::filesystem::path parent = job.sources[i].parent_path();
+            std::string name = job.sources[i].filename().string();
+            auto found = std::find_if(listed.begin(), listed.end(), [&](const std::shared_ptr<RemoveNode>& node) {
+                return node->name == parent.string();
+            });
+            if (found == listed.end()) {
+                auto node = std::make_shared<RemoveNode>();
+                node->name = parent.string();
+                node->fd = open(parent.c_str(), DIRECTORY_FLAGS);
+                struct stat status;
+                if (node->fd >= 0 && fstat(node->fd, &status) == 0) {
+                    node->device = status.st_dev;
+                    node->inode = status.st_ino;
+                }
+                found = listed.insert(listed.end(), node);
+            }
+            const std::shared_ptr<RemoveNode>& directory = *found;
+            if (directory->fd < 0) {
+                failures.add(i, describe(parent, errno));
+                continue;
+            }
+
+            // A link to a directory is removed itself, never what it points to
+            struct stat status;
+            if (fstatat(directory->fd, name.c_str(), &status, AT_SYMLINK_NOFOLLOW) != 0) {
+                failures.add(i, describe(job.sources[i], errno));
+            } else if (S_ISDIR(status.st_mode)) {
+                auto node = std::make_shared<RemoveNode>();
+                node->parent = directory;
+                node->name = name;
+                node->root = i;
+                initial.push_back({std::move(node), {}});
+            } else if (unlinkat(directory->fd, name.c_str(), 0) == 0) {
+                progress.files_done++;
+            } else {
+                failures.add(i, describe(job.sources[i], errno));
+            }
+        }
+
+        WorkStack<RemoveItem> stack;
+        stack.run(std::move(initial), thread_count, [&](RemoveItem& item, size_t, std::vector<RemoveItem>& more) {
+            removeDirectory(item, more, progress, failures, cancelled);
+        }, cancelled);
+#endif
+    }
+
+    // Mode and modification time of a copied directory, applied once everything inside it was copied
+    struct DirectoryAttributes {
+        std::filesystem::path target;
+        std::filesystem::perms permissions;
+        std::filesystem::file_time_type modified;
+        bool has_time;
+    };
+
+    // Copy the trees below the roots, one entry per work item so that files are copied in parallel
+    void copyTrees(const std::vector<CopyItem>& roots, TransferProgress& progress, Failures& failures,
+                   const FileTransfer::CancelCheck& cancelled, size_t thread_count) {
+        std::mutex directories_mutex;
+        std::vector<DirectoryAttributes> directories;
+
+        WorkStack<CopyItem> stack;
+        stack.run(roots, thread_count, [&](CopyItem& item, size_t, std::vector<CopyItem>& more) {
+            std::error_code ec;
+            std::filesystem::file_status status = std::filesystem::symlink_status(item.source, ec);
+            if (ec) {
+                failures.add(item.root, describe(item.source, ec.message()));
+                return;
+            }
+
+            if (std::filesystem::is_symlink(status)) {
+                std::filesystem::path link = std::filesystem::read_symlink(item.source, ec);
+                if (!ec) std::filesystem::create_symlink(link, item.target, ec);
+            } else if (std::filesystem::is_directory(status)) {
+                if (!std::filesystem::create_directory(item.target, ec) && !ec) {
+                    ec = std::make_error_code(std::errc::file_exists);
+                }
+                if (!ec) {
+                    // The owner keeps write access until the entries have been created inside
+                    std::error_code mode_ec;
+                    std::filesystem::permissions(item.target, status.permissions() | std::filesystem::perms::owner_all,
+                                                 mode_ec);
+                    std::error_code time_ec;
+                    std::filesystem::file_time_type modified = std::filesystem::last_write_time(item.source, time_ec);
+                    {
+                        std::lock_guard<std::mutex> lock(directories_mutex);
+                        directories.push_back({item.target, status.permissions(), modified, !time_ec});
+                    }
+                    std::filesystem::directory_iterator it(item.source, ec);
+                    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+                        more.push_back({it->path(), item.target / it->path().filename(), item.root});
+                    }
+                }
+            } else if (std::filesystem::is_regular_file(status)) {
+                std::string error;
+                if (!FileTransfer::copyFile(item.source, item.target, progress, cancelled, error)) {
+                    if (!isCancelled(cancelled)) failures.add(item.root, error);
+                    return;
+                }
+            } else {
+                failures.add(item.root, describe(item.source, "not a file, directory or link"));
+                return;
+            }
+
+            if (ec) {
+                failures.add(item.root, describe(item.source, ec.message()));
+                return;
+            }
+            progress.files_done++;
+        }, cancelled);
+
+        // A directory is recorded before the ones inside it, so going backwards finishes the
+        // insides before their parent loses write or search access
+        for (auto it = directories.rbegin(); it != directories.rend(); ++it) {
+            std::error_code ec;
+            if (it->has_time) std::filesystem::last_write_time(it->target, it->modified, ec);
+            std::filesystem::permissions(it->target, it->permissions, ec);
+        }
+    }
+}
+
+namespace FileTransfer {
+    bool copyFile(const std::filesystem::path& source, const std::filesystem::path& target,
+                  TransferProgress& progress, const CancelCheck& cancelled, std::string& error) {
+#ifdef _WIN32
+        std::error_code ec;
+        if (!std::filesystem::copy_file(source, target, std::filesystem::copy_options::none, ec)) {
+            error = describe(target, ec ? ec.message() : "already exists");
+            return false;
+        }
+        uint64_t size = std::filesystem::file_size(target, ec);
+        if (!ec) progress.bytes_done += size;
+        return true;
+#else
+        int in = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) {
+            error = describe(source, errno);
+            return false;
+        }
+        struct stat status;
+        if (fstat(in, &status) != 0) {
+            error = describe(source, errno);
+            close(in);
+            return false;
+        }
+        int out = open(target.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (out < 0) {
+            error = describe(target, errno);
+            close(in);
+            return false;
+        }
+
+        int error_number = 0;
+        bool copied = false;
+#ifdef FICLONE
+        // A reflink shares the blocks of the source, so no data is copied at all
+        if (status.st_size > 0 && ioctl(out, FICLONE, in) == 0) {
+            progress.bytes_done += static_cast<uint64_t>(status.st_size);
+            progress.files_cloned++;
+            copied = true;
+        }
+#endif
+        if (!copied) copied = copyData(in, out, status, progress, cancelled, error_number);
+        if (copied) copyAttributes(out, status);
+        if (close(out) != 0 && copied) {
+            error_number = errno;
+            copied = false;
+        }
+        close(in);
+
+        if (!copied) {
+            unlink(target.c_str());
+            error = error_number != 0 ? describe(target, error_number) : describe(target, "cancelled");
+        }
+        return copied;
+#endif
+    }
+
+    bool run(const FileJob& job, TransferProgress& progress, const CancelCheck& cancelled,
+             std::string& error, size_t thread_count) {
+        if (thread_count == 0) {
+            thread_count = defaultThreadCount();
+        }
+        Failures failures(progress, job.sources.size());
+
+        if (job.operation == FileJob::REMOVE) {
+            std::vector<size_t> sources(job.sources.size());
+            for (size_t i = 0; i < sources.size(); i++) {
+                sources[i] = i;
+            }
+            removeTrees(job, sources, progress, failures, cancelled, thread_count);
+        } else {
+            // Moves within one filesystem are a rename; everything else is copied
+            std::vector<CopyItem> copies;
+            for (size_t i = 0; i < job.sources.size() && !isCancelled(cancelled); i++) {
+                const std::filesystem::path& source = job.sources[i];
+                std::filesystem::path target = job.destination / source.filename();
+                std::error_code ec;
+                if (std::filesystem::exists(std::filesystem::symlink_status(target, ec))) {
+                    failures.add(i, describe(target, "already exists"));
+                    continue;
+                }
+                if (isWithin(job.destination, source)) {
+                    failures.add(i, describe(source, "destination is inside it"));
+                    continue;
+                }
+                if (job.operation == FileJob::MOVE) {
+                    // Something may have been created at the target since the check above
+                    renameNoReplace(source, target, ec);
+                    if (!ec) {
+                        progress.files_done++;
+                        continue;
+                    }
+                    if (ec == std::errc::file_exists) {
+                        failures.add(i, describe(target, "already exists"));
+                        continue;
+                    }
+                    if (ec != std::errc::cross_device_link) {
+                        failures.add(i, describe(source, ec.message()));
+                        continue;
+                    }
+                }
+                copies.push_back({source, target, i});
+            }
+
+            if (!copies.empty() && !isCancelled(cancelled)) {
+                scan(copies, progress, cancelled, thread_count);
+                progress.stage = TransferProgress::COPYING;
+                copyTrees(copies, progress, failures, cancelled, thread_count);
+            }
+
+            // A source moved across filesystems goes once all of it has been copied
+            if (job.operation == FileJob::MOVE && !copies.empty() && !isCancelled(cancelled)) {
+                std::vector<size_t> copied;
+                for (const CopyItem& item : copies) {
+                    if (!failures.failed(item.root)) copied.push_back(item.root);
+                }
+                removeTrees(job, copied, progress, failures, cancelled, thread_count);
+            }
+        }
+
+        progress.stage = TransferProgress::DONE;
+        error = failures.first();
+        return !isCancelled(cancelled);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef FILE_TRANSFER_H
+#define FILE_TRANSFER_H
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief A copy, move or removal of several entries, as queued by the browser
+ */
+struct FileJob {
+    enum Operation { COPY, MOVE, REMOVE };
+
+    Operation operation = COPY;
+    std::vector<std::filesystem::path> sources;     // Files and directories to act on
+    std::filesystem::path destination;              // Directory receiving copies and moves
+};
+
+/**
+ * @brief Counters published by a running job, safe to read from any thread
+ */
+struct TransferProgress {
+    enum Stage { SCANNING, COPYING, REMOVING, DONE };
+
+    std::atomic<int> stage{SCANNING};
+    std::atomic<uint64_t> files_total{0};     // Entries the scan found to copy
+    std::atomic<uint64_t> bytes_total{0};     // Bytes of the regular files among them
+    std::atomic<uint64_t> files_done{0};      // Entries copied, moved or removed so far
+    std::atomic<uint64_t> bytes_done{0};      // Bytes copied so far, holes of sparse files included
+    std::atomic<uint64_t> files_cloned{0};    // Files copied as a reflink, sharing their blocks
+    std::atomic<uint64_t> errors{0};          // Entries that could not be handled
+};
+
+/**
+ * @brief Copies, moves and removes directory trees
+ * Trees are walked by a pool of threads, one entry per work item, so several
+ * files are copied at once. A file is cloned when the filesystem supports
+ * reflinks, otherwise copied by the kernel with copy_file_range; the holes of
+ * sparse files are skipped rather than written out. Symbolic links are copied
+ * as links and never followed.
+ *
+ * Removal works on directory descriptors: every directory is opened relative
+ * to its parent's descriptor, starting from the directory a source is listed
+ * in, and its entries are unlinked with unlinkat. Subdirectories are spread
+ * over the threads, and a directory is removed by whichever thread finishes
+ * the last work below it. Links are unlinked, never entered. When the
+ * process runs out of descriptors, those of directories not in use are
+ * closed and reopened later through "..", so deep trees are removed too.
+ */
+namespace FileTransfer {
+    // Returns true when the job should stop
+    using CancelCheck = std::function<bool()>;
+
+    /**
+     * @brief Copy one regular file
+     * The target must not exist. It receives the mode and modification time of
+     * the source, and is removed again when the copy fails or is cancelled.
+     * @param source File to copy
+     * @param target Path of the new file
+     * @param progress bytes_done and files_cloned are updated as the copy runs
+     * @param cancelled Polled between chunks
+     * @param error Receives the reason on failure
+     * @return true if the file was copied
+     */
+    bool copyFile(const std::filesystem::path& source, const std::filesystem::path& target,
+                  TransferProgress& progress, const CancelCheck& cancelled, std::string& error);
+
+    /**
+     * @brief Run a job to the end
+     * Copies and moves never replace an existing entry of the destination. A
+     * move renames each source when it stays on one filesystem, and copies
+     * then removes it otherwise; a source is only removed when all of it was
+     * copied. Failures are counted and the job goes on with the next entry;
+     * the directories above an entry that could not be removed are kept.
+     * @param job Job to run
+     * @param progress Updated as the job runs
+     * @param cancelled Polled between entries and between chunks of a file
+     * @param error Receives the first failure
+     * @param thread_count Copy and removal threads (0 selects one per core, at least four)
+     * @return true if the job ran to the end, false if it was cancelled
+     */
+    bool run(const FileJob& job, TransferProgress& progress, const CancelCheck& cancelled,
+             std::string& error, size_t thread_count = 0);
+}
+
+#endif // FILE_TRANSFER_H
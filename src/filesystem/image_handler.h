@@ -2,6 +2,22 @@
 #define IMAGE_HANDLER_H
 
 #include <filesystem>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Downscaled image ready to be drawn as half-block cells
+ */
+struct ImagePreview {
+    std::string format;             // Decoder that produced the image
+    int source_width = 0;           // Original size in pixels
+    int source_height = 0;
+    int width = 0;                  // Scaled size in pixels; two pixel rows per terminal row
+    int height = 0;
+    std::vector<uint8_t> rgb;       // width * height RGB pixels
+    std::string error;              // Set when the image could not be decoded
+};
 
 /**
  * @brief Image file handling functionality
@@ -15,11 +31,22 @@ namespace ImageHandler {
     bool isImageFile(const std::filesystem::path& file_path);
     
     /**
-     * @brief Launch the default system image viewer for a file
+     * @brief Check if an image can be decoded by the built-in decoders
+     * @param file_path Path to the file
+     * @return true for PPM/PGM/PBM, BMP, TGA and PNG files
+     */
+    bool canPreview(const std::filesystem::path& file_path);
+
+    /**
+     * @brief Decode an image and downscale it to fit a pixel box
      * @param image_path Path to the image file
-     * @param debug_enabled Whether debug output is enabled
+     * @param max_width Box width in pixels (one per terminal column)
+     * @param max_height Box height in pixels (two per terminal row)
+     * @param preview Receives the scaled pixels or error
+     * @return true if successful, false otherwise
      */
-    void launchImageViewer(const std::filesystem::path& image_path, bool debug_enabled);
+    bool loadImagePreview(const std::filesystem::path& image_path, int max_width, int max_height,
+                          ImagePreview& preview);
 }
 
 #endif // IMAGE_HANDLER_H
@@ -0,0 +1,137 @@
+#include "json_index.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUICKVIEW_JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    inline int lowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    inline bool isInteresting(char c) {
+        return c == '"' || c == '\\' || c == '{' || c == '}' || c == '[' || c == ']';
+    }
+
+#ifdef QUICKVIEW_JSON_SSE2
+    // Bit i is set when p[i] is a quote, backslash or bracket
+    inline uint32_t interestingMask16(const char* p) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // '[' | 0x20 == '{' and ']' | 0x20 == '}', so two compares cover all four brackets
+        const __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        __m128i m = _mm_cmpeq_epi8(folded, _mm_set1_epi8('{'));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+        return static_cast<uint32_t>(_mm_movemask_epi8(m));
+    }
+#endif
+
+    // Bit i is set when p[i] needs attention; scans 64 bytes at a time
+    inline uint64_t interestingMask64(const char* p) {
+#ifdef QUICKVIEW_JSON_SSE2
+        return static_cast<uint64_t>(interestingMask16(p)) |
+               (static_cast<uint64_t>(interestingMask16(p + 16)) << 16) |
+               (static_cast<uint64_t>(interestingMask16(p + 32)) << 32) |
+               (static_cast<uint64_t>(interestingMask16(p + 48)) << 48);
+#else
+        uint64_t mask = 0;
+        for (int i = 0; i < 64; i++) {
+            if (isInteresting(p[i])) mask |= uint64_t(1) << i;
+        }
+        return mask;
+#endif
+    }
+}
+
+bool JsonIndex::build(const char* data, size_t size) {
+    containers_.clear();
+    error_.clear();
+
+    std::vector<uint32_t> stack;
+    bool in_string = false;
+    size_t skip_to = 0;  // Offset after an escaped character
+    bool ok = true;
+
+    auto handle = [&](size_t i) {
+        if (i < skip_to) return;
+        char c = data[i];
+
+        if (in_string) {
+            if (c == '\\') {
+                skip_to = i + 2;
+            } else if (c == '"') {
+                in_string = false;
+            }
+            return;
+        }
+
+        switch (c) {
+            case '"':
+                in_string = true;
+                break;
+            case '{':
+            case '[':
+                stack.push_back(static_cast<uint32_t>(containers_.size()));
+                containers_.push_back({i, 0, 0});
+                break;
+            case '}':
+            case ']': {
+                if (stack.empty()) {
+                    error_ = "Unexpected '" + std::string(1, c) + "' at offset " + std::to_string(i);
+                    ok = false;
+                    return;
+                }
+                Container& container = containers_[stack.back()];
+                char open = data[container.open];
+                if ((open == '{') != (c == '}')) {
+                    error_ = "Mismatched '" + std::string(1, c) + "' at offset " + std::to_string(i);
+                    ok = false;
+                    return;
+                }
+                container.close = i;
+                container.end = static_cast<uint32_t>(containers_.size());
+                stack.pop_back();
+                break;
+            }
+            default:
+                break;
+        }
+    };
+
+    size_t pos = 0;
+    while (ok && pos + 64 <= size) {
+        uint64_t bits = interestingMask64(data + pos);
+        while (bits && ok) {
+            handle(pos + lowestBit(bits));
+            bits &= bits - 1;
+        }
+        pos += 64;
+    }
+    for (; ok && pos < size; pos++) {
+        if (isInteresting(data[pos])) handle(pos);
+    }
+
+    if (!ok) return false;
+
+    if (in_string) {
+        error_ = "Unterminated string";
+        return false;
+    }
+    if (!stack.empty()) {
+        error_ = "Unclosed bracket at offset " + std::to_string(containers_[stack.back()].open);
+        return false;
+    }
+    return true;
+}
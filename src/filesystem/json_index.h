@@ -0,0 +1,43 @@
+#ifndef JSON_INDEX_H
+#define JSON_INDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Structural index of a JSON document
+ * A single pass over the raw bytes records every object and array together with
+ * the offset of its matching close bracket. Nothing else is parsed: members and
+ * scalar values are located on demand by scanning between known offsets, which
+ * lets a viewer open huge documents without building a DOM.
+ */
+class JsonIndex {
+public:
+    /**
+     * @brief One object or array in document order
+     */
+    struct Container {
+        uint64_t open;      // Offset of '{' or '['
+        uint64_t close;     // Offset of the matching '}' or ']'
+        uint32_t end;       // Index one past the last nested container
+    };
+
+    /**
+     * @brief Build the index over a buffer
+     * @param data Document bytes (must stay valid while the index is used)
+     * @param size Number of bytes
+     * @return true if the brackets and strings are balanced
+     */
+    bool build(const char* data, size_t size);
+
+    const std::vector<Container>& getContainers() const { return containers_; }
+    const std::string& getError() const { return error_; }
+
+private:
+    std::vector<Container> containers_;
+    std::string error_;
+};
+
+#endif // JSON_INDEX_H
@@ -0,0 +1,91 @@
+#include "line_index.h"
+#include "../utils/hash.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+    // Below this a single thread is faster than starting more
+    const size_t MIN_CHUNK = 1 << 20;
+
+    struct Chunk {
+        size_t begin;
+        size_t end;
+        std::vector<uint64_t> starts;
+        std::vector<uint64_t> hashes;
+    };
+
+    void indexChunk(const char* data, Chunk& chunk) {
+        size_t pos = chunk.begin;
+        while (pos < chunk.end) {
+            const char* newline = static_cast<const char*>(memchr(data + pos, '\n', chunk.end - pos));
+            size_t line_end = newline ? static_cast<size_t>(newline - data) : chunk.end;
+
+            chunk.starts.push_back(pos);
+            chunk.hashes.push_back(Xxh3Hasher::hash(data + pos, line_end - pos));
+            pos = line_end + 1;
+        }
+    }
+}
+
+LineIndex::LineIndex()
+    : data_(nullptr)
+    , size_(0)
+{
+}
+
+void LineIndex::build(const char* data, size_t size, size_t thread_count) {
+    data_ = data;
+    size_ = size;
+    starts_.clear();
+    hashes_.clear();
+
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    thread_count = std::max<size_t>(1, std::min(thread_count, size / MIN_CHUNK));
+
+    // Cut at even offsets, then move each cut just past the next newline
+    std::vector<Chunk> chunks(thread_count);
+    size_t begin = 0;
+    for (size_t i = 0; i < thread_count; i++) {
+        size_t end = i + 1 == thread_count ? size : std::max(begin, size / thread_count * (i + 1));
+        if (end < size) {
+            const char* newline = static_cast<const char*>(memchr(data + end, '\n', size - end));
+            end = newline ? static_cast<size_t>(newline - data) + 1 : size;
+        }
+        chunks[i].begin = begin;
+        chunks[i].end = end;
+        begin = end;
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < chunks.size(); i++) {
+        threads.emplace_back(indexChunk, data, std::ref(chunks[i]));
+    }
+    indexChunk(data, chunks[0]);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    size_t line_count = 0;
+    for (const auto& chunk : chunks) {
+        line_count += chunk.starts.size();
+    }
+    starts_.reserve(line_count);
+    hashes_.reserve(line_count);
+    for (const auto& chunk : chunks) {
+        starts_.insert(starts_.end(), chunk.starts.begin(), chunk.starts.end());
+        hashes_.insert(hashes_.end(), chunk.hashes.begin(), chunk.hashes.end());
+    }
+}
+
+void LineIndex::getLine(size_t index, const char*& begin, size_t& length) const {
+    size_t start = static_cast<size_t>(starts_[index]);
+    size_t end = index + 1 < starts_.size() ? static_cast<size_t>(starts_[index + 1]) - 1 : size_;
+    if (end > start && end == size_ && data_[end - 1] == '\n') {
+        end--;  // Last line of a file that ends with a newline
+    }
+    begin = data_ + start;
+    length = end - start;
+}
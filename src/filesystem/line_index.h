@@ -0,0 +1,43 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Line offsets and per-line hashes of an in-memory buffer
+ * The buffer is split into newline-aligned chunks that are indexed in
+ * parallel. The buffer must outlive the index.
+ */
+class LineIndex {
+public:
+    LineIndex();
+
+    /**
+     * @brief Index a buffer, replacing any previous contents
+     * @param data Buffer to index
+     * @param size Buffer size in bytes
+     * @param thread_count Threads to use (0 selects one per core)
+     */
+    void build(const char* data, size_t size, size_t thread_count = 0);
+
+    size_t getLineCount() const { return starts_.size(); }
+    const std::vector<uint64_t>& getHashes() const { return hashes_; }
+
+    /**
+     * @brief Get a line's bytes without its newline
+     * @param index Line number, starting at 0
+     * @param begin Receives the first byte
+     * @param length Receives the length in bytes
+     */
+    void getLine(size_t index, const char*& begin, size_t& length) const;
+
+private:
+    const char* data_;
+    size_t size_;
+    std::vector<uint64_t> starts_;      // Offset of each line's first byte
+    std::vector<uint64_t> hashes_;      // XXH3 of each line without its newline
+};
+
+#endif // LINE_INDEX_H
@@ -0,0 +1,157 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+// Mapping of a zero-length file is not allowed, so empty files point here
+static const char EMPTY_MAPPING[1] = {0};
+
+MappedFile::MappedFile()
+    : data_(nullptr)
+    , size_(0)
+    , open_(false)
+#ifdef _WIN32
+    , file_handle_(INVALID_HANDLE_VALUE)
+    , mapping_handle_(nullptr)
+#else
+    , fd_(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::filesystem::path& path) {
+    close();
+
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error_ = "Cannot open file";
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        error_ = "Cannot determine file size";
+        return false;
+    }
+
+    file_handle_ = file;
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ == 0) {
+        data_ = EMPTY_MAPPING;
+        open_ = true;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        error_ = "Cannot create file mapping";
+        return false;
+    }
+    mapping_handle_ = mapping;
+
+    data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        close();
+        error_ = "Cannot map file";
+        return false;
+    }
+
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ && data_ != EMPTY_MAPPING) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_) {
+        CloseHandle(mapping_handle_);
+        mapping_handle_ = nullptr;
+    }
+    if (file_handle_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_handle_);
+        file_handle_ = INVALID_HANDLE_VALUE;
+    }
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
+
+void MappedFile::adviseSequential() {
+    // FILE_FLAG_SEQUENTIAL_SCAN is already passed to CreateFileW
+}
+
+#else
+
+bool MappedFile::open(const std::filesystem::path& path) {
+    close();
+
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        error_ = std::string("Cannot open file: ") + strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        error_ = std::string("Cannot stat file: ") + strerror(errno);
+        close();
+        return false;
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        data_ = EMPTY_MAPPING;
+        open_ = true;
+        return true;
+    }
+
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        error_ = std::string("Cannot map file: ") + strerror(errno);
+        close();
+        return false;
+    }
+
+    data_ = static_cast<const char*>(mapping);
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ && data_ != EMPTY_MAPPING) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
+
+void MappedFile::adviseSequential() {
+    if (data_ && data_ != EMPTY_MAPPING) {
+        madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+    }
+}
+
+#endif
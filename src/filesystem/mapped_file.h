@@ -0,0 +1,57 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <filesystem>
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ * Large files are paged in by the kernel on demand, so opening a multi-gigabyte
+ * file costs the same as opening a small one.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file into memory
+     * @param path Path to the file
+     * @return true if successful, false otherwise (see getError())
+     */
+    bool open(const std::filesystem::path& path);
+
+    /**
+     * @brief Unmap the file and release all handles
+     */
+    void close();
+
+    /**
+     * @brief Hint that the mapping will be read front to back
+     */
+    void adviseSequential();
+
+    bool isOpen() const { return open_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& getError() const { return error_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    bool open_;
+    std::string error_;
+
+#ifdef _WIN32
+    void* file_handle_;
+    void* mapping_handle_;
+#else
+    int fd_;
+#endif
+};
+
+#endif // MAPPED_FILE_H
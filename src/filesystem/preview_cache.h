@@ -0,0 +1,76 @@
+#ifndef PREVIEW_CACHE_H
+#define PREVIEW_CACHE_H
+
+#include "file_key.h"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @brief Thread-safe LRU cache of previews keyed by file identity
+ * Entries are keyed by inode and mtime, so an edited file misses the cache
+ * and a renamed file still hits it.
+ */
+template <typename Preview>
+class PreviewCache {
+public:
+    /**
+     * @brief Create an empty cache
+     * @param capacity Maximum number of previews kept
+     */
+    explicit PreviewCache(size_t capacity = 128)
+        : capacity_(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    /**
+     * @brief Look up a preview
+     * @param key File identity
+     * @return Cached preview, or nullptr on a miss
+     */
+    std::shared_ptr<const Preview> find(const FileKey& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = lookup_.find(key);
+        if (it == lookup_.end()) return nullptr;
+
+        // Move to the front so it is evicted last
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    /**
+     * @brief Add a preview, evicting the least recently used entry if full
+     * @param key File identity
+     * @param preview Preview to cache
+     */
+    void insert(const FileKey& key, std::shared_ptr<const Preview> preview) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = lookup_.find(key);
+        if (it != lookup_.end()) {
+            it->second->second = std::move(preview);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+
+        entries_.emplace_front(key, std::move(preview));
+        lookup_[key] = entries_.begin();
+
+        if (entries_.size() > capacity_) {
+            lookup_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+private:
+    using Entry = std::pair<FileKey, std::shared_ptr<const Preview>>;
+
+    size_t capacity_;
+    std::list<Entry> entries_;  // Most recently used first
+    std::unordered_map<FileKey, typename std::list<Entry>::iterator, FileKeyHash> lookup_;
+    std::mutex mutex_;
+};
+
+#endif // PREVIEW_CACHE_H
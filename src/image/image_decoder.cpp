@@ -0,0 +1,687 @@
+#include "image_decoder.h"
+#include "inflate.h"
+#include <cstring>
+#include <cstdlib>
+
+namespace {
+    // Refuse images whose decoded RGB buffer would be unreasonably large
+    const uint64_t MAX_PIXELS = 1ull << 28;
+
+    inline uint16_t readLE16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+    inline uint32_t readLE32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+    inline uint32_t readBE32(const uint8_t* p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+               (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+    }
+
+    bool allocate(Image& image, int width, int height, std::string& error) {
+        if (width <= 0 || height <= 0) {
+            error = "Invalid image dimensions";
+            return false;
+        }
+        if (static_cast<uint64_t>(width) * static_cast<uint64_t>(height) > MAX_PIXELS) {
+            error = "Image too large to preview";
+            return false;
+        }
+        image.width = width;
+        image.height = height;
+        image.stride = static_cast<size_t>(width) * 3;
+        image.storage.assign(image.stride * static_cast<size_t>(height), 0);
+        image.pixels = image.storage.data();
+        return true;
+    }
+
+    // ---- PPM / PGM / PBM ----
+
+    class PnmReader {
+    public:
+        PnmReader(const uint8_t* data, size_t size) : data_(data), size_(size), pos_(2) {}
+
+        // Next decimal token, skipping whitespace and comments
+        bool readNumber(uint32_t& value) {
+            while (pos_ < size_) {
+                uint8_t c = data_[pos_];
+                if (c == '#') {
+                    while (pos_ < size_ && data_[pos_] != '\n') pos_++;
+                } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+                    pos_++;
+                } else {
+                    break;
+                }
+            }
+            if (pos_ >= size_ || data_[pos_] < '0' || data_[pos_] > '9') return false;
+            uint64_t result = 0;
+            while (pos_ < size_ && data_[pos_] >= '0' && data_[pos_] <= '9') {
+                result = result * 10 + (data_[pos_++] - '0');
+                if (result > 0xFFFFFFFFull) return false;
+            }
+            value = static_cast<uint32_t>(result);
+            return true;
+        }
+
+        // Single bit for plain PBM, where digits need not be separated
+        bool readBit(uint32_t& value) {
+            while (pos_ < size_ && data_[pos_] != '0' && data_[pos_] != '1') {
+                if (data_[pos_] == '#') {
+                    while (pos_ < size_ && data_[pos_] != '\n') pos_++;
+                } else {
+                    pos_++;
+                }
+            }
+            if (pos_ >= size_) return false;
+            value = data_[pos_++] - '0';
+            return true;
+        }
+
+        size_t position() const { return pos_; }
+        void skip(size_t bytes) { pos_ += bytes; }
+
+    private:
+        const uint8_t* data_;
+        size_t size_;
+        size_t pos_;
+    };
+
+    bool decodePnm(const uint8_t* data, size_t size, Image& image, std::string& error) {
+        char kind = static_cast<char>(data[1]);
+        PnmReader reader(data, size);
+
+        uint32_t width = 0, height = 0, maxval = 1;
+        if (!reader.readNumber(width) || !reader.readNumber(height) ||
+            (kind != '1' && kind != '4' && !reader.readNumber(maxval))) {
+            error = "Invalid PNM header";
+            return false;
+        }
+        if (maxval == 0 || maxval > 65535 || width > 0x7FFFFFFF || height > 0x7FFFFFFF) {
+            error = "Invalid PNM header";
+            return false;
+        }
+
+        bool binary = kind >= '4';
+        if (binary) reader.skip(1);  // Single whitespace before the raster
+        size_t raster = reader.position();
+        const uint8_t* pixels = data + (raster < size ? raster : size);
+        size_t available = raster < size ? size - raster : 0;
+
+        // Raw 8-bit PPM is already RGB: view it in place instead of copying
+        if (kind == '6' && maxval == 255) {
+            uint64_t needed = static_cast<uint64_t>(width) * height * 3;
+            if (width == 0 || height == 0 || needed > available) {
+                error = "Truncated PPM data";
+                return false;
+            }
+            if (static_cast<uint64_t>(width) * height > MAX_PIXELS) {
+                error = "Image too large to preview";
+                return false;
+            }
+            image.width = static_cast<int>(width);
+            image.height = static_cast<int>(height);
+            image.stride = static_cast<size_t>(width) * 3;
+            image.pixels = pixels;
+            return true;
+        }
+
+        if (!allocate(image, static_cast<int>(width), static_cast<int>(height), error)) return false;
+
+        const int channels = (kind == '3' || kind == '6') ? 3 : 1;
+        const int sample_bytes = maxval > 255 ? 2 : 1;
+        const uint64_t sample_count = static_cast<uint64_t>(width) * height * channels;
+        uint8_t* out = image.storage.data();
+
+        if (kind == '4') {
+            size_t row_bytes = (width + 7) / 8;
+            if (static_cast<uint64_t>(row_bytes) * height > available) {
+                error = "Truncated PBM data";
+                return false;
+            }
+            for (uint32_t y = 0; y < height; y++) {
+                const uint8_t* row = pixels + y * row_bytes;
+                for (uint32_t x = 0; x < width; x++) {
+                    uint8_t value = ((row[x >> 3] >> (7 - (x & 7))) & 1) ? 0 : 255;
+                    memset(out, value, 3);
+                    out += 3;
+                }
+            }
+            return true;
+        }
+
+        if (binary) {
+            if (sample_count * sample_bytes > available) {
+                error = "Truncated PNM data";
+                return false;
+            }
+            const uint8_t* in = pixels;
+            for (uint64_t i = 0; i < static_cast<uint64_t>(width) * height; i++) {
+                uint8_t rgb[3];
+                for (int c = 0; c < channels; c++) {
+                    uint32_t sample = sample_bytes == 2 ? ((in[0] << 8) | in[1]) : in[0];
+                    in += sample_bytes;
+                    rgb[c] = static_cast<uint8_t>(sample * 255 / maxval);
+                }
+                out[0] = rgb[0];
+                out[1] = channels == 3 ? rgb[1] : rgb[0];
+                out[2] = channels == 3 ? rgb[2] : rgb[0];
+                out += 3;
+            }
+            return true;
+        }
+
+        // Plain (ASCII) variants
+        for (uint64_t i = 0; i < static_cast<uint64_t>(width) * height; i++) {
+            uint8_t rgb[3];
+            for (int c = 0; c < channels; c++) {
+                uint32_t sample;
+                bool ok = kind == '1' ? reader.readBit(sample) : reader.readNumber(sample);
+                if (!ok) {
+                    error = "Truncated PNM data";
+                    return false;
+                }
+                if (kind == '1') {
+                    rgb[c] = sample ? 0 : 255;
+                } else {
+                    rgb[c] = static_cast<uint8_t>((sample > maxval ? maxval : sample) * 255 / maxval);
+                }
+            }
+            out[0] = rgb[0];
+            out[1] = channels == 3 ? rgb[1] : rgb[0];
+            out[2] = channels == 3 ? rgb[2] : rgb[0];
+            out += 3;
+        }
+        return true;
+    }
+
+    // ---- BMP ----
+
+    // Extract a channel selected by a bit mask and scale it to 8 bits
+    inline uint8_t maskedChannel(uint32_t pixel, uint32_t mask) {
+        if (mask == 0) return 0;
+        int shift = 0;
+        while (!((mask >> shift) & 1)) shift++;
+        uint32_t max = mask >> shift;
+        return static_cast<uint8_t>(((pixel & mask) >> shift) * 255 / max);
+    }
+
+    bool decodeBmp(const uint8_t* data, size_t size, Image& image, std::string& error) {
+        if (size < 26) {
+            error = "Truncated BMP header";
+            return false;
+        }
+        uint32_t pixel_offset = readLE32(data + 10);
+        uint32_t header_size = readLE32(data + 14);
+
+        int32_t width, height;
+        uint16_t bpp;
+        uint32_t compression = 0;
+        uint32_t colors_used = 0;
+        size_t palette_entry = 4;
+
+        if (header_size == 12) {
+            width = readLE16(data + 18);
+            height = static_cast<int16_t>(readLE16(data + 20));
+            bpp = readLE16(data + 24);
+            palette_entry = 3;
+        } else if (header_size >= 40 && size >= 54) {
+            width = static_cast<int32_t>(readLE32(data + 18));
+            height = static_cast<int32_t>(readLE32(data + 22));
+            bpp = readLE16(data + 28);
+            compression = readLE32(data + 30);
+            colors_used = readLE32(data + 46);
+        } else {
+            error = "Unsupported BMP header";
+            return false;
+        }
+
+        // The index unpacking below relies on whole pixels per byte and a nonzero row size
+        if (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8 && bpp != 16 && bpp != 24 && bpp != 32) {
+            error = "Unsupported BMP bit depth";
+            return false;
+        }
+
+        bool bitfields = compression == 3 || compression == 6;
+        if (compression != 0 && !bitfields) {
+            error = "Compressed BMP is not supported";
+            return false;
+        }
+
+        bool top_down = height < 0;
+        if (top_down) height = -height;
+        if (!allocate(image, width, height, error)) return false;
+
+        // Channel masks: defaults for 16 and 32 bits, overridden by BI_BITFIELDS
+        uint32_t red_mask = 0x7C00, green_mask = 0x03E0, blue_mask = 0x001F;
+        if (bpp == 32) {
+            red_mask = 0x00FF0000;
+            green_mask = 0x0000FF00;
+            blue_mask = 0x000000FF;
+        }
+        if (bitfields && size >= 66) {
+            red_mask = readLE32(data + 54);
+            green_mask = readLE32(data + 58);
+            blue_mask = readLE32(data + 62);
+        }
+
+        // Palette for indexed images
+        size_t palette_offset = 14 + header_size + ((bitfields && header_size == 40) ? 12 : 0);
+        uint32_t palette_size = 0;
+        if (bpp <= 8) {
+            palette_size = colors_used ? colors_used : (1u << bpp);
+            if (palette_size > 256) palette_size = 256;
+            if (palette_offset + palette_size * palette_entry > size) {
+                error = "Truncated BMP palette";
+                return false;
+            }
+        }
+
+        size_t row_bytes = ((static_cast<size_t>(width) * bpp + 31) / 32) * 4;
+        if (pixel_offset > size || row_bytes * static_cast<uint64_t>(height) > size - pixel_offset) {
+            error = "Truncated BMP data";
+            return false;
+        }
+
+        for (int y = 0; y < height; y++) {
+            const uint8_t* row = data + pixel_offset + row_bytes * (top_down ? y : height - 1 - y);
+            uint8_t* out = image.storage.data() + image.stride * y;
+
+            for (int x = 0; x < width; x++, out += 3) {
+                if (bpp == 24) {
+                    const uint8_t* p = row + x * 3;
+                    out[0] = p[2];
+                    out[1] = p[1];
+                    out[2] = p[0];
+                } else if (bpp == 32 || bpp == 16) {
+                    uint32_t pixel = bpp == 32 ? readLE32(row + x * 4) : readLE16(row + x * 2);
+                    out[0] = maskedChannel(pixel, red_mask);
+                    out[1] = maskedChannel(pixel, green_mask);
+                    out[2] = maskedChannel(pixel, blue_mask);
+                } else {
+                    int bit = x * bpp;
+                    uint32_t index = (row[bit >> 3] >> (8 - bpp - (bit & 7))) & ((1u << bpp) - 1);
+                    if (index >= palette_size) index = 0;
+                    const uint8_t* entry = data + palette_offset + index * palette_entry;
+                    out[0] = entry[2];
+                    out[1] = entry[1];
+                    out[2] = entry[0];
+                }
+            }
+        }
+        return true;
+    }
+
+    // ---- TGA ----
+
+    inline void tgaPixel(const uint8_t* p, int depth, uint8_t* out) {
+        switch (depth) {
+            case 8:
+                out[0] = out[1] = out[2] = p[0];
+                break;
+            case 15:
+            case 16: {
+                uint16_t v = readLE16(p);
+                out[0] = static_cast<uint8_t>(((v >> 10) & 0x1F) * 255 / 31);
+                out[1] = static_cast<uint8_t>(((v >> 5) & 0x1F) * 255 / 31);
+                out[2] = static_cast<uint8_t>((v & 0x1F) * 255 / 31);
+                break;
+            }
+            default:  // 24 and 32 bits are stored BGR(A)
+                out[0] = p[2];
+                out[1] = p[1];
+                out[2] = p[0];
+                break;
+        }
+    }
+
+    bool decodeTga(const uint8_t* data, size_t size, Image& image, std::string& error) {
+        if (size < 18) {
+            error = "Truncated TGA header";
+            return false;
+        }
+        uint8_t id_length = data[0];
+        uint8_t map_type = data[1];
+        uint8_t type = data[2];
+        uint16_t map_first = readLE16(data + 3);
+        uint16_t map_length = readLE16(data + 5);
+        uint8_t map_depth = data[7];
+        int width = readLE16(data + 12);
+        int height = readLE16(data + 14);
+        uint8_t depth = data[16];
+        bool top_down = (data[17] & 0x20) != 0;
+
+        bool rle = type >= 9;
+        uint8_t base_type = rle ? type - 8 : type;
+        bool mapped = base_type == 1;
+        if (base_type < 1 || base_type > 3 || (mapped && map_type != 1)) {
+            error = "Unsupported TGA type";
+            return false;
+        }
+        int pixel_depth = mapped ? map_depth : depth;
+        if ((mapped && depth != 8) || (base_type == 3 && depth != 8) ||
+            (pixel_depth != 8 && pixel_depth != 15 && pixel_depth != 16 && pixel_depth != 24 && pixel_depth != 32)) {
+            error = "Unsupported TGA pixel depth";
+            return false;
+        }
+
+        size_t map_entry = (map_depth + 7) / 8;
+        size_t map_offset = 18 + id_length;
+        size_t pos = map_offset + (map_type == 1 ? map_length * map_entry : 0);
+        if (pos > size) {
+            error = "Truncated TGA color map";
+            return false;
+        }
+        if (!allocate(image, width, height, error)) return false;
+
+        const size_t in_bytes = (depth + 7) / 8;
+        uint64_t total = static_cast<uint64_t>(width) * height;
+
+        auto emit = [&](const uint8_t* p, uint64_t index) -> bool {
+            uint64_t y = index / width;
+            uint64_t x = index % width;
+            uint64_t row = top_down ? y : height - 1 - y;
+            uint8_t* out = image.storage.data() + row * image.stride + x * 3;
+            if (mapped) {
+                uint32_t entry = p[0] >= map_first ? p[0] - map_first : 0;
+                if (entry >= map_length) return false;
+                tgaPixel(data + map_offset + entry * map_entry, map_depth, out);
+            } else {
+                tgaPixel(p, pixel_depth, out);
+            }
+            return true;
+        };
+
+        uint64_t index = 0;
+        while (index < total) {
+            if (!rle) {
+                if (pos + in_bytes > size) break;
+                if (!emit(data + pos, index++)) break;
+                pos += in_bytes;
+                continue;
+            }
+            if (pos >= size) break;
+            uint8_t header = data[pos++];
+            uint32_t count = (header & 0x7F) + 1;
+            if (header & 0x80) {
+                if (pos + in_bytes > size) break;
+                for (uint32_t i = 0; i < count && index < total; i++) emit(data + pos, index++);
+                pos += in_bytes;
+            } else {
+                for (uint32_t i = 0; i < count && index < total; i++) {
+                    if (pos + in_bytes > size) break;
+                    emit(data + pos, index++);
+                    pos += in_bytes;
+                }
+            }
+        }
+
+        if (index < total) {
+            error = "Truncated TGA data";
+            return false;
+        }
+        return true;
+    }
+
+    // ---- PNG ----
+
+    inline uint8_t paeth(int a, int b, int c) {
+        int p = a + b - c;
+        int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+        if (pb <= pc) return static_cast<uint8_t>(b);
+        return static_cast<uint8_t>(c);
+    }
+
+    bool unfilter(uint8_t* rows, size_t row_bytes, int height, int bpp, std::string& error) {
+        // Each scanline is a filter byte followed by row_bytes of data
+        const uint8_t* previous = nullptr;
+        for (int y = 0; y < height; y++) {
+            uint8_t* line = rows + y * (row_bytes + 1);
+            uint8_t filter = line[0];
+            uint8_t* cur = line + 1;
+
+            switch (filter) {
+                case 0:
+                    break;
+                case 1:
+                    for (size_t i = bpp; i < row_bytes; i++) cur[i] = static_cast<uint8_t>(cur[i] + cur[i - bpp]);
+                    break;
+                case 2:
+                    if (previous) for (size_t i = 0; i < row_bytes; i++) cur[i] = static_cast<uint8_t>(cur[i] + previous[i]);
+                    break;
+                case 3:
+                    for (size_t i = 0; i < row_bytes; i++) {
+                        int left = i >= static_cast<size_t>(bpp) ? cur[i - bpp] : 0;
+                        int up = previous ? previous[i] : 0;
+                        cur[i] = static_cast<uint8_t>(cur[i] + ((left + up) >> 1));
+                    }
+                    break;
+                case 4:
+                    for (size_t i = 0; i < row_bytes; i++) {
+                        int left = i >= static_cast<size_t>(bpp) ? cur[i - bpp] : 0;
+                        int up = previous ? previous[i] : 0;
+                        int up_left = (previous && i >= static_cast<size_t>(bpp)) ? previous[i - bpp] : 0;
+                        cur[i] = static_cast<uint8_t>(cur[i] + paeth(left, up, up_left));
+                    }
+                    break;
+                default:
+                    error = "Invalid PNG filter";
+                    return false;
+            }
+            previous = cur;
+        }
+        return true;
+    }
+
+    struct PngInfo {
+        int width;
+        int height;
+        int bit_depth;
+        int color_type;
+        int channels;
+        uint8_t palette[256][4];
+        int palette_size;
+    };
+
+    // Read sample i of a scanline at any bit depth, scaled to 8 bits
+    inline uint8_t pngSample(const uint8_t* line, size_t i, int bit_depth, bool scale) {
+        switch (bit_depth) {
+            case 8: return line[i];
+            case 16: return line[i * 2];
+            default: {
+                size_t bit = i * bit_depth;
+                uint32_t value = (line[bit >> 3] >> (8 - bit_depth - (bit & 7))) & ((1u << bit_depth) - 1);
+                return scale ? static_cast<uint8_t>(value * 255 / ((1u << bit_depth) - 1)) : static_cast<uint8_t>(value);
+            }
+        }
+    }
+
+    // Convert count pixels of a scanline to RGB, writing every step-th output pixel
+    void convertPngRow(const PngInfo& info, const uint8_t* line, int count, uint8_t* out, int step) {
+        for (int x = 0; x < count; x++, out += 3 * step) {
+            size_t base = static_cast<size_t>(x) * info.channels;
+            uint8_t r, g, b, a = 255;
+            switch (info.color_type) {
+                case 0:
+                    r = g = b = pngSample(line, base, info.bit_depth, true);
+                    break;
+                case 2:
+                    r = pngSample(line, base, info.bit_depth, true);
+                    g = pngSample(line, base + 1, info.bit_depth, true);
+                    b = pngSample(line, base + 2, info.bit_depth, true);
+                    break;
+                case 3: {
+                    uint8_t index = pngSample(line, base, info.bit_depth, false);
+                    const uint8_t* entry = info.palette[index];
+                    r = entry[0];
+                    g = entry[1];
+                    b = entry[2];
+                    a = entry[3];
+                    break;
+                }
+                case 4:
+                    r = g = b = pngSample(line, base, info.bit_depth, true);
+                    a = pngSample(line, base + 1, info.bit_depth, true);
+                    break;
+                default:
+                    r = pngSample(line, base, info.bit_depth, true);
+                    g = pngSample(line, base + 1, info.bit_depth, true);
+                    b = pngSample(line, base + 2, info.bit_depth, true);
+                    a = pngSample(line, base + 3, info.bit_depth, true);
+                    break;
+            }
+            if (a != 255) {
+                r = static_cast<uint8_t>(r * a / 255);
+                g = static_cast<uint8_t>(g * a / 255);
+                b = static_cast<uint8_t>(b * a / 255);
+            }
+            out[0] = r;
+            out[1] = g;
+            out[2] = b;
+        }
+    }
+
+    bool decodePng(const uint8_t* data, size_t size, Image& image, std::string& error) {
+        PngInfo info{};
+        bool have_header = false;
+        int interlace = 0;
+        std::vector<uint8_t> compressed;
+
+        for (int i = 0; i < 256; i++) {
+            info.palette[i][0] = info.palette[i][1] = info.palette[i][2] = 0;
+            info.palette[i][3] = 255;
+        }
+
+        size_t pos = 8;
+        while (pos + 8 <= size) {
+            uint32_t length = readBE32(data + pos);
+            const uint8_t* type = data + pos + 4;
+            const uint8_t* body = data + pos + 8;
+            if (length > size - pos - 8) {
+                error = "Truncated PNG chunk";
+                return false;
+            }
+
+            if (memcmp(type, "IHDR", 4) == 0 && length >= 13) {
+                info.width = static_cast<int>(readBE32(body));
+                info.height = static_cast<int>(readBE32(body + 4));
+                info.bit_depth = body[8];
+                info.color_type = body[9];
+                interlace = body[12];
+                have_header = true;
+            } else if (memcmp(type, "PLTE", 4) == 0) {
+                info.palette_size = static_cast<int>(length / 3 > 256 ? 256 : length / 3);
+                for (int i = 0; i < info.palette_size; i++) {
+                    info.palette[i][0] = body[i * 3];
+                    info.palette[i][1] = body[i * 3 + 1];
+                    info.palette[i][2] = body[i * 3 + 2];
+                }
+            } else if (memcmp(type, "tRNS", 4) == 0 && info.color_type == 3) {
+                for (uint32_t i = 0; i < length && i < 256; i++) info.palette[i][3] = body[i];
+            } else if (memcmp(type, "IDAT", 4) == 0) {
+                compressed.insert(compressed.end(), body, body + length);
+            } else if (memcmp(type, "IEND", 4) == 0) {
+                break;
+            }
+            pos += 12 + static_cast<size_t>(length);  // Length, type, body and CRC
+        }
+
+        if (!have_header) {
+            error = "Missing PNG header";
+            return false;
+        }
+
+        switch (info.color_type) {
+            case 0: info.channels = 1; break;
+            case 2: info.channels = 3; break;
+            case 3: info.channels = 1; break;
+            case 4: info.channels = 2; break;
+            case 6: info.channels = 4; break;
+            default:
+                error = "Unsupported PNG color type";
+                return false;
+        }
+        int depth = info.bit_depth;
+        bool valid_depth = depth == 8 || (depth == 16 && info.color_type != 3) ||
+                           ((depth == 1 || depth == 2 || depth == 4) && (info.color_type == 0 || info.color_type == 3));
+        if (!valid_depth) {
+            error = "Unsupported PNG bit depth";
+            return false;
+        }
+        if (!allocate(image, info.width, info.height, error)) return false;
+
+        const int bits_per_pixel = info.channels * depth;
+        const int filter_bpp = bits_per_pixel >= 8 ? bits_per_pixel / 8 : 1;
+        auto rowBytes = [&](int width) { return (static_cast<size_t>(width) * bits_per_pixel + 7) / 8; };
+
+        // Adam7 passes: x start, y start, x step, y step
+        static const int PASSES[7][4] = {
+            {0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}
+        };
+        const int pass_count = interlace ? 7 : 1;
+
+        size_t expected = 0;
+        for (int p = 0; p < pass_count; p++) {
+            const int* pass = interlace ? PASSES[p] : nullptr;
+            int pass_width = pass ? (info.width - pass[0] + pass[2] - 1) / pass[2] : info.width;
+            int pass_height = pass ? (info.height - pass[1] + pass[3] - 1) / pass[3] : info.height;
+            if (pass_width > 0 && pass_height > 0) expected += (rowBytes(pass_width) + 1) * pass_height;
+        }
+
+        std::vector<uint8_t> raw;
+        raw.reserve(expected);
+        // The size is known from the header, so a stream inflating past it is rejected rather than buffered
+        if (!Inflate::zlibDecompress(compressed.data(), compressed.size(), raw, error, expected)) return false;
+        if (raw.size() < expected) {
+            error = "Truncated PNG image data";
+            return false;
+        }
+        compressed.clear();
+        compressed.shrink_to_fit();
+
+        size_t offset = 0;
+        for (int p = 0; p < pass_count; p++) {
+            const int* pass = interlace ? PASSES[p] : nullptr;
+            int pass_width = pass ? (info.width - pass[0] + pass[2] - 1) / pass[2] : info.width;
+            int pass_height = pass ? (info.height - pass[1] + pass[3] - 1) / pass[3] : info.height;
+            if (pass_width <= 0 || pass_height <= 0) continue;
+
+            size_t row_bytes = rowBytes(pass_width);
+            if (!unfilter(raw.data() + offset, row_bytes, pass_height, filter_bpp, error)) return false;
+
+            for (int y = 0; y < pass_height; y++) {
+                const uint8_t* line = raw.data() + offset + y * (row_bytes + 1) + 1;
+                int out_y = pass ? pass[1] + y * pass[3] : y;
+                int out_x = pass ? pass[0] : 0;
+                int step = pass ? pass[2] : 1;
+                convertPngRow(info, line, pass_width, image.storage.data() + out_y * image.stride + out_x * 3, step);
+            }
+            offset += (row_bytes + 1) * pass_height;
+        }
+        return true;
+    }
+}
+
+namespace ImageDecoder {
+    std::string detectFormat(const uint8_t* data, size_t size, const std::string& extension) {
+        static const uint8_t PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        if (size >= 8 && memcmp(data, PNG_SIGNATURE, 8) == 0) return "PNG";
+        if (size >= 2 && data[0] == 'B' && data[1] == 'M') return "BMP";
+        if (size >= 2 && data[0] == 'P' && data[1] >= '1' && data[1] <= '6') return "PNM";
+        if (extension == ".tga" && size >= 18) return "TGA";
+        return "";
+    }
+
+    bool decode(const uint8_t* data, size_t size, const std::string& extension,
+                Image& image, std::string& error) {
+        image = Image();
+        std::string format = detectFormat(data, size, extension);
+
+        if (format == "PNG") return decodePng(data, size, image, error);
+        if (format == "BMP") return decodeBmp(data, size, image, error);
+        if (format == "PNM") return decodePnm(data, size, image, error);
+        if (format == "TGA") return decodeTga(data, size, image, error);
+
+        error = "Unsupported image format";
+        return false;
+    }
+}
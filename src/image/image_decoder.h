@@ -0,0 +1,49 @@
+#ifndef IMAGE_DECODER_H
+#define IMAGE_DECODER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Decoded 8-bit RGB image
+ * Pixels either live in storage or, for raw formats, point straight into the
+ * caller's buffer, so the caller's buffer must outlive the image.
+ */
+struct Image {
+    int width = 0;
+    int height = 0;
+    size_t stride = 0;                  // Bytes per row
+    const uint8_t* pixels = nullptr;    // First row, 3 bytes per pixel
+    std::vector<uint8_t> storage;
+};
+
+/**
+ * @brief Built-in decoders for simple image formats
+ * Supports PPM/PGM/PBM, BMP, TGA and PNG. Alpha is composited over black.
+ */
+namespace ImageDecoder {
+    /**
+     * @brief Detect a supported format from the leading bytes
+     * @param data File contents
+     * @param size Number of bytes
+     * @param extension Lowercase file extension, used to recognize TGA (which has no magic number)
+     * @return Format name ("PNG", "BMP", "PNM", "TGA"), or empty if unsupported
+     */
+    std::string detectFormat(const uint8_t* data, size_t size, const std::string& extension);
+
+    /**
+     * @brief Decode an image held in memory
+     * @param data File contents
+     * @param size Number of bytes
+     * @param extension Lowercase file extension, used to recognize TGA (which has no magic number)
+     * @param image Receives the pixels
+     * @param error Receives a description on failure
+     * @return true if successful, false otherwise
+     */
+    bool decode(const uint8_t* data, size_t size, const std::string& extension,
+                Image& image, std::string& error);
+}
+
+#endif // IMAGE_DECODER_H
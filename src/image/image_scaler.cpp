@@ -0,0 +1,99 @@
+#include "image_scaler.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUICKVIEW_SCALER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Add one row of bytes into 32-bit column sums
+    void accumulateRow(const uint8_t* row, size_t length, uint32_t* sums) {
+        size_t i = 0;
+#ifdef QUICKVIEW_SCALER_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= length; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            __m128i high = _mm_unpackhi_epi8(bytes, zero);
+
+            __m128i* out = reinterpret_cast<__m128i*>(sums + i);
+            _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), _mm_unpacklo_epi16(low, zero)));
+            _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), _mm_unpackhi_epi16(low, zero)));
+            _mm_storeu_si128(out + 2, _mm_add_epi32(_mm_loadu_si128(out + 2), _mm_unpacklo_epi16(high, zero)));
+            _mm_storeu_si128(out + 3, _mm_add_epi32(_mm_loadu_si128(out + 3), _mm_unpackhi_epi16(high, zero)));
+        }
+#endif
+        for (; i < length; i++) {
+            sums[i] += row[i];
+        }
+    }
+}
+
+namespace ImageScaler {
+    void fitWithin(int src_width, int src_height, int max_width, int max_height,
+                   int& dst_width, int& dst_height) {
+        dst_width = src_width;
+        dst_height = src_height;
+        if (src_width <= 0 || src_height <= 0 || max_width <= 0 || max_height <= 0) {
+            dst_width = dst_height = 0;
+            return;
+        }
+
+        if (dst_width > max_width) {
+            dst_height = static_cast<int>(static_cast<int64_t>(dst_height) * max_width / dst_width);
+            dst_width = max_width;
+        }
+        if (dst_height > max_height) {
+            dst_width = static_cast<int>(static_cast<int64_t>(dst_width) * max_height / dst_height);
+            dst_height = max_height;
+        }
+        dst_width = std::max(1, dst_width);
+        dst_height = std::max(1, dst_height);
+    }
+
+    void boxDownscale(const uint8_t* src, int src_width, int src_height, size_t src_stride,
+                      int dst_width, int dst_height, std::vector<uint8_t>& dst) {
+        dst.assign(static_cast<size_t>(dst_width) * dst_height * 3, 0);
+        if (dst_width <= 0 || dst_height <= 0) return;
+
+        const size_t row_length = static_cast<size_t>(src_width) * 3;
+        std::vector<uint32_t> sums(row_length);
+
+        // Source column span of every output column
+        std::vector<int> column_start(dst_width + 1);
+        for (int x = 0; x <= dst_width; x++) {
+            column_start[x] = static_cast<int>(static_cast<int64_t>(x) * src_width / dst_width);
+        }
+
+        for (int y = 0; y < dst_height; y++) {
+            int row_begin = static_cast<int>(static_cast<int64_t>(y) * src_height / dst_height);
+            int row_end = static_cast<int>(static_cast<int64_t>(y + 1) * src_height / dst_height);
+            if (row_end <= row_begin) row_end = row_begin + 1;
+
+            // Vertical pass: every source byte is touched exactly once
+            std::fill(sums.begin(), sums.end(), 0);
+            for (int sy = row_begin; sy < row_end; sy++) {
+                accumulateRow(src + static_cast<size_t>(sy) * src_stride, row_length, sums.data());
+            }
+
+            // Horizontal pass over the (much smaller) column sums
+            uint8_t* out = dst.data() + static_cast<size_t>(y) * dst_width * 3;
+            const uint32_t rows = static_cast<uint32_t>(row_end - row_begin);
+            for (int x = 0; x < dst_width; x++) {
+                int col_begin = column_start[x];
+                int col_end = std::max(column_start[x + 1], col_begin + 1);
+                uint64_t r = 0, g = 0, b = 0;
+                for (int sx = col_begin; sx < col_end; sx++) {
+                    r += sums[sx * 3];
+                    g += sums[sx * 3 + 1];
+                    b += sums[sx * 3 + 2];
+                }
+                uint64_t count = static_cast<uint64_t>(rows) * (col_end - col_begin);
+                out[x * 3] = static_cast<uint8_t>(r / count);
+                out[x * 3 + 1] = static_cast<uint8_t>(g / count);
+                out[x * 3 + 2] = static_cast<uint8_t>(b / count);
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef IMAGE_SCALER_H
+#define IMAGE_SCALER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Image downscaling for terminal previews
+ */
+namespace ImageScaler {
+    /**
+     * @brief Fit an image into a box while keeping its aspect ratio (never upscales)
+     * @param src_width Source width in pixels
+     * @param src_height Source height in pixels
+     * @param max_width Box width
+     * @param max_height Box height
+     * @param dst_width Receives the target width
+     * @param dst_height Receives the target height
+     */
+    void fitWithin(int src_width, int src_height, int max_width, int max_height,
+                   int& dst_width, int& dst_height);
+
+    /**
+     * @brief Downscale an RGB image with a box filter (each output pixel averages its source area)
+     * @param src First source row, 3 bytes per pixel
+     * @param src_width Source width in pixels
+     * @param src_height Source height in pixels
+     * @param src_stride Bytes per source row
+     * @param dst_width Target width (at most src_width)
+     * @param dst_height Target height (at most src_height)
+     * @param dst Receives dst_width * dst_height RGB pixels
+     */
+    void boxDownscale(const uint8_t* src, int src_width, int src_height, size_t src_stride,
+                      int dst_width, int dst_height, std::vector<uint8_t>& dst);
+}
+
+#endif // IMAGE_SCALER_H
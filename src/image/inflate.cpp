@@ -0,0 +1,360 @@
+#include "inflate.h"
+#include <cstring>
+
+namespace {
+    const int MAX_BITS = 15;
+    const int FAST_BITS = 10;
+
+    const uint16_t LENGTH_BASE[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    const uint8_t LENGTH_EXTRA[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    const uint16_t DIST_BASE[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+    };
+    const uint8_t DIST_EXTRA[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+    const uint8_t CODE_LENGTH_ORDER[19] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+    };
+
+    // Little-endian bit reader; reading past the end yields zeros and sets overrun
+    class BitReader {
+    public:
+        BitReader(const uint8_t* data, size_t size)
+            : data_(data), size_(size), pos_(0), buffer_(0), count_(0), overrun_(false) {}
+
+        void refill() {
+            while (count_ <= 56) {
+                if (pos_ < size_) {
+                    buffer_ |= static_cast<uint64_t>(data_[pos_++]) << count_;
+                } else if (count_ == 0 || pos_ >= size_ + 8) {
+                    overrun_ = true;
+                    return;
+                } else {
+                    pos_++;  // Pad with zero bytes so the final codes can be peeked
+                }
+                count_ += 8;
+            }
+        }
+
+        uint32_t peek(int bits) {
+            if (count_ < bits) refill();
+            return static_cast<uint32_t>(buffer_ & ((uint64_t(1) << bits) - 1));
+        }
+
+        void consume(int bits) {
+            buffer_ >>= bits;
+            count_ -= bits;
+        }
+
+        uint32_t read(int bits) {
+            if (bits == 0) return 0;
+            uint32_t value = peek(bits);
+            consume(bits);
+            return value;
+        }
+
+        void alignToByte() {
+            consume(count_ % 8);
+        }
+
+        // Byte-aligned access for stored blocks
+        bool readBytes(uint8_t* out, size_t length) {
+            while (length > 0 && count_ >= 8) {
+                *out++ = static_cast<uint8_t>(buffer_);
+                consume(8);
+                length--;
+            }
+            // Bytes still in the buffer were consumed above; rewind to the first unbuffered byte
+            size_t byte_pos = pos_ - count_ / 8;
+            if (byte_pos > size_ || length > size_ - byte_pos) return false;
+            memcpy(out, data_ + byte_pos, length);
+            pos_ = byte_pos + length;
+            buffer_ = 0;
+            count_ = 0;
+            return true;
+        }
+
+        bool overrun() const { return overrun_ || pos_ > size_ + 8; }
+
+    private:
+        const uint8_t* data_;
+        size_t size_;
+        size_t pos_;
+        uint64_t buffer_;
+        int count_;
+        bool overrun_;
+    };
+
+    // Canonical Huffman decoder with a direct lookup table for short codes
+    class Huffman {
+    public:
+        bool build(const uint8_t* lengths, int symbol_count) {
+            memset(count_, 0, sizeof(count_));
+            memset(fast_, 0, sizeof(fast_));
+            for (int i = 0; i < symbol_count; i++) count_[lengths[i]]++;
+            count_[0] = 0;
+
+            // Reject over-subscribed code sets
+            int left = 1;
+            for (int len = 1; len <= MAX_BITS; len++) {
+                left <<= 1;
+                left -= count_[len];
+                if (left < 0) return false;
+            }
+
+            uint16_t offsets[MAX_BITS + 2];
+            offsets[1] = 0;
+            for (int len = 1; len <= MAX_BITS; len++) offsets[len + 1] = offsets[len] + count_[len];
+            for (int i = 0; i < symbol_count; i++) {
+                if (lengths[i]) symbol_[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+            }
+
+            // Fill the fast table: codes are stored bit-reversed in the stream
+            int code = 0;
+            int index = 0;
+            for (int len = 1; len <= FAST_BITS; len++) {
+                for (int i = 0; i < count_[len]; i++, code++, index++) {
+                    int reversed = 0;
+                    for (int b = 0; b < len; b++) reversed |= ((code >> b) & 1) << (len - 1 - b);
+                    for (int fill = reversed; fill < (1 << FAST_BITS); fill += (1 << len)) {
+                        fast_[fill] = static_cast<uint16_t>((len << 12) | symbol_[index]);
+                    }
+                }
+                code <<= 1;
+            }
+            return true;
+        }
+
+        int decode(BitReader& bits) const {
+            uint32_t entry = fast_[bits.peek(FAST_BITS)];
+            if (entry) {
+                bits.consume(static_cast<int>(entry >> 12));
+                return static_cast<int>(entry & 0x0FFF);
+            }
+
+            // Long code: walk the canonical code space one bit at a time
+            int code = 0, first = 0, index = 0;
+            for (int len = 1; len <= MAX_BITS; len++) {
+                code |= static_cast<int>(bits.read(1));
+                int count = count_[len];
+                if (code - count < first) {
+                    return symbol_[index + (code - first)];
+                }
+                index += count;
+                first += count;
+                first <<= 1;
+                code <<= 1;
+            }
+            return -1;
+        }
+
+    private:
+        uint16_t count_[MAX_BITS + 1];
+        uint16_t symbol_[288];
+        uint16_t fast_[1 << FAST_BITS];
+    };
+
+    const char* const TOO_LARGE = "Decompressed data larger than expected";
+
+    bool inflateBlock(BitReader& bits, const Huffman& literals, const Huffman& distances,
+                      std::vector<uint8_t>& out, size_t out_start, size_t max_output, std::string& error) {
+        while (true) {
+            int symbol = literals.decode(bits);
+            if (symbol < 0 || bits.overrun()) {
+                error = "Corrupt compressed data";
+                return false;
+            }
+            if (symbol < 256) {
+                if (out.size() - out_start >= max_output) {
+                    error = TOO_LARGE;
+                    return false;
+                }
+                out.push_back(static_cast<uint8_t>(symbol));
+                continue;
+            }
+            if (symbol == 256) return true;
+
+            symbol -= 257;
+            if (symbol >= 29) {
+                error = "Invalid length code";
+                return false;
+            }
+            size_t length = LENGTH_BASE[symbol] + bits.read(LENGTH_EXTRA[symbol]);
+
+            int dist_symbol = distances.decode(bits);
+            if (dist_symbol < 0 || dist_symbol >= 30) {
+                error = "Invalid distance code";
+                return false;
+            }
+            size_t distance = DIST_BASE[dist_symbol] + bits.read(DIST_EXTRA[dist_symbol]);
+            if (distance > out.size() - out_start) {
+                error = "Distance too far back";
+                return false;
+            }
+            if (length > max_output - (out.size() - out_start)) {
+                error = TOO_LARGE;
+                return false;
+            }
+
+            // Byte-by-byte copy handles overlapping runs
+            size_t from = out.size() - distance;
+            out.resize(out.size() + length);
+            uint8_t* dest = out.data() + out.size() - length;
+            const uint8_t* src = out.data() + from;
+            for (size_t i = 0; i < length; i++) dest[i] = src[i];
+        }
+    }
+}
+
+namespace Inflate {
+    bool inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::string& error,
+                 size_t max_output) {
+        BitReader bits(data, size);
+        const size_t out_start = out.size();
+        bool final_block = false;
+
+        Huffman fixed_literals, fixed_distances;
+        bool fixed_built = false;
+
+        while (!final_block) {
+            final_block = bits.read(1) != 0;
+            uint32_t type = bits.read(2);
+
+            if (type == 0) {
+                // Stored block
+                bits.alignToByte();
+                uint32_t length = bits.read(16);
+                uint32_t inverse = bits.read(16);
+                if ((length ^ 0xFFFF) != inverse) {
+                    error = "Corrupt stored block";
+                    return false;
+                }
+                if (length > max_output - (out.size() - out_start)) {
+                    error = TOO_LARGE;
+                    return false;
+                }
+                size_t old_size = out.size();
+                out.resize(old_size + length);
+                if (!bits.readBytes(out.data() + old_size, length)) {
+                    error = "Truncated stored block";
+                    return false;
+                }
+            } else if (type == 1) {
+                if (!fixed_built) {
+                    uint8_t lengths[288 + 30];
+                    memset(lengths, 8, 144);
+                    memset(lengths + 144, 9, 112);
+                    memset(lengths + 256, 7, 24);
+                    memset(lengths + 280, 8, 8);
+                    memset(lengths + 288, 5, 30);
+                    fixed_literals.build(lengths, 288);
+                    fixed_distances.build(lengths + 288, 30);
+                    fixed_built = true;
+                }
+                if (!inflateBlock(bits, fixed_literals, fixed_distances, out, out_start, max_output, error)) return false;
+            } else if (type == 2) {
+                int literal_count = static_cast<int>(bits.read(5)) + 257;
+                int distance_count = static_cast<int>(bits.read(5)) + 1;
+                int code_length_count = static_cast<int>(bits.read(4)) + 4;
+                if (literal_count > 286 || distance_count > 30) {
+                    error = "Invalid dynamic block header";
+                    return false;
+                }
+
+                uint8_t code_lengths[19] = {0};
+                for (int i = 0; i < code_length_count; i++) {
+                    code_lengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(bits.read(3));
+                }
+                Huffman code_length_decoder;
+                if (!code_length_decoder.build(code_lengths, 19)) {
+                    error = "Invalid code length codes";
+                    return false;
+                }
+
+                uint8_t lengths[286 + 30] = {0};
+                int total = literal_count + distance_count;
+                int index = 0;
+                while (index < total) {
+                    int symbol = code_length_decoder.decode(bits);
+                    if (symbol < 0 || bits.overrun()) {
+                        error = "Corrupt code lengths";
+                        return false;
+                    }
+                    if (symbol < 16) {
+                        lengths[index++] = static_cast<uint8_t>(symbol);
+                        continue;
+                    }
+
+                    uint8_t value = 0;
+                    int repeat;
+                    if (symbol == 16) {
+                        if (index == 0) {
+                            error = "Repeat with no previous length";
+                            return false;
+                        }
+                        value = lengths[index - 1];
+                        repeat = 3 + static_cast<int>(bits.read(2));
+                    } else if (symbol == 17) {
+                        repeat = 3 + static_cast<int>(bits.read(3));
+                    } else {
+                        repeat = 11 + static_cast<int>(bits.read(7));
+                    }
+                    if (index + repeat > total) {
+                        error = "Too many code lengths";
+                        return false;
+                    }
+                    while (repeat--) lengths[index++] = value;
+                }
+
+                if (lengths[256] == 0) {
+                    error = "Missing end-of-block code";
+                    return false;
+                }
+
+                Huffman literals, distances;
+                if (!literals.build(lengths, literal_count) || !distances.build(lengths + literal_count, distance_count)) {
+                    error = "Invalid Huffman table";
+                    return false;
+                }
+                if (!inflateBlock(bits, literals, distances, out, out_start, max_output, error)) return false;
+            } else {
+                error = "Invalid block type";
+                return false;
+            }
+
+            if (bits.overrun()) {
+                error = "Truncated compressed data";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool zlibDecompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::string& error,
+                        size_t max_output) {
+        if (size < 2) {
+            error = "Truncated zlib header";
+            return false;
+        }
+        uint8_t cmf = data[0];
+        uint8_t flags = data[1];
+        if ((cmf & 0x0F) != 8 || ((cmf << 8) | flags) % 31 != 0) {
+            error = "Invalid zlib header";
+            return false;
+        }
+        if (flags & 0x20) {
+            error = "Preset dictionaries are not supported";
+            return false;
+        }
+        return inflate(data + 2, size - 2, out, error, max_output);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Bundled DEFLATE decoder (RFC 1950/1951), enough for PNG image data
+ */
+namespace Inflate {
+    /**
+     * @brief Decompress a raw DEFLATE stream
+     * @param data Compressed bytes
+     * @param size Number of compressed bytes
+     * @param out Receives the decompressed bytes (appended)
+     * @param error Receives a description on failure
+     * @param max_output Most bytes to append; a stream that decompresses to more is rejected
+     * @return true if successful, false on corrupt or oversized input
+     */
+    bool inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::string& error,
+                 size_t max_output = SIZE_MAX);
+
+    /**
+     * @brief Decompress a zlib stream (2-byte header, DEFLATE data, Adler-32 trailer)
+     * @param data Compressed bytes
+     * @param size Number of compressed bytes
+     * @param out Receives the decompressed bytes (appended)
+     * @param error Receives a description on failure
+     * @param max_output Most bytes to append; a stream that decompresses to more is rejected
+     * @return true if successful, false on corrupt or oversized input
+     */
+    bool zlibDecompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::string& error,
+                        size_t max_output = SIZE_MAX);
+}
+
+#endif // INFLATE_H
@@ -1,41 +1,231 @@
 #include "core/quickview.h"
+#include "ui/memory/memory_terminal.h"
+#include "utils/log.h"
+#include "utils/trace.h"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <sstream>
+#include <iterator>
 #include <exception>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <climits>
 
 /**
  * @brief Main entry point for the quickView application
- * 
+ *
+ * quickView [OPTIONS] [DIRECTORY] lists DIRECTORY, the working directory by
+ * default. quickView [OPTIONS] FILE [+LINE] opens FILE in the viewer at LINE
+ * without reading its directory first.
+ *
+ * With --headless[=WIDTHxHEIGHT] the interface is drawn into memory instead of
+ * the terminal. Keys are read from standard input (VT sequences for the special
+ * keys), and on exit the final screen is written to stdout and per-frame
+ * statistics to stderr. --terminal=NAME picks the terminal backend, for
+ * example "vt" to write escape sequences without ncurses. --fps=N caps the
+ * redraw rate (60 by default, 0 for no cap). --trace=FILE records timing
+ * spans and writes them to FILE as a Chrome trace on exit and on 't'.
+ * --debug logs to the default log file, --log=FILE to FILE.
+ *
+ * Visited directories are recorded for the jump prompt in the default history
+ * file, or in FILE with --history=FILE. Headless runs keep no history unless
+ * --history is given.
+ *
+ * --record=FILE saves the typed keys with their timing. --replay=FILE presses
+ * them again at the same pace on a headless screen of the recorded size and
+ * reports the latency of every key instead of the frame statistics.
+ *
  * @param argc Number of command line arguments
  * @param argv Array of command line arguments
  * @return int Exit code (0 for success, non-zero for error)
  */
 int main(int argc, char* argv[]) {
     try {
-        // Check for debug flag
+        // Check for command line flags
         bool debug_mode = false;
+        std::filesystem::path log_path;
+        bool headless = false;
+        std::string backend;
+        int frame_rate = 60;
+        int headless_width = 80;
+        int headless_height = 24;
+        bool headless_size_given = false;
+        std::filesystem::path record_path;
+        std::filesystem::path replay_path;
+        std::filesystem::path start_path;
+        std::filesystem::path history_path;
+        bool history_given = false;
+        int start_line = 0;
         for (int i = 1; i < argc; i++) {
             if (strcmp(argv[i], "--debug") == 0 || strcmp(argv[i], "-d") == 0) {
                 debug_mode = true;
-                break;
+            } else if (strncmp(argv[i], "--log=", 6) == 0 && argv[i][6] != '\0') {
+                debug_mode = true;
+                log_path = argv[i] + 6;
+            } else if (strncmp(argv[i], "--fps=", 6) == 0) {
+                char* end;
+                long fps = strtol(argv[i] + 6, &end, 10);
+                if (*end != '\0' || end == argv[i] + 6 || fps < 0 || fps > 1000) {
+                    std::cerr << "Invalid frame rate: " << argv[i] + 6 << std::endl;
+                    return 1;
+                }
+                frame_rate = static_cast<int>(fps);
+            } else if (strncmp(argv[i], "--trace=", 8) == 0 && argv[i][8] != '\0') {
+                Trace::start(argv[i] + 8);
+            } else if (strncmp(argv[i], "--terminal=", 11) == 0) {
+                backend = argv[i] + 11;
+            } else if (strncmp(argv[i], "--record=", 9) == 0 && argv[i][9] != '\0') {
+                record_path = argv[i] + 9;
+            } else if (strncmp(argv[i], "--history=", 10) == 0 && argv[i][10] != '\0') {
+                history_path = argv[i] + 10;
+                history_given = true;
+            } else if (strncmp(argv[i], "--replay=", 9) == 0 && argv[i][9] != '\0') {
+                replay_path = argv[i] + 9;
+            } else if (strcmp(argv[i], "--headless") == 0) {
+                headless = true;
+            } else if (strncmp(argv[i], "--headless=", 11) == 0) {
+                headless = true;
+                headless_size_given = true;
+                if (sscanf(argv[i] + 11, "%dx%d", &headless_width, &headless_height) != 2 ||
+                    headless_width < 20 || headless_height < 10) {
+                    std::cerr << "Invalid headless screen size: " << argv[i] + 11 << std::endl;
+                    return 1;
+                }
+            } else if (argv[i][0] == '+' && !start_path.empty()) {
+                char* end;
+                long line = strtol(argv[i] + 1, &end, 10);
+                if (*end != '\0' || end == argv[i] + 1 || line < 1 || line > INT_MAX) {
+                    std::cerr << "Invalid line number: " << argv[i] + 1 << std::endl;
+                    return 1;
+                }
+                start_line = static_cast<int>(line);
+            } else if (argv[i][0] != '-' && start_path.empty()) {
+                start_path = argv[i];
+            }
+        }
+
+        if (!start_path.empty()) {
+            std::error_code ec;
+            auto status = std::filesystem::status(start_path, ec);
+            if (ec) {
+                std::cerr << "Cannot open " << start_path.string() << ": " << ec.message() << std::endl;
+                return 1;
+            }
+            if (start_line > 0 && !std::filesystem::is_regular_file(status)) {
+                std::cerr << "A line number needs a file: " << start_path.string() << std::endl;
+                return 1;
             }
         }
 
-        // Create application instance
-        QuickView app(debug_mode);
-        
+        // Log to a file so that nothing is written over the interface
+        if (debug_mode) {
+            if (log_path.empty()) log_path = Log::getDefaultPath();
+            std::string error;
+            if (log_path.empty() || !Log::start(log_path, error)) {
+                std::cerr << (log_path.empty() ? "No log file location, use --log=FILE" : error) << std::endl;
+                return 1;
+            }
+        }
+
+        // A replay runs headless, at the recorded screen size unless one is given
+        std::vector<KeystrokeMonitor::Key> replay_keys;
+        if (!replay_path.empty()) {
+            int width, height;
+            std::string error;
+            if (!KeystrokeMonitor::load(replay_path, replay_keys, width, height, error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            headless = true;
+            if (!headless_size_given) {
+                headless_width = std::max(width, 20);
+                headless_height = std::max(height, 10);
+            }
+        }
+
+        std::unique_ptr<ITerminal> terminal;
+        MemoryTerminal* memory_terminal = nullptr;
+        if (headless) {
+            auto memory = std::make_unique<MemoryTerminal>(headless_width, headless_height);
+            if (replay_path.empty()) {
+                memory->pushInput(std::string(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>()));
+            }
+            memory_terminal = memory.get();
+            terminal = std::move(memory);
+        } else if (!backend.empty()) {
+            terminal = createTerminal(backend);
+            if (!terminal) {
+                std::cerr << "Unknown terminal backend: " << backend << std::endl;
+                return 1;
+            }
+        }
+
+        // Create application instance; the monitor outlives it
+        KeystrokeMonitor keystroke_monitor;
+        QuickView app(std::move(terminal));
+        app.setFrameRate(frame_rate);
+        if (!history_given && !headless) {
+            history_path = DirectoryHistory::getDefaultPath();
+        }
+        app.setHistoryPath(history_path);
+        if (!start_path.empty()) {
+            app.setStartPath(start_path, start_line);
+        }
+
         // Initialize the application
         if (!app.initialize()) {
             std::cerr << "Failed to initialize quickView application" << std::endl;
             return 1;
         }
-        
+
+        // Scripted input expects the listing to be there, as a person would wait to see it
+        if (memory_terminal && replay_path.empty()) {
+            app.waitForDirectory();
+        }
+
+        if (!record_path.empty()) {
+            int width, height;
+            app.getTerminal()->getScreenSize(width, height);
+            std::string error;
+            if (!keystroke_monitor.startRecording(record_path, width, height, error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+        if (!replay_path.empty()) {
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& key : replay_keys) {
+                memory_terminal->pushKey(key.key, start + std::chrono::microseconds(key.offset_us));
+            }
+            keystroke_monitor.startReplay(replay_keys, start);
+        }
+        if (!record_path.empty() || !replay_path.empty()) {
+            app.setKeystrokeMonitor(&keystroke_monitor);
+        }
+
         // Run the main application loop
         app.run();
 
+        if (!replay_path.empty()) {
+            std::ostringstream frames;
+            memory_terminal->writeReport(std::cout, frames);
+            keystroke_monitor.writeReport(std::cerr);
+        } else if (memory_terminal) {
+            memory_terminal->writeReport(std::cout, std::cerr);
+        }
+
+        if (Trace::isEnabled()) {
+            std::string error;
+            if (!Trace::write(error)) {
+                std::cerr << error << std::endl;
+            }
+        }
+
         // Application will clean up automatically via destructor
         return 0;
-        
+
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
@@ -0,0 +1,174 @@
+#include "event_loop.h"
+
+#ifdef __linux__
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace {
+    // Timers are polled from a fixed array along with the three other descriptors
+    const size_t MAX_TIMERS = 8;
+
+    sigset_t previous_mask;
+
+    struct timespec toTimespec(std::chrono::milliseconds duration) {
+        struct timespec value;
+        value.tv_sec = static_cast<time_t>(duration.count() / 1000);
+        value.tv_nsec = static_cast<long>(duration.count() % 1000) * 1000000L;
+        return value;
+    }
+
+    // Empty a non-blocking descriptor that holds a counter or queued records
+    void drain(int fd) {
+        char buffer[sizeof(struct signalfd_siginfo) * 8];
+        while (read(fd, buffer, sizeof(buffer)) > 0) {}
+    }
+}
+
+EventLoop::EventLoop(int input_fd)
+    : active_(false)
+    , input_fd_(input_fd)
+    , signal_fd_(-1)
+    , wake_fd_(-1)
+{
+    if (input_fd < 0) return;
+
+    // Blocked signals stay pending until they are read from the signalfd
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGWINCH);
+    sigaddset(&signals, SIGCHLD);
+    if (pthread_sigmask(SIG_BLOCK, &signals, &previous_mask) != 0) return;
+
+    signal_fd_ = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (signal_fd_ < 0 || wake_fd_ < 0) {
+        if (signal_fd_ >= 0) close(signal_fd_);
+        if (wake_fd_ >= 0) close(wake_fd_);
+        signal_fd_ = wake_fd_ = -1;
+        pthread_sigmask(SIG_SETMASK, &previous_mask, nullptr);
+        return;
+    }
+    active_ = true;
+}
+
+EventLoop::~EventLoop() {
+    if (!active_) return;
+
+    for (int fd : timer_fds_) {
+        close(fd);
+    }
+    close(signal_fd_);
+    close(wake_fd_);
+    pthread_sigmask(SIG_SETMASK, &previous_mask, nullptr);
+}
+
+void EventLoop::wake() {
+    if (!active_) return;
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd_, &one, sizeof(one));
+    (void)written;  // Only fails when the counter is already nonzero
+}
+
+int EventLoop::createTimer() {
+    if (!active_ || timer_fds_.size() >= MAX_TIMERS) return -1;
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) return -1;
+    timer_fds_.push_back(fd);
+    return static_cast<int>(timer_fds_.size()) - 1;
+}
+
+void EventLoop::startTimer(int timer, std::chrono::milliseconds delay, std::chrono::milliseconds interval) {
+    if (timer < 0 || timer >= static_cast<int>(timer_fds_.size())) return;
+
+    // A zero it_value would disarm the timer
+    struct itimerspec setting;
+    setting.it_value = toTimespec(std::max(delay, std::chrono::milliseconds(1)));
+    setting.it_interval = toTimespec(interval);
+    timerfd_settime(timer_fds_[timer], 0, &setting, nullptr);
+}
+
+void EventLoop::stopTimer(int timer) {
+    if (timer < 0 || timer >= static_cast<int>(timer_fds_.size())) return;
+
+    // Rearming also clears the expiry count
+    struct itimerspec setting = {};
+    timerfd_settime(timer_fds_[timer], 0, &setting, nullptr);
+}
+
+unsigned EventLoop::wait(int timeout_ms, std::vector<int>& expired) {
+    expired.clear();
+    if (!active_) return 0;
+
+    // Input, signals and wakeups first, then one entry per timer
+    const size_t FIXED = 3;
+    struct pollfd fds[FIXED + MAX_TIMERS];
+    size_t count = FIXED + timer_fds_.size();
+    fds[0] = {input_fd_, POLLIN, 0};
+    fds[1] = {signal_fd_, POLLIN, 0};
+    fds[2] = {wake_fd_, POLLIN, 0};
+    for (size_t i = FIXED; i < count; i++) {
+        fds[i] = {timer_fds_[i - FIXED], POLLIN, 0};
+    }
+
+    int ready = poll(fds, count, timeout_ms);
+    if (ready <= 0) return 0;       // Timeout, or EINTR from a signal that is not ours
+
+    unsigned events = 0;
+    if (fds[0].revents) events |= INPUT;
+    if (fds[1].revents & POLLIN) {
+        struct signalfd_siginfo info;
+        while (read(signal_fd_, &info, sizeof(info)) == sizeof(info)) {
+            if (info.ssi_signo == SIGWINCH) events |= RESIZE;
+            if (info.ssi_signo == SIGCHLD) events |= CHILD;
+        }
+    }
+    if (fds[2].revents & POLLIN) {
+        drain(wake_fd_);
+        events |= WAKE;
+    }
+    for (size_t i = FIXED; i < count; i++) {
+        if (fds[i].revents & POLLIN) {
+            drain(fds[i].fd);
+            expired.push_back(static_cast<int>(i - FIXED));
+            events |= TIMER;
+        }
+    }
+    return events;
+}
+
+#else
+
+// No signalfd, timerfd or eventfd: the loop stays inactive and the caller
+// falls back to polling the terminal with a timeout
+EventLoop::EventLoop(int input_fd)
+    : active_(false), input_fd_(input_fd), signal_fd_(-1), wake_fd_(-1) {
+}
+
+EventLoop::~EventLoop() {
+}
+
+void EventLoop::wake() {
+}
+
+int EventLoop::createTimer() {
+    return -1;
+}
+
+void EventLoop::startTimer(int, std::chrono::milliseconds, std::chrono::milliseconds) {
+}
+
+void EventLoop::stopTimer(int) {
+}
+
+unsigned EventLoop::wait(int, std::vector<int>& expired) {
+    expired.clear();
+    return 0;
+}
+
+#endif
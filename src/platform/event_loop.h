@@ -0,0 +1,90 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <chrono>
+#include <vector>
+
+/**
+ * @brief Waits on keyboard input, signals, timers and worker wakeups at once
+ *
+ * On Linux a single poll() covers the input descriptor, a signalfd for
+ * SIGWINCH and SIGCHLD, one timerfd per timer and an eventfd that other
+ * threads write to through wake(). Those signals are blocked in the calling
+ * thread, so the loop must be created before any other thread is started
+ * for them to stay blocked process-wide.
+ *
+ * Elsewhere, or when there is no input descriptor, the loop is inactive and
+ * the caller keeps waiting in ITerminal::getKey() with a timeout.
+ */
+class EventLoop {
+public:
+    // Bits returned by wait()
+    enum Event : unsigned {
+        INPUT = 1 << 0,     // The input descriptor is readable
+        WAKE = 1 << 1,      // wake() was called
+        RESIZE = 1 << 2,    // SIGWINCH arrived
+        CHILD = 1 << 3,     // SIGCHLD arrived
+        TIMER = 1 << 4      // At least one timer expired
+    };
+
+    /**
+     * @brief Set up the descriptors and block SIGWINCH and SIGCHLD
+     * @param input_fd Descriptor that becomes readable on a key press, or -1
+     */
+    explicit EventLoop(int input_fd);
+
+    /**
+     * @brief Close the descriptors and restore the signal mask
+     */
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Check whether wait() can be used
+     */
+    bool isActive() const { return active_; }
+
+    /**
+     * @brief Make the current or next wait() return WAKE; safe from any thread
+     */
+    void wake();
+
+    /**
+     * @brief Create a stopped timer
+     * @return Timer id for startTimer() and stopTimer(), or -1 if the loop is inactive
+     */
+    int createTimer();
+
+    /**
+     * @brief Start or restart a timer
+     * @param timer Timer id
+     * @param delay Time until the first expiry
+     * @param interval Time between later expiries; zero fires once
+     */
+    void startTimer(int timer, std::chrono::milliseconds delay,
+                    std::chrono::milliseconds interval = std::chrono::milliseconds(0));
+
+    /**
+     * @brief Stop a timer; an expiry that has not been reported yet is discarded
+     */
+    void stopTimer(int timer);
+
+    /**
+     * @brief Block until something happens
+     * @param timeout_ms Longest wait; negative waits indefinitely
+     * @param expired Receives the ids of the timers that expired
+     * @return Event bits, 0 on timeout
+     */
+    unsigned wait(int timeout_ms, std::vector<int>& expired);
+
+private:
+    bool active_;
+    int input_fd_;
+    int signal_fd_;
+    int wake_fd_;
+    std::vector<int> timer_fds_;    // Indexed by timer id
+};
+
+#endif // EVENT_LOOP_H
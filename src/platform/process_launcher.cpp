@@ -0,0 +1,304 @@
+#include "process_launcher.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <shellapi.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace {
+#ifndef _WIN32
+    // Set by the SIGCHLD handler, cleared by reapChildren()
+    volatile sig_atomic_t child_exited = 1;
+
+    void onChildExited(int) {
+        child_exited = 1;
+    }
+#endif
+
+    std::string lowercaseExtension(const std::filesystem::path& file_path) {
+        std::string extension = file_path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension;
+    }
+}
+
+ProcessLauncher::ProcessLauncher() {
+#if defined(__APPLE__)
+    handlers_["*"] = {{"open"}};
+#elif !defined(_WIN32)
+    handlers_["*"] = {{"xdg-open"}};
+
+    // Images fall back to common viewers when no desktop opener is installed
+    const std::vector<Command> image_viewers = {
+        {"xdg-open"}, {"eog"}, {"feh"}, {"display"}, {"gwenview"}, {"ristretto"}
+    };
+    for (const char* extension : {".jpg", ".jpeg", ".png", ".gif", ".bmp", ".tiff", ".tif", ".webp",
+                                  ".svg", ".ico", ".ppm", ".pgm", ".pbm", ".xpm", ".pcx", ".tga"}) {
+        handlers_[extension] = image_viewers;
+    }
+#endif
+}
+
+bool ProcessLauncher::loadHandlers(const std::filesystem::path& config_path) {
+    std::ifstream file(config_path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::map<std::string, std::vector<Command>> configured;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string extension;
+        Command command;
+        if (parseCommand(line, extension, command)) {
+            configured[extension].push_back(std::move(command));
+        }
+    }
+
+    for (auto& entry : configured) {
+        handlers_[entry.first] = std::move(entry.second);
+    }
+    return true;
+}
+
+std::filesystem::path ProcessLauncher::getDefaultConfigPath() {
+    const char* config_home = std::getenv("XDG_CONFIG_HOME");
+    if (config_home && *config_home) {
+        return std::filesystem::path(config_home) / "quickview" / "open_with.conf";
+    }
+#ifdef _WIN32
+    const char* home = std::getenv("APPDATA");
+    if (home && *home) {
+        return std::filesystem::path(home) / "quickview" / "open_with.conf";
+    }
+#else
+    const char* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::filesystem::path(home) / ".config" / "quickview" / "open_with.conf";
+    }
+#endif
+    return std::filesystem::path();
+}
+
+bool ProcessLauncher::hasHandler(const std::filesystem::path& file_path) const {
+    return handlers_.count(lowercaseExtension(file_path)) > 0;
+}
+
+bool ProcessLauncher::open(const std::filesystem::path& file_path, std::string& error) {
+#ifdef _WIN32
+    // ShellExecute hands the file to its associated program and returns immediately
+    HINSTANCE result = ShellExecuteW(nullptr, L"open", file_path.wstring().c_str(),
+                                     nullptr, nullptr, SW_SHOWNORMAL);
+    if (reinterpret_cast<INT_PTR>(result) <= 32) {
+        error = "No program is associated with " + file_path.filename().string();
+        return false;
+    }
+    return true;
+#else
+    auto it = handlers_.find(lowercaseExtension(file_path));
+    if (it == handlers_.end()) {
+        it = handlers_.find("*");
+    }
+    if (it == handlers_.end() || it->second.empty()) {
+        error = "No handler configured for " + file_path.filename().string();
+        return false;
+    }
+
+    // Take the first candidate that is installed
+    const Command* command = nullptr;
+    std::string executable;
+    for (const Command& candidate : it->second) {
+        executable = findExecutable(candidate[0]);
+        if (!executable.empty()) {
+            command = &candidate;
+            break;
+        }
+    }
+    if (!command) {
+        error = "Handler not found: " + it->second.front()[0];
+        return false;
+    }
+
+    // Substitute the file path for %f, or append it
+    std::vector<std::string> arguments;
+    bool substituted = false;
+    for (std::string argument : *command) {
+        for (size_t pos = argument.find("%f"); pos != std::string::npos;
+             pos = argument.find("%f", pos + file_path.string().size())) {
+            argument.replace(pos, 2, file_path.string());
+            substituted = true;
+        }
+        arguments.push_back(argument);
+    }
+    if (!substituted) {
+        arguments.push_back(file_path.string());
+    }
+
+    std::vector<char*> argv;
+    for (std::string& argument : arguments) {
+        argv.push_back(&argument[0]);
+    }
+    argv.push_back(nullptr);
+
+    // Detach the handler from the terminal: discard its I/O and give it its own
+    // process group so keyboard signals aimed at quickView do not reach it
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t empty_mask;
+    sigemptyset(&empty_mask);
+    posix_spawnattr_setsigmask(&attributes, &empty_mask);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK);
+
+    pid_t pid;
+    int result = posix_spawn(&pid, executable.c_str(), &actions, &attributes, argv.data(), environ);
+
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (result != 0) {
+        error = "Cannot start " + (*command)[0] + ": " + strerror(result);
+        return false;
+    }
+
+    children_.push_back({static_cast<long>(pid), (*command)[0]});
+    return true;
+#endif
+}
+
+bool ProcessLauncher::reapChildren(std::vector<std::string>& failures) {
+#ifdef _WIN32
+    (void)failures;
+    return false;
+#else
+    if (!child_exited || children_.empty()) {
+        return false;
+    }
+    child_exited = 0;
+
+    // Only wait for our own children so other subprocesses keep their exit status
+    bool reaped = false;
+    for (auto it = children_.begin(); it != children_.end();) {
+        int status;
+        pid_t result = waitpid(static_cast<pid_t>(it->pid), &status, WNOHANG);
+        if (result == 0 || (result < 0 && errno == EINTR)) {
+            ++it;
+            continue;
+        }
+
+        if (result > 0) {
+            if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+                failures.push_back(it->program + " exited with status " + std::to_string(WEXITSTATUS(status)));
+            } else if (WIFSIGNALED(status)) {
+                failures.push_back(it->program + " was killed by signal " + std::to_string(WTERMSIG(status)));
+            }
+        }
+        it = children_.erase(it);
+        reaped = true;
+    }
+    return reaped;
+#endif
+}
+
+void ProcessLauncher::installSignalHandler() {
+#ifndef _WIN32
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onChildExited;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_NOCLDSTOP;
+    sigaction(SIGCHLD, &action, nullptr);
+#endif
+}
+
+void ProcessLauncher::notifyChildExited() {
+#ifndef _WIN32
+    child_exited = 1;
+#endif
+}
+
+std::string ProcessLauncher::findExecutable(const std::string& program) {
+#ifdef _WIN32
+    return program;
+#else
+    if (program.find('/') != std::string::npos) {
+        return access(program.c_str(), X_OK) == 0 ? program : std::string();
+    }
+
+    const char* path = std::getenv("PATH");
+    std::string directories = path ? path : "/usr/bin:/bin";
+    size_t start = 0;
+    while (start <= directories.size()) {
+        size_t end = directories.find(':', start);
+        if (end == std::string::npos) end = directories.size();
+
+        std::string directory = directories.substr(start, end - start);
+        std::string candidate = (directory.empty() ? "." : directory) + "/" + program;
+        if (access(candidate.c_str(), X_OK) == 0) {
+            return candidate;
+        }
+        start = end + 1;
+    }
+    return std::string();
+#endif
+}
+
+bool ProcessLauncher::parseCommand(const std::string& line, std::string& extension, Command& command) {
+    // Split on whitespace; double quotes group words that contain spaces
+    std::vector<std::string> words;
+    std::string word;
+    bool in_word = false;
+    bool quoted = false;
+    for (char c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            in_word = true;
+        } else if (!quoted && std::isspace(static_cast<unsigned char>(c))) {
+            if (in_word) {
+                words.push_back(word);
+                word.clear();
+                in_word = false;
+            }
+        } else if (!quoted && c == '#' && !in_word) {
+            break;  // Comment
+        } else {
+            word += c;
+            in_word = true;
+        }
+    }
+    if (in_word) {
+        words.push_back(word);
+    }
+
+    if (words.size() < 2) {
+        return false;
+    }
+
+    extension = words[0];
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension != "*" && extension[0] != '.') {
+        extension = "." + extension;
+    }
+    command.assign(words.begin() + 1, words.end());
+    return true;
+}
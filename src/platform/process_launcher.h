@@ -0,0 +1,99 @@
+#ifndef PROCESS_LAUNCHER_H
+#define PROCESS_LAUNCHER_H
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Starts external "open with" handlers without a shell and without blocking
+ *
+ * Handlers are chosen by file extension. Each extension maps to a list of
+ * candidate commands; the first one found on PATH is spawned directly with
+ * its output discarded. Children are reaped from the main loop after SIGCHLD,
+ * so a handler that exits with an error can still be reported.
+ *
+ * Handlers are read from open_with.conf, one per line:
+ *     .png  feh --scale-down %f
+ *     *     xdg-open
+ * %f is replaced by the file path (appended when absent). Several lines for
+ * the same extension are tried in order, and "*" matches every file.
+ * On Windows files always open through the shell association.
+ */
+class ProcessLauncher {
+public:
+    using Command = std::vector<std::string>;
+
+    /**
+     * @brief Create a launcher with the built-in handlers
+     */
+    ProcessLauncher();
+
+    /**
+     * @brief Add handlers from a configuration file, replacing the defaults of the extensions it lists
+     * @param config_path Path to the configuration file
+     * @return true if the file was read, false if it does not exist or cannot be opened
+     */
+    bool loadHandlers(const std::filesystem::path& config_path);
+
+    /**
+     * @brief Get the per-user configuration file ($XDG_CONFIG_HOME/quickview/open_with.conf)
+     * @return Path to the configuration file, or an empty path if no home directory is known
+     */
+    static std::filesystem::path getDefaultConfigPath();
+
+    /**
+     * @brief Check if a handler is configured for the file's extension (ignoring "*")
+     * @param file_path Path to the file
+     * @return true if an extension-specific handler exists
+     */
+    bool hasHandler(const std::filesystem::path& file_path) const;
+
+    /**
+     * @brief Open a file with its handler; returns as soon as the process is started
+     * @param file_path Path to the file
+     * @param error Receives a description on failure
+     * @return true if a handler was started, false otherwise
+     */
+    bool open(const std::filesystem::path& file_path, std::string& error);
+
+    /**
+     * @brief Collect handlers that have exited since the last call
+     * @param failures Receives a message for each handler that failed
+     * @return true if any handler was reaped
+     */
+    bool reapChildren(std::vector<std::string>& failures);
+
+    /**
+     * @brief Get the number of handlers that are still running
+     */
+    size_t getRunningCount() const { return children_.size(); }
+
+    /**
+     * @brief Install the SIGCHLD handler that marks children for reaping
+     * The handler is installed without SA_RESTART so a blocking read of the
+     * keyboard returns and the main loop can reap promptly.
+     */
+    static void installSignalHandler();
+
+    /**
+     * @brief Mark children for reaping when SIGCHLD is received some other way
+     * For callers that block SIGCHLD and read it from a signalfd.
+     */
+    static void notifyChildExited();
+
+private:
+    struct Child {
+        long pid;
+        std::string program;
+    };
+
+    std::map<std::string, std::vector<Command>> handlers_;  // Lowercase extension or "*"
+    std::vector<Child> children_;
+
+    static std::string findExecutable(const std::string& program);
+    static bool parseCommand(const std::string& line, std::string& extension, Command& command);
+};
+
+#endif // PROCESS_LAUNCHER_H
@@ -5,12 +5,15 @@
     #include "../ui/windows/windows_terminal.h"
 #else
     #include "../ui/ncurses/ncurses_terminal.h"
+    #include "../ui/vt/vt_terminal.h"
 #endif
 
-std::unique_ptr<ITerminal> createTerminal() {
+std::unique_ptr<ITerminal> createTerminal(const std::string& backend) {
 #ifdef _WIN32
-    return std::make_unique<WindowsTerminal>();
+    if (backend.empty() || backend == "windows") return std::make_unique<WindowsTerminal>();
 #else
-    return std::make_unique<NCursesTerminal>();
+    if (backend.empty() || backend == "ncurses") return std::make_unique<NCursesTerminal>();
+    if (backend == "vt") return std::make_unique<VtTerminal>();
 #endif
+    return nullptr;
 }
@@ -3,6 +3,10 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <cstdint>
+
+class DrawList;
 
 /**
  * @brief Abstract interface for terminal operations
@@ -20,7 +24,9 @@ public:
         STATUS_BAR = 1,     // White on blue
         SELECTED = 2,       // Black on yellow  
         ERROR = 3,          // White on red
-        DIRECTORY = 4       // Green on black
+        DIRECTORY = 4,      // Green on black
+        DIFF_REMOVED = 5,   // Red on black
+        DIFF_ADDED = 6      // Green on black
     };
     
     // Key codes (standardized across platforms)
@@ -36,7 +42,8 @@ public:
         KEY_END_KEY,
         KEY_ENTER_KEY,
         KEY_ESCAPE_KEY,
-        KEY_RESIZE_EVENT
+        KEY_RESIZE_EVENT,
+        KEY_BACKSPACE_KEY       // Added last so that recorded key codes stay valid
     };
     
     virtual ~ITerminal() = default;
@@ -46,7 +53,28 @@ public:
     virtual void shutdown() = 0;
     virtual void getScreenSize(int& width, int& height) = 0;
     virtual int getKey() = 0;
-    
+
+    /**
+     * @brief Set how long getKey() waits for input
+     * @param milliseconds Timeout; negative blocks until a key arrives. On timeout getKey() returns KEY_UNKNOWN
+     */
+    virtual void setInputTimeout(int milliseconds) = 0;
+
+    /**
+     * @brief Get the descriptor that becomes readable when a key is pressed
+     * Lets the caller wait for input together with other events and call
+     * getKey() only once something has arrived.
+     * @return File descriptor, or -1 when input does not come from one
+     */
+    virtual int getInputDescriptor() = 0;
+
+    /**
+     * @brief Re-read the terminal size after a window change
+     * For callers that receive SIGWINCH themselves; getKey() then never
+     * returns KEY_RESIZE_EVENT.
+     */
+    virtual void updateScreenSize() = 0;
+
     // Window management
     virtual WindowHandle createWindow(int height, int width, int start_y, int start_x) = 0;
     virtual void destroyWindow(WindowHandle window) = 0;
@@ -57,13 +85,45 @@ public:
     virtual void drawBorder(WindowHandle window) = 0;
     virtual void drawText(WindowHandle window, int y, int x, const std::string& text) = 0;
     virtual void drawHorizontalLine(WindowHandle window, int y, int x, int length) = 0;
+
+    /**
+     * @brief Draw one row of image cells, each showing two vertically stacked pixels
+     * Backends use the upper half block with the top pixel as foreground and the
+     * bottom pixel as background, degrading to flat colors or ASCII shades.
+     * @param top RGB pixels of the upper pixel row, 3 bytes per cell
+     * @param bottom RGB pixels of the lower pixel row, or nullptr for an odd last row
+     * @param count Number of cells
+     */
+    virtual void drawImageRow(WindowHandle window, int y, int x,
+                              const uint8_t* top, const uint8_t* bottom, int count) = 0;
     
     // Text attributes
     virtual void setTextAttribute(WindowHandle window, ColorPair color, bool bold = false, bool reverse = false) = 0;
     virtual void clearTextAttribute(WindowHandle window, ColorPair color, bool bold = false, bool reverse = false) = 0;
+
+    /**
+     * @brief Run a recorded list of drawing commands against one window
+     * The window is resolved once and the commands are replayed in order, so a
+     * whole frame costs one virtual call instead of one per row.
+     * @param window Window to draw into
+     * @param list Commands to run
+     */
+    virtual void submit(WindowHandle window, const DrawList& list) = 0;
     
     // Screen operations
+
+    /**
+     * @brief Stage a window's contents for the next updateScreen()
+     * Backends keep the last staged frame of each window and skip the rows
+     * that have not changed since, so redrawing identical content is cheap.
+     */
     virtual void refreshWindow(WindowHandle window) = 0;
+
+    /**
+     * @brief Send every staged change to the screen in a single update
+     */
+    virtual void updateScreen() = 0;
+
     virtual void refreshScreen() = 0;
     virtual void clearScreen() = 0;
     
@@ -83,10 +143,121 @@ public:
     virtual void forceCompleteRedraw() = 0;
 };
 
+/**
+ * @brief Reusable buffer of drawing commands for one window
+ * Mirrors the drawing calls of ITerminal without the window argument. Text and
+ * pixel data are copied into one shared byte buffer, and reset() keeps the
+ * capacity, so recording a frame does not allocate once the buffer has grown.
+ */
+class DrawList {
+public:
+    enum class Op : uint8_t {
+        CLEAR_WINDOW,
+        DRAW_BORDER,
+        DRAW_TEXT,
+        CENTER_TEXT,
+        HORIZONTAL_LINE,
+        IMAGE_ROW,
+        SET_ATTRIBUTE,
+        CLEAR_ATTRIBUTE
+    };
+
+    struct Command {
+        Op op;
+        bool bold;
+        bool reverse;
+        ITerminal::ColorPair color;
+        int y;
+        int x;
+        int count;          // Line length or image cell count
+        uint32_t offset;    // Start of the command's text or pixels in the data buffer
+        uint32_t size;      // Bytes of text or pixels
+    };
+
+    void reset() {
+        commands_.clear();
+        data_.clear();
+    }
+
+    void clearWindow() { add(Op::CLEAR_WINDOW); }
+    void drawBorder() { add(Op::DRAW_BORDER); }
+
+    void drawText(int y, int x, const std::string& text) {
+        add(Op::DRAW_TEXT, y, x, 0, text.data(), text.size());
+    }
+
+    void drawText(int y, int x, const char* text, size_t length) {
+        add(Op::DRAW_TEXT, y, x, 0, text, length);
+    }
+
+    void centerText(int y, const std::string& text) {
+        add(Op::CENTER_TEXT, y, 0, 0, text.data(), text.size());
+    }
+
+    void drawHorizontalLine(int y, int x, int length) { add(Op::HORIZONTAL_LINE, y, x, length); }
+
+    void drawImageRow(int y, int x, const uint8_t* top, const uint8_t* bottom, int count) {
+        add(Op::IMAGE_ROW, y, x, count, top, static_cast<size_t>(count) * 3);
+        if (bottom) {
+            data_.insert(data_.end(), reinterpret_cast<const char*>(bottom),
+                         reinterpret_cast<const char*>(bottom) + static_cast<size_t>(count) * 3);
+            commands_.back().size += static_cast<uint32_t>(count) * 3;
+        }
+    }
+
+    void setTextAttribute(ITerminal::ColorPair color, bool bold = false, bool reverse = false) {
+        add(Op::SET_ATTRIBUTE);
+        setStyle(color, bold, reverse);
+    }
+
+    void clearTextAttribute(ITerminal::ColorPair color, bool bold = false, bool reverse = false) {
+        add(Op::CLEAR_ATTRIBUTE);
+        setStyle(color, bold, reverse);
+    }
+
+    const std::vector<Command>& getCommands() const { return commands_; }
+    bool empty() const { return commands_.empty(); }
+
+    // Text of a text command; it is command.size bytes long and not null-terminated
+    const char* getText(const Command& command) const {
+        return data_.data() + command.offset;
+    }
+
+    // Image rows store the top pixels, then the bottom ones when present
+    const uint8_t* getTopPixels(const Command& command) const {
+        return reinterpret_cast<const uint8_t*>(data_.data() + command.offset);
+    }
+
+    const uint8_t* getBottomPixels(const Command& command) const {
+        size_t row_bytes = static_cast<size_t>(command.count) * 3;
+        return command.size > row_bytes ? getTopPixels(command) + row_bytes : nullptr;
+    }
+
+private:
+    std::vector<Command> commands_;
+    std::vector<char> data_;
+
+    void add(Op op, int y = 0, int x = 0, int count = 0, const void* data = nullptr, size_t size = 0) {
+        commands_.push_back({op, false, false, ITerminal::DEFAULT, y, x, count,
+                             static_cast<uint32_t>(data_.size()), static_cast<uint32_t>(size)});
+        if (size > 0) {
+            const char* bytes = static_cast<const char*>(data);
+            data_.insert(data_.end(), bytes, bytes + size);
+        }
+    }
+
+    void setStyle(ITerminal::ColorPair color, bool bold, bool reverse) {
+        commands_.back().color = color;
+        commands_.back().bold = bold;
+        commands_.back().reverse = reverse;
+    }
+};
+
 /**
  * @brief Factory function to create platform-appropriate terminal instance
- * @return Unique pointer to terminal implementation
+ * @param backend "ncurses" or "vt" on Linux/macOS, "windows" on Windows; empty for the platform default
+ * @return Unique pointer to terminal implementation, or nullptr for an unknown backend
  */
-std::unique_ptr<ITerminal> createTerminal();
+std::unique_ptr<ITerminal> createTerminal(const std::string& backend = "");
 
 #endif // TERMINAL_INTERFACE_H
@@ -1,39 +1,90 @@
 #include "display.h"
 #include "../utils/utils.h"
+#include "../utils/trace.h"
 #include "../filesystem/file_operations.h"
 #include "../core/quickview.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    DrawList draw_list;
+    int draw_depth = 0;
+
+    /**
+     * @brief Records a Display function's drawing into the shared draw list
+     * Display functions that call each other draw into the outermost caller's
+     * list, which is submitted to the window once that caller returns.
+     */
+    class WindowDraw {
+    public:
+        WindowDraw(ITerminal* terminal, ITerminal::WindowHandle window)
+            : terminal_(terminal)
+            , window_(window)
+        {
+            if (draw_depth++ == 0) {
+                draw_list.reset();
+            }
+        }
+
+        ~WindowDraw() {
+            if (--draw_depth == 0) {
+                terminal_->submit(window_, draw_list);
+            }
+        }
+
+        DrawList& list() { return draw_list; }
+
+    private:
+        ITerminal* terminal_;
+        ITerminal::WindowHandle window_;
+    };
+
+    // Draw text cut to width - 4 cells the way the panels cut their lines, without building a string
+    void drawClipped(DrawList& list, int y, int x, const char* text, int width) {
+        size_t length = strlen(text);
+        if (static_cast<int>(length) > width - 4) {
+            size_t kept = static_cast<size_t>(std::max(0, width - 7));
+            list.drawText(y, x, text, kept);
+            list.drawText(y, x + static_cast<int>(kept), "...", 3);
+        } else {
+            list.drawText(y, x, text, length);
+        }
+    }
+}
 
 namespace Display {
     void drawFileBrowser(ITerminal* terminal,
                         ITerminal::WindowHandle window,
                         const std::vector<std::filesystem::directory_entry>& entries,
+                        EntryLabels& labels,
+                        const BrowserTree& tree,
                         int selected_index,
                         int scroll_offset,
-                        const std::filesystem::path& current_directory) {
-        terminal->clearWindow(window);
+                        const std::filesystem::path& marked_path,
+                        const std::set<std::filesystem::path>& selection) {
+        Trace::Span span("Display::drawFileBrowser");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
 
         // Draw border
-        terminal->drawBorder(window);
+        list.drawBorder();
 
         // Draw title
-        terminal->drawText(window, 0, 2, " Directory ");
+        list.drawText(0, 2, " Directory ");
 
         // Get window dimensions
         int max_y, max_x;
         terminal->getWindowSize(window, max_x, max_y);
         int display_height = max_y - 4;  // Account for borders, title, and header
 
-        // Display current directory path (truncated if too long)
-        std::string dir_path = current_directory.filename().string();
-        if (dir_path.empty()) dir_path = current_directory.string();
-        if (dir_path.length() > max_x - 4) {
-            dir_path = "..." + dir_path.substr(dir_path.length() - (max_x - 7));
-        }
-        terminal->drawText(window, 1, 1, dir_path);
+        // Display current directory name (truncated if too long)
+        list.drawText(1, 1, labels.getDirectoryLabel(max_x));
 
         // Draw horizontal line under directory name
-        terminal->drawHorizontalLine(window, 2, 1, max_x - 2);
+        list.drawHorizontalLine(2, 1, max_x - 2);
         
         // Display files starting from scroll offset
         int start_y = 3;
@@ -44,32 +95,31 @@ namespace Display {
             // Highlight selected file
             if (entry_index == selected_index) {
                 if (terminal->hasColors()) {
-                    terminal->setTextAttribute(window, ITerminal::SELECTED);
+                    list.setTextAttribute(ITerminal::SELECTED);
                 } else {
-                    terminal->setTextAttribute(window, ITerminal::DEFAULT, false, true); // reverse
+                    list.setTextAttribute(ITerminal::DEFAULT, false, true); // reverse
                 }
             }
 
-            // Get filename and truncate if necessary
-            std::string filename = entry.path().filename().string();
-            if (filename.length() > max_x - 4) {
-                filename = filename.substr(0, max_x - 7) + "...";
-            }
+            // Entries of expanded directories are indented by their depth
+            int indent = (size_t)entry_index < tree.size() ? std::min(2 * tree.getRow(entry_index).depth, max_x / 2) : 0;
 
-            // Add directory indicator
-            std::error_code ec;
-            if (entry.is_directory(ec) && !ec) {
-                filename = "[" + filename + "]";
+            // Flag the entry marked for comparison and entries selected for a job in front of the cached label
+            int x = 1 + indent;
+            if (!marked_path.empty() && entry.path() == marked_path) {
+                list.drawText(start_y + i, x++, "*", 1);
             }
-
-            terminal->drawText(window, start_y + i, 1, filename);
+            if (!selection.empty() && selection.count(entry.path())) {
+                list.drawText(start_y + i, x++, "+", 1);
+            }
+            list.drawText(start_y + i, x, labels.getRow(entry_index, max_x - indent));
 
             // Turn off highlighting
             if (entry_index == selected_index) {
                 if (terminal->hasColors()) {
-                    terminal->clearTextAttribute(window, ITerminal::SELECTED);
+                    list.clearTextAttribute(ITerminal::SELECTED);
                 } else {
-                    terminal->clearTextAttribute(window, ITerminal::DEFAULT, false, true); // reverse
+                    list.clearTextAttribute(ITerminal::DEFAULT, false, true); // reverse
                 }
             }
         }
@@ -78,83 +128,68 @@ namespace Display {
     void drawStatusBar(ITerminal* terminal,
                       ITerminal::WindowHandle window,
                       const std::vector<std::filesystem::directory_entry>& entries,
+                      EntryLabels& labels,
                       int selected_index,
-                      const std::filesystem::path& current_directory,
                       const std::string& status_message,
+                      const std::string& status_error,
+                      const std::string& job_status,
                       int screen_width) {
-        terminal->clearWindow(window);
-        
-        // Build status information
-        std::string status_info;
-        
-        if (!entries.empty() && selected_index < entries.size()) {
-            const auto& selected_entry = entries[selected_index];
-            std::string filename = selected_entry.path().filename().string();
-            
-            std::error_code ec;
-            if (selected_entry.is_directory(ec) && !ec) {
-                status_info = "[DIR] " + filename;
-            } else if (selected_entry.is_regular_file(ec) && !ec) {
-                // Try to get file size
-                try {
-                    auto file_size = std::filesystem::file_size(selected_entry.path());
-                    if (file_size < 1024) {
-                        status_info = filename + " (" + std::to_string(file_size) + " bytes)";
-                    } else if (file_size < 1024 * 1024) {
-                        status_info = filename + " (" + std::to_string(file_size / 1024) + " KB)";
-                    } else {
-                        status_info = filename + " (" + std::to_string(file_size / (1024 * 1024)) + " MB)";
-                    }
-                } catch (const std::exception& e) {
-                    status_info = filename + " (size unknown)";
-                }
-            } else {
-                status_info = filename + " (special file)";
-            }
-            
-            // Add current directory info
-            std::string dir_info = " | " + current_directory.filename().string();
-            if (dir_info == " | ") {
-                dir_info = " | " + current_directory.string();
-            }
-            
-            // Truncate if too long to fit with version info
-            std::string version_info = "quickView v1.0";
-            int available_space = screen_width - version_info.length() - 3; // 3 for spacing
-            
-            std::string full_status = status_info + dir_info;
-            if (full_status.length() > available_space) {
-                if (status_info.length() > available_space - 3) {
-                    status_info = status_info.substr(0, available_space - 3) + "...";
-                    full_status = status_info;
-                } else {
-                    full_status = status_info + "...";
-                }
+        Trace::Span span("Display::drawStatusBar");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+
+        // Space left of the version info, 3 for spacing
+        const char* version_info = "quickView v1.0";
+        int version_length = static_cast<int>(strlen(version_info));
+        int available_space = screen_width - version_length - 3;
+
+        // Job progress sits left of the version info, taking at most half of the bar
+        int job_length = std::min(static_cast<int>(job_status.length()), screen_width / 2);
+        if (job_length > 0) {
+            available_space -= job_length + 2;
+            list.drawText(0, screen_width - version_length - job_length - 3, job_status.data(), job_length);
+        }
+
+        if (!status_error.empty()) {
+            // Errors replace the file details until the next key press
+            list.setTextAttribute(ITerminal::ERROR);
+            if (available_space > 3 && (int)status_error.length() > available_space) {
+                list.drawText(0, 1, status_error.data(), available_space - 3);
+                list.drawText(0, available_space - 2, "...", 3);
             } else {
-                full_status = status_info + dir_info;
+                list.drawText(0, 1, status_error);
             }
-            
-            terminal->drawText(window, 0, 1, full_status);
+            list.clearTextAttribute(ITerminal::ERROR);
+        } else if (!entries.empty() && selected_index < entries.size()) {
+            // Name, size and directory, cached per entry
+            list.drawText(0, 1, labels.getStatus(selected_index, available_space));
         } else {
-            terminal->drawText(window, 0, 1, status_message);
+            list.drawText(0, 1, status_message);
         }
 
         // Display version info on the right
-        std::string version_info = "quickView v1.0";
-        terminal->drawText(window, 0, screen_width - version_info.length() - 1, version_info);
+        list.drawText(0, screen_width - version_length - 1, version_info, version_length);
     }
 
     void drawInfoWindow(ITerminal* terminal,
                        ITerminal::WindowHandle window,
                        const std::vector<std::filesystem::directory_entry>& entries,
-                       int selected_index) {
-        terminal->clearWindow(window);
+                       EntryLabels& labels,
+                       int selected_index,
+                       const FileAnalysis* analysis) {
+        Trace::Span span("Display::drawInfoWindow");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
 
         // Draw border
-        terminal->drawBorder(window);
+        list.drawBorder();
 
         // Draw title
-        terminal->drawText(window, 0, 2, " Info ");
+        list.drawText(0, 2, " Info ");
 
         // Show file/directory information
         if (!entries.empty() && selected_index < entries.size()) {
@@ -162,9 +197,9 @@ namespace Display {
 
             std::error_code ec;
             if (selected_entry.is_directory(ec) && !ec) {
-                drawDirectoryInfo(terminal, window, selected_entry);
+                drawDirectoryInfo(terminal, window, labels, selected_index);
             } else {
-                drawFileInfo(terminal, window, selected_entry);
+                drawFileInfo(terminal, window, selected_entry, labels, selected_index, analysis);
             }
         } else {
             // Get window dimensions
@@ -172,132 +207,107 @@ namespace Display {
             terminal->getWindowSize(window, max_x, max_y);
 
             int center_y = max_y / 2;
-            terminal->centerText(window, center_y, "No file selected");
+            list.centerText(center_y, "No file selected");
         }
     }
 
-    void drawDirectoryInfo(ITerminal* terminal, ITerminal::WindowHandle window, const std::filesystem::directory_entry& dir_entry) {
+    void drawDirectoryInfo(ITerminal* terminal, ITerminal::WindowHandle window, EntryLabels& labels, size_t index) {
+        Trace::Span span("Display::drawDirectoryInfo");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
         // Get window dimensions
         int max_y, max_x;
         terminal->getWindowSize(window, max_x, max_y);
 
-        // Show directory name (truncated if necessary)
-        std::string dirname = dir_entry.path().filename().string();
-        if (dirname.empty()) dirname = dir_entry.path().string();
-        if (dirname.length() > max_x - 4) {
-            dirname = dirname.substr(0, max_x - 7) + "...";
-        }
-        terminal->drawText(window, 1, 2, "[" + dirname + "]");
-
-        // Count directory contents
-        try {
-            int total_dirs = 0, total_files = 0;
-
-            std::error_code ec;
-            for (const auto& entry : std::filesystem::directory_iterator(dir_entry.path(), ec)) {
-                if (ec) break;
+        // Name, type and the number of entries inside, counted once per listing
+        list.drawText(1, 2, labels.getInfoName(index, max_x));
+        list.drawText(2, 2, "Directory", 9);
+        list.drawText(3, 2, labels.getInfoDetails(index, max_x));
 
-                std::error_code entry_ec;
-                if (entry.is_directory(entry_ec) && !entry_ec) {
-                    total_dirs++;
-                } else {
-                    total_files++;
-                }
-            }
-
-            terminal->drawText(window, 2, 2, "Directory");
-            terminal->drawText(window, 3, 2, "Total: " + std::to_string(total_dirs) + " dirs, " + std::to_string(total_files) + " files");
-
-            // Show truncated path if there's space
-            if (max_y > 4) {
-                std::string path_display = dir_entry.path().string();
-                if (path_display.length() > max_x - 4) {
-                    // Show end of path with "..."
-                    path_display = "..." + path_display.substr(path_display.length() - (max_x - 7));
-                }
-                terminal->drawText(window, max_y - 2, 2, path_display);
-            }
-
-        } catch (const std::exception& e) {
-            terminal->drawText(window, 2, 2, "Directory");
-            terminal->drawText(window, 3, 2, "Error reading contents");
+        // Show truncated path if there's space
+        if (max_y > 4) {
+            list.drawText(max_y - 2, 2, labels.getInfoPath(index, max_x));
         }
     }
 
-    void drawFileInfo(ITerminal* terminal, ITerminal::WindowHandle window, const std::filesystem::directory_entry& file_entry) {
+    void drawFileInfo(ITerminal* terminal, ITerminal::WindowHandle window, const std::filesystem::directory_entry& file_entry,
+                      EntryLabels& labels, size_t index, const FileAnalysis* analysis) {
+        Trace::Span span("Display::drawFileInfo");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
         // Get window dimensions
         int max_y, max_x;
         terminal->getWindowSize(window, max_x, max_y);
 
-        // Show filename (truncated if necessary)
-        std::string filename = file_entry.path().filename().string();
-        if (filename.length() > max_x - 4) {
-            filename = filename.substr(0, max_x - 7) + "...";
-        }
-        terminal->drawText(window, 1, 2, filename);
+        // Show filename, then file type and size on one line
+        list.drawText(1, 2, labels.getInfoName(index, max_x));
+        list.drawText(2, 2, labels.getInfoDetails(index, max_x));
 
-        // Show file type and size on one line
-        std::string type_info;
         std::error_code ec;
         if (file_entry.is_regular_file(ec) && !ec) {
-            try {
-                auto file_size = std::filesystem::file_size(file_entry.path());
-                if (file_size < 1024) {
-                    type_info = "File (" + std::to_string(file_size) + " bytes)";
-                } else if (file_size < 1024 * 1024) {
-                    type_info = "File (" + std::to_string(file_size / 1024) + " KB)";
-                } else if (file_size < 1024 * 1024 * 1024) {
-                    type_info = "File (" + std::to_string(file_size / (1024 * 1024)) + " MB)";
-                } else {
-                    type_info = "File (" + std::to_string(file_size / (1024 * 1024 * 1024)) + " GB)";
-                }
-            } catch (const std::exception& e) {
-                type_info = "File (size unknown)";
-            }
-
             // Show file extension if available and space permits
             std::string extension = file_entry.path().extension().string();
             if (!extension.empty() && max_y > 3) {
-                terminal->drawText(window, 3, 2, "Ext: " + extension);
+                list.drawText(3, 2, "Ext: ", 5);
+                list.drawText(3, 7, extension);
             }
 
-        } else if (file_entry.is_directory(ec) && !ec) {
-            type_info = "Directory";
-        } else if (file_entry.is_symlink(ec) && !ec) {
-            type_info = "Symbolic Link";
-        } else {
-            type_info = "Special File";
-        }
+            // Show content analysis once the background pass has finished, in rows 4 and up,
+            // stopping above the path line
+            char line[160];
+            int row = 4;
+            auto addLine = [&](const char* text) {
+                if (row < max_y - 2) {
+                    drawClipped(list, row++, 2, text, max_x);
+                }
+            };
+            if (!analysis) {
+                addLine("Analyzing...");
+            } else if (!analysis->error.empty()) {
+                snprintf(line, sizeof(line), "Analysis failed: %s", analysis->error.c_str());
+                addLine(line);
+            } else {
+                if (analysis->binary) {
+                    addLine("Binary");
+                } else {
+                    snprintf(line, sizeof(line), "Text, %s, %llu %s", analysis->encoding.c_str(),
+                             static_cast<unsigned long long>(analysis->line_count),
+                             analysis->line_count == 1 ? "line" : "lines");
+                    addLine(line);
+                }
 
-        // Truncate type info if too long
-        if (type_info.length() > max_x - 4) {
-            type_info = type_info.substr(0, max_x - 7) + "...";
+                snprintf(line, sizeof(line), "xxh3: %016llx", static_cast<unsigned long long>(analysis->xxh3));
+                addLine(line);
+                if (analysis->sha256.empty()) {
+                    addLine("sha256: press 's' to compute");
+                } else {
+                    snprintf(line, sizeof(line), "sha256: %s", analysis->sha256.c_str());
+                    addLine(line);
+                }
+            }
         }
-        terminal->drawText(window, 2, 2, type_info);
 
         // Show truncated path if there's space
         if (max_y > 4) {
-            std::string path_display = file_entry.path().string();
-            if (path_display.length() > max_x - 4) {
-                // Show end of path with "..."
-                path_display = "..." + path_display.substr(path_display.length() - (max_x - 7));
-            }
-            terminal->drawText(window, max_y - 2, 2, path_display);
+            list.drawText(max_y - 2, 2, labels.getInfoPath(index, max_x));
         }
     }
 
-
-
-
-
-
-
     // Stub implementations for remaining functions - to be completed
     void drawNormalContent(ITerminal* terminal, ITerminal::WindowHandle window,
                           const std::vector<std::filesystem::directory_entry>& entries,
-                          int selected_index) {
-        terminal->clearWindow(window);
-        terminal->drawBorder(window);
+                          EntryLabels& labels,
+                          int selected_index,
+                          const TextPreview* preview,
+                          const ImagePreview* image_preview) {
+        Trace::Span span("Display::drawNormalContent");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+        list.drawBorder();
 
         // Get window dimensions
         int max_y, max_x;
@@ -309,78 +319,199 @@ namespace Display {
 
             std::error_code ec;
             if (selected_entry.is_directory(ec) && !ec) {
-                drawDirectoryContentsInWindow(terminal, selected_entry.path(), window);
+                drawDirectoryContentsInWindow(terminal, labels, selected_index, window);
+            } else if (selected_entry.is_regular_file(ec) && !ec) {
+                if (ImageHandler::canPreview(selected_entry.path())) {
+                    drawImagePreview(terminal, window, selected_entry.path(), image_preview);
+                } else {
+                    drawFilePreview(terminal, window, selected_entry.path(), preview);
+                }
             } else {
-                // Show file preview or placeholder for files
+                // Show placeholder for special files
                 int center_y = max_y / 2;
-                terminal->centerText(window, center_y - 1, "File Preview");
-                terminal->centerText(window, center_y + 1, "File details shown in info panel below");
+                list.centerText(center_y - 1, "File Preview");
+                list.centerText(center_y + 1, "File details shown in info panel below");
             }
         } else {
             // Show welcome/placeholder content
             int center_y = max_y / 2;
-            terminal->centerText(window, center_y - 2, "Content Area");
-            terminal->centerText(window, center_y, "Directory contents shown here");
-            terminal->centerText(window, center_y + 2, "Use arrow keys to navigate files");
-            terminal->centerText(window, center_y + 3, "Press Enter to open directories");
+            list.centerText(center_y - 2, "Content Area");
+            list.centerText(center_y, "Directory contents shown here");
+            list.centerText(center_y + 2, "Use arrow keys to navigate files");
+            list.centerText(center_y + 3, "Press Enter to open directories");
+        }
+    }
+
+    void drawFilePreview(ITerminal* terminal, ITerminal::WindowHandle window,
+                        const std::filesystem::path& file_path,
+                        const TextPreview* preview) {
+        Trace::Span span("Display::drawFilePreview");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        // Get window dimensions (border already drawn by parent)
+        int max_y, max_x;
+        terminal->getWindowSize(window, max_x, max_y);
+        int center_y = max_y / 2;
+
+        if (!preview) {
+            list.centerText(center_y, "Loading preview...");
+            return;
+        }
+        if (!preview->error.empty()) {
+            list.centerText(center_y - 1, "No preview available");
+            list.centerText(center_y + 1, preview->error);
+            return;
+        }
+        if (preview->binary) {
+            list.centerText(center_y - 1, "Binary file");
+            list.centerText(center_y + 1, "File details shown in info panel below");
+            return;
+        }
+
+        // Draw title
+        std::string title = "Preview: " + file_path.filename().string();
+        if (title.length() > max_x - 4) {
+            title = title.substr(0, max_x - 7) + "...";
+        }
+        list.drawText(1, 2, title);
+
+        // Draw horizontal line
+        list.drawHorizontalLine(2, 2, max_x - 4);
+
+        // Display as many lines as fit
+        int display_height = max_y - 4;  // Account for borders and title
+        for (int i = 0; i < display_height && i < (int)preview->lines.size(); i++) {
+            const std::string& line = preview->lines[i];
+            if (line.length() > max_x - 4) {
+                list.drawText(3 + i, 2, line.substr(0, max_x - 4));
+            } else {
+                list.drawText(3 + i, 2, line);
+            }
+        }
+    }
+
+    void drawImagePreview(ITerminal* terminal, ITerminal::WindowHandle window,
+                         const std::filesystem::path& file_path,
+                         const ImagePreview* preview) {
+        Trace::Span span("Display::drawImagePreview");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        // Get window dimensions (border already drawn by parent)
+        int max_y, max_x;
+        terminal->getWindowSize(window, max_x, max_y);
+        int center_y = max_y / 2;
+
+        if (!preview) {
+            list.centerText(center_y, "Decoding image...");
+            return;
+        }
+        if (!preview->error.empty()) {
+            list.centerText(center_y - 1, "No preview available");
+            list.centerText(center_y + 1, preview->error);
+            return;
+        }
+
+        // Draw title with the original size
+        std::string title = "Image: " + file_path.filename().string() + " (" +
+                            std::to_string(preview->source_width) + "x" +
+                            std::to_string(preview->source_height) + " " + preview->format + ")";
+        if (title.length() > max_x - 4) {
+            title = title.substr(0, max_x - 7) + "...";
+        }
+        list.drawText(1, 2, title);
+        list.drawHorizontalLine(2, 2, max_x - 4);
+
+        // Center horizontally; the image was scaled to fit the area below the title
+        int display_height = max_y - 4;
+        int width = std::min(preview->width, max_x - 4);
+        int start_x = 2 + (max_x - 4 - width) / 2;
+        const size_t row_bytes = static_cast<size_t>(preview->width) * 3;
+        for (int row = 0; row < display_height && row * 2 < preview->height; row++) {
+            const uint8_t* top = preview->rgb.data() + row * 2 * row_bytes;
+            const uint8_t* bottom = row * 2 + 1 < preview->height ? top + row_bytes : nullptr;
+            list.drawImageRow(3 + row, start_x, top, bottom, width);
         }
     }
 
     void drawHelpContent(ITerminal* terminal, ITerminal::WindowHandle window) {
-        terminal->clearWindow(window);
-        terminal->drawBorder(window);
-
-        terminal->drawText(window, 2, 2, "Welcome to quickView!");
-        terminal->drawText(window, 3, 2, "=====================");
-        terminal->drawText(window, 5, 2, "File Browser Navigation:");
-        terminal->drawText(window, 6, 4, "UP/DOWN  - Navigate file list");
-        terminal->drawText(window, 7, 4, "PgUp/PgDn- Page through file list");
-        terminal->drawText(window, 8, 4, "HOME/END - Go to top/bottom of list");
-        terminal->drawText(window, 9, 4, "ENTER    - Enter directory/select file");
-        terminal->drawText(window, 11, 2, "File Viewing (press 'v' on a file):");
-        terminal->drawText(window, 12, 4, "UP/DOWN  - Scroll line by line");
-        terminal->drawText(window, 13, 4, "PgUp/PgDn- Scroll page by page");
-        terminal->drawText(window, 14, 4, "HOME/END - Go to top/bottom");
-        terminal->drawText(window, 16, 2, "Interface Layout:");
-        terminal->drawText(window, 17, 4, "Left Panel    - File browser");
-        terminal->drawText(window, 18, 4, "Top Right     - Directory/file contents");
-        terminal->drawText(window, 19, 4, "Bottom Right  - File/directory information");
-        terminal->drawText(window, 20, 4, "Status Bar    - Current selection details");
-        terminal->drawText(window, 22, 2, "General Commands:");
-        terminal->drawText(window, 23, 4, "v, V     - View files (opens images in viewer)");
-        terminal->drawText(window, 24, 4, "h, H     - Show this help");
-        terminal->drawText(window, 25, 4, "a, A     - Show about information");
-        terminal->drawText(window, 26, 4, "q, Q     - Quit application");
-        terminal->drawText(window, 27, 4, "ESC      - Quit application");
-
-        terminal->drawText(window, 29, 2, "Press any key to start browsing files...");
+        Trace::Span span("Display::drawHelpContent");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+        list.drawBorder();
+
+        list.drawText(2, 2, "Welcome to quickView!");
+        list.drawText(3, 2, "=====================");
+        list.drawText(5, 2, "File Browser Navigation:");
+        list.drawText(6, 4, "UP/DOWN  - Navigate file list");
+        list.drawText(7, 4, "PgUp/PgDn- Page through file list");
+        list.drawText(8, 4, "HOME/END - Go to top/bottom of list");
+        list.drawText(9, 4, "ENTER    - Enter directory/select file");
+        list.drawText(10, 4, "RIGHT/LEFT - Expand/collapse directory in place");
+        list.drawText(11, 4, "Typing   - Jump to the first name starting with it");
+        list.drawText(12, 2, "File Viewing (press 'v' on a file):");
+        list.drawText(13, 4, "UP/DOWN  - Scroll line by line");
+        list.drawText(14, 4, "PgUp/PgDn- Scroll page by page");
+        list.drawText(15, 4, "HOME/END - Go to top/bottom");
+        list.drawText(16, 4, "ENTER/LEFT - Expand/collapse nodes in .json files");
+        list.drawText(17, 2, "Interface Layout:");
+        list.drawText(18, 4, "Left Panel    - File browser");
+        list.drawText(19, 4, "Top Right     - Directory/file contents");
+        list.drawText(20, 4, "Bottom Right  - File/directory information");
+        list.drawText(21, 4, "Status Bar    - Current selection details");
+        list.drawText(22, 2, "General Commands:");
+        list.drawText(23, 4, "v, V     - View files (opens images in viewer)");
+        list.drawText(24, 4, "s, S     - Compute SHA-256 of the selected file");
+        list.drawText(25, 4, "d, D     - Find duplicate files below this directory");
+        list.drawText(26, 4, "g, G     - Jump to a visited directory by part of its name");
+        list.drawText(27, 4, "m, M     - Mark an entry; c, C compares it with the selected one");
+        list.drawText(28, 4, "SPACE    - Select; p, P copies and x, X moves the selection here");
+        list.drawText(29, 4, "r, R     - Remove the selection or entry; k, K cancels file jobs");
+        list.drawText(30, 4, "h, H     - Show this help");
+        list.drawText(31, 4, "a, A     - Show about information");
+        list.drawText(32, 4, "t, T     - Write the trace file (with --trace=FILE)");
+        list.drawText(33, 4, "q, Q     - Quit application");
+        list.drawText(34, 4, "ESC      - Quit application");
+
+        list.drawText(35, 2, "Press any key to start browsing files...");
     }
 
     void drawAboutContent(ITerminal* terminal, ITerminal::WindowHandle window) {
-        terminal->clearWindow(window);
-        terminal->drawBorder(window);
-
-        terminal->centerText(window, 5, "quickView v1.0");
-        terminal->centerText(window, 7, "A C++ NCurses GUI Application");
-        terminal->centerText(window, 9, "by Thomas Borland");
-        terminal->centerText(window, 11, "Built with modern C++17");
-        terminal->centerText(window, 13, "Press any key to return...");
+        Trace::Span span("Display::drawAboutContent");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+        list.drawBorder();
+
+        list.centerText(5, "quickView v1.0");
+        list.centerText(7, "A C++ NCurses GUI Application");
+        list.centerText(9, "by Thomas Borland");
+        list.centerText(11, "Built with modern C++17");
+        list.centerText(13, "Press any key to return...");
     }
 
     void drawFileViewContent(ITerminal* terminal, ITerminal::WindowHandle window,
                             const std::vector<std::string>& file_lines,
                             int scroll_offset,
                             const std::string& filename) {
-        terminal->clearWindow(window);
-        terminal->drawBorder(window);
+        Trace::Span span("Display::drawFileViewContent");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+        list.drawBorder();
 
         // Get window dimensions
         int max_y, max_x;
         terminal->getWindowSize(window, max_x, max_y);
 
         if (file_lines.empty()) {
-            terminal->centerText(window, max_y / 2, "No file content to display");
-            terminal->centerText(window, max_y / 2 + 2, "Press any key to return...");
+            list.centerText(max_y / 2, "No file content to display");
+            list.centerText(max_y / 2 + 2, "Press any key to return...");
             return;
         }
 
@@ -390,10 +521,10 @@ namespace Display {
         if (display_filename.length() > max_x - 6) {
             display_filename = display_filename.substr(0, max_x - 9) + "...";
         }
-        terminal->drawText(window, 1, 2, "File: " + display_filename);
+        list.drawText(1, 2, "File: " + display_filename);
 
         // Draw horizontal line
-        terminal->drawHorizontalLine(window, 2, 2, max_x - 4);
+        list.drawHorizontalLine(2, 2, max_x - 4);
 
         // Display file content
         int display_height = max_y - 5;  // Account for borders, title, and bottom margin
@@ -409,7 +540,7 @@ namespace Display {
                 display_line = display_line.substr(0, max_x - 4);
             }
 
-            terminal->drawText(window, start_line + i, 2, display_line);
+            list.drawText(start_line + i, 2, display_line);
         }
 
         // Show scroll indicator and controls
@@ -418,91 +549,425 @@ namespace Display {
                                     std::to_string(std::min(scroll_offset + display_height, (int)file_lines.size())) +
                                     " of " + std::to_string(file_lines.size()) +
                                     " | UP/DOWN:scroll PgUp/PgDn:page HOME/END:top/bottom ESC:exit";
-            terminal->drawText(window, max_y - 2, 2, scroll_info);
+            list.drawText(max_y - 2, 2, scroll_info);
         } else {
-            terminal->drawText(window, max_y - 2, 2, "UP/DOWN:scroll PgUp/PgDn:page HOME/END:top/bottom ESC:exit");
+            list.drawText(max_y - 2, 2, "UP/DOWN:scroll PgUp/PgDn:page HOME/END:top/bottom ESC:exit");
         }
     }
 
 
 
-    void drawDirectoryContentsInWindow(ITerminal* terminal, const std::filesystem::path& dir_path, ITerminal::WindowHandle window) {
-        // Get window dimensions (border already drawn by parent)
+    void drawJsonViewContent(ITerminal* terminal, ITerminal::WindowHandle window, const JsonTree& tree) {
+        Trace::Span span("Display::drawJsonViewContent");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+        list.drawBorder();
+
+        // Get window dimensions
         int max_y, max_x;
         terminal->getWindowSize(window, max_x, max_y);
 
         // Draw title
-        terminal->drawText(window, 1, 2, "Contents:");
-
-        // Show full directory path with proper truncation
-        std::string full_path = dir_path.string();
-        std::string display_path;
-
-        // Apply standard path shortening technique
-        int available_width = max_x - 6; // Account for borders and brackets
-        if (full_path.length() > available_width) {
-            // Show beginning and end of path with "..." in middle
-            int prefix_len = available_width / 3;
-            int suffix_len = available_width - prefix_len - 3; // 3 for "..."
-
-            if (prefix_len > 0 && suffix_len > 0) {
-                display_path = full_path.substr(0, prefix_len) + "..." +
-                              full_path.substr(full_path.length() - suffix_len);
+        std::string title = "JSON: " + tree.getPath().filename().string() + " (" + Utils::formatSize(tree.getFileSize()) + ")";
+        if (title.length() > max_x - 4) {
+            title = title.substr(0, max_x - 7) + "...";
+        }
+        list.drawText(1, 2, title);
+
+        // Draw horizontal line
+        list.drawHorizontalLine(2, 2, max_x - 4);
+
+        // Display visible rows only
+        int display_height = max_y - 5;  // Account for borders, title, and bottom margin
+        int start_line = 3;
+        int scroll_offset = tree.getScrollOffset();
+        size_t row_width = max_x > 4 ? max_x - 4 : 0;
+
+        for (int i = 0; i < display_height && (size_t)(i + scroll_offset) < tree.getRowCount(); i++) {
+            int row_index = i + scroll_offset;
+            bool selected = row_index == tree.getSelectedRow();
+
+            if (selected) {
+                if (terminal->hasColors()) {
+                    list.setTextAttribute(ITerminal::SELECTED);
+                } else {
+                    list.setTextAttribute(ITerminal::DEFAULT, false, true); // reverse
+                }
+            }
+
+            list.drawText(start_line + i, 2, tree.formatRow(row_index, row_width));
+
+            if (selected) {
+                if (terminal->hasColors()) {
+                    list.clearTextAttribute(ITerminal::SELECTED);
+                } else {
+                    list.clearTextAttribute(ITerminal::DEFAULT, false, true); // reverse
+                }
+            }
+        }
+
+        std::string footer = "Row " + std::to_string(tree.getSelectedRow() + 1) + " of " +
+                             std::to_string(tree.getRowCount()) +
+                             " | ENTER/RIGHT:expand LEFT:collapse PgUp/PgDn:page ESC:exit";
+        if (footer.length() > row_width) {
+            footer = footer.substr(0, row_width);
+        }
+        list.drawText(max_y - 2, 2, footer);
+    }
+
+    void drawDiffViewContent(ITerminal* terminal,
+                             ITerminal::WindowHandle window,
+                             const DiffView& view) {
+        Trace::Span span("Display::drawDiffViewContent");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+        list.drawBorder();
+
+        // Get window dimensions
+        int max_y, max_x;
+        terminal->getWindowSize(window, max_x, max_y);
+        size_t row_width = max_x > 4 ? max_x - 4 : 0;
+
+        // Draw title
+        std::string title = "Diff: " + view.getLeftPath().filename().string() + " -> " +
+                            view.getRightPath().filename().string();
+        if (title.length() > row_width) {
+            title = title.substr(0, row_width);
+        }
+        list.drawText(1, 2, title);
+
+        // Draw horizontal line
+        list.drawHorizontalLine(2, 2, max_x - 4);
+
+        // Two columns split by " | ", each with a line number gutter
+        size_t largest = std::max(view.getLeftLineCount(), view.getRightLineCount());
+        size_t gutter = std::to_string(largest).length() + 1;
+        size_t column_width = row_width > 3 ? (row_width - 3) / 2 : 0;
+        size_t text_width = column_width > gutter ? column_width - gutter : 0;
+        int right_x = 2 + (int)column_width + 3;
+
+        int display_height = max_y - 5;  // Account for borders, title, and bottom margin
+        int start_line = 3;
+        int scroll_offset = view.getScrollOffset();
+
+        for (int i = 0; i < display_height && (size_t)(i + scroll_offset) < view.getRowCount(); i++) {
+            DiffView::Row row = view.getRow(i + scroll_offset);
+
+            for (int side = 0; side < 2; side++) {
+                long line = side == 0 ? row.left : row.right;
+                if (line < 0) continue;
+
+                std::string number = std::to_string(line + 1);
+                std::string text = std::string(gutter - 1 - number.length(), ' ') + number + " " +
+                                   view.formatLine(side == 1, line, text_width);
+                ITerminal::ColorPair color = side == 0 ? ITerminal::DIFF_REMOVED : ITerminal::DIFF_ADDED;
+                bool highlight = row.changed && terminal->hasColors();
+
+                if (highlight) list.setTextAttribute(color);
+                list.drawText(start_line + i, side == 0 ? 2 : right_x, text);
+                if (highlight) list.clearTextAttribute(color);
+            }
+
+            // Without colors, changed rows are flagged in the separator
+            list.drawText(start_line + i, 2 + (int)column_width + 1,
+                               row.changed && !terminal->hasColors() ? "*" : "|");
+        }
+
+        std::string footer;
+        if (view.getHunkCount() == 0) {
+            footer = "Files are identical";
+        } else if (view.getCurrentHunk() >= 0) {
+            footer = "Hunk " + std::to_string(view.getCurrentHunk() + 1) + " of " + std::to_string(view.getHunkCount());
+        } else {
+            footer = std::to_string(view.getHunkCount()) + " hunks";
+        }
+        footer += " | n:next hunk p:previous PgUp/PgDn:page ESC:exit";
+        if (footer.length() > row_width) {
+            footer = footer.substr(0, row_width);
+        }
+        list.drawText(max_y - 2, 2, footer);
+    }
+
+    void drawCompareViewContent(ITerminal* terminal,
+                                ITerminal::WindowHandle window,
+                                const CompareView& view,
+                                const TreeCompareProgress* progress) {
+        Trace::Span span("Display::drawCompareViewContent");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+        list.drawBorder();
+
+        // Get window dimensions
+        int max_y, max_x;
+        terminal->getWindowSize(window, max_x, max_y);
+        size_t row_width = max_x > 4 ? max_x - 4 : 0;
+
+        // Draw title
+        std::string title = "Compare: " + view.getLeftRoot().string() + " -> " + view.getRightRoot().string();
+        if (title.length() > row_width) {
+            title = title.substr(0, row_width);
+        }
+        list.drawText(1, 2, title);
+
+        // Draw horizontal line
+        list.drawHorizontalLine(2, 2, max_x - 4);
+
+        // Rows stream in while the comparison runs, so the list is drawn in both states
+        int display_height = max_y - 5;  // Account for borders, title, and bottom margin
+        int start_line = 3;
+        int scroll_offset = view.getScrollOffset();
+
+        if (view.getRowCount() == 0) {
+            list.centerText(max_y / 2, progress ? "Comparing..." : "Directories are identical");
+        }
+
+        for (int i = 0; i < display_height && (size_t)(i + scroll_offset) < view.getRowCount(); i++) {
+            int row_index = i + scroll_offset;
+            bool selected = row_index == view.getSelectedRow();
+            const TreeDifference* difference = view.getDifference(row_index);
+
+            // Added entries are green, removed ones red and changed ones bold
+            ITerminal::ColorPair color = ITerminal::DEFAULT;
+            bool bold = false;
+            if (selected) {
+                color = ITerminal::SELECTED;
+            } else if (!difference) {
+                color = ITerminal::DIRECTORY;
+            } else if (difference->kind == TreeDifference::ADDED) {
+                color = ITerminal::DIFF_ADDED;
+            } else if (difference->kind == TreeDifference::REMOVED) {
+                color = ITerminal::DIFF_REMOVED;
             } else {
-                // Fallback: just truncate from end
-                display_path = full_path.substr(0, available_width - 3) + "...";
+                bold = true;
             }
+            bool reverse = selected && !terminal->hasColors();
+            if (!terminal->hasColors()) color = ITerminal::DEFAULT;
+
+            list.setTextAttribute(color, bold, reverse);
+            list.drawText(start_line + i, 2, view.formatRow(row_index, row_width));
+            list.clearTextAttribute(color, bold, reverse);
+        }
+
+        std::string footer = "+" + std::to_string(view.getCount(TreeDifference::ADDED)) + " added  -" +
+                             std::to_string(view.getCount(TreeDifference::REMOVED)) + " removed  ~" +
+                             std::to_string(view.getCount(TreeDifference::CHANGED)) + " changed";
+        if (progress) {
+            footer += " | " + std::to_string(progress->directories.load()) + " directories, " +
+                      std::to_string(progress->files_compared.load()) + " files, " +
+                      Utils::formatSize(progress->bytes_read.load()) + " read | ESC:cancel";
         } else {
-            display_path = full_path;
+            footer += " | Enter:diff/collapse ESC:exit";
+        }
+        if (footer.length() > row_width) {
+            footer = footer.substr(0, row_width);
         }
+        list.drawText(max_y - 2, 2, footer);
+    }
+
+    void drawDuplicateViewContent(ITerminal* terminal,
+                                  ITerminal::WindowHandle window,
+                                  const DuplicateView& view,
+                                  const DuplicateProgress* progress) {
+        Trace::Span span("Display::drawDuplicateViewContent");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+        list.drawBorder();
+
+        // Get window dimensions
+        int max_y, max_x;
+        terminal->getWindowSize(window, max_x, max_y);
+        size_t row_width = max_x > 4 ? max_x - 4 : 0;
 
-        terminal->drawText(window, 2, 2, display_path);
+        // Draw title
+        std::string title = "Duplicates: " + view.getRoot().string();
+        if (title.length() > row_width) {
+            title = "..." + title.substr(title.length() - (row_width - 3));
+        }
+        list.drawText(1, 2, title);
 
         // Draw horizontal line
-        terminal->drawHorizontalLine(window, 3, 2, max_x - 4);
+        list.drawHorizontalLine(2, 2, max_x - 4);
+
+        if (progress) {
+            uint64_t hashed = progress->files_hashed.load();
+            uint64_t to_hash = progress->files_to_hash.load();
+            std::string stage;
+            switch (progress->stage.load()) {
+                case DuplicateProgress::WALKING:
+                    stage = "Scanning directories";
+                    break;
+                case DuplicateProgress::GROUPING:
+                    stage = "Grouping files by size";
+                    break;
+                case DuplicateProgress::PARTIAL_HASH:
+                    stage = "Hashing first and last 4 KB: " + std::to_string(hashed) + " of " + std::to_string(to_hash);
+                    break;
+                default:
+                    stage = "Hashing whole files: " + std::to_string(hashed) + " of " + std::to_string(to_hash);
+                    break;
+            }
 
-        std::vector<std::filesystem::directory_entry> preview_entries;
-        if (FileOperations::loadDirectoryPreview(dir_path, preview_entries)) {
-            // Display entries
-            int display_height = max_y - 6;  // Account for borders, title, and bottom margin
-            int entries_shown = 0;
+            list.drawText(4, 2, stage.substr(0, row_width));
+            list.drawText(5, 2, (std::to_string(progress->files_found.load()) + " files found, " +
+                                              Utils::formatSize(progress->bytes_hashed.load()) + " read").substr(0, row_width));
+            list.drawText(max_y - 2, 2, std::string("Any key: cancel").substr(0, row_width));
+            return;
+        }
 
-            for (const auto& entry : preview_entries) {
-                if (entries_shown >= display_height) break;
+        if (view.getRowCount() == 0) {
+            list.centerText(max_y / 2, "No duplicate files found");
+            return;
+        }
+
+        // Display visible rows only
+        int display_height = max_y - 5;  // Account for borders, title, and bottom margin
+        int start_line = 3;
+        int scroll_offset = view.getScrollOffset();
 
-                std::string filename = entry.path().filename().string();
+        for (int i = 0; i < display_height && (size_t)(i + scroll_offset) < view.getRowCount(); i++) {
+            int row_index = i + scroll_offset;
+            bool selected = row_index == view.getSelectedRow();
+            bool header = view.isHeaderRow(row_index);
 
-                // Truncate filename if too long
-                if (filename.length() > max_x - 6) {
-                    filename = filename.substr(0, max_x - 9) + "...";
+            if (selected) {
+                if (terminal->hasColors()) {
+                    list.setTextAttribute(ITerminal::SELECTED);
+                } else {
+                    list.setTextAttribute(ITerminal::DEFAULT, false, true); // reverse
                 }
+            } else if (header) {
+                list.setTextAttribute(ITerminal::DEFAULT, true);
+            }
 
-                // Add directory indicator and color
-                std::error_code ec;
-                if (entry.is_directory(ec) && !ec) {
-                    filename = "[" + filename + "]";
-                    // Use color for directories if available
-                    if (terminal->hasColors()) {
-                        terminal->setTextAttribute(window, ITerminal::DIRECTORY);
-                    }
+            list.drawText(start_line + i, 2, view.formatRow(row_index, row_width));
+
+            if (selected) {
+                if (terminal->hasColors()) {
+                    list.clearTextAttribute(ITerminal::SELECTED);
+                } else {
+                    list.clearTextAttribute(ITerminal::DEFAULT, false, true); // reverse
                 }
+            } else if (header) {
+                list.clearTextAttribute(ITerminal::DEFAULT, true);
+            }
+        }
 
-                terminal->drawText(window, 4 + entries_shown, 2, filename);
+        std::string footer = std::to_string(view.getGroupCount()) + " groups, " +
+                             Utils::formatSize(view.getReclaimableBytes()) + " reclaimable" +
+                             " | ENTER:go to file PgUp/PgDn:page ESC:exit";
+        if (footer.length() > row_width) {
+            footer = footer.substr(0, row_width);
+        }
+        list.drawText(max_y - 2, 2, footer);
+    }
 
-                // Turn off color
+    void drawJumpViewContent(ITerminal* terminal,
+                             ITerminal::WindowHandle window,
+                             const std::string& query,
+                             const std::vector<DirectoryHistory::Match>& matches,
+                             int selected,
+                             bool history_open) {
+        Trace::Span span("Display::drawJumpViewContent");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        list.clearWindow();
+        list.drawBorder();
+
+        int max_y, max_x;
+        terminal->getWindowSize(window, max_x, max_y);
+        size_t row_width = max_x > 4 ? max_x - 4 : 0;
+
+        // Keep the end of the query in view while it is typed
+        std::string title = "Jump to: " + query + "_";
+        if (title.length() > row_width) {
+            title = "..." + title.substr(title.length() - (row_width - 3));
+        }
+        list.drawText(1, 2, title);
+        list.drawHorizontalLine(2, 2, max_x - 4);
+
+        if (matches.empty()) {
+            list.centerText(max_y / 2, !history_open ? "No directory history is kept" :
+                                       query.empty() ? "No directories visited yet" : "No visited directory matches");
+        }
+
+        int display_height = max_y - 5;
+        for (int i = 0; i < display_height && (size_t)i < matches.size(); i++) {
+            // Long paths keep their end, where the directory name is
+            std::string row = matches[i].path.string();
+            if (row.length() > row_width) {
+                row = "..." + row.substr(row.length() - (row_width - 3));
+            }
+
+            bool is_selected = i == selected;
+            if (is_selected) {
+                if (terminal->hasColors()) {
+                    list.setTextAttribute(ITerminal::SELECTED);
+                } else {
+                    list.setTextAttribute(ITerminal::DEFAULT, false, true); // reverse
+                }
+            }
+            list.drawText(3 + i, 2, row);
+            if (is_selected) {
                 if (terminal->hasColors()) {
-                    terminal->clearTextAttribute(window, ITerminal::DIRECTORY);
+                    list.clearTextAttribute(ITerminal::SELECTED);
+                } else {
+                    list.clearTextAttribute(ITerminal::DEFAULT, false, true); // reverse
                 }
+            }
+        }
+
+        std::string footer = std::to_string(matches.size()) + " directories" +
+                             " | ENTER:open UP/DOWN:select BACKSPACE:erase ESC:cancel";
+        if (footer.length() > row_width) {
+            footer = footer.substr(0, row_width);
+        }
+        list.drawText(max_y - 2, 2, footer);
+    }
 
-                entries_shown++;
+    void drawDirectoryContentsInWindow(ITerminal* terminal, EntryLabels& labels, size_t index,
+                                       ITerminal::WindowHandle window) {
+        Trace::Span span("Display::drawDirectoryContentsInWindow");
+        WindowDraw draw(terminal, window);
+        DrawList& list = draw.list();
+
+        // Get window dimensions (border already drawn by parent)
+        int max_y, max_x;
+        terminal->getWindowSize(window, max_x, max_y);
+
+        // Draw title
+        list.drawText(1, 2, "Contents:");
+
+        // The listing and its strings are read and built once per directory shown
+        const EntryLabels::DirectoryPreview& preview = labels.getDirectoryPreview(index, max_x, max_y);
+        list.drawText(2, 2, preview.path);
+
+        // Draw horizontal line
+        list.drawHorizontalLine(3, 2, max_x - 4);
+
+        if (preview.readable) {
+            for (size_t i = 0; i < preview.rows.size(); i++) {
+                // Use color for directories if available
+                bool colored = preview.directories[i] && terminal->hasColors();
+                if (colored) list.setTextAttribute(ITerminal::DIRECTORY);
+                list.drawText(4 + static_cast<int>(i), 2, preview.rows[i]);
+                if (colored) list.clearTextAttribute(ITerminal::DIRECTORY);
             }
 
             // Show overflow indicator at bottom if needed
-            if (preview_entries.size() > display_height) {
-                terminal->drawText(window, max_y - 2, 2, "... and " + std::to_string(preview_entries.size() - display_height) + " more items");
+            if (!preview.more.empty()) {
+                list.drawText(max_y - 2, 2, preview.more);
             }
         } else {
-            terminal->drawText(window, 5, 2, "Error reading directory");
+            list.drawText(5, 2, "Error reading directory");
         }
     }
 }
@@ -2,7 +2,18 @@
 #define DISPLAY_H
 
 #include "../platform/terminal_interface.h"
+#include "../core/json_tree.h"
+#include "../core/duplicate_view.h"
+#include "../core/diff_view.h"
+#include "../core/compare_view.h"
+#include "../core/browser_tree.h"
+#include "../filesystem/file_operations.h"
+#include "../filesystem/image_handler.h"
+#include "../filesystem/file_analysis.h"
+#include "../filesystem/directory_history.h"
+#include "entry_labels.h"
 #include <filesystem>
+#include <set>
 #include <vector>
 #include <string>
 
@@ -18,33 +29,43 @@ namespace Display {
      * @param terminal Terminal interface
      * @param window File browser window handle
      * @param entries Directory entries to display
+     * @param labels Cached display strings of the entries and their directory
+     * @param tree Depth of each entry; rows are indented by it
      * @param selected_index Currently selected file index
      * @param scroll_offset Scroll offset for the list
-     * @param current_directory Current directory path
+     * @param marked_path Entry marked for comparison, empty if none
+     * @param selection Entries selected for a file job
      */
     void drawFileBrowser(ITerminal* terminal,
                         ITerminal::WindowHandle window,
                         const std::vector<std::filesystem::directory_entry>& entries,
+                        EntryLabels& labels,
+                        const BrowserTree& tree,
                         int selected_index,
                         int scroll_offset,
-                        const std::filesystem::path& current_directory);
+                        const std::filesystem::path& marked_path,
+                        const std::set<std::filesystem::path>& selection);
     
     /**
      * @brief Draw the status bar
      * @param terminal Terminal interface
      * @param window Status window handle
      * @param entries Directory entries
+     * @param labels Cached display strings of the entries
      * @param selected_index Currently selected file index
-     * @param current_directory Current directory path
      * @param status_message Status message to display
+     * @param status_error Error shown in place of the file details, empty if none
+     * @param job_status Progress of the running file job, shown right of the details; empty if none
      * @param screen_width Screen width for layout
      */
     void drawStatusBar(ITerminal* terminal,
                       ITerminal::WindowHandle window,
                       const std::vector<std::filesystem::directory_entry>& entries,
+                      EntryLabels& labels,
                       int selected_index,
-                      const std::filesystem::path& current_directory,
                       const std::string& status_message,
+                      const std::string& status_error,
+                      const std::string& job_status,
                       int screen_width);
 
     /**
@@ -52,24 +73,58 @@ namespace Display {
      * @param terminal Terminal interface
      * @param window Info window handle
      * @param entries Directory entries
+     * @param labels Cached display strings of the entries
      * @param selected_index Currently selected file index
+     * @param analysis Content analysis of the selected file, nullptr while it is running
      */
     void drawInfoWindow(ITerminal* terminal,
                        ITerminal::WindowHandle window,
                        const std::vector<std::filesystem::directory_entry>& entries,
-                       int selected_index);
+                       EntryLabels& labels,
+                       int selected_index,
+                       const FileAnalysis* analysis);
 
     /**
-     * @brief Draw normal content (directory preview or welcome)
+     * @brief Draw normal content (directory preview, file preview or welcome)
      * @param terminal Terminal interface
      * @param window Content window handle
      * @param entries Directory entries
+     * @param labels Cached display strings of the entries and of a directory's listing
      * @param selected_index Currently selected file index
+     * @param preview Text preview of the selected file, nullptr while it is loading
+     * @param image_preview Image preview of the selected file, nullptr while it is loading
      */
     void drawNormalContent(ITerminal* terminal,
                           ITerminal::WindowHandle window,
                           const std::vector<std::filesystem::directory_entry>& entries,
-                          int selected_index);
+                          EntryLabels& labels,
+                          int selected_index,
+                          const TextPreview* preview,
+                          const ImagePreview* image_preview);
+
+    /**
+     * @brief Draw the text preview of a file
+     * @param terminal Terminal interface
+     * @param window Content window handle
+     * @param file_path Previewed file
+     * @param preview Preview lines, nullptr while loading
+     */
+    void drawFilePreview(ITerminal* terminal,
+                        ITerminal::WindowHandle window,
+                        const std::filesystem::path& file_path,
+                        const TextPreview* preview);
+
+    /**
+     * @brief Draw a downscaled image with two pixel rows per text row
+     * @param terminal Terminal interface
+     * @param window Content window handle
+     * @param file_path Previewed file
+     * @param preview Scaled pixels, nullptr while loading
+     */
+    void drawImagePreview(ITerminal* terminal,
+                         ITerminal::WindowHandle window,
+                         const std::filesystem::path& file_path,
+                         const ImagePreview* preview);
 
     /**
      * @brief Draw help content
@@ -99,29 +154,96 @@ namespace Display {
                             int scroll_offset,
                             const std::string& filename);
 
+    /**
+     * @brief Draw the collapsible JSON tree view
+     * @param terminal Terminal interface
+     * @param window Content window handle
+     * @param tree JSON tree with its visible rows and selection
+     */
+    void drawJsonViewContent(ITerminal* terminal,
+                            ITerminal::WindowHandle window,
+                            const JsonTree& tree);
+
+    /**
+     * @brief Draw the side-by-side diff of the marked and selected files
+     * @param terminal Terminal interface
+     * @param window Content window handle
+     * @param view Diff with its scroll position
+     */
+    void drawDiffViewContent(ITerminal* terminal,
+                             ITerminal::WindowHandle window,
+                             const DiffView& view);
+
+    /**
+     * @brief Draw the duplicate finder's progress or its result groups
+     * @param terminal Terminal interface
+     * @param window Content window handle
+     * @param view Duplicate groups with their selection
+     * @param progress Counters of the running search, nullptr once it has finished
+     */
+    void drawDuplicateViewContent(ITerminal* terminal,
+                                  ITerminal::WindowHandle window,
+                                  const DuplicateView& view,
+                                  const DuplicateProgress* progress);
+
+    /**
+     * @brief Draw the jump prompt and the visited directories matching it
+     * @param terminal Terminal interface
+     * @param window Content window handle
+     * @param query Text typed so far
+     * @param matches Best matches first
+     * @param selected Index of the selected match
+     * @param history_open Whether visited directories are being recorded at all
+     */
+    void drawJumpViewContent(ITerminal* terminal,
+                             ITerminal::WindowHandle window,
+                             const std::string& query,
+                             const std::vector<DirectoryHistory::Match>& matches,
+                             int selected,
+                             bool history_open);
+
+    /**
+     * @brief Draw the tree of differences between two directories
+     * @param terminal Terminal interface
+     * @param window Content window handle
+     * @param view Differences found so far, with their selection
+     * @param progress Counters of the running comparison, nullptr once it has finished
+     */
+    void drawCompareViewContent(ITerminal* terminal,
+                                ITerminal::WindowHandle window,
+                                const CompareView& view,
+                                const TreeCompareProgress* progress);
+
     /**
      * @brief Draw directory information in info window
      * @param terminal Terminal interface
      * @param window Info window handle
-     * @param dir_entry Directory entry
+     * @param labels Cached display strings of the entries
+     * @param index Index of the directory entry
      */
-    void drawDirectoryInfo(ITerminal* terminal, ITerminal::WindowHandle window, const std::filesystem::directory_entry& dir_entry);
+    void drawDirectoryInfo(ITerminal* terminal, ITerminal::WindowHandle window, EntryLabels& labels, size_t index);
 
     /**
      * @brief Draw file information in info window
      * @param terminal Terminal interface
      * @param window Info window handle
      * @param file_entry File entry
+     * @param labels Cached display strings of the entries
+     * @param index Index of the file entry
+     * @param analysis Content analysis, nullptr while it is running
      */
-    void drawFileInfo(ITerminal* terminal, ITerminal::WindowHandle window, const std::filesystem::directory_entry& file_entry);
+    void drawFileInfo(ITerminal* terminal, ITerminal::WindowHandle window, const std::filesystem::directory_entry& file_entry,
+                      EntryLabels& labels, size_t index, const FileAnalysis* analysis);
 
     /**
      * @brief Draw directory contents in a window
      * @param terminal Terminal interface
-     * @param dir_path Directory path to display
+     * @param labels Cached display strings; the listing is read once per directory shown
+     * @param index Entry index of the directory to display
      * @param window Window handle to draw in
      */
-    void drawDirectoryContentsInWindow(ITerminal* terminal, const std::filesystem::path& dir_path, ITerminal::WindowHandle window);
+    void drawDirectoryContentsInWindow(ITerminal* terminal, EntryLabels& labels, size_t index,
+                                       ITerminal::WindowHandle window);
 }
 
 #endif // DISPLAY_H
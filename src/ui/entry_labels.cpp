@@ -0,0 +1,278 @@
+#include "entry_labels.h"
+#include "../filesystem/file_operations.h"
+#include <algorithm>
+
+namespace {
+    // Cut text that is longer than width - 4 cells to width - 7 and mark the cut with "...",
+    // the margins every panel leaves for its border
+    void cutEnd(std::string& text, int width) {
+        if (static_cast<int>(text.length()) > width - 4) {
+            text.resize(std::max(0, width - 7));
+            text += "...";
+        }
+    }
+
+    // Same, keeping the end of the text
+    void cutStart(std::string& text, int width) {
+        if (static_cast<int>(text.length()) > width - 4) {
+            text.erase(0, text.length() - std::max(0, width - 7));
+            text.insert(0, "...");
+        }
+    }
+
+    void appendSize(std::string& out, uintmax_t size, bool with_gigabytes) {
+        if (size < 1024) {
+            out += std::to_string(size) + " bytes";
+        } else if (size < 1024 * 1024) {
+            out += std::to_string(size / 1024) + " KB";
+        } else if (!with_gigabytes || size < 1024 * 1024 * 1024) {
+            out += std::to_string(size / (1024 * 1024)) + " MB";
+        } else {
+            out += std::to_string(size / (1024 * 1024 * 1024)) + " GB";
+        }
+    }
+}
+
+void EntryLabels::reset(const std::vector<std::filesystem::directory_entry>& entries,
+                        const std::filesystem::path& directory) {
+    entries_ = &entries;
+    directory_ = directory;
+    directory_name_ = directory.filename().string();
+    if (directory_name_.empty()) directory_name_ = directory.string();
+    directory_label_width_ = -1;
+    labels_.clear();
+    labels_.resize(entries.size());
+
+    // The listing is read again in case the change that led here touched the previewed directory
+    preview_path_.clear();
+}
+
+void EntryLabels::insert(size_t index, size_t count) {
+    labels_.insert(labels_.begin() + index, count, Labels());
+}
+
+void EntryLabels::erase(size_t index, size_t count) {
+    labels_.erase(labels_.begin() + index, labels_.begin() + index + count);
+}
+
+const std::string& EntryLabels::getDirectoryLabel(int width) {
+    if (directory_label_width_ != width) {
+        directory_label_ = directory_name_;
+        cutStart(directory_label_, width);
+        directory_label_width_ = width;
+    }
+    return directory_label_;
+}
+
+const std::string& EntryLabels::getRow(size_t index, int width) {
+    Labels& labels = prepare(index);
+    if (labels.row_width != width) {
+        labels.row = (*entries_)[index].path().filename().string();
+        cutEnd(labels.row, width);
+        if (labels.kind == Kind::DIRECTORY) {
+            labels.row.insert(0, "[");
+            labels.row += ']';
+        }
+        labels.row_width = width;
+    }
+    return labels.row;
+}
+
+const std::string& EntryLabels::getStatus(size_t index, int width) {
+    Labels& labels = prepare(index);
+    if (labels.status_width == width) return labels.status;
+
+    const std::filesystem::path& path = (*entries_)[index].path();
+    std::string filename = path.filename().string();
+    std::string status_info;
+    if (labels.kind == Kind::DIRECTORY) {
+        status_info = "[DIR] " + filename;
+    } else if (labels.kind == Kind::FILE) {
+        readSize(index, labels);
+        status_info = filename + " (";
+        if (labels.size_valid) {
+            appendSize(status_info, labels.size, false);
+        } else {
+            status_info += "size unknown";
+        }
+        status_info += ")";
+    } else {
+        status_info = filename + " (special file)";
+    }
+
+    // Children of an expanded directory name that directory rather than the listed one
+    std::filesystem::path parent = path.parent_path();
+    std::string parent_name = parent == directory_ ? directory_name_ : parent.filename().string();
+    if (parent_name.empty()) parent_name = parent.string();
+
+    // Drop the directory first, then cut the entry itself
+    labels.status = status_info + " | " + parent_name;
+    if (static_cast<int>(labels.status.length()) > width) {
+        if (static_cast<int>(status_info.length()) > width - 3) {
+            labels.status = status_info.substr(0, std::max(0, width - 3)) + "...";
+        } else {
+            labels.status = status_info + "...";
+        }
+    }
+    labels.status_width = width;
+    return labels.status;
+}
+
+const std::string& EntryLabels::getInfoName(size_t index, int width) {
+    Labels& labels = prepare(index);
+    if (labels.info_name_width != width) {
+        const std::filesystem::path& path = (*entries_)[index].path();
+        labels.info_name = path.filename().string();
+        if (labels.info_name.empty()) labels.info_name = path.string();
+        cutEnd(labels.info_name, width);
+        if (labels.kind == Kind::DIRECTORY) {
+            labels.info_name.insert(0, "[");
+            labels.info_name += ']';
+        }
+        labels.info_name_width = width;
+    }
+    return labels.info_name;
+}
+
+const std::string& EntryLabels::getInfoDetails(size_t index, int width) {
+    Labels& labels = prepare(index);
+    if (labels.info_details_width != width) {
+        switch (labels.kind) {
+            case Kind::DIRECTORY:
+                readSize(index, labels);
+                labels.info_details = labels.size_valid
+                    ? "Total: " + std::to_string(labels.directory_count) + " dirs, " +
+                      std::to_string(labels.size) + " files"
+                    : "Error reading contents";
+                break;
+            case Kind::FILE:
+                readSize(index, labels);
+                labels.info_details = "File (";
+                if (labels.size_valid) {
+                    appendSize(labels.info_details, labels.size, true);
+                } else {
+                    labels.info_details += "size unknown";
+                }
+                labels.info_details += ")";
+                break;
+            case Kind::SYMLINK:
+                labels.info_details = "Symbolic Link";
+                break;
+            default:
+                labels.info_details = "Special File";
+                break;
+        }
+        cutEnd(labels.info_details, width);
+        labels.info_details_width = width;
+    }
+    return labels.info_details;
+}
+
+const std::string& EntryLabels::getInfoPath(size_t index, int width) {
+    Labels& labels = prepare(index);
+    if (labels.info_path_width != width) {
+        labels.info_path = (*entries_)[index].path().string();
+        cutStart(labels.info_path, width);
+        labels.info_path_width = width;
+    }
+    return labels.info_path;
+}
+
+// Private helper functions
+EntryLabels::Labels& EntryLabels::prepare(size_t index) {
+    Labels& labels = labels_[index];
+    if (labels.kind == Kind::UNKNOWN) {
+        const auto& entry = (*entries_)[index];
+        std::error_code ec;
+        if (entry.is_directory(ec) && !ec) {
+            labels.kind = Kind::DIRECTORY;
+        } else if (entry.is_regular_file(ec) && !ec) {
+            labels.kind = Kind::FILE;
+        } else if (entry.is_symlink(ec) && !ec) {
+            labels.kind = Kind::SYMLINK;
+        } else {
+            labels.kind = Kind::SPECIAL;
+        }
+    }
+    return labels;
+}
+
+void EntryLabels::readSize(size_t index, Labels& labels) {
+    if (labels.size_read) return;
+    labels.size_read = true;
+
+    const auto& entry = (*entries_)[index];
+    std::error_code ec;
+    if (labels.kind == Kind::FILE) {
+        labels.size = entry.file_size(ec);
+        labels.size_valid = !ec;
+        return;
+    }
+
+    // Directories count their files and subdirectories
+    try {
+        for (const auto& child : std::filesystem::directory_iterator(entry.path(), ec)) {
+            std::error_code child_ec;
+            if (child.is_directory(child_ec) && !child_ec) {
+                labels.directory_count++;
+            } else {
+                labels.size++;
+            }
+        }
+        labels.size_valid = !ec;
+    } catch (const std::exception&) {
+        labels.size_valid = false;
+    }
+}
+
+const EntryLabels::DirectoryPreview& EntryLabels::getDirectoryPreview(size_t index, int width, int height) {
+    const std::filesystem::path& path = (*entries_)[index].path();
+    if (path != preview_path_) {
+        preview_path_ = path;
+        preview_.readable = FileOperations::loadDirectoryPreview(path, preview_entries_);
+        preview_width_ = -1;
+    }
+    if (preview_width_ == width && preview_height_ == height) return preview_;
+
+    // Show the beginning and the end of a long path with "..." in the middle
+    preview_.path = path.string();
+    int available_width = width - 6;
+    if (static_cast<int>(preview_.path.length()) > available_width) {
+        int prefix_len = available_width / 3;
+        int suffix_len = available_width - prefix_len - 3;
+        if (prefix_len > 0 && suffix_len > 0) {
+            preview_.path = preview_.path.substr(0, prefix_len) + "..." +
+                            preview_.path.substr(preview_.path.length() - suffix_len);
+        } else {
+            preview_.path = preview_.path.substr(0, std::max(0, available_width - 3)) + "...";
+        }
+    }
+
+    // Borders, title, path, separator and bottom margin
+    size_t display_height = static_cast<size_t>(std::max(0, height - 6));
+    size_t shown = std::min(preview_entries_.size(), display_height);
+    preview_.rows.resize(shown);
+    preview_.directories.resize(shown);
+    for (size_t i = 0; i < shown; i++) {
+        std::string& row = preview_.rows[i];
+        row = preview_entries_[i].path().filename().string();
+        if (static_cast<int>(row.length()) > width - 6) {
+            row.resize(std::max(0, width - 9));
+            row += "...";
+        }
+        std::error_code ec;
+        preview_.directories[i] = preview_entries_[i].is_directory(ec) && !ec;
+        if (preview_.directories[i]) {
+            row.insert(0, "[");
+            row += ']';
+        }
+    }
+    preview_.more.clear();
+    if (preview_entries_.size() > display_height) {
+        preview_.more = "... and " + std::to_string(preview_entries_.size() - display_height) + " more items";
+    }
+
+    preview_width_ = width;
+    preview_height_ = height;
+    return preview_;
+}
@@ -0,0 +1,138 @@
+#ifndef ENTRY_LABELS_H
+#define ENTRY_LABELS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Display strings of the loaded directory entries, built once per entry
+ * The browser row, status bar summary and info panel lines of an entry are
+ * formatted the first time they are drawn and kept until the width they were
+ * truncated for changes, so redrawing entries that have been shown before
+ * does not allocate. File sizes and directory totals are read once per entry.
+ * The listing of the directory shown in the content pane is read once when
+ * that directory is first shown and kept until another one is.
+ */
+class EntryLabels {
+public:
+    // Listing of a directory entry for the content pane
+    struct DirectoryPreview {
+        bool readable = false;
+        std::string path;                   // Full path, shortened in the middle to fit
+        std::vector<std::string> rows;      // Names cut to fit, bracketed for directories; as many as fit
+        std::vector<bool> directories;      // Which rows are directories
+        std::string more;                   // "... and N more items", empty when every entry fits
+    };
+
+    /**
+     * @brief Drop all strings and start over for a new listing
+     * @param entries Entries the indexes refer to; must stay alive until the next reset
+     * @param directory Directory the entries were read from
+     */
+    void reset(const std::vector<std::filesystem::directory_entry>& entries,
+               const std::filesystem::path& directory);
+
+    /**
+     * @brief Make room for entries inserted into the listing, keeping the strings of the others
+     * @param index Position of the first inserted entry
+     * @param count Number of entries inserted
+     */
+    void insert(size_t index, size_t count);
+
+    /**
+     * @brief Drop the strings of entries removed from the listing
+     * @param index Position of the first removed entry
+     * @param count Number of entries removed
+     */
+    void erase(size_t index, size_t count);
+
+    /**
+     * @brief Get the name of the listed directory for the browser header, keeping its end
+     * @param width Width of the file browser window
+     */
+    const std::string& getDirectoryLabel(int width);
+
+    /**
+     * @brief Get the browser row: the name, bracketed for directories, cut to fit
+     * @param index Entry index
+     * @param width Width of the file browser window
+     */
+    const std::string& getRow(size_t index, int width);
+
+    /**
+     * @brief Get the status bar summary: name, type or size, and the directory holding it, cut to fit
+     * @param index Entry index
+     * @param width Space left of the version text
+     */
+    const std::string& getStatus(size_t index, int width);
+
+    /**
+     * @brief Get the name line of the info panel
+     * @param index Entry index
+     * @param width Width of the info window
+     */
+    const std::string& getInfoName(size_t index, int width);
+
+    /**
+     * @brief Get the type line of the info panel (size, or the totals of a directory)
+     * @param index Entry index
+     * @param width Width of the info window
+     */
+    const std::string& getInfoDetails(size_t index, int width);
+
+    /**
+     * @brief Get the path line of the info panel, keeping the end of the path
+     * @param index Entry index
+     * @param width Width of the info window
+     */
+    const std::string& getInfoPath(size_t index, int width);
+
+    /**
+     * @brief Get the listing of a directory entry for the content pane
+     * @param index Entry index; the entry must be a directory
+     * @param width Width of the content window
+     * @param height Height of the content window
+     */
+    const DirectoryPreview& getDirectoryPreview(size_t index, int width, int height);
+
+private:
+    enum class Kind : uint8_t { UNKNOWN, DIRECTORY, FILE, SYMLINK, SPECIAL };
+
+    struct Labels {
+        Kind kind = Kind::UNKNOWN;
+        bool size_read = false;
+        bool size_valid = false;
+        uintmax_t size = 0;             // File size, or the number of files in a directory
+        uintmax_t directory_count = 0;  // Subdirectories of a directory
+        std::string row;
+        std::string status;
+        std::string info_name;
+        std::string info_details;
+        std::string info_path;
+        int row_width = -1;             // Width each string was cut for, -1 before it is built
+        int status_width = -1;
+        int info_name_width = -1;
+        int info_details_width = -1;
+        int info_path_width = -1;
+    };
+
+    const std::vector<std::filesystem::directory_entry>* entries_ = nullptr;
+    std::filesystem::path directory_;
+    std::string directory_name_;
+    std::string directory_label_;
+    int directory_label_width_ = -1;
+    std::vector<Labels> labels_;
+
+    std::filesystem::path preview_path_;    // Directory preview_entries_ were read from, empty for none
+    std::vector<std::filesystem::directory_entry> preview_entries_;
+    DirectoryPreview preview_;
+    int preview_width_ = -1;                // Size preview_ was built for, -1 before it is built
+    int preview_height_ = -1;
+
+    Labels& prepare(size_t index);
+    void readSize(size_t index, Labels& labels);
+};
+
+#endif // ENTRY_LABELS_H
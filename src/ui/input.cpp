@@ -1,12 +1,102 @@
 #include "input.h"
 #include "../core/quickview.h"
-#include "../utils/utils.h"
+#include "../utils/log.h"
+#include "../utils/trace.h"
+#include <vector>
+
+namespace {
+    // Upper bound on keys handled before a frame is drawn, so a flood cannot starve rendering
+    const size_t MAX_KEYS_PER_FRAME = 1024;
+
+    /**
+     * @brief Apply a run of identical keys as one state change where possible
+     * @return false if the key has no collapsed form and must be processed one by one
+     */
+    bool processRepeatedKey(QuickView* app, int key, int count) {
+        // The first key of the batch answers a pending removal or quit, so it must go through processKey
+        if (app->isConfirmingRemoval() || app->isConfirmingQuit()) return false;
+        if (key == ITerminal::KEY_RESIZE_EVENT) {
+            // Only the final size matters
+            app->resizeHandler();
+            return true;
+        }
+        if (key != ITerminal::KEY_UP_ARROW && key != ITerminal::KEY_DOWN_ARROW &&
+            key != ITerminal::KEY_PAGE_UP && key != ITerminal::KEY_PAGE_DOWN) {
+            return false;
+        }
+
+        bool page = key == ITerminal::KEY_PAGE_UP || key == ITerminal::KEY_PAGE_DOWN;
+        int delta = key == ITerminal::KEY_UP_ARROW || key == ITerminal::KEY_PAGE_UP ? -count : count;
+        switch (app->getCurrentDisplayMode()) {
+            case QuickView::DisplayMode::NORMAL:
+                if (page) {
+                    delta < 0 ? app->navigatePageUp(count) : app->navigatePageDown(count);
+                } else {
+                    delta < 0 ? app->navigateUp(count) : app->navigateDown(count);
+                }
+                return true;
+            case QuickView::DisplayMode::JSON_VIEW:
+                if (page) return false;
+                app->jsonViewMove(delta);
+                return true;
+            case QuickView::DisplayMode::DUPLICATE_VIEW:
+                if (page) return false;
+                app->duplicateViewMove(delta);
+                return true;
+            case QuickView::DisplayMode::COMPARE_VIEW:
+                if (page) return false;
+                app->compareViewMove(delta);
+                return true;
+            case QuickView::DisplayMode::DIFF_VIEW:
+                if (page) return false;
+                app->diffViewScroll(delta);
+                return true;
+            default:
+                return false;
+        }
+    }
+}
 
 namespace Input {
-    void handleInput(QuickView* app) {
+    bool handleInput(QuickView* app) {
         int key = app->getTerminal()->getKey();
-        Utils::debugPrint(app->isDebugEnabled(), "Key pressed: %d ('%c')\n", key, (key >= 32 && key <= 126) ? key : '?');
-        processKey(app, key);
+        if (key == ITerminal::KEY_UNKNOWN) {
+            return false;  // Input timeout, no key pressed
+        }
+        Trace::Span span("Input::handleInput");
+
+        // Drain everything already typed so a key-repeat flood costs one frame, not one per key
+        std::vector<int> keys;
+        keys.push_back(key);
+        app->getTerminal()->setInputTimeout(0);
+        while (keys.size() < MAX_KEYS_PER_FRAME) {
+            key = app->getTerminal()->getKey();
+            if (key == ITerminal::KEY_UNKNOWN) break;
+            keys.push_back(key);
+        }
+
+        KeystrokeMonitor* monitor = app->getKeystrokeMonitor();
+        if (monitor) {
+            for (int read : keys) monitor->keyRead(read);
+        }
+
+        app->clearStatusError();
+        for (size_t i = 0; i < keys.size() && app->isRunning(); ) {
+            size_t run = 1;
+            while (i + run < keys.size() && keys[i + run] == keys[i]) run++;
+            LOG_DEBUG("Key pressed: %d ('%c') x%zu", keys[i], (keys[i] >= 32 && keys[i] <= 126) ? keys[i] : '?', run);
+
+            if (monitor) monitor->beginKeys();
+            if (run > 1 && processRepeatedKey(app, keys[i], static_cast<int>(run))) {
+                i += run;
+            } else {
+                processKey(app, keys[i]);
+                run = 1;
+                i++;
+            }
+            if (monitor) monitor->endKeys(run);
+        }
+        return keys.size() == MAX_KEYS_PER_FRAME;
     }
 
     void processKey(QuickView* app, int key) {
@@ -23,6 +113,53 @@ namespace Input {
             }
         }
         
+        // Handle JSON tree view navigation
+        if (app->getCurrentDisplayMode() == QuickView::DisplayMode::JSON_VIEW) {
+            if (!processJsonViewKey(app, key)) {
+                // Any other key returns to normal mode
+                app->setDisplayMode(QuickView::DisplayMode::NORMAL);
+                app->setNeedsRedraw(true);
+                app->setStatusMessage("Use arrows to navigate, Enter to select, 'v' to view files, 'h' for help, 'q' to quit");
+            }
+            return;
+        }
+
+        // Handle diff view scrolling and hunk navigation
+        if (app->getCurrentDisplayMode() == QuickView::DisplayMode::DIFF_VIEW) {
+            if (!processDiffViewKey(app, key)) {
+                // Any other key returns to the directory comparison or to normal mode
+                app->closeDiffView();
+            }
+            return;
+        }
+
+        // Handle directory comparison navigation
+        if (app->getCurrentDisplayMode() == QuickView::DisplayMode::COMPARE_VIEW) {
+            if (!processCompareViewKey(app, key)) {
+                // Any other key cancels a running comparison and returns to normal mode
+                app->closeCompareView();
+            }
+            return;
+        }
+
+        // Handle the jump prompt, where printable keys are part of the query
+        if (app->getCurrentDisplayMode() == QuickView::DisplayMode::JUMP_VIEW) {
+            if (!processJumpViewKey(app, key)) {
+                // Any other key cancels the jump
+                app->closeJumpView();
+            }
+            return;
+        }
+
+        // Handle duplicate list navigation
+        if (app->getCurrentDisplayMode() == QuickView::DisplayMode::DUPLICATE_VIEW) {
+            if (!processDuplicateViewKey(app, key)) {
+                // Any other key cancels a running search and returns to normal mode
+                app->closeDuplicateView();
+            }
+            return;
+        }
+
         // Handle other special modes
         if (app->getCurrentDisplayMode() == QuickView::DisplayMode::HELP || 
             app->getCurrentDisplayMode() == QuickView::DisplayMode::ABOUT) {
@@ -33,13 +170,30 @@ namespace Input {
             return;
         }
         
+        // A removal waits for its answer: 'y' confirms, any other key keeps the entries
+        if (app->isConfirmingRemoval()) {
+            app->confirmRemoval(key == 'y' || key == 'Y');
+            return;
+        }
+
+        // So does a quit that would cut a file job short
+        if (app->isConfirmingQuit()) {
+            app->confirmQuit(key == 'y' || key == 'Y');
+            return;
+        }
+
+        // While a name is being typed, every printable key extends it, including command letters
+        if (key >= ' ' && key <= '~' && app->isTypingAhead()) {
+            app->typeAhead(static_cast<char>(key));
+            return;
+        }
+
         // Normal mode key handling
         switch (key) {
             case 'q':
             case 'Q':
             case ITerminal::KEY_ESCAPE_KEY:
-                app->setRunning(false);
-                app->setStatusMessage("Goodbye!");
+                app->requestQuit();
                 break;
 
             case 'h':
@@ -56,11 +210,70 @@ namespace Input {
                 app->setStatusMessage("About screen - Press any key to return");
                 break;
 
+            case 't':
+            case 'T':
+                app->writeTrace();
+                break;
+
             case 'v':
             case 'V':
                 app->viewFile();
                 break;
 
+            case 'o':
+            case 'O':
+                app->openWithHandler();
+                break;
+
+            case 's':
+            case 'S':
+                app->computeSelectedSha256();
+                break;
+
+            case 'd':
+            case 'D':
+                app->findDuplicates();
+                break;
+
+            case 'g':
+            case 'G':
+                app->openJumpView();
+                break;
+
+            case 'm':
+            case 'M':
+                app->markSelected();
+                break;
+
+            case 'c':
+            case 'C':
+                app->compareWithMarked();
+                break;
+
+            case ' ':
+                app->toggleSelection();
+                break;
+
+            case 'p':
+            case 'P':
+                app->queueSelection(FileJob::COPY);
+                break;
+
+            case 'x':
+            case 'X':
+                app->queueSelection(FileJob::MOVE);
+                break;
+
+            case 'r':
+            case 'R':
+                app->requestRemoval();
+                break;
+
+            case 'k':
+            case 'K':
+                app->cancelJobs();
+                break;
+
             case ITerminal::KEY_UP_ARROW:
                 app->navigateUp();
                 break;
@@ -81,6 +294,14 @@ namespace Input {
                 app->navigateHome();
                 break;
 
+            case ITerminal::KEY_RIGHT_ARROW:
+                app->expandSelected();
+                break;
+
+            case ITerminal::KEY_LEFT_ARROW:
+                app->collapseSelected();
+                break;
+
             case ITerminal::KEY_END_KEY:
                 app->navigateEnd();
                 break;
@@ -96,7 +317,12 @@ namespace Input {
                 break;
                 
             default:
-                app->setStatusMessage("Use arrows to navigate, Enter to select, 'v' to view files, 'h' for help, 'q' to quit");
+                // Other characters jump to the first name starting with them
+                if (key > ' ' && key <= '~') {
+                    app->typeAhead(static_cast<char>(key));
+                } else {
+                    app->setStatusMessage("Use arrows to navigate, Enter to select, 'v' to view files, 'h' for help, 'q' to quit");
+                }
                 break;
         }
     }
@@ -125,4 +351,158 @@ namespace Input {
                 return false; // Key not handled
         }
     }
+
+    bool processJsonViewKey(QuickView* app, int key) {
+        switch (key) {
+            case ITerminal::KEY_UP_ARROW:
+                app->jsonViewMove(-1);
+                return true;
+            case ITerminal::KEY_DOWN_ARROW:
+                app->jsonViewMove(1);
+                return true;
+            case ITerminal::KEY_PAGE_UP:
+                app->jsonViewPageUp();
+                return true;
+            case ITerminal::KEY_PAGE_DOWN:
+                app->jsonViewPageDown();
+                return true;
+            case ITerminal::KEY_HOME_KEY:
+                app->jsonViewHome();
+                return true;
+            case ITerminal::KEY_END_KEY:
+                app->jsonViewEnd();
+                return true;
+            case ITerminal::KEY_RIGHT_ARROW:
+            case ITerminal::KEY_ENTER_KEY:
+            case '\n':
+            case '\r':
+                app->jsonViewExpand();
+                return true;
+            case ITerminal::KEY_LEFT_ARROW:
+                app->jsonViewCollapse();
+                return true;
+            default:
+                return false; // Key not handled
+        }
+    }
+
+    bool processJumpViewKey(QuickView* app, int key) {
+        switch (key) {
+            case ITerminal::KEY_UP_ARROW:
+                app->jumpViewMove(-1);
+                return true;
+            case ITerminal::KEY_DOWN_ARROW:
+                app->jumpViewMove(1);
+                return true;
+            case ITerminal::KEY_BACKSPACE_KEY:
+                app->jumpViewErase();
+                return true;
+            case ITerminal::KEY_ENTER_KEY:
+            case '\n':
+            case '\r':
+                app->jumpViewOpen();
+                return true;
+            case ITerminal::KEY_RESIZE_EVENT:
+                app->resizeHandler();
+                return true;
+            default:
+                if (key >= ' ' && key <= '~') {
+                    app->jumpViewType(static_cast<char>(key));
+                    return true;
+                }
+                return false; // Key not handled
+        }
+    }
+
+    bool processDuplicateViewKey(QuickView* app, int key) {
+        switch (key) {
+            case ITerminal::KEY_UP_ARROW:
+                app->duplicateViewMove(-1);
+                return true;
+            case ITerminal::KEY_DOWN_ARROW:
+                app->duplicateViewMove(1);
+                return true;
+            case ITerminal::KEY_PAGE_UP:
+                app->duplicateViewPageUp();
+                return true;
+            case ITerminal::KEY_PAGE_DOWN:
+                app->duplicateViewPageDown();
+                return true;
+            case ITerminal::KEY_HOME_KEY:
+                app->duplicateViewHome();
+                return true;
+            case ITerminal::KEY_END_KEY:
+                app->duplicateViewEnd();
+                return true;
+            case ITerminal::KEY_ENTER_KEY:
+            case '\n':
+            case '\r':
+                app->duplicateViewReveal();
+                return true;
+            default:
+                return false; // Key not handled
+        }
+    }
+
+    bool processCompareViewKey(QuickView* app, int key) {
+        switch (key) {
+            case ITerminal::KEY_UP_ARROW:
+                app->compareViewMove(-1);
+                return true;
+            case ITerminal::KEY_DOWN_ARROW:
+                app->compareViewMove(1);
+                return true;
+            case ITerminal::KEY_PAGE_UP:
+                app->compareViewPageUp();
+                return true;
+            case ITerminal::KEY_PAGE_DOWN:
+                app->compareViewPageDown();
+                return true;
+            case ITerminal::KEY_HOME_KEY:
+                app->compareViewHome();
+                return true;
+            case ITerminal::KEY_END_KEY:
+                app->compareViewEnd();
+                return true;
+            case ITerminal::KEY_ENTER_KEY:
+            case '\n':
+            case '\r':
+                app->compareViewOpen();
+                return true;
+            default:
+                return false; // Key not handled
+        }
+    }
+
+    bool processDiffViewKey(QuickView* app, int key) {
+        switch (key) {
+            case ITerminal::KEY_UP_ARROW:
+                app->diffViewScroll(-1);
+                return true;
+            case ITerminal::KEY_DOWN_ARROW:
+                app->diffViewScroll(1);
+                return true;
+            case ITerminal::KEY_PAGE_UP:
+                app->diffViewPageUp();
+                return true;
+            case ITerminal::KEY_PAGE_DOWN:
+                app->diffViewPageDown();
+                return true;
+            case ITerminal::KEY_HOME_KEY:
+                app->diffViewHome();
+                return true;
+            case ITerminal::KEY_END_KEY:
+                app->diffViewEnd();
+                return true;
+            case 'n':
+                app->diffViewJumpToHunk(true);
+                return true;
+            case 'p':
+            case 'N':
+                app->diffViewJumpToHunk(false);
+                return true;
+            default:
+                return false; // Key not handled
+        }
+    }
 }
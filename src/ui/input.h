@@ -11,8 +11,9 @@ namespace Input {
     /**
      * @brief Handle input from the user
      * @param app Pointer to the QuickView application instance
+     * @return true if the batch limit was reached and more keys may be waiting
      */
-    void handleInput(QuickView* app);
+    bool handleInput(QuickView* app);
     
     /**
      * @brief Process a key press
@@ -28,6 +29,46 @@ namespace Input {
      * @return true if key was handled, false otherwise
      */
     bool processFileViewKey(QuickView* app, int key);
+
+    /**
+     * @brief Process JSON tree view keys (navigation, expand and collapse)
+     * @param app Pointer to the QuickView application instance
+     * @param key Key code that was pressed
+     * @return true if key was handled, false otherwise
+     */
+    bool processJsonViewKey(QuickView* app, int key);
+
+    /**
+     * @brief Process duplicate list keys (navigation and jumping to a file)
+     * @param app Pointer to the QuickView application instance
+     * @param key Key code that was pressed
+     * @return true if key was handled, false otherwise
+     */
+    bool processDuplicateViewKey(QuickView* app, int key);
+
+    /**
+     * @brief Process diff view keys (scrolling and jumping between hunks)
+     * @param app Pointer to the QuickView application instance
+     * @param key Key code that was pressed
+     * @return true if key was handled, false otherwise
+     */
+    bool processDiffViewKey(QuickView* app, int key);
+
+    /**
+     * @brief Process directory comparison keys (navigation, collapsing and opening entries)
+     * @param app Pointer to the QuickView application instance
+     * @param key Key code that was pressed
+     * @return true if key was handled, false otherwise
+     */
+    bool processCompareViewKey(QuickView* app, int key);
+
+    /**
+     * @brief Process jump prompt keys (typing the query, choosing and opening a directory)
+     * @param app Pointer to the QuickView application instance
+     * @param key Key code that was pressed
+     * @return true if key was handled, false otherwise
+     */
+    bool processJumpViewKey(QuickView* app, int key);
 }
 
 #endif // INPUT_H
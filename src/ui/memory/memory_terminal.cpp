@@ -0,0 +1,574 @@
+#include "memory_terminal.h"
+#include "../../utils/utils.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+    const char32_t HORIZONTAL = U'─';
+    const char32_t VERTICAL = U'│';
+    const char32_t UPPER_HALF_BLOCK = U'▀';
+
+    const MemoryTerminal::Cell BLANK = {U' ', ITerminal::DEFAULT, false, false, false, 0, 0};
+
+    uint32_t packRgb(const uint8_t* rgb) {
+        return static_cast<uint32_t>(rgb[0]) << 16 | static_cast<uint32_t>(rgb[1]) << 8 | rgb[2];
+    }
+
+    // Decode one UTF-8 sequence; malformed input yields '?' and skips a byte
+    char32_t decodeUtf8(const char* text, size_t length, size_t& i) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        if (lead < 0x80) {
+            i++;
+            return lead;
+        }
+
+        int extra = (lead >> 5) == 0x6 ? 1 : (lead >> 4) == 0xE ? 2 : (lead >> 3) == 0x1E ? 3 : -1;
+        if (extra < 0 || i + extra >= length) {
+            i++;
+            return U'?';
+        }
+
+        char32_t ch = lead & (0x3F >> extra);
+        for (int k = 1; k <= extra; k++) {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xC0) != 0x80) {
+                i++;
+                return U'?';
+            }
+            ch = (ch << 6) | (next & 0x3F);
+        }
+        i += extra + 1;
+        return ch;
+    }
+}
+
+MemoryTerminal::MemoryTerminal(int width, int height)
+    : width_(width)
+    , height_(height)
+    , staged_(static_cast<size_t>(width) * height, BLANK)
+    , shown_(static_cast<size_t>(width) * height, BLANK)
+    , input_timeout_ms_(-1)
+    , frame_count_(0)
+    , totals_{0, 0, 0, 0, 0, 0.0}
+    , frame_{0, 0, 0, 0, 0, 0.0}
+    , frame_started_(false)
+    , frame_allocations_(0) {
+    // Reserved up front so that recording a frame never allocates in the middle of a session
+    frames_.reserve(KEPT_FRAMES);
+}
+
+MemoryTerminal::~MemoryTerminal() {
+    shutdown();
+}
+
+bool MemoryTerminal::initialize() {
+    return true;
+}
+
+void MemoryTerminal::shutdown() {
+    // The screen stays readable after shutdown so callers can inspect the last frame
+    windows_.clear();
+}
+
+void MemoryTerminal::getScreenSize(int& width, int& height) {
+    countCall();
+    width = width_;
+    height = height_;
+}
+
+int MemoryTerminal::getKey() {
+    // Waiting for input is not rendering; the frame clock restarts with the next call
+    frame_started_ = false;
+
+    int key;
+    if (popKey(key)) {
+        return key;
+    }
+
+    // The next key is pressed later: wait for it as a terminal would
+    if (!keys_.empty()) {
+        auto until = keys_.front().available;
+        if (input_timeout_ms_ >= 0) {
+            until = std::min(until, std::chrono::steady_clock::now() + std::chrono::milliseconds(input_timeout_ms_));
+        }
+        std::this_thread::sleep_until(until);
+        return popKey(key) ? key : KEY_UNKNOWN;
+    }
+
+    // Out of input: let pending background work finish, then ask to quit. Escape
+    // rather than 'q', since prompts take letters as text
+    if (input_timeout_ms_ >= 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(input_timeout_ms_));
+        return KEY_UNKNOWN;
+    }
+    return KEY_ESCAPE_KEY;
+}
+
+void MemoryTerminal::setInputTimeout(int milliseconds) {
+    input_timeout_ms_ = milliseconds;
+}
+
+int MemoryTerminal::getInputDescriptor() {
+    return -1;  // Keys come from the queue
+}
+
+void MemoryTerminal::updateScreenSize() {
+}
+
+ITerminal::WindowHandle MemoryTerminal::createWindow(int height, int width, int start_y, int start_x) {
+    countCall();
+    if (height <= 0 || width <= 0) return nullptr;
+
+    windows_.push_back(std::unique_ptr<Window>(new Window{
+        start_y, start_x, width, height, DEFAULT, false, false,
+        std::vector<Cell>(static_cast<size_t>(width) * height, BLANK)}));
+    return static_cast<WindowHandle>(windows_.back().get());
+}
+
+void MemoryTerminal::destroyWindow(WindowHandle window) {
+    countCall();
+    auto it = std::find_if(windows_.begin(), windows_.end(),
+                           [window](const std::unique_ptr<Window>& w) { return w.get() == window; });
+    if (it != windows_.end()) {
+        windows_.erase(it);
+    }
+}
+
+void MemoryTerminal::getWindowSize(WindowHandle window, int& width, int& height) {
+    countCall();
+    Window* win = getWindow(window);
+    if (win) {
+        width = win->width;
+        height = win->height;
+    } else {
+        width = width_;
+        height = height_;
+    }
+}
+
+void MemoryTerminal::clearWindow(WindowHandle window) {
+    countCall();
+    Window* win = getWindow(window);
+    if (win) {
+        std::fill(win->cells.begin(), win->cells.end(), BLANK);
+    }
+}
+
+void MemoryTerminal::drawBorder(WindowHandle window) {
+    countCall();
+    Window* win = getWindow(window);
+    if (!win) return;
+
+    Cell cell = BLANK;
+    cell.ch = HORIZONTAL;
+    for (int x = 1; x < win->width - 1; x++) {
+        put(win, 0, x, cell);
+        put(win, win->height - 1, x, cell);
+    }
+    cell.ch = VERTICAL;
+    for (int y = 1; y < win->height - 1; y++) {
+        put(win, y, 0, cell);
+        put(win, y, win->width - 1, cell);
+    }
+    cell.ch = U'┌';
+    put(win, 0, 0, cell);
+    cell.ch = U'┐';
+    put(win, 0, win->width - 1, cell);
+    cell.ch = U'└';
+    put(win, win->height - 1, 0, cell);
+    cell.ch = U'┘';
+    put(win, win->height - 1, win->width - 1, cell);
+}
+
+void MemoryTerminal::drawText(WindowHandle window, int y, int x, const std::string& text) {
+    countCall();
+    Window* win = getWindow(window);
+    if (win) {
+        putText(win, y, x, text.data(), text.size());
+    }
+}
+
+void MemoryTerminal::drawHorizontalLine(WindowHandle window, int y, int x, int length) {
+    countCall();
+    Window* win = getWindow(window);
+    if (!win) return;
+
+    Cell cell = BLANK;
+    cell.ch = HORIZONTAL;
+    cell.color = win->color;
+    cell.bold = win->bold;
+    cell.reverse = win->reverse;
+    for (int i = 0; i < length; i++) {
+        put(win, y, x + i, cell);
+    }
+}
+
+void MemoryTerminal::drawImageRow(WindowHandle window, int y, int x,
+                                  const uint8_t* top, const uint8_t* bottom, int count) {
+    countCall();
+    Window* win = getWindow(window);
+    if (!win) return;
+
+    // Keep the exact pixels rather than a palette approximation
+    Cell cell = BLANK;
+    cell.ch = UPPER_HALF_BLOCK;
+    cell.image = true;
+    for (int i = 0; i < count; i++) {
+        cell.foreground = packRgb(top + i * 3);
+        cell.background = bottom ? packRgb(bottom + i * 3) : 0;
+        put(win, y, x + i, cell);
+    }
+}
+
+void MemoryTerminal::setTextAttribute(WindowHandle window, ColorPair color, bool bold, bool reverse) {
+    countCall();
+    Window* win = getWindow(window);
+    if (!win) return;
+
+    // Same semantics as curses wattron(): a color replaces the current one, flags accumulate
+    if (color != DEFAULT) win->color = color;
+    win->bold = win->bold || bold;
+    win->reverse = win->reverse || reverse;
+}
+
+void MemoryTerminal::clearTextAttribute(WindowHandle window, ColorPair color, bool bold, bool reverse) {
+    countCall();
+    Window* win = getWindow(window);
+    if (!win) return;
+
+    if (color != DEFAULT) win->color = DEFAULT;
+    if (bold) win->bold = false;
+    if (reverse) win->reverse = false;
+}
+
+void MemoryTerminal::submit(WindowHandle window, const DrawList& list) {
+    countCall();
+    size_t calls = frame_.calls;
+
+    for (const DrawList::Command& command : list.getCommands()) {
+        switch (command.op) {
+            case DrawList::Op::CLEAR_WINDOW:
+                MemoryTerminal::clearWindow(window);
+                break;
+            case DrawList::Op::DRAW_BORDER:
+                MemoryTerminal::drawBorder(window);
+                break;
+            case DrawList::Op::DRAW_TEXT:
+                putText(getWindow(window), command.y, command.x, list.getText(command), command.size);
+                break;
+            case DrawList::Op::CENTER_TEXT:
+                if (Window* win = getWindow(window)) {
+                    putText(win, command.y, (win->width - static_cast<int>(command.size)) / 2,
+                            list.getText(command), command.size);
+                }
+                break;
+            case DrawList::Op::HORIZONTAL_LINE:
+                MemoryTerminal::drawHorizontalLine(window, command.y, command.x, command.count);
+                break;
+            case DrawList::Op::IMAGE_ROW:
+                MemoryTerminal::drawImageRow(window, command.y, command.x, list.getTopPixels(command),
+                                             list.getBottomPixels(command), command.count);
+                break;
+            case DrawList::Op::SET_ATTRIBUTE:
+                MemoryTerminal::setTextAttribute(window, command.color, command.bold, command.reverse);
+                break;
+            case DrawList::Op::CLEAR_ATTRIBUTE:
+                MemoryTerminal::clearTextAttribute(window, command.color, command.bold, command.reverse);
+                break;
+        }
+    }
+
+    // The whole list is one call; its commands are counted separately
+    frame_.calls = calls;
+    frame_.commands += list.getCommands().size();
+}
+
+void MemoryTerminal::refreshWindow(WindowHandle window) {
+    countCall();
+    Window* win = getWindow(window);
+    if (!win) return;
+
+    for (int y = 0; y < win->height; y++) {
+        int screen_y = win->y + y;
+        if (screen_y < 0 || screen_y >= height_) continue;
+        for (int x = 0; x < win->width; x++) {
+            int screen_x = win->x + x;
+            if (screen_x < 0 || screen_x >= width_) continue;
+            staged_[static_cast<size_t>(screen_y) * width_ + screen_x] =
+                win->cells[static_cast<size_t>(y) * win->width + x];
+        }
+    }
+}
+
+void MemoryTerminal::updateScreen() {
+    countCall();
+    present(frame_);
+
+    frame_.microseconds = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - frame_start_).count();
+    frame_.allocations = Utils::getAllocationCount() - frame_allocations_;
+    if (frames_.size() < KEPT_FRAMES) {
+        frames_.push_back(frame_);
+    } else {
+        frames_[frame_count_ % KEPT_FRAMES] = frame_;
+    }
+    frame_count_++;
+    totals_.cells_changed += frame_.cells_changed;
+    totals_.calls += frame_.calls;
+    totals_.commands += frame_.commands;
+    totals_.bytes += frame_.bytes;
+    totals_.allocations += frame_.allocations;
+    totals_.microseconds += frame_.microseconds;
+    frame_ = {0, 0, 0, 0, 0, 0.0};
+    frame_started_ = false;
+}
+
+void MemoryTerminal::refreshScreen() {
+    updateScreen();
+}
+
+void MemoryTerminal::clearScreen() {
+    countCall();
+    std::fill(staged_.begin(), staged_.end(), BLANK);
+    invalidateScreen();
+}
+
+void MemoryTerminal::hideCursor() {
+    countCall();
+}
+
+void MemoryTerminal::showCursor() {
+    countCall();
+}
+
+bool MemoryTerminal::hasColors() {
+    countCall();
+    return true;
+}
+
+void MemoryTerminal::initializeColors() {
+    countCall();
+}
+
+void MemoryTerminal::centerText(WindowHandle window, int y, const std::string& text) {
+    countCall();
+    Window* win = getWindow(window);
+    if (win) {
+        putText(win, y, (win->width - static_cast<int>(text.length())) / 2, text.data(), text.size());
+    }
+}
+
+void MemoryTerminal::enableOptimizations() {
+    countCall();
+}
+
+void MemoryTerminal::forceCompleteRedraw() {
+    invalidateScreen();
+    updateScreen();
+}
+
+void MemoryTerminal::pushKey(int key) {
+    keys_.push_back({key, std::chrono::steady_clock::time_point()});
+}
+
+void MemoryTerminal::pushKey(int key, std::chrono::steady_clock::time_point available) {
+    keys_.push_back({key, available});
+}
+
+void MemoryTerminal::pushInput(const std::string& bytes) {
+    for (size_t i = 0; i < bytes.size(); i++) {
+        char ch = bytes[i];
+        if (ch == '\r' || ch == '\n') {
+            pushKey(KEY_ENTER_KEY);
+            continue;
+        }
+        if (ch == '\x7f' || ch == '\b') {
+            pushKey(KEY_BACKSPACE_KEY);
+            continue;
+        }
+        if (ch != '\x1b') {
+            pushKey(static_cast<unsigned char>(ch));
+            continue;
+        }
+
+        // CSI and SS3 sequences: ESC [ A, ESC O A, ESC [ 5 ~, ESC [ 1 ; 5 A ...
+        if (i + 2 < bytes.size() && (bytes[i + 1] == '[' || bytes[i + 1] == 'O')) {
+            size_t end = i + 2;
+            while (end < bytes.size() && ((bytes[end] >= '0' && bytes[end] <= '9') || bytes[end] == ';')) end++;
+            if (end < bytes.size() && bytes[end] >= 0x40 && bytes[end] <= 0x7E) {
+                // Modifiers after ';' are ignored
+                std::string parameter = bytes.substr(i + 2, end - i - 2);
+                parameter = parameter.substr(0, parameter.find(';'));
+                int key = KEY_UNKNOWN;
+                switch (bytes[end]) {
+                    case 'A': key = KEY_UP_ARROW; break;
+                    case 'B': key = KEY_DOWN_ARROW; break;
+                    case 'C': key = KEY_RIGHT_ARROW; break;
+                    case 'D': key = KEY_LEFT_ARROW; break;
+                    case 'H': key = KEY_HOME_KEY; break;
+                    case 'F': key = KEY_END_KEY; break;
+                    case '~':
+                        if (parameter == "1" || parameter == "7") key = KEY_HOME_KEY;
+                        else if (parameter == "4" || parameter == "8") key = KEY_END_KEY;
+                        else if (parameter == "5") key = KEY_PAGE_UP;
+                        else if (parameter == "6") key = KEY_PAGE_DOWN;
+                        break;
+                }
+                if (key != KEY_UNKNOWN) {
+                    pushKey(key);
+                }
+                i = end;
+                continue;
+            }
+        }
+        pushKey(KEY_ESCAPE_KEY);
+    }
+}
+
+const MemoryTerminal::Cell& MemoryTerminal::getCell(int y, int x) const {
+    return shown_[static_cast<size_t>(y) * width_ + x];
+}
+
+std::string MemoryTerminal::getRowText(int y) const {
+    std::string text;
+    const Cell* row = shown_.data() + static_cast<size_t>(y) * width_;
+    int length = width_;
+    while (length > 0 && (row[length - 1].ch == U' ' || row[length - 1].ch == INVALID_CELL)) length--;
+
+    for (int x = 0; x < length; x++) {
+        appendUtf8(text, row[x].ch == INVALID_CELL ? U' ' : row[x].ch);
+    }
+    return text;
+}
+
+std::vector<MemoryTerminal::FrameStats> MemoryTerminal::getFrameStats() const {
+    std::vector<FrameStats> frames;
+    frames.reserve(frames_.size());
+    for (size_t number = frame_count_ - frames_.size(); number < frame_count_; number++) {
+        frames.push_back(frames_[number % KEPT_FRAMES]);
+    }
+    return frames;
+}
+
+void MemoryTerminal::clearFrameStats() {
+    frames_.clear();
+    frame_count_ = 0;
+    totals_ = {0, 0, 0, 0, 0, 0.0};
+}
+
+void MemoryTerminal::writeReport(std::ostream& screen, std::ostream& statistics) const {
+    for (int y = 0; y < height_; y++) {
+        screen << getRowText(y) << '\n';
+    }
+
+    // Frames older than the kept ones only count towards the totals
+    size_t first = frame_count_ - frames_.size();
+    statistics << "frame  cells  calls  commands  bytes  allocations  time (us)\n";
+    if (first > 0) statistics << "(first " << first << " frames not kept)\n";
+    for (size_t number = first; number < frame_count_; number++) {
+        const FrameStats& frame = frames_[number % KEPT_FRAMES];
+        statistics << number + 1 << "  " << frame.cells_changed << "  " << frame.calls << "  "
+                   << frame.commands << "  " << frame.bytes << "  " << frame.allocations << "  "
+                   << static_cast<long>(frame.microseconds) << '\n';
+    }
+
+    statistics << "total: " << frame_count_ << " frames, " << totals_.cells_changed << " cells changed, "
+               << totals_.calls << " calls, " << totals_.commands << " commands, " << totals_.bytes << " bytes, "
+               << totals_.allocations << " allocations, " << static_cast<long>(totals_.microseconds) << " us";
+    if (frame_count_ > 0) {
+        statistics << " (" << static_cast<long>(totals_.microseconds / frame_count_) << " us per frame)";
+    }
+    statistics << '\n';
+}
+
+void MemoryTerminal::present(FrameStats& stats) {
+    for (size_t i = 0; i < staged_.size(); i++) {
+        if (staged_[i] != shown_[i]) {
+            shown_[i] = staged_[i];
+            stats.cells_changed++;
+        }
+    }
+}
+
+void MemoryTerminal::resizeScreen(int width, int height) {
+    width_ = width;
+    height_ = height;
+    staged_.assign(static_cast<size_t>(width) * height, BLANK);
+    shown_.assign(staged_.size(), BLANK);
+    invalidateScreen();
+}
+
+void MemoryTerminal::invalidateScreen() {
+    for (Cell& cell : shown_) {
+        cell.ch = INVALID_CELL;
+    }
+}
+
+bool MemoryTerminal::popKey(int& key) {
+    if (keys_.empty() || keys_.front().available > std::chrono::steady_clock::now()) return false;
+    key = keys_.front().key;
+    keys_.pop_front();
+    return true;
+}
+
+void MemoryTerminal::appendUtf8(std::string& out, char32_t ch) {
+    if (ch < 0x80) {
+        out += static_cast<char>(ch);
+    } else if (ch < 0x800) {
+        out += static_cast<char>(0xC0 | (ch >> 6));
+        out += static_cast<char>(0x80 | (ch & 0x3F));
+    } else if (ch < 0x10000) {
+        out += static_cast<char>(0xE0 | (ch >> 12));
+        out += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (ch & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (ch >> 18));
+        out += static_cast<char>(0x80 | ((ch >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (ch & 0x3F));
+    }
+}
+
+// Private helper functions
+void MemoryTerminal::countCall() {
+    if (!frame_started_) {
+        frame_started_ = true;
+        frame_start_ = std::chrono::steady_clock::now();
+        frame_allocations_ = Utils::getAllocationCount();
+    }
+    frame_.calls++;
+}
+
+void MemoryTerminal::put(Window* window, int y, int x, const Cell& cell) {
+    if (y < 0 || y >= window->height || x < 0 || x >= window->width) return;
+    window->cells[static_cast<size_t>(y) * window->width + x] = cell;
+}
+
+void MemoryTerminal::putText(Window* window, int y, int x, const char* text, size_t length) {
+    if (!window) return;
+
+    // Text is clipped at the right edge rather than wrapped; like curses, tabs
+    // advance to the next multiple of 8 and control characters show as ^X
+    Cell cell = BLANK;
+    cell.color = window->color;
+    cell.bold = window->bold;
+    cell.reverse = window->reverse;
+    size_t i = 0;
+    while (i < length && x < window->width) {
+        char32_t ch = decodeUtf8(text, length, i);
+        if (ch == U'\t') {
+            cell.ch = U' ';
+            do {
+                put(window, y, x++, cell);
+            } while (x % 8 != 0 && x < window->width);
+        } else if (ch < 0x20 || ch == 0x7F) {
+            cell.ch = U'^';
+            put(window, y, x++, cell);
+            cell.ch = ch ^ 0x40;
+            put(window, y, x++, cell);
+        } else {
+            cell.ch = ch;
+            put(window, y, x++, cell);
+        }
+    }
+}
@@ -0,0 +1,223 @@
+#ifndef MEMORY_TERMINAL_H
+#define MEMORY_TERMINAL_H
+
+#include "../../platform/terminal_interface.h"
+#include <chrono>
+#include <deque>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Headless implementation of the terminal interface
+ * Renders into an in-memory grid of cells instead of a TTY, reads keys from a
+ * queue and records statistics for every frame, so the display code can be
+ * benchmarked and its output inspected without a terminal.
+ */
+class MemoryTerminal : public ITerminal {
+public:
+    /**
+     * @brief One character cell of the screen
+     */
+    struct Cell {
+        char32_t ch;
+        ColorPair color;
+        bool bold;
+        bool reverse;
+        bool image;             // Half block colored by the two pixels below
+        uint32_t foreground;    // RGB of image cells (top pixel)
+        uint32_t background;    // RGB of image cells (bottom pixel)
+
+        bool operator==(const Cell& other) const {
+            return ch == other.ch && color == other.color && bold == other.bold &&
+                   reverse == other.reverse && image == other.image &&
+                   foreground == other.foreground && background == other.background;
+        }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief What one frame cost, timed from the first call after the last getKey() to updateScreen()
+     */
+    struct FrameStats {
+        size_t cells_changed;   // Screen cells that differ from the previous frame
+        size_t calls;           // ITerminal calls, each submit() counting once
+        size_t commands;        // Drawing commands replayed from submitted lists
+        size_t bytes;           // Output sent to a real terminal, 0 when headless
+        size_t allocations;     // Heap allocations made by the drawing thread
+        double microseconds;    // Wall time spent producing the frame
+    };
+
+    /**
+     * @brief Create a blank screen
+     * @param width Screen width in cells
+     * @param height Screen height in cells
+     */
+    MemoryTerminal(int width = 80, int height = 24);
+    ~MemoryTerminal() override;
+
+    // Core terminal operations
+    bool initialize() override;
+    void shutdown() override;
+    void getScreenSize(int& width, int& height) override;
+    int getKey() override;
+    void setInputTimeout(int milliseconds) override;
+    int getInputDescriptor() override;
+    void updateScreenSize() override;
+
+    // Window management
+    WindowHandle createWindow(int height, int width, int start_y, int start_x) override;
+    void destroyWindow(WindowHandle window) override;
+    void getWindowSize(WindowHandle window, int& width, int& height) override;
+
+    // Drawing operations
+    void clearWindow(WindowHandle window) override;
+    void drawBorder(WindowHandle window) override;
+    void drawText(WindowHandle window, int y, int x, const std::string& text) override;
+    void drawHorizontalLine(WindowHandle window, int y, int x, int length) override;
+    void drawImageRow(WindowHandle window, int y, int x,
+                      const uint8_t* top, const uint8_t* bottom, int count) override;
+
+    // Text attributes
+    void setTextAttribute(WindowHandle window, ColorPair color, bool bold = false, bool reverse = false) override;
+    void clearTextAttribute(WindowHandle window, ColorPair color, bool bold = false, bool reverse = false) override;
+    void submit(WindowHandle window, const DrawList& list) override;
+
+    // Screen operations
+    void refreshWindow(WindowHandle window) override;
+    void updateScreen() override;
+    void refreshScreen() override;
+    void clearScreen() override;
+
+    // Cursor operations
+    void hideCursor() override;
+    void showCursor() override;
+
+    // Color support
+    bool hasColors() override;
+    void initializeColors() override;
+
+    // Utility functions
+    void centerText(WindowHandle window, int y, const std::string& text) override;
+
+    // Platform-specific optimizations
+    void enableOptimizations() override;
+    void forceCompleteRedraw() override;
+
+    /**
+     * @brief Queue a key for getKey()
+     * @param key Character or KeyCode
+     */
+    void pushKey(int key);
+
+    /**
+     * @brief Queue a key that getKey() returns no earlier than the given time
+     * Keys queued this way replay recorded typing at its original pace:
+     * getKey() waits for a key that is not due yet, bounded by the input timeout.
+     * @param key Character or KeyCode
+     * @param available When the key is pressed
+     */
+    void pushKey(int key, std::chrono::steady_clock::time_point available);
+
+    /**
+     * @brief Queue the keys encoded in raw terminal input
+     * Understands the VT sequences of the arrow, paging, Home and End keys and
+     * drops other complete sequences; carriage returns and newlines become
+     * Enter and a lone ESC becomes Escape.
+     * @param bytes Input as a terminal would deliver it
+     */
+    void pushInput(const std::string& bytes);
+
+    /**
+     * @brief Get a cell of the screen as last shown by updateScreen()
+     */
+    const Cell& getCell(int y, int x) const;
+
+    /**
+     * @brief Get a screen row as UTF-8 text without trailing blanks
+     */
+    std::string getRowText(int y) const;
+
+    /**
+     * @brief Get the most recent frames, oldest first
+     * Only the last KEPT_FRAMES frames are kept, so that a long session does
+     * not grow; the totals of writeReport() cover every frame.
+     */
+    std::vector<FrameStats> getFrameStats() const;
+    void clearFrameStats();
+
+    // Frames kept for getFrameStats() and listed one by one in the report
+    static const size_t KEPT_FRAMES = 1000;
+
+    /**
+     * @brief Write the screen followed by a summary of the recorded frames
+     * @param screen Receives the screen text, one line per row
+     * @param statistics Receives one line per kept frame and the totals of all frames
+     */
+    void writeReport(std::ostream& screen, std::ostream& statistics) const;
+
+protected:
+    // Matches no real cell, so the next frame repaints every cell holding it
+    static constexpr char32_t INVALID_CELL = 0xFFFFFFFF;
+
+    /**
+     * @brief Make the staged screen the shown one
+     * Subclasses that drive a real terminal override this to send the changes.
+     * @param stats Frame being completed; cells_changed and bytes are filled in
+     */
+    virtual void present(FrameStats& stats);
+
+    /**
+     * @brief Change the screen size; everything is repainted on the next frame
+     */
+    void resizeScreen(int width, int height);
+
+    /**
+     * @brief Make every shown cell differ from any real one
+     */
+    void invalidateScreen();
+
+    /**
+     * @brief Take the next queued key
+     * @return false if the queue is empty or its next key is not due yet
+     */
+    bool popKey(int& key);
+
+    static void appendUtf8(std::string& out, char32_t ch);
+
+    int width_;
+    int height_;
+    std::vector<Cell> staged_;                      // Screen after the refreshWindow() calls so far
+    std::vector<Cell> shown_;                       // Screen as of the last updateScreen()
+    int input_timeout_ms_;
+
+private:
+    struct Window {
+        int y, x, width, height;
+        ColorPair color;            // Current attributes for new text
+        bool bold;
+        bool reverse;
+        std::vector<Cell> cells;
+    };
+
+    std::vector<std::unique_ptr<Window>> windows_;  // A WindowHandle points at one of these
+    struct QueuedKey {
+        int key;
+        std::chrono::steady_clock::time_point available;
+    };
+
+    std::deque<QueuedKey> keys_;
+    std::vector<FrameStats> frames_;                // Ring of the last KEPT_FRAMES frames
+    size_t frame_count_;                            // Frames since the last clear
+    FrameStats totals_;                             // Sums over every frame since the last clear
+    FrameStats frame_;
+    bool frame_started_;
+    std::chrono::steady_clock::time_point frame_start_;
+    uint64_t frame_allocations_;                    // Allocation count when the frame started
+
+    Window* getWindow(WindowHandle handle) { return static_cast<Window*>(handle); }
+    void countCall();
+    void put(Window* window, int y, int x, const Cell& cell);
+    void putText(Window* window, int y, int x, const char* text, size_t length);
+};
+
+#endif // MEMORY_TERMINAL_H
@@ -1,8 +1,35 @@
 #include "ncurses_terminal.h"
 #include "../../utils/utils.h"
 #include <algorithm>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <langinfo.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
 
-NCursesTerminal::NCursesTerminal() : initialized_(false) {
+namespace {
+    // Color pairs below this number are reserved for the interface palette
+    const short FIRST_IMAGE_PAIR = 16;
+
+    // Steps of the xterm 6x6x6 color cube
+    const int CUBE_LEVELS[6] = {0, 95, 135, 175, 215, 255};
+
+    int nearestCubeIndex(int value) {
+        int best = 0;
+        for (int i = 1; i < 6; i++) {
+            if (std::abs(CUBE_LEVELS[i] - value) < std::abs(CUBE_LEVELS[best] - value)) best = i;
+        }
+        return best;
+    }
+
+    int distanceSquared(int r1, int g1, int b1, int r2, int g2, int b2) {
+        return (r1 - r2) * (r1 - r2) + (g1 - g2) * (g1 - g2) + (b1 - b2) * (b1 - b2);
+    }
+}
+
+NCursesTerminal::NCursesTerminal()
+    : initialized_(false), unicode_(false), next_image_pair_(FIRST_IMAGE_PAIR) {
 }
 
 NCursesTerminal::~NCursesTerminal() {
@@ -11,6 +38,10 @@ NCursesTerminal::~NCursesTerminal() {
 
 bool NCursesTerminal::initialize() {
     if (initialized_) return true;
+
+    // Pick up the user's character set so the half block used for images renders
+    setlocale(LC_CTYPE, "");
+    unicode_ = strcmp(nl_langinfo(CODESET), "UTF-8") == 0;
     
     // Initialize NCurses
     if (!initscr()) {
@@ -41,10 +72,8 @@ void NCursesTerminal::shutdown() {
     if (!initialized_) return;
     
     // Clean up all windows
-    for (auto& pair : windows_) {
-        if (pair.second && pair.second != stdscr) {
-            delwin(pair.second);
-        }
+    for (auto& window : windows_) {
+        delwin(window->win);
     }
     windows_.clear();
     
@@ -62,20 +91,37 @@ int NCursesTerminal::getKey() {
     return mapKeyCode(key);
 }
 
+void NCursesTerminal::setInputTimeout(int milliseconds) {
+    // getch() returns ERR (mapped to KEY_UNKNOWN) when the timeout expires
+    timeout(milliseconds);
+}
+
+int NCursesTerminal::getInputDescriptor() {
+    return STDIN_FILENO;
+}
+
+void NCursesTerminal::updateScreenSize() {
+    // What the ncurses SIGWINCH handler would do, minus queueing KEY_RESIZE
+    struct winsize size;
+    if (initialized_ && ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0) {
+        resize_term(size.ws_row, size.ws_col);
+    }
+}
+
 ITerminal::WindowHandle NCursesTerminal::createWindow(int height, int width, int start_y, int start_x) {
     WINDOW* win = newwin(height, width, start_y, start_x);
     if (!win) return nullptr;
-    
-    WindowHandle handle = static_cast<WindowHandle>(win);
-    windows_[handle] = win;
-    return handle;
+
+    windows_.push_back(std::unique_ptr<Window>(new Window{win, {}}));
+    return static_cast<WindowHandle>(windows_.back().get());
 }
 
 void NCursesTerminal::destroyWindow(WindowHandle window) {
-    WINDOW* win = getNCursesWindow(window);
-    if (win && win != stdscr) {
-        delwin(win);
-        windows_.erase(window);
+    auto it = std::find_if(windows_.begin(), windows_.end(),
+                           [window](const std::unique_ptr<Window>& w) { return w.get() == window; });
+    if (it != windows_.end()) {
+        delwin((*it)->win);
+        windows_.erase(it);
     }
 }
 
@@ -116,6 +162,47 @@ void NCursesTerminal::drawHorizontalLine(WindowHandle window, int y, int x, int
     }
 }
 
+void NCursesTerminal::drawImageRow(WindowHandle window, int y, int x,
+                                   const uint8_t* top, const uint8_t* bottom, int count) {
+    WINDOW* win = getNCursesWindow(window);
+    if (!win) return;
+
+    attr_t saved_attrs;
+    short saved_pair;
+    wattr_get(win, &saved_attrs, &saved_pair, nullptr);
+    wmove(win, y, x);
+
+    for (int i = 0; i < count; i++) {
+        const uint8_t* upper = top + i * 3;
+        const uint8_t* lower = bottom ? bottom + i * 3 : nullptr;
+
+        if (!has_colors()) {
+            // Monochrome: shade by the luminance of both pixels
+            static const char RAMP[] = " .:-=+*#%@";
+            int luma = (upper[0] * 3 + upper[1] * 6 + upper[2]) / 10;
+            if (lower) luma = (luma + (lower[0] * 3 + lower[1] * 6 + lower[2]) / 10) / 2;
+            wattr_set(win, A_NORMAL, 0, nullptr);
+            waddch(win, RAMP[luma * 9 / 255]);
+        } else if (unicode_) {
+            // Upper half block: foreground paints the top pixel, background the bottom one
+            short background = lower ? nearestColor(lower) : COLOR_BLACK;
+            wattr_set(win, A_NORMAL, imagePair(nearestColor(upper), background), nullptr);
+            waddstr(win, "\xE2\x96\x80");  // U+2580 in UTF-8
+        } else {
+            // No half block available: one flat cell per pixel pair
+            uint8_t average[3];
+            for (int c = 0; c < 3; c++) {
+                average[c] = lower ? static_cast<uint8_t>((upper[c] + lower[c]) / 2) : upper[c];
+            }
+            short color = nearestColor(average);
+            wattr_set(win, A_NORMAL, imagePair(color, color), nullptr);
+            waddch(win, ' ');
+        }
+    }
+
+    wattr_set(win, saved_attrs, saved_pair, nullptr);
+}
+
 void NCursesTerminal::setTextAttribute(WindowHandle window, ColorPair color, bool bold, bool reverse) {
     WINDOW* win = getNCursesWindow(window);
     if (win) {
@@ -144,18 +231,89 @@ void NCursesTerminal::clearTextAttribute(WindowHandle window, ColorPair color, b
     }
 }
 
+void NCursesTerminal::submit(WindowHandle window, const DrawList& list) {
+    WINDOW* win = getNCursesWindow(window);
+
+    // Qualified calls skip virtual dispatch; the handle itself resolves without a lookup
+    for (const DrawList::Command& command : list.getCommands()) {
+        switch (command.op) {
+            case DrawList::Op::CLEAR_WINDOW:
+                NCursesTerminal::clearWindow(window);
+                break;
+            case DrawList::Op::DRAW_BORDER:
+                NCursesTerminal::drawBorder(window);
+                break;
+            case DrawList::Op::DRAW_TEXT:
+                mvwaddnstr(win, command.y, command.x, list.getText(command), static_cast<int>(command.size));
+                break;
+            case DrawList::Op::CENTER_TEXT:
+                mvwaddnstr(win, command.y, (getmaxx(win) - static_cast<int>(command.size)) / 2,
+                           list.getText(command), static_cast<int>(command.size));
+                break;
+            case DrawList::Op::HORIZONTAL_LINE:
+                NCursesTerminal::drawHorizontalLine(window, command.y, command.x, command.count);
+                break;
+            case DrawList::Op::IMAGE_ROW:
+                NCursesTerminal::drawImageRow(window, command.y, command.x, list.getTopPixels(command),
+                                              list.getBottomPixels(command), command.count);
+                break;
+            case DrawList::Op::SET_ATTRIBUTE:
+                NCursesTerminal::setTextAttribute(window, command.color, command.bold, command.reverse);
+                break;
+            case DrawList::Op::CLEAR_ATTRIBUTE:
+                NCursesTerminal::clearTextAttribute(window, command.color, command.bold, command.reverse);
+                break;
+        }
+    }
+}
+
 void NCursesTerminal::refreshWindow(WindowHandle window) {
+    if (!window) {
+        wnoutrefresh(stdscr);
+        return;
+    }
     WINDOW* win = getNCursesWindow(window);
-    if (win) {
-        wrefresh(win);
+
+    int height, width;
+    getmaxyx(win, height, width);
+    size_t cells = static_cast<size_t>(height) * width;
+
+    // A window redrawn from scratch touches every row; untouch the rows that
+    // match the last frame so wnoutrefresh() and doupdate() skip them entirely
+    std::vector<cchar_t>& frame = static_cast<Window*>(window)->frame;
+    bool first_frame = frame.size() != cells;
+    if (first_frame) {
+        frame.assign(cells, cchar_t());
     }
+    row_buffer_.resize(width + 1);
+
+    for (int y = 0; y < height; y++) {
+        if (is_linetouched(win, y) != TRUE) continue;
+
+        memset(row_buffer_.data(), 0, row_buffer_.size() * sizeof(cchar_t));
+        mvwin_wchnstr(win, y, 0, row_buffer_.data(), width);
+        cchar_t* last = frame.data() + static_cast<size_t>(y) * width;
+        if (!first_frame && memcmp(last, row_buffer_.data(), width * sizeof(cchar_t)) == 0) {
+            wtouchln(win, y, 1, 0);
+        } else {
+            memcpy(last, row_buffer_.data(), width * sizeof(cchar_t));
+        }
+    }
+    wnoutrefresh(win);
+}
+
+void NCursesTerminal::updateScreen() {
+    doupdate();
 }
 
 void NCursesTerminal::refreshScreen() {
+    // stdscr covers every window, so their retained frames no longer match the screen
+    dropFrames();
     refresh();
 }
 
 void NCursesTerminal::clearScreen() {
+    dropFrames();
     clear();
 }
 
@@ -177,6 +335,8 @@ void NCursesTerminal::initializeColors() {
     init_pair(2, COLOR_BLACK, COLOR_YELLOW); // Selected item
     init_pair(3, COLOR_WHITE, COLOR_RED);    // Error messages
     init_pair(4, COLOR_GREEN, COLOR_BLACK);  // Directories
+    init_pair(5, COLOR_RED, COLOR_BLACK);    // Removed lines
+    init_pair(6, COLOR_GREEN, COLOR_BLACK);  // Added lines
 }
 
 void NCursesTerminal::centerText(WindowHandle window, int y, const std::string& text) {
@@ -193,17 +353,17 @@ void NCursesTerminal::enableOptimizations() {
 }
 
 void NCursesTerminal::forceCompleteRedraw() {
+    dropFrames();
     clearok(stdscr, TRUE);
     clear();
     refresh();
 }
 
 // Private helper functions
-WINDOW* NCursesTerminal::getNCursesWindow(WindowHandle handle) {
-    if (!handle) return stdscr;
-    
-    auto it = windows_.find(handle);
-    return (it != windows_.end()) ? it->second : nullptr;
+void NCursesTerminal::dropFrames() {
+    for (auto& window : windows_) {
+        window->frame.clear();
+    }
 }
 
 int NCursesTerminal::mapKeyCode(int ncurses_key) {
@@ -220,17 +380,70 @@ int NCursesTerminal::mapKeyCode(int ncurses_key) {
         case '\n':
         case '\r': return KEY_ENTER_KEY;
         case 27: return KEY_ESCAPE_KEY;
+        case KEY_BACKSPACE:
+        case 127:
+        case '\b': return KEY_BACKSPACE_KEY;
         case KEY_RESIZE: return KEY_RESIZE_EVENT;
         default: return ncurses_key;
     }
 }
 
+short NCursesTerminal::nearestColor(const uint8_t* rgb) {
+    int r = rgb[0], g = rgb[1], b = rgb[2];
+
+    if (COLORS >= 256) {
+        // Closest of the 6x6x6 cube and the 24-step gray ramp
+        int ri = nearestCubeIndex(r), gi = nearestCubeIndex(g), bi = nearestCubeIndex(b);
+        int cube_distance = distanceSquared(r, g, b, CUBE_LEVELS[ri], CUBE_LEVELS[gi], CUBE_LEVELS[bi]);
+
+        int gray_index = std::min(23, std::max(0, ((r + g + b) / 3 - 3) / 10));
+        int gray = 8 + gray_index * 10;
+        int gray_distance = distanceSquared(r, g, b, gray, gray, gray);
+
+        if (gray_distance < cube_distance) return static_cast<short>(232 + gray_index);
+        return static_cast<short>(16 + ri * 36 + gi * 6 + bi);
+    }
+
+    // Basic palette: curses numbers red, green and blue as bits 0, 1 and 2
+    int brightest = std::max(r, std::max(g, b));
+    int threshold = brightest / 2;
+    short color = COLOR_BLACK;
+    if (brightest >= 64) {
+        if (r > threshold) color |= COLOR_RED;
+        if (g > threshold) color |= COLOR_GREEN;
+        if (b > threshold) color |= COLOR_BLUE;
+    }
+    if (COLORS >= 16 && brightest >= 192) color += 8;
+    return color;
+}
+
+short NCursesTerminal::imagePair(short foreground, short background) {
+    int key = (foreground << 16) | background;
+    auto it = image_pairs_.find(key);
+    if (it != image_pairs_.end()) return it->second;
+
+    // Start over once the pair table is exhausted; cells already on screen may change color
+    int limit = std::min(COLOR_PAIRS, 32767);
+    if (next_image_pair_ >= limit) {
+        image_pairs_.clear();
+        next_image_pair_ = FIRST_IMAGE_PAIR;
+    }
+    if (next_image_pair_ >= limit) return 0;
+
+    short pair = next_image_pair_++;
+    init_pair(pair, foreground, background);
+    image_pairs_[key] = pair;
+    return pair;
+}
+
 int NCursesTerminal::mapColorPair(ColorPair color) {
     switch (color) {
         case STATUS_BAR: return 1;
         case SELECTED: return 2;
         case ERROR: return 3;
         case DIRECTORY: return 4;
+        case DIFF_REMOVED: return 5;
+        case DIFF_ADDED: return 6;
         default: return 0;
     }
 }
@@ -3,7 +3,8 @@
 
 #include "../../platform/terminal_interface.h"
 #include <ncurses.h>
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 /**
  * @brief NCurses implementation of the terminal interface
@@ -20,6 +21,9 @@ public:
     void shutdown() override;
     void getScreenSize(int& width, int& height) override;
     int getKey() override;
+    void setInputTimeout(int milliseconds) override;
+    int getInputDescriptor() override;
+    void updateScreenSize() override;
     
     // Window management
     WindowHandle createWindow(int height, int width, int start_y, int start_x) override;
@@ -31,13 +35,17 @@ public:
     void drawBorder(WindowHandle window) override;
     void drawText(WindowHandle window, int y, int x, const std::string& text) override;
     void drawHorizontalLine(WindowHandle window, int y, int x, int length) override;
+    void drawImageRow(WindowHandle window, int y, int x,
+                      const uint8_t* top, const uint8_t* bottom, int count) override;
     
     // Text attributes
     void setTextAttribute(WindowHandle window, ColorPair color, bool bold = false, bool reverse = false) override;
     void clearTextAttribute(WindowHandle window, ColorPair color, bool bold = false, bool reverse = false) override;
+    void submit(WindowHandle window, const DrawList& list) override;
     
     // Screen operations
     void refreshWindow(WindowHandle window) override;
+    void updateScreen() override;
     void refreshScreen() override;
     void clearScreen() override;
     
@@ -57,13 +65,28 @@ public:
     void forceCompleteRedraw() override;
 
 private:
+    // A WindowHandle points at one of these, so resolving it needs no lookup
+    struct Window {
+        WINDOW* win;
+        std::vector<cchar_t> frame;     // Last staged contents, row by row
+    };
+
     bool initialized_;
-    std::map<WindowHandle, WINDOW*> windows_;
+    std::vector<std::unique_ptr<Window>> windows_;
+    std::vector<cchar_t> row_buffer_;
+    bool unicode_;                              // Locale can render the half block character
+    std::unordered_map<int, short> image_pairs_; // (fg << 16 | bg) -> allocated color pair
+    short next_image_pair_;
     
     // Helper functions
-    WINDOW* getNCursesWindow(WindowHandle handle);
+    WINDOW* getNCursesWindow(WindowHandle handle) {
+        return handle ? static_cast<Window*>(handle)->win : stdscr;
+    }
+    void dropFrames();
     int mapKeyCode(int ncurses_key);
     int mapColorPair(ColorPair color);
+    short nearestColor(const uint8_t* rgb);
+    short imagePair(short foreground, short background);
 };
 
 #endif // NCURSES_TERMINAL_H
@@ -0,0 +1,80 @@
+#include "type_ahead.h"
+#include <algorithm>
+#include <cctype>
+
+void TypeAhead::reset(const std::vector<std::filesystem::directory_entry>& entries) {
+    entries_ = &entries;
+    built_ = false;
+    folded_.clear();
+    offsets_.clear();
+    runs_.clear();
+    prefix_.clear();
+}
+
+bool TypeAhead::isActive(std::chrono::steady_clock::time_point now) const {
+    return !prefix_.empty() && now - last_key_ < TIMEOUT;
+}
+
+int TypeAhead::type(char c, std::chrono::steady_clock::time_point now) {
+    if (!isActive(now)) prefix_.clear();
+    last_key_ = now;
+    if (!built_) build();
+
+    // Fold the same way FileOperations::sortEntries does
+    std::string extended = prefix_;
+    extended += static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+    int index = find(extended);
+    if (index >= 0) {
+        prefix_ = std::move(extended);
+    } else {
+        prefix_.clear();
+    }
+    return index;
+}
+
+void TypeAhead::build() {
+    built_ = true;
+    if (!entries_) return;
+
+    offsets_.reserve(entries_->size() + 1);
+    for (const auto& entry : *entries_) {
+        offsets_.push_back(static_cast<uint32_t>(folded_.size()));
+        size_t start = folded_.size();
+        folded_ += entry.path().filename().string();
+        std::transform(folded_.begin() + start, folded_.end(), folded_.begin() + start, ::tolower);
+    }
+    offsets_.push_back(static_cast<uint32_t>(folded_.size()));
+
+    // Directories and files are sorted separately, so the listing is a few ascending runs
+    size_t begin = 0;
+    for (size_t i = 1; i <= entries_->size(); i++) {
+        if (i == entries_->size() || key(i) < key(i - 1)) {
+            runs_.push_back({begin, i});
+            begin = i;
+        }
+    }
+}
+
+std::string_view TypeAhead::key(size_t index) const {
+    return std::string_view(folded_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]);
+}
+
+int TypeAhead::find(std::string_view prefix) const {
+    for (const Run& run : runs_) {
+        // First name in the run not ordered before the prefix; if any name starts with it, this one does
+        size_t low = run.begin;
+        size_t high = run.end;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (key(middle) < prefix) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        if (low < run.end && key(low).compare(0, prefix.size(), prefix) == 0) {
+            return static_cast<int>(low);
+        }
+    }
+    return -1;
+}
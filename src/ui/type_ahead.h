@@ -0,0 +1,67 @@
+#ifndef TYPE_AHEAD_H
+#define TYPE_AHEAD_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Finds the first listed entry whose name starts with the typed characters
+ * Typed characters accumulate into a prefix until no key has been typed for
+ * TIMEOUT. Names are folded to lower case once per listing, on the first
+ * lookup, and searched by binary search: the browser lists directories and
+ * then files, each sorted by folded name, so each group is searched on its
+ * own, in listing order.
+ */
+class TypeAhead {
+public:
+    // Pause after which the next key starts a new prefix
+    static constexpr std::chrono::milliseconds TIMEOUT{1000};
+
+    /**
+     * @brief Forget the prefix and the folded names for a new listing
+     * @param entries Entries to search; must stay alive until the next reset
+     */
+    void reset(const std::vector<std::filesystem::directory_entry>& entries);
+
+    /**
+     * @brief Check whether a prefix is being typed, so that the next key extends it
+     * @param now Current time
+     */
+    bool isActive(std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Add a character to the prefix and find the first entry it starts
+     * A character that leaves no match ends the prefix, so that the next key
+     * is a command again.
+     * @param c Typed character
+     * @param now Time it was typed
+     * @return Index of the entry, or -1 when no name starts with the extended prefix
+     */
+    int type(char c, std::chrono::steady_clock::time_point now);
+
+    const std::string& getPrefix() const { return prefix_; }
+
+private:
+    struct Run {
+        size_t begin;
+        size_t end;
+    };
+
+    const std::vector<std::filesystem::directory_entry>* entries_ = nullptr;
+    bool built_ = false;
+    std::string folded_;                // Folded names, back to back
+    std::vector<uint32_t> offsets_;     // Start of each name in folded_, plus the end
+    std::vector<Run> runs_;             // Maximal index ranges whose names ascend
+    std::string prefix_;
+    std::chrono::steady_clock::time_point last_key_;
+
+    void build();
+    std::string_view key(size_t index) const;
+    int find(std::string_view prefix) const;
+};
+
+#endif // TYPE_AHEAD_H
@@ -0,0 +1,465 @@
+#include "vt_terminal.h"
+#include <algorithm>
+#include <cerrno>
+#include <clocale>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <langinfo.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+    const int32_t DEFAULT_COLOR = -1;
+    const int32_t TRUE_COLOR = 1 << 24;
+
+    // How long the rest of an escape sequence may trail its ESC
+    const int ESCAPE_DELAY_MS = 25;
+
+    // Steps of the xterm 6x6x6 color cube
+    const int CUBE_LEVELS[6] = {0, 95, 135, 175, 215, 255};
+
+    volatile sig_atomic_t resize_pending = 0;
+    struct sigaction previous_winch;
+
+    void onWindowChange(int) {
+        resize_pending = 1;
+    }
+
+    int nearestCubeIndex(int value) {
+        int best = 0;
+        for (int i = 1; i < 6; i++) {
+            if (std::abs(CUBE_LEVELS[i] - value) < std::abs(CUBE_LEVELS[best] - value)) best = i;
+        }
+        return best;
+    }
+
+    int distanceSquared(int r1, int g1, int b1, int r2, int g2, int b2) {
+        return (r1 - r2) * (r1 - r2) + (g1 - g2) * (g1 - g2) + (b1 - b2) * (b1 - b2);
+    }
+
+    // Closest entry of the xterm 256-color palette, as NCursesTerminal picks it
+    int32_t nearestPaletteColor(uint32_t rgb) {
+        int r = (rgb >> 16) & 0xFF, g = (rgb >> 8) & 0xFF, b = rgb & 0xFF;
+        int ri = nearestCubeIndex(r), gi = nearestCubeIndex(g), bi = nearestCubeIndex(b);
+        int cube_distance = distanceSquared(r, g, b, CUBE_LEVELS[ri], CUBE_LEVELS[gi], CUBE_LEVELS[bi]);
+
+        int gray_index = std::min(23, std::max(0, ((r + g + b) / 3 - 3) / 10));
+        int gray = 8 + gray_index * 10;
+        int gray_distance = distanceSquared(r, g, b, gray, gray, gray);
+
+        if (gray_distance < cube_distance) return 232 + gray_index;
+        return 16 + ri * 36 + gi * 6 + bi;
+    }
+
+    uint32_t averageColor(uint32_t a, uint32_t b) {
+        uint32_t average = 0;
+        for (int shift = 0; shift <= 16; shift += 8) {
+            average |= ((((a >> shift) & 0xFF) + ((b >> shift) & 0xFF)) / 2) << shift;
+        }
+        return average;
+    }
+
+    // DEC special graphics character for a box drawing character, or 0
+    char lineDrawingCharacter(char32_t ch) {
+        switch (ch) {
+            case U'─': return 'q';
+            case U'│': return 'x';
+            case U'┌': return 'l';
+            case U'┐': return 'k';
+            case U'└': return 'm';
+            case U'┘': return 'j';
+            default: return 0;
+        }
+    }
+
+    void appendNumber(std::string& out, int value) {
+        char digits[12];
+        int length = snprintf(digits, sizeof(digits), "%d", value);
+        out.append(digits, length);
+    }
+
+    // ESC [ n <final>, leaving out n when it is 1
+    void appendCsi(std::string& out, int count, char final_byte) {
+        out += "\x1b[";
+        if (count != 1) appendNumber(out, count);
+        out += final_byte;
+    }
+
+    // Shortest way to move along the current row
+    void appendHorizontalMove(std::string& out, int from, int to) {
+        if (to == from) return;
+        if (to == 0) {
+            out += '\r';
+            return;
+        }
+
+        std::string relative;
+        appendCsi(relative, std::abs(to - from), to > from ? 'C' : 'D');
+        std::string absolute;
+        appendCsi(absolute, to + 1, 'G');
+        out += relative.length() <= absolute.length() ? relative : absolute;
+    }
+
+    // The rest of an escape sequence may still be on its way
+    bool endsInsideEscape(const std::string& bytes) {
+        size_t escape = bytes.rfind('\x1b');
+        if (escape == std::string::npos) return false;
+        if (escape + 1 == bytes.size()) return true;
+        if (bytes[escape + 1] != '[' && bytes[escape + 1] != 'O') return false;
+        for (size_t i = escape + 2; i < bytes.size(); i++) {
+            if (!((bytes[i] >= '0' && bytes[i] <= '9') || bytes[i] == ';')) return false;
+        }
+        return true;
+    }
+}
+
+VtTerminal::VtTerminal()
+    : initialized_(false)
+    , original_termios_()
+    , unicode_(false)
+    , true_color_(false)
+    , cursor_y_(-1)
+    , cursor_x_(-1)
+    , pen_{DEFAULT_COLOR, DEFAULT_COLOR, false, false}
+    , pen_known_(false)
+    , clear_pending_(false)
+    , line_drawing_(false) {
+}
+
+VtTerminal::~VtTerminal() {
+    shutdown();
+}
+
+bool VtTerminal::initialize() {
+    if (initialized_) return true;
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) return false;
+
+    // wcwidth() needs the user's character set
+    setlocale(LC_CTYPE, "");
+    unicode_ = strcmp(nl_langinfo(CODESET), "UTF-8") == 0;
+
+    if (tcgetattr(STDIN_FILENO, &original_termios_) != 0) return false;
+    struct termios raw = original_termios_;
+    raw.c_lflag &= ~(ICANON | ECHO | IEXTEN);   // Keep ISIG so Ctrl-C still works
+    raw.c_iflag &= ~(IXON | ICRNL);
+    raw.c_oflag &= ~OPOST;                      // Line feeds move straight down
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSADRAIN, &raw) != 0) return false;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onWindowChange;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGWINCH, &action, &previous_winch);     // No SA_RESTART: interrupt poll()
+    resize_pending = 0;
+
+    const char* color_term = getenv("COLORTERM");
+    true_color_ = color_term && (strcmp(color_term, "truecolor") == 0 || strcmp(color_term, "24bit") == 0);
+
+    // Alternate screen without a cursor; the first frame clears it
+    writeAll("\x1b[?1049h\x1b[?25l");
+    output_.reserve(64 * 1024);
+    updateSize();
+
+    initialized_ = true;
+    return true;
+}
+
+void VtTerminal::shutdown() {
+    if (initialized_) {
+        writeAll("\x1b(B\x1b[0m\x1b[?25h\x1b[?1049l");
+        tcsetattr(STDIN_FILENO, TCSADRAIN, &original_termios_);
+        sigaction(SIGWINCH, &previous_winch, nullptr);
+        initialized_ = false;
+    }
+    MemoryTerminal::shutdown();
+}
+
+int VtTerminal::getKey() {
+    int key;
+    while (!popKey(key)) {
+        if (resize_pending) {
+            resize_pending = 0;
+            updateSize();
+            return KEY_RESIZE_EVENT;
+        }
+
+        struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+        int ready = poll(&input, 1, input_timeout_ms_);
+        if (ready < 0 && errno == EINTR) continue;     // Window change or other signal
+        if (ready <= 0 || !readInput()) return KEY_UNKNOWN;
+    }
+    return key;
+}
+
+int VtTerminal::getInputDescriptor() {
+    return STDIN_FILENO;
+}
+
+void VtTerminal::updateScreenSize() {
+    if (initialized_) updateSize();
+}
+
+void VtTerminal::hideCursor() {
+    MemoryTerminal::hideCursor();
+    if (initialized_) writeAll("\x1b[?25l");
+}
+
+void VtTerminal::showCursor() {
+    MemoryTerminal::showCursor();
+    if (initialized_) writeAll("\x1b[?25h");
+}
+
+void VtTerminal::clearScreen() {
+    MemoryTerminal::clearScreen();
+    clear_pending_ = true;
+}
+
+void VtTerminal::present(FrameStats& stats) {
+    if (!initialized_) {
+        MemoryTerminal::present(stats);
+        return;
+    }
+
+    output_.clear();
+    if (clear_pending_) {
+        // Erasing uses the current background, so reset the attributes first
+        output_ += "\x1b[0m\x1b[H\x1b[2J";
+        pen_ = {DEFAULT_COLOR, DEFAULT_COLOR, false, false};
+        pen_known_ = true;
+        cursor_y_ = cursor_x_ = 0;
+        std::fill(shown_.begin(), shown_.end(), Cell{U' ', DEFAULT, false, false, false, 0, 0});
+        clear_pending_ = false;
+    }
+
+    for (int y = 0; y < height_; y++) {
+        size_t row = static_cast<size_t>(y) * width_;
+        for (int x = 0; x < width_; x++) {
+            const Cell& cell = staged_[row + x];
+            if (cell == shown_[row + x]) continue;
+
+            moveCursor(y, x);
+            appendCell(cell);
+            shown_[row + x] = cell;
+            stats.cells_changed++;
+        }
+    }
+
+    // The whole frame goes out in one write
+    stats.bytes = output_.size();
+    if (!output_.empty()) {
+        writeAll(output_);
+    }
+}
+
+// Private helper functions
+VtTerminal::Pen VtTerminal::penFor(const Cell& cell) const {
+    if (cell.image) {
+        uint32_t top = cell.foreground;
+        uint32_t bottom = cell.background;
+        if (!unicode_) {
+            // No half block: one flat cell in the average of both pixels
+            top = bottom = averageColor(top, bottom);
+        }
+        if (true_color_) {
+            return {static_cast<int32_t>(TRUE_COLOR | top), static_cast<int32_t>(TRUE_COLOR | bottom), false, false};
+        }
+        return {nearestPaletteColor(top), nearestPaletteColor(bottom), false, false};
+    }
+
+    // Same palette as NCursesTerminal::initializeColors()
+    Pen pen = {DEFAULT_COLOR, DEFAULT_COLOR, cell.bold, cell.reverse};
+    switch (cell.color) {
+        case STATUS_BAR:   pen.foreground = 7; pen.background = 4; break;  // White on blue
+        case SELECTED:     pen.foreground = 0; pen.background = 3; break;  // Black on yellow
+        case ERROR:        pen.foreground = 7; pen.background = 1; break;  // White on red
+        case DIRECTORY:    pen.foreground = 2; pen.background = 0; break;  // Green on black
+        case DIFF_REMOVED: pen.foreground = 1; pen.background = 0; break;  // Red on black
+        case DIFF_ADDED:   pen.foreground = 2; pen.background = 0; break;  // Green on black
+        default: break;
+    }
+    return pen;
+}
+
+void VtTerminal::moveCursor(int y, int x) {
+    if (y == cursor_y_ && x == cursor_x_) return;
+
+    std::string absolute = "\x1b[";
+    if (y > 0 || x > 0) appendNumber(absolute, y + 1);
+    if (x > 0) {
+        absolute += ';';
+        appendNumber(absolute, x + 1);
+    }
+    absolute += 'H';
+
+    if (cursor_y_ < 0) {
+        output_ += absolute;
+    } else if (y == cursor_y_) {
+        // A short run of unchanged plain cells is cheaper to print again than to skip
+        std::string skip;
+        appendHorizontalMove(skip, cursor_x_, x);
+        size_t row = static_cast<size_t>(y) * width_;
+        // Not while the line drawing set is selected, which would turn the letters into glyphs
+        bool reprint = pen_known_ && !line_drawing_ && x > cursor_x_ &&
+                       x - cursor_x_ < static_cast<int>(skip.length());
+        for (int i = cursor_x_; reprint && i < x; i++) {
+            const Cell& cell = staged_[row + i];
+            reprint = cell.ch >= 0x20 && cell.ch < 0x7F && penFor(cell) == pen_;
+        }
+        if (reprint) {
+            for (int i = cursor_x_; i < x; i++) {
+                output_ += static_cast<char>(staged_[row + i].ch);
+            }
+        } else {
+            output_ += skip.length() <= absolute.length() ? skip : absolute;
+        }
+    } else {
+        std::string relative;
+        int rows = y - cursor_y_;
+        if (rows > 0 && rows <= 3) {
+            relative.append(rows, '\n');
+        } else {
+            appendCsi(relative, std::abs(rows), rows > 0 ? 'B' : 'A');
+        }
+        appendHorizontalMove(relative, cursor_x_, x);
+        output_ += relative.length() < absolute.length() ? relative : absolute;
+    }
+
+    cursor_y_ = y;
+    cursor_x_ = x;
+}
+
+void VtTerminal::setPen(const Pen& pen) {
+    if (pen_known_ && pen == pen_) return;
+
+    output_ += "\x1b[";
+    bool first = true;
+    Pen current = pen_;
+
+    // Bold and reverse can only be dropped together with everything else
+    if (!pen_known_ || (current.bold && !pen.bold) || (current.reverse && !pen.reverse)) {
+        output_ += '0';
+        first = false;
+        current = {DEFAULT_COLOR, DEFAULT_COLOR, false, false};
+    }
+    if (pen.bold && !current.bold) {
+        if (!first) output_ += ';';
+        output_ += '1';
+        first = false;
+    }
+    if (pen.reverse && !current.reverse) {
+        if (!first) output_ += ';';
+        output_ += '7';
+        first = false;
+    }
+    if (pen.foreground != current.foreground) {
+        if (!first) output_ += ';';
+        appendColor(pen.foreground, false);
+        first = false;
+    }
+    if (pen.background != current.background) {
+        if (!first) output_ += ';';
+        appendColor(pen.background, true);
+    }
+    output_ += 'm';
+
+    pen_ = pen;
+    pen_known_ = true;
+}
+
+void VtTerminal::appendColor(int32_t color, bool background) {
+    if (color == DEFAULT_COLOR) {
+        output_ += background ? "49" : "39";
+    } else if (color & TRUE_COLOR) {
+        output_ += background ? "48;2;" : "38;2;";
+        appendNumber(output_, (color >> 16) & 0xFF);
+        output_ += ';';
+        appendNumber(output_, (color >> 8) & 0xFF);
+        output_ += ';';
+        appendNumber(output_, color & 0xFF);
+    } else if (color < 8) {
+        appendNumber(output_, (background ? 40 : 30) + color);
+    } else {
+        output_ += background ? "48;5;" : "38;5;";
+        appendNumber(output_, color);
+    }
+}
+
+void VtTerminal::appendCell(const Cell& cell) {
+    setPen(penFor(cell));
+    char32_t ch = cell.ch < 0x20 || cell.ch == 0x7F ? U'?' : cell.ch;
+
+    // Without UTF-8, lines come from the DEC special graphics set as curses draws them
+    char line = 0;
+    if (!unicode_ && ch >= 0x80) {
+        line = lineDrawingCharacter(ch);
+        ch = cell.image ? U' ' : line ? static_cast<char32_t>(line) : U'?';
+    }
+    if ((line != 0) != line_drawing_) {
+        output_ += line ? "\x1b(0" : "\x1b(B";
+        line_drawing_ = line != 0;
+    }
+    appendUtf8(output_, ch);
+
+    // Wide or zero-width characters and the pending wrap at the right margin
+    // leave the cursor somewhere the next move should not assume
+    cursor_x_++;
+    if (cursor_x_ >= width_ || (ch >= 0x80 && wcwidth(static_cast<wchar_t>(ch)) != 1)) {
+        cursor_y_ = cursor_x_ = -1;
+    }
+}
+
+bool VtTerminal::readInput() {
+    std::string bytes;
+    char buffer[256];
+
+    do {
+        ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+        bytes.append(buffer, count);
+
+        // Wait briefly for the rest of a split escape sequence
+        struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+        if (!endsInsideEscape(bytes) || poll(&input, 1, ESCAPE_DELAY_MS) <= 0) break;
+    } while (true);
+
+    if (bytes.empty()) return false;
+    pushInput(bytes);
+    return true;
+}
+
+void VtTerminal::writeAll(const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t count = write(STDOUT_FILENO, data.data() + written, data.size() - written);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) {
+                struct pollfd output = {STDOUT_FILENO, POLLOUT, 0};
+                poll(&output, 1, -1);
+                continue;
+            }
+            return;
+        }
+        written += count;
+    }
+}
+
+void VtTerminal::updateSize() {
+    struct winsize size;
+    int width = 80, height = 24;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0) {
+        width = size.ws_col;
+        height = size.ws_row;
+    }
+
+    // Old contents reflow unpredictably, so the next frame starts from a cleared screen
+    resizeScreen(width, height);
+    clear_pending_ = true;
+}
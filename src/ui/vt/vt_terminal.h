@@ -0,0 +1,75 @@
+#ifndef VT_TERMINAL_H
+#define VT_TERMINAL_H
+
+#include "../memory/memory_terminal.h"
+#include <string>
+#include <termios.h>
+
+/**
+ * @brief Terminal interface that writes VT/ANSI escape sequences directly
+ * Drawing goes into the in-memory cell grids of MemoryTerminal (the back
+ * buffer); each frame is compared with what the terminal shows (the front
+ * buffer) and only the changed cells are sent, using the shortest cursor
+ * movement and attribute changes, in a single write(). No terminfo database
+ * is loaded, so it assumes an xterm-compatible terminal.
+ */
+class VtTerminal : public MemoryTerminal {
+public:
+    VtTerminal();
+    ~VtTerminal() override;
+
+    // Core terminal operations
+    bool initialize() override;
+    void shutdown() override;
+    int getKey() override;
+    int getInputDescriptor() override;
+    void updateScreenSize() override;
+
+    // Screen operations
+    void clearScreen() override;
+
+    // Cursor operations
+    void hideCursor() override;
+    void showCursor() override;
+
+protected:
+    void present(FrameStats& stats) override;
+
+private:
+    // Attributes as sent to the terminal
+    struct Pen {
+        int32_t foreground;     // -1 default, 0-255 palette index, TRUE_COLOR | RGB
+        int32_t background;
+        bool bold;
+        bool reverse;
+
+        bool operator==(const Pen& other) const {
+            return foreground == other.foreground && background == other.background &&
+                   bold == other.bold && reverse == other.reverse;
+        }
+        bool operator!=(const Pen& other) const { return !(*this == other); }
+    };
+
+    bool initialized_;
+    struct termios original_termios_;
+    bool unicode_;              // Locale can render UTF-8 (box drawing and half blocks)
+    bool true_color_;           // Terminal takes 24-bit colors (COLORTERM)
+    std::string output_;        // Frame being assembled; keeps its capacity
+    int cursor_y_;              // Cursor position, -1 when unknown
+    int cursor_x_;
+    Pen pen_;
+    bool pen_known_;
+    bool clear_pending_;        // Erase the whole screen at the start of the next frame
+    bool line_drawing_;         // DEC special graphics character set selected
+
+    Pen penFor(const Cell& cell) const;
+    void moveCursor(int y, int x);
+    void setPen(const Pen& pen);
+    void appendColor(int32_t color, bool background);
+    void appendCell(const Cell& cell);
+    bool readInput();
+    void writeAll(const std::string& data);
+    void updateSize();
+};
+
+#endif // VT_TERMINAL_H
@@ -3,6 +3,7 @@
 #ifdef _WIN32
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 // Windows Console color constants
 #ifndef FOREGROUND_WHITE
@@ -25,7 +26,7 @@ WindowsTerminal::WindowsTerminal()
     : initialized_(false)
     , console_output_(INVALID_HANDLE_VALUE)
     , console_input_(INVALID_HANDLE_VALUE)
-    , next_window_id_(1) {
+    , input_timeout_ms_(-1) {
 }
 
 WindowsTerminal::~WindowsTerminal() {
@@ -95,6 +96,12 @@ int WindowsTerminal::getKey() {
     DWORD events_read;
     
     while (true) {
+        // Wait for input only as long as the caller allows
+        DWORD wait = input_timeout_ms_ < 0 ? INFINITE : static_cast<DWORD>(input_timeout_ms_);
+        if (WaitForSingleObject(console_input_, wait) != WAIT_OBJECT_0) {
+            return KEY_UNKNOWN;
+        }
+
         if (!ReadConsoleInput(console_input_, &input, 1, &events_read)) {
             return KEY_UNKNOWN;
         }
@@ -107,10 +114,20 @@ int WindowsTerminal::getKey() {
     }
 }
 
+void WindowsTerminal::setInputTimeout(int milliseconds) {
+    input_timeout_ms_ = milliseconds;
+}
+
+int WindowsTerminal::getInputDescriptor() {
+    return -1;  // Console input is a handle; resizes arrive as input records
+}
+
+void WindowsTerminal::updateScreenSize() {
+}
+
 ITerminal::WindowHandle WindowsTerminal::createWindow(int height, int width, int start_y, int start_x) {
-    WindowHandle handle = reinterpret_cast<WindowHandle>(next_window_id_++);
-    
-    WindowInfo info;
+    auto window = std::unique_ptr<WindowInfo>(new WindowInfo());
+    WindowInfo& info = *window;
     info.x = start_x;
     info.y = start_y;
     info.width = width;
@@ -127,12 +144,16 @@ ITerminal::WindowHandle WindowsTerminal::createWindow(int height, int width, int
         }
     }
     
-    windows_[handle] = info;
-    return handle;
+    windows_.push_back(std::move(window));
+    return static_cast<WindowHandle>(windows_.back().get());
 }
 
 void WindowsTerminal::destroyWindow(WindowHandle window) {
-    windows_.erase(window);
+    auto it = std::find_if(windows_.begin(), windows_.end(),
+                           [window](const std::unique_ptr<WindowInfo>& w) { return w.get() == window; });
+    if (it != windows_.end()) {
+        windows_.erase(it);
+    }
 }
 
 void WindowsTerminal::getWindowSize(WindowHandle window, int& width, int& height) {
@@ -198,6 +219,23 @@ void WindowsTerminal::drawHorizontalLine(WindowHandle window, int y, int x, int
     }
 }
 
+void WindowsTerminal::drawImageRow(WindowHandle window, int y, int x,
+                                   const uint8_t* top, const uint8_t* bottom, int count) {
+    WindowInfo* info = getWindowInfo(window);
+    if (!info || y < 0 || y >= info->height) return;
+
+    for (int i = 0; i < count && x + i < info->width; i++) {
+        if (x + i < 0) continue;
+        WORD foreground = nearestConsoleColor(top + i * 3);
+        WORD background = bottom ? nearestConsoleColor(bottom + i * 3) : 0;
+
+        // Upper half block: foreground paints the top pixel, background the bottom one
+        CHAR_INFO& cell = info->buffer[y][x + i];
+        cell.Char.UnicodeChar = 0x2580;
+        cell.Attributes = foreground | (background << 4);
+    }
+}
+
 // ... Additional Windows-specific implementations would continue here
 // For brevity, I'll show the key mapping and helper functions
 
@@ -213,15 +251,11 @@ int WindowsTerminal::mapKeyCode(int windows_key) {
         case VK_END: return KEY_END_KEY;
         case VK_RETURN: return KEY_ENTER_KEY;
         case VK_ESCAPE: return KEY_ESCAPE_KEY;
+        case VK_BACK: return KEY_BACKSPACE_KEY;
         default: return windows_key;
     }
 }
 
-WindowsTerminal::WindowInfo* WindowsTerminal::getWindowInfo(WindowHandle handle) {
-    auto it = windows_.find(handle);
-    return (it != windows_.end()) ? &it->second : nullptr;
-}
-
 void WindowsTerminal::drawCharacter(WindowHandle window, int y, int x, char ch, WORD attributes) {
     WindowInfo* info = getWindowInfo(window);
     if (!info || y < 0 || y >= info->height || x < 0 || x >= info->width) return;
@@ -254,15 +288,86 @@ void WindowsTerminal::clearTextAttribute(WindowHandle window, ColorPair color, b
     info->default_attributes = original_info_.wAttributes;
 }
 
+void WindowsTerminal::submit(WindowHandle window, const DrawList& list) {
+    // Qualified calls skip virtual dispatch; the handle itself resolves without a lookup
+    for (const DrawList::Command& command : list.getCommands()) {
+        switch (command.op) {
+            case DrawList::Op::CLEAR_WINDOW:
+                WindowsTerminal::clearWindow(window);
+                break;
+            case DrawList::Op::DRAW_BORDER:
+                WindowsTerminal::drawBorder(window);
+                break;
+            case DrawList::Op::DRAW_TEXT:
+                WindowsTerminal::drawText(window, command.y, command.x,
+                                          std::string(list.getText(command), command.size));
+                break;
+            case DrawList::Op::CENTER_TEXT:
+                WindowsTerminal::centerText(window, command.y, std::string(list.getText(command), command.size));
+                break;
+            case DrawList::Op::HORIZONTAL_LINE:
+                WindowsTerminal::drawHorizontalLine(window, command.y, command.x, command.count);
+                break;
+            case DrawList::Op::IMAGE_ROW:
+                WindowsTerminal::drawImageRow(window, command.y, command.x, list.getTopPixels(command),
+                                              list.getBottomPixels(command), command.count);
+                break;
+            case DrawList::Op::SET_ATTRIBUTE:
+                WindowsTerminal::setTextAttribute(window, command.color, command.bold, command.reverse);
+                break;
+            case DrawList::Op::CLEAR_ATTRIBUTE:
+                WindowsTerminal::clearTextAttribute(window, command.color, command.bold, command.reverse);
+                break;
+        }
+    }
+}
+
 void WindowsTerminal::refreshWindow(WindowHandle window) {
-    updateWindowBuffer(window);
+    WindowInfo* info = getWindowInfo(window);
+    if (!info) return;
+
+    // Only rows that differ from the last staged frame are written by updateScreen()
+    info->frame.resize(info->buffer.size());
+    info->dirty.resize(info->buffer.size(), false);
+    for (size_t y = 0; y < info->buffer.size(); y++) {
+        const auto& row = info->buffer[y];
+        auto& last = info->frame[y];
+        if (last.size() == row.size() && memcmp(last.data(), row.data(), row.size() * sizeof(CHAR_INFO)) == 0) {
+            continue;
+        }
+        last = row;
+        info->dirty[y] = true;
+    }
+}
+
+void WindowsTerminal::updateScreen() {
+    // One console write per run of consecutive dirty rows
+    for (auto& window : windows_) {
+        WindowInfo& info = *window;
+        int height = static_cast<int>(info.dirty.size());
+        for (int y = 0; y < height;) {
+            if (!info.dirty[y]) {
+                y++;
+                continue;
+            }
+            int end = y;
+            while (end < height && info.dirty[end]) {
+                info.dirty[end++] = false;
+            }
+            writeRows(info, y, end - y);
+            y = end;
+        }
+    }
 }
 
 void WindowsTerminal::refreshScreen() {
-    // Refresh all windows
-    for (auto& pair : windows_) {
-        updateWindowBuffer(pair.first);
+    // Rewrite all windows, whatever was staged before
+    for (auto& window : windows_) {
+        WindowInfo& info = *window;
+        info.frame = info.buffer;
+        info.dirty.assign(info.buffer.size(), true);
     }
+    updateScreen();
 }
 
 void WindowsTerminal::clearScreen() {
@@ -276,6 +381,11 @@ void WindowsTerminal::clearScreen() {
         FillConsoleOutputAttribute(console_output_, info.wAttributes, size, coord, &written);
         SetConsoleCursorPosition(console_output_, coord);
     }
+
+    // The console no longer shows what was staged, so every row is written again
+    for (auto& window : windows_) {
+        window->frame.clear();
+    }
 }
 
 void WindowsTerminal::hideCursor() {
@@ -323,26 +433,23 @@ void WindowsTerminal::forceCompleteRedraw() {
     refreshScreen();
 }
 
-void WindowsTerminal::updateWindowBuffer(WindowHandle window) {
-    WindowInfo* info = getWindowInfo(window);
-    if (!info) return;
-
-    // Write the window buffer to the console
-    COORD buffer_size = {(SHORT)info->width, (SHORT)info->height};
+void WindowsTerminal::writeRows(const WindowInfo& info, int first, int count) {
+    // Write rows [first, first + count) of the staged frame to the console
+    COORD buffer_size = {(SHORT)info.width, (SHORT)count};
     COORD buffer_coord = {0, 0};
     SMALL_RECT write_region = {
-        (SHORT)info->x,
-        (SHORT)info->y,
-        (SHORT)(info->x + info->width - 1),
-        (SHORT)(info->y + info->height - 1)
+        (SHORT)info.x,
+        (SHORT)(info.y + first),
+        (SHORT)(info.x + info.width - 1),
+        (SHORT)(info.y + first + count - 1)
     };
 
-    // Flatten the 2D buffer for WriteConsoleOutput
+    // Flatten the rows for WriteConsoleOutput
     std::vector<CHAR_INFO> flat_buffer;
-    flat_buffer.reserve(info->width * info->height);
+    flat_buffer.reserve(info.width * count);
 
-    for (const auto& row : info->buffer) {
-        for (const auto& cell : row) {
+    for (int y = first; y < first + count; y++) {
+        for (const auto& cell : info.frame[y]) {
             flat_buffer.push_back(cell);
         }
     }
@@ -350,6 +457,20 @@ void WindowsTerminal::updateWindowBuffer(WindowHandle window) {
     WriteConsoleOutput(console_output_, flat_buffer.data(), buffer_size, buffer_coord, &write_region);
 }
 
+WORD WindowsTerminal::nearestConsoleColor(const uint8_t* rgb) {
+    // Each channel contributes its bit; bright channels also set the intensity bit
+    WORD color = 0;
+    int brightest = std::max(rgb[0], std::max(rgb[1], rgb[2]));
+    int threshold = brightest / 2;
+    if (brightest >= 64) {
+        if (rgb[0] > threshold) color |= FOREGROUND_RED;
+        if (rgb[1] > threshold) color |= FOREGROUND_GREEN;
+        if (rgb[2] > threshold) color |= FOREGROUND_BLUE;
+    }
+    if (brightest >= 192) color |= FOREGROUND_INTENSITY;
+    return color;
+}
+
 WORD WindowsTerminal::mapColorPair(ColorPair color) {
     switch (color) {
         case STATUS_BAR:
@@ -360,6 +481,10 @@ WORD WindowsTerminal::mapColorPair(ColorPair color) {
             return FOREGROUND_WHITE | BACKGROUND_RED;
         case DIRECTORY:
             return FOREGROUND_GREEN;
+        case DIFF_REMOVED:
+            return FOREGROUND_RED | FOREGROUND_INTENSITY;
+        case DIFF_ADDED:
+            return FOREGROUND_GREEN | FOREGROUND_INTENSITY;
         default:
             return FOREGROUND_WHITE;
     }
@@ -6,7 +6,6 @@
 #ifdef _WIN32
 #include <windows.h>
 #include <conio.h>
-#include <map>
 #include <vector>
 
 /**
@@ -24,6 +23,9 @@ public:
     void shutdown() override;
     void getScreenSize(int& width, int& height) override;
     int getKey() override;
+    void setInputTimeout(int milliseconds) override;
+    int getInputDescriptor() override;
+    void updateScreenSize() override;
     
     // Window management
     WindowHandle createWindow(int height, int width, int start_y, int start_x) override;
@@ -35,13 +37,17 @@ public:
     void drawBorder(WindowHandle window) override;
     void drawText(WindowHandle window, int y, int x, const std::string& text) override;
     void drawHorizontalLine(WindowHandle window, int y, int x, int length) override;
+    void drawImageRow(WindowHandle window, int y, int x,
+                      const uint8_t* top, const uint8_t* bottom, int count) override;
     
     // Text attributes
     void setTextAttribute(WindowHandle window, ColorPair color, bool bold = false, bool reverse = false) override;
     void clearTextAttribute(WindowHandle window, ColorPair color, bool bold = false, bool reverse = false) override;
+    void submit(WindowHandle window, const DrawList& list) override;
     
     // Screen operations
     void refreshWindow(WindowHandle window) override;
+    void updateScreen() override;
     void refreshScreen() override;
     void clearScreen() override;
     
@@ -65,20 +71,23 @@ private:
         int x, y, width, height;
         WORD default_attributes;
         std::vector<std::vector<CHAR_INFO>> buffer;
+        std::vector<std::vector<CHAR_INFO>> frame;  // Contents last staged by refreshWindow()
+        std::vector<bool> dirty;                    // Staged rows not yet written to the console
     };
     
     bool initialized_;
     HANDLE console_output_;
     HANDLE console_input_;
     CONSOLE_SCREEN_BUFFER_INFO original_info_;
-    std::map<WindowHandle, WindowInfo> windows_;
-    int next_window_id_;
+    std::vector<std::unique_ptr<WindowInfo>> windows_;  // A WindowHandle points at one of these
+    int input_timeout_ms_;
     
     // Helper functions
-    WindowInfo* getWindowInfo(WindowHandle handle);
+    WindowInfo* getWindowInfo(WindowHandle handle) { return static_cast<WindowInfo*>(handle); }
     int mapKeyCode(int windows_key);
     WORD mapColorPair(ColorPair color);
-    void updateWindowBuffer(WindowHandle window);
+    WORD nearestConsoleColor(const uint8_t* rgb);
+    void writeRows(const WindowInfo& info, int first, int count);
     void drawCharacter(WindowHandle window, int y, int x, char ch, WORD attributes);
 };
 
@@ -90,6 +99,9 @@ public:
     void shutdown() override {}
     void getScreenSize(int& width, int& height) override { width = height = 0; }
     int getKey() override { return -1; }
+    void setInputTimeout(int) override {}
+    int getInputDescriptor() override { return -1; }
+    void updateScreenSize() override {}
     WindowHandle createWindow(int, int, int, int) override { return nullptr; }
     void destroyWindow(WindowHandle) override {}
     void getWindowSize(WindowHandle, int&, int&) override {}
@@ -97,9 +109,12 @@ public:
     void drawBorder(WindowHandle) override {}
     void drawText(WindowHandle, int, int, const std::string&) override {}
     void drawHorizontalLine(WindowHandle, int, int, int) override {}
+    void drawImageRow(WindowHandle, int, int, const uint8_t*, const uint8_t*, int) override {}
     void setTextAttribute(WindowHandle, ColorPair, bool, bool) override {}
     void clearTextAttribute(WindowHandle, ColorPair, bool, bool) override {}
+    void submit(WindowHandle, const DrawList&) override {}
     void refreshWindow(WindowHandle) override {}
+    void updateScreen() override {}
     void refreshScreen() override {}
     void clearScreen() override {}
     void hideCursor() override {}
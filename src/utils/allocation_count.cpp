@@ -0,0 +1,50 @@
+#include "utils.h"
+#include <cstdlib>
+#include <new>
+
+// Global operator new is replaced so allocations can be counted; the memory
+// still comes from malloc()
+
+namespace {
+    // Per thread, so worker threads do not show up in the UI thread's counts
+    thread_local uint64_t allocation_count = 0;
+}
+
+namespace Utils {
+    uint64_t getAllocationCount() {
+        return allocation_count;
+    }
+}
+
+void* operator new(std::size_t size) {
+    allocation_count++;
+    if (size == 0) size = 1;
+    while (true) {
+        void* memory = std::malloc(size);
+        if (memory) return memory;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,390 @@
+#include "hash.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUICKVIEW_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace {
+    const uint64_t PRIME32_1 = 0x9E3779B1U;
+    const uint64_t PRIME32_2 = 0x85EBCA77U;
+    const uint64_t PRIME32_3 = 0xC2B2AE3DU;
+    const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+    const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+    const uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+    const uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+    const size_t SECRET_SIZE = 192;
+    const size_t STRIPE_LENGTH = 64;
+    const size_t STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_LENGTH) / 8;
+    const size_t LAST_STRIPE_SECRET = SECRET_SIZE - STRIPE_LENGTH - 7;
+    const size_t MERGE_SECRET = 11;
+
+    // Default XXH3 secret
+    const uint8_t SECRET[SECRET_SIZE] = {
+        0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+        0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+        0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+        0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+        0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+        0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+        0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+        0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+        0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+        0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+        0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+        0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+    };
+
+    uint32_t readLE32(const uint8_t* p) {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;  // All supported targets are little-endian
+    }
+
+    uint64_t readLE64(const uint8_t* p) {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint64_t rotl64(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t swap64(uint64_t value) {
+        value = ((value << 8) & 0xFF00FF00FF00FF00ULL) | ((value >> 8) & 0x00FF00FF00FF00FFULL);
+        value = ((value << 16) & 0xFFFF0000FFFF0000ULL) | ((value >> 16) & 0x0000FFFF0000FFFFULL);
+        return (value << 32) | (value >> 32);
+    }
+
+    // 64x64 -> 128 bit multiply, folded by xoring the halves
+    uint64_t mul128Fold64(uint64_t lhs, uint64_t rhs) {
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 uint128;
+        uint128 product = static_cast<uint128>(lhs) * rhs;
+        return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        uint64_t high;
+        uint64_t low = _umul128(lhs, rhs, &high);
+        return low ^ high;
+#else
+        uint64_t lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+        uint64_t hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+        uint64_t lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+        uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+        uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+        uint64_t high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+        uint64_t low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+        return low ^ high;
+#endif
+    }
+
+    uint64_t xxh64Avalanche(uint64_t hash) {
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    uint64_t avalanche(uint64_t hash) {
+        hash ^= hash >> 37;
+        hash *= PRIME_MX1;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    uint64_t rrmxmx(uint64_t hash, uint64_t length) {
+        hash ^= rotl64(hash, 49) ^ rotl64(hash, 24);
+        hash *= PRIME_MX2;
+        hash ^= (hash >> 35) + length;
+        hash *= PRIME_MX2;
+        return hash ^ (hash >> 28);
+    }
+
+    uint64_t mix16(const uint8_t* input, const uint8_t* secret) {
+        return mul128Fold64(readLE64(input) ^ readLE64(secret), readLE64(input + 8) ^ readLE64(secret + 8));
+    }
+
+    uint64_t hashShort(const uint8_t* input, size_t length) {
+        if (length > 8) {
+            uint64_t low = readLE64(input) ^ (readLE64(SECRET + 24) ^ readLE64(SECRET + 32));
+            uint64_t high = readLE64(input + length - 8) ^ (readLE64(SECRET + 40) ^ readLE64(SECRET + 48));
+            return avalanche(length + swap64(low) + high + mul128Fold64(low, high));
+        }
+        if (length >= 4) {
+            uint64_t combined = readLE32(input + length - 4) + (static_cast<uint64_t>(readLE32(input)) << 32);
+            return rrmxmx(combined ^ (readLE64(SECRET + 8) ^ readLE64(SECRET + 16)), length);
+        }
+        if (length > 0) {
+            uint32_t combined = (static_cast<uint32_t>(input[0]) << 16) | (static_cast<uint32_t>(input[length >> 1]) << 24) |
+                                input[length - 1] | (static_cast<uint32_t>(length) << 8);
+            return xxh64Avalanche(combined ^ (static_cast<uint64_t>(readLE32(SECRET)) ^ readLE32(SECRET + 4)));
+        }
+        return xxh64Avalanche(readLE64(SECRET + 56) ^ readLE64(SECRET + 64));
+    }
+
+    uint64_t hashMedium(const uint8_t* input, size_t length) {
+        uint64_t acc = length * PRIME64_1;
+        if (length <= 128) {
+            size_t rounds = (length - 1) / 32;
+            for (size_t i = 0; i <= rounds; i++) {
+                acc += mix16(input + 16 * i, SECRET + 32 * i);
+                acc += mix16(input + length - 16 * (i + 1), SECRET + 32 * i + 16);
+            }
+            return avalanche(acc);
+        }
+
+        // 129 to 240 bytes
+        for (size_t i = 0; i < 8; i++) {
+            acc += mix16(input + 16 * i, SECRET + 16 * i);
+        }
+        uint64_t acc_end = mix16(input + length - 16, SECRET + 136 - 17);
+        acc = avalanche(acc);
+        for (size_t i = 8; i < length / 16; i++) {
+            acc_end += mix16(input + 16 * i, SECRET + 16 * (i - 8) + 3);
+        }
+        return avalanche(acc + acc_end);
+    }
+
+    // Mix one 64-byte stripe into the eight accumulators
+    void accumulateStripe(uint64_t* acc, const uint8_t* input, const uint8_t* secret) {
+#ifdef QUICKVIEW_HASH_SSE2
+        __m128i* xacc = reinterpret_cast<__m128i*>(acc);
+        for (int i = 0; i < 4; i++) {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + i);
+            __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+            __m128i data_key = _mm_xor_si128(data, key);
+            __m128i data_key_high = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            __m128i product = _mm_mul_epu32(data_key, data_key_high);
+            __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            __m128i sum = _mm_add_epi64(_mm_loadu_si128(xacc + i), swapped);
+            _mm_storeu_si128(xacc + i, _mm_add_epi64(product, sum));
+        }
+#else
+        for (int lane = 0; lane < 8; lane++) {
+            uint64_t data = readLE64(input + lane * 8);
+            uint64_t data_key = data ^ readLE64(secret + lane * 8);
+            acc[lane ^ 1] += data;
+            acc[lane] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+        }
+#endif
+    }
+
+    void scrambleAccumulators(uint64_t* acc, const uint8_t* secret) {
+        for (int lane = 0; lane < 8; lane++) {
+            uint64_t value = acc[lane];
+            value ^= value >> 47;
+            value ^= readLE64(secret + lane * 8);
+            acc[lane] = value * PRIME32_1;
+        }
+    }
+
+    uint64_t mergeAccumulators(const uint64_t* acc, const uint8_t* secret, uint64_t start) {
+        uint64_t result = start;
+        for (int i = 0; i < 4; i++) {
+            result += mul128Fold64(acc[2 * i] ^ readLE64(secret + 16 * i), acc[2 * i + 1] ^ readLE64(secret + 16 * i + 8));
+        }
+        return avalanche(result);
+    }
+}
+
+Xxh3Hasher::Xxh3Hasher()
+    : accumulators_{PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1}
+    , buffered_(0)
+    , stripes_in_block_(0)
+    , total_length_(0)
+{
+}
+
+void Xxh3Hasher::consumeStripes(const uint8_t* input, size_t stripes) {
+    for (size_t i = 0; i < stripes; i++) {
+        accumulateStripe(accumulators_, input + i * STRIPE_LENGTH, SECRET + stripes_in_block_ * 8);
+        if (++stripes_in_block_ == STRIPES_PER_BLOCK) {
+            scrambleAccumulators(accumulators_, SECRET + SECRET_SIZE - STRIPE_LENGTH);
+            stripes_in_block_ = 0;
+        }
+    }
+    memcpy(last_stripe_, input + (stripes - 1) * STRIPE_LENGTH, STRIPE_LENGTH);
+}
+
+void Xxh3Hasher::update(const void* data, size_t size) {
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+    total_length_ += size;
+
+    if (size <= BUFFER_SIZE - buffered_) {
+        memcpy(buffer_ + buffered_, input, size);
+        buffered_ += size;
+        return;
+    }
+
+    // Stripes are only consumed once more input is known to follow, because
+    // the final stripe of the input is mixed in differently
+    if (buffered_ > 0) {
+        size_t fill = BUFFER_SIZE - buffered_;
+        memcpy(buffer_ + buffered_, input, fill);
+        input += fill;
+        size -= fill;
+        consumeStripes(buffer_, BUFFER_SIZE / STRIPE_LENGTH);
+        buffered_ = 0;
+    }
+
+    if (size > BUFFER_SIZE) {
+        size_t stripes = (size - 1) / STRIPE_LENGTH;
+        consumeStripes(input, stripes);
+        input += stripes * STRIPE_LENGTH;
+        size -= stripes * STRIPE_LENGTH;
+    }
+
+    memcpy(buffer_, input, size);
+    buffered_ = size;
+}
+
+uint64_t Xxh3Hasher::digest() const {
+    if (total_length_ <= 16) return hashShort(buffer_, buffered_);
+    if (total_length_ <= 240) return hashMedium(buffer_, buffered_);
+
+    // Finish on copies so the hasher stays usable
+    Xxh3Hasher state(*this);
+    uint8_t last_stripe[STRIPE_LENGTH];
+    const uint8_t* last = last_stripe;
+    if (state.buffered_ >= STRIPE_LENGTH) {
+        state.consumeStripes(state.buffer_, (state.buffered_ - 1) / STRIPE_LENGTH);
+        last = buffer_ + buffered_ - STRIPE_LENGTH;
+    } else {
+        size_t catch_up = STRIPE_LENGTH - buffered_;
+        memcpy(last_stripe, last_stripe_ + STRIPE_LENGTH - catch_up, catch_up);
+        memcpy(last_stripe + catch_up, buffer_, buffered_);
+    }
+    accumulateStripe(state.accumulators_, last, SECRET + LAST_STRIPE_SECRET);
+    return mergeAccumulators(state.accumulators_, SECRET + MERGE_SECRET, total_length_ * PRIME64_1);
+}
+
+uint64_t Xxh3Hasher::hash(const void* data, size_t size) {
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+    if (size <= 16) return hashShort(input, size);
+    if (size <= 240) return hashMedium(input, size);
+
+    Xxh3Hasher hasher;
+    hasher.update(input, size);
+    return hasher.digest();
+}
+
+namespace {
+    const uint32_t SHA256_K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    uint32_t rotr32(uint32_t value, int bits) {
+        return (value >> bits) | (value << (32 - bits));
+    }
+}
+
+Sha256Hasher::Sha256Hasher()
+    : state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}
+    , block_size_(0)
+    , total_length_(0)
+{
+}
+
+void Sha256Hasher::processBlock(const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) | (static_cast<uint32_t>(block[i * 4 + 1]) << 16) |
+               (static_cast<uint32_t>(block[i * 4 + 2]) << 8) | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+        uint32_t choice = (e & f) ^ (~e & g);
+        uint32_t temp1 = h + s1 + choice + SHA256_K[i] + w[i];
+        uint32_t s0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+        uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t temp2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+
+    state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+    state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+}
+
+void Sha256Hasher::update(const void* data, size_t size) {
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+    total_length_ += size;
+
+    if (block_size_ > 0) {
+        size_t fill = std::min(size, sizeof(block_) - block_size_);
+        memcpy(block_ + block_size_, input, fill);
+        block_size_ += fill;
+        input += fill;
+        size -= fill;
+        if (block_size_ < sizeof(block_)) return;
+        processBlock(block_);
+        block_size_ = 0;
+    }
+
+    while (size >= sizeof(block_)) {
+        processBlock(input);
+        input += sizeof(block_);
+        size -= sizeof(block_);
+    }
+
+    memcpy(block_, input, size);
+    block_size_ = size;
+}
+
+std::string Sha256Hasher::finish() {
+    uint64_t bit_length = total_length_ * 8;
+
+    // Pad with 0x80, zeros, then the big-endian bit length
+    uint8_t padding[72] = {0x80};
+    size_t padding_length = (block_size_ < 56 ? 56 : 120) - block_size_;
+    update(padding, padding_length);
+    uint8_t length_bytes[8];
+    for (int i = 0; i < 8; i++) {
+        length_bytes[i] = static_cast<uint8_t>(bit_length >> (56 - i * 8));
+    }
+    update(length_bytes, sizeof(length_bytes));
+
+    static const char HEX[] = "0123456789abcdef";
+    std::string digest;
+    digest.reserve(64);
+    for (uint32_t word : state_) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            digest += HEX[(word >> shift) & 0xF];
+        }
+    }
+    return digest;
+}
@@ -0,0 +1,80 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Streaming XXH3 (64-bit, seed 0) content hash
+ * Produces the same values as the reference XXH3_64bits() for any split of the input.
+ */
+class Xxh3Hasher {
+public:
+    Xxh3Hasher();
+
+    /**
+     * @brief Add bytes to the hash
+     * @param data Bytes to add
+     * @param size Number of bytes
+     */
+    void update(const void* data, size_t size);
+
+    /**
+     * @brief Get the hash of everything added so far (the hasher can keep being updated)
+     * @return 64-bit hash
+     */
+    uint64_t digest() const;
+
+    /**
+     * @brief Hash a buffer in one call
+     * @param data Bytes to hash
+     * @param size Number of bytes
+     * @return 64-bit hash
+     */
+    static uint64_t hash(const void* data, size_t size);
+
+private:
+    static const size_t BUFFER_SIZE = 256;
+    static const size_t STRIPE_LENGTH = 64;
+
+    uint64_t accumulators_[8];
+    uint8_t buffer_[BUFFER_SIZE];           // Input not yet consumed
+    uint8_t last_stripe_[STRIPE_LENGTH];    // Last consumed stripe, needed when the input ends mid-stripe
+    size_t buffered_;
+    size_t stripes_in_block_;
+    uint64_t total_length_;
+
+    void consumeStripes(const uint8_t* input, size_t stripes);
+};
+
+/**
+ * @brief Streaming SHA-256
+ */
+class Sha256Hasher {
+public:
+    Sha256Hasher();
+
+    /**
+     * @brief Add bytes to the hash
+     * @param data Bytes to add
+     * @param size Number of bytes
+     */
+    void update(const void* data, size_t size);
+
+    /**
+     * @brief Finish the hash; the hasher must not be updated afterwards
+     * @return Lowercase hexadecimal digest
+     */
+    std::string finish();
+
+private:
+    uint32_t state_[8];
+    uint8_t block_[64];
+    size_t block_size_;
+    uint64_t total_length_;
+
+    void processBlock(const uint8_t* block);
+};
+
+#endif // HASH_H
@@ -0,0 +1,302 @@
+#include "line_diff.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+    // Open-addressing set of line hashes, used to find lines only one side has
+    class HashSet {
+    public:
+        HashSet(const std::vector<uint64_t>& values, size_t begin, size_t end)
+            : has_zero_(false)
+        {
+            size_t capacity = 16;
+            while (capacity < (end - begin) * 2) capacity <<= 1;
+            slots_.assign(capacity, 0);
+            mask_ = capacity - 1;
+
+            for (size_t i = begin; i < end; i++) {
+                insert(values[i]);
+            }
+        }
+
+        bool contains(uint64_t value) const {
+            if (value == 0) return has_zero_;
+            for (size_t slot = position(value);; slot = (slot + 1) & mask_) {
+                if (slots_[slot] == value) return true;
+                if (slots_[slot] == 0) return false;
+            }
+        }
+
+    private:
+        std::vector<uint64_t> slots_;   // 0 marks an empty slot
+        size_t mask_;
+        bool has_zero_;
+
+        size_t position(uint64_t value) const {
+            return static_cast<size_t>((value * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+        }
+
+        void insert(uint64_t value) {
+            if (value == 0) {
+                has_zero_ = true;
+                return;
+            }
+            size_t slot = position(value);
+            while (slots_[slot] != 0 && slots_[slot] != value) {
+                slot = (slot + 1) & mask_;
+            }
+            slots_[slot] = value;
+        }
+    };
+
+    /**
+     * @brief Linear-space Myers diff that flags the changed lines of both sides
+     * The middle snake search follows GNU diff, including its cutoff for
+     * searches that grow too expensive.
+     */
+    class MyersDiff {
+    public:
+        MyersDiff(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b,
+                  std::vector<char>& changed_a, std::vector<char>& changed_b)
+            : a_(a.data())
+            , b_(b.data())
+            , changed_a_(changed_a.data())
+            , changed_b_(changed_b.data())
+            , forward_(a.size() + b.size() + 3)
+            , backward_(a.size() + b.size() + 3)
+        {
+            // Diagonals run from -|b| - 1 to |a| + 1
+            fd_ = forward_.data() + b.size() + 1;
+            bd_ = backward_.data() + b.size() + 1;
+        }
+
+        void run(long n, long m) {
+            struct Range {
+                long a_begin, a_end, b_begin, b_end;
+            };
+
+            // Explicit stack: the cutoff can make splits lopsided and the recursion deep
+            std::vector<Range> pending = {{0, n, 0, m}};
+            while (!pending.empty()) {
+                Range range = pending.back();
+                pending.pop_back();
+
+                while (range.a_begin < range.a_end && range.b_begin < range.b_end &&
+                       a_[range.a_begin] == b_[range.b_begin]) {
+                    range.a_begin++;
+                    range.b_begin++;
+                }
+                while (range.a_begin < range.a_end && range.b_begin < range.b_end &&
+                       a_[range.a_end - 1] == b_[range.b_end - 1]) {
+                    range.a_end--;
+                    range.b_end--;
+                }
+
+                if (range.a_begin == range.a_end || range.b_begin == range.b_end) {
+                    markChanged(range.a_begin, range.a_end, range.b_begin, range.b_end);
+                    continue;
+                }
+
+                long x, y;
+                split(range.a_begin, range.a_end, range.b_begin, range.b_end, x, y);
+                if ((x == range.a_begin && y == range.b_begin) || (x == range.a_end && y == range.b_end)) {
+                    // No progress possible; treat the rest as one replacement
+                    markChanged(range.a_begin, range.a_end, range.b_begin, range.b_end);
+                    continue;
+                }
+                pending.push_back({x, range.a_end, y, range.b_end});
+                pending.push_back({range.a_begin, x, range.b_begin, y});
+            }
+        }
+
+    private:
+        const uint64_t* a_;
+        const uint64_t* b_;
+        char* changed_a_;
+        char* changed_b_;
+        std::vector<long> forward_;
+        std::vector<long> backward_;
+        long* fd_;      // Furthest x reached on each diagonal searching forward
+        long* bd_;      // Smallest x reached on each diagonal searching backward
+
+        // Edits searched per split before settling for a guess; splits with fewer
+        // differences than this, which covers ordinary edits, stay minimal
+        static const long MAX_COST = 256;
+
+        void markChanged(long a_begin, long a_end, long b_begin, long b_end) {
+            std::fill(changed_a_ + a_begin, changed_a_ + a_end, 1);
+            std::fill(changed_b_ + b_begin, changed_b_ + b_end, 1);
+        }
+
+        // Find where a shortest edit script crosses the middle, or a good guess when that gets too expensive
+        void split(long xoff, long xlim, long yoff, long ylim, long& split_x, long& split_y) {
+            long* fd = fd_;
+            long* bd = bd_;
+            const long dmin = xoff - ylim;
+            const long dmax = xlim - yoff;
+            const long fmid = xoff - yoff;
+            const long bmid = xlim - ylim;
+            long fmin = fmid, fmax = fmid;
+            long bmin = bmid, bmax = bmid;
+            const bool odd = (fmid - bmid) & 1;
+
+            fd[fmid] = xoff;
+            bd[bmid] = xlim;
+
+            for (long cost = 1;; cost++) {
+                // Extend the forward search by one edit
+                if (fmin > dmin) fd[--fmin - 1] = -1; else ++fmin;
+                if (fmax < dmax) fd[++fmax + 1] = -1; else --fmax;
+                for (long d = fmax; d >= fmin; d -= 2) {
+                    long low = fd[d - 1], high = fd[d + 1];
+                    long x = low >= high ? low + 1 : high;
+                    long y = x - d;
+                    while (x < xlim && y < ylim && a_[x] == b_[y]) {
+                        x++;
+                        y++;
+                    }
+                    fd[d] = x;
+                    if (odd && bmin <= d && d <= bmax && bd[d] <= x) {
+                        split_x = x;
+                        split_y = y;
+                        return;
+                    }
+                }
+
+                // Extend the backward search by one edit
+                if (bmin > dmin) bd[--bmin - 1] = LONG_MAX; else ++bmin;
+                if (bmax < dmax) bd[++bmax + 1] = LONG_MAX; else --bmax;
+                for (long d = bmax; d >= bmin; d -= 2) {
+                    long low = bd[d - 1], high = bd[d + 1];
+                    long x = low < high ? low : high - 1;
+                    long y = x - d;
+                    while (x > xoff && y > yoff && a_[x - 1] == b_[y - 1]) {
+                        x--;
+                        y--;
+                    }
+                    bd[d] = x;
+                    if (!odd && fmin <= d && d <= fmax && x <= fd[d]) {
+                        split_x = x;
+                        split_y = y;
+                        return;
+                    }
+                }
+
+                if (cost < MAX_COST) continue;
+
+                // Too expensive: split at whichever search got furthest
+                long forward_best = -1, forward_x = xoff;
+                for (long d = fmax; d >= fmin; d -= 2) {
+                    long x = std::min(fd[d], xlim);
+                    long y = x - d;
+                    if (ylim < y) {
+                        x = ylim + d;
+                        y = ylim;
+                    }
+                    if (forward_best < x + y) {
+                        forward_best = x + y;
+                        forward_x = x;
+                    }
+                }
+
+                long backward_best = LONG_MAX, backward_x = xlim;
+                for (long d = bmax; d >= bmin; d -= 2) {
+                    long x = std::max(xoff, bd[d]);
+                    long y = x - d;
+                    if (y < yoff) {
+                        x = yoff + d;
+                        y = yoff;
+                    }
+                    if (x + y < backward_best) {
+                        backward_best = x + y;
+                        backward_x = x;
+                    }
+                }
+
+                if ((xlim + ylim) - backward_best < forward_best - (xoff + yoff)) {
+                    split_x = forward_x;
+                    split_y = forward_best - forward_x;
+                } else {
+                    split_x = backward_x;
+                    split_y = backward_best - backward_x;
+                }
+                return;
+            }
+        }
+    };
+}
+
+namespace LineDiff {
+    std::vector<Hunk> diff(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+        const size_t n = a.size();
+        const size_t m = b.size();
+        std::vector<char> changed_a(n, 0);
+        std::vector<char> changed_b(m, 0);
+
+        // Common prefix and suffix never take part in the search
+        size_t prefix = 0;
+        while (prefix < n && prefix < m && a[prefix] == b[prefix]) prefix++;
+        size_t suffix = 0;
+        while (suffix < n - prefix && suffix < m - prefix && a[n - 1 - suffix] == b[m - 1 - suffix]) suffix++;
+        const size_t a_end = n - suffix;
+        const size_t b_end = m - suffix;
+
+        // A line missing from the other side is always a change, so only search the rest
+        std::vector<uint64_t> kept_a, kept_b;
+        std::vector<size_t> index_a, index_b;
+        {
+            HashSet in_a(a, prefix, a_end);
+            HashSet in_b(b, prefix, b_end);
+            for (size_t i = prefix; i < a_end; i++) {
+                if (in_b.contains(a[i])) {
+                    kept_a.push_back(a[i]);
+                    index_a.push_back(i);
+                } else {
+                    changed_a[i] = 1;
+                }
+            }
+            for (size_t j = prefix; j < b_end; j++) {
+                if (in_a.contains(b[j])) {
+                    kept_b.push_back(b[j]);
+                    index_b.push_back(j);
+                } else {
+                    changed_b[j] = 1;
+                }
+            }
+        }
+
+        std::vector<char> kept_changed_a(kept_a.size(), 0);
+        std::vector<char> kept_changed_b(kept_b.size(), 0);
+        MyersDiff(kept_a, kept_b, kept_changed_a, kept_changed_b).run((long)kept_a.size(), (long)kept_b.size());
+        for (size_t i = 0; i < kept_a.size(); i++) {
+            if (kept_changed_a[i]) changed_a[index_a[i]] = 1;
+        }
+        for (size_t j = 0; j < kept_b.size(); j++) {
+            if (kept_changed_b[j]) changed_b[index_b[j]] = 1;
+        }
+
+        // Unchanged lines pair up in order; everything between them is a hunk
+        std::vector<Hunk> hunks;
+        size_t i = 0, j = 0;
+        while (i < n || j < m) {
+            if (i < n && j < m && !changed_a[i] && !changed_b[j]) {
+                i++;
+                j++;
+                continue;
+            }
+
+            Hunk hunk = {i, 0, j, 0};
+            while (i < n && changed_a[i]) i++;
+            while (j < m && changed_b[j]) j++;
+            if (i == hunk.a_begin && j == hunk.b_begin) {
+                // Unpaired unchanged lines cannot happen; close out the rest rather than loop
+                i = n;
+                j = m;
+            }
+            hunk.a_count = i - hunk.a_begin;
+            hunk.b_count = j - hunk.b_begin;
+            hunks.push_back(hunk);
+        }
+        return hunks;
+    }
+}
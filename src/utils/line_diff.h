@@ -0,0 +1,35 @@
+#ifndef LINE_DIFF_H
+#define LINE_DIFF_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Line-level diff of two sequences of line hashes
+ */
+namespace LineDiff {
+    /**
+     * @brief A run of changed lines; a_count or b_count is 0 for pure insertions and deletions
+     */
+    struct Hunk {
+        size_t a_begin;
+        size_t a_count;
+        size_t b_begin;
+        size_t b_count;
+    };
+
+    /**
+     * @brief Compute the hunks that turn sequence a into sequence b
+     * Uses the linear-space Myers algorithm (middle snake divide and conquer).
+     * Lines found on only one side are removed before the search, and very
+     * expensive searches settle for a near-minimal split, so the cost stays
+     * close to linear for inputs that share little.
+     * @param a Hashes of the old lines
+     * @param b Hashes of the new lines
+     * @return Hunks in file order
+     */
+    std::vector<Hunk> diff(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b);
+}
+
+#endif // LINE_DIFF_H
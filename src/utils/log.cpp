@@ -0,0 +1,344 @@
+#include "log.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+namespace {
+    // Records the queue holds; about 256 KB
+    const size_t QUEUE_CAPACITY = 1024;
+
+    // Size at which the file is rotated, and how many rotated files are kept
+    const long MAX_FILE_SIZE = 4 * 1024 * 1024;
+    const int KEPT_FILES = 3;
+
+    using Log::Detail::Record;
+    using Log::Detail::Type;
+
+    // Bounded multi-producer queue after Dmitry Vyukov: each cell's sequence
+    // number says whether it is free for the producer at that position or
+    // holds a record for the consumer, so neither side takes a lock
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    std::atomic<bool> running(false);
+    std::unique_ptr<Cell[]> cells;
+    std::atomic<size_t> enqueue_position(0);
+    size_t dequeue_position = 0;                // Writer thread only
+    std::atomic<uint64_t> dropped(0);
+
+    // The writer sleeps once the queue is empty; producers wake it only then
+    std::atomic<bool> writer_sleeping(false);
+    std::mutex wake_mutex;
+    std::condition_variable wake_condition;
+    std::thread writer;
+
+    FILE* file = nullptr;
+    std::filesystem::path file_path;
+    std::atomic<uint32_t> next_thread_number(1);
+
+    bool pop(Record& record) {
+        Cell& cell = cells[dequeue_position % QUEUE_CAPACITY];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeue_position + 1) return false;
+        record = cell.record;
+        cell.sequence.store(dequeue_position + QUEUE_CAPACITY, std::memory_order_release);
+        dequeue_position++;
+        return true;
+    }
+
+    // Arguments are read back in the order they were encoded
+    struct Reader {
+        const Record& record;
+        size_t offset = 0;
+
+        bool next(Type& type) {
+            if (offset >= record.size) return false;
+            type = static_cast<Type>(record.data[offset++]);
+            return true;
+        }
+
+        template <typename T>
+        T read() {
+            T value;
+            memcpy(&value, record.data + offset, sizeof(T));
+            offset += sizeof(T);
+            return value;
+        }
+    };
+
+    // printf one argument, picking the conversion from the stored type so a
+    // mismatched format string cannot read the wrong type
+    void formatArgument(std::string& out, const std::string& flags, char conversion, Type type, Reader& reader) {
+        char spec[48];
+        char buffer[256];
+        int length = 0;
+        switch (type) {
+            case Type::INT:
+            case Type::UINT: {
+                unsigned long long bits = reader.read<unsigned long long>();
+                if (conversion == 'c') {
+                    snprintf(spec, sizeof(spec), "%%%sc", flags.c_str());
+                    length = snprintf(buffer, sizeof(buffer), spec, static_cast<int>(bits));
+                } else if (conversion == 'o' || conversion == 'u' || conversion == 'x' || conversion == 'X') {
+                    snprintf(spec, sizeof(spec), "%%%sll%c", flags.c_str(), conversion);
+                    length = snprintf(buffer, sizeof(buffer), spec, bits);
+                } else if (type == Type::INT) {
+                    snprintf(spec, sizeof(spec), "%%%slld", flags.c_str());
+                    length = snprintf(buffer, sizeof(buffer), spec, static_cast<long long>(bits));
+                } else {
+                    snprintf(spec, sizeof(spec), "%%%sllu", flags.c_str());
+                    length = snprintf(buffer, sizeof(buffer), spec, bits);
+                }
+                break;
+            }
+            case Type::DOUBLE: {
+                double value = reader.read<double>();
+                if (!strchr("fFeEgGaA", conversion)) conversion = 'g';
+                snprintf(spec, sizeof(spec), "%%%s%c", flags.c_str(), conversion);
+                length = snprintf(buffer, sizeof(buffer), spec, value);
+                break;
+            }
+            case Type::POINTER:
+                length = snprintf(buffer, sizeof(buffer), "%p", reader.read<const void*>());
+                break;
+            case Type::STRING: {
+                uint16_t size = reader.read<uint16_t>();
+                std::string text(reader.record.data + reader.offset, size);
+                reader.offset += size;
+                snprintf(spec, sizeof(spec), "%%%ss", flags.c_str());
+                int needed = snprintf(nullptr, 0, spec, text.c_str());
+                if (needed > 0) {
+                    size_t start = out.size();
+                    out.resize(start + needed + 1);
+                    snprintf(&out[start], needed + 1, spec, text.c_str());
+                    out.resize(start + needed);
+                }
+                return;
+            }
+        }
+        if (length > 0) out.append(buffer, std::min<size_t>(length, sizeof(buffer) - 1));
+    }
+
+    void formatMessage(std::string& out, const Record& record) {
+        Reader reader{record};
+        for (const char* p = record.format; *p; p++) {
+            if (*p != '%') {
+                out += *p;
+                continue;
+            }
+            const char* start = p++;
+            if (*p == '%') {
+                out += '%';
+                continue;
+            }
+
+            std::string flags;
+            while (*p && strchr("-+ #0123456789.", *p)) flags += *p++;
+            while (*p && strchr("hlLqjzt", *p)) p++;
+            if (!*p) {
+                out.append(start);
+                break;
+            }
+
+            Type type;
+            if (flags.size() > 20 || !reader.next(type)) {
+                out.append(start, p + 1);   // Missing argument: keep the specifier
+                continue;
+            }
+            formatArgument(out, flags, *p, type, reader);
+        }
+        while (!out.empty() && out.back() == '\n') out.pop_back();
+    }
+
+    void formatLine(std::string& out, const Record& record) {
+        static const char* const LEVEL_NAMES[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR"};
+
+        time_t seconds = static_cast<time_t>(record.time_ns / 1000000000);
+        struct tm local;
+#ifdef _WIN32
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        char prefix[64];
+        size_t length = strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local);
+        snprintf(prefix + length, sizeof(prefix) - length, ".%03u %-5s [%u] ",
+                 static_cast<unsigned>(record.time_ns / 1000000 % 1000),
+                 LEVEL_NAMES[static_cast<int>(record.level)], record.thread);
+
+        out.clear();
+        out += prefix;
+        formatMessage(out, record);
+        out += '\n';
+    }
+
+    void rotate() {
+        fclose(file);
+        std::error_code ec;
+        for (int i = KEPT_FILES - 1; i >= 1; i--) {
+            std::filesystem::path from = file_path.string() + "." + std::to_string(i);
+            std::filesystem::rename(from, file_path.string() + "." + std::to_string(i + 1), ec);
+        }
+        std::filesystem::rename(file_path, file_path.string() + ".1", ec);
+        file = fopen(file_path.string().c_str(), "a");
+    }
+
+    void writeRecords() {
+#ifndef _WIN32
+        // The log starts before the event loop blocks its signals, which must never reach this thread
+        sigset_t all;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, nullptr);
+#endif
+        std::string line;
+        Record record;
+        for (;;) {
+            bool wrote = false;
+            while (file && pop(record)) {
+                formatLine(line, record);
+                fwrite(line.data(), 1, line.size(), file);
+                wrote = true;
+            }
+
+            uint64_t lost = dropped.exchange(0);
+            if (file && lost > 0) {
+                fprintf(file, "%llu log messages dropped, the queue was full\n", static_cast<unsigned long long>(lost));
+                wrote = true;
+            }
+            if (wrote && file) {
+                fflush(file);
+                if (ftell(file) > MAX_FILE_SIZE) rotate();
+            }
+
+            // Recheck after announcing the sleep so a push in between is not missed
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            writer_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            Cell& cell = cells[dequeue_position % QUEUE_CAPACITY];
+            if (cell.sequence.load(std::memory_order_acquire) == dequeue_position + 1) {
+                writer_sleeping.store(false);
+                continue;
+            }
+            if (!running.load()) break;
+            wake_condition.wait(lock);
+            writer_sleeping.store(false);
+        }
+    }
+
+    // Stops the writer before the queue it reads is destroyed
+    struct Shutdown {
+        ~Shutdown() { Log::stop(); }
+    } shutdown_at_exit;
+}
+
+namespace Log {
+    bool start(const std::filesystem::path& path, std::string& error) {
+        if (running.load()) return true;
+
+        std::error_code ec;
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path(), ec);
+        }
+        file_path = path;
+        file = fopen(path.string().c_str(), "a");
+        if (!file) {
+            error = "Cannot open log file " + path.string();
+            return false;
+        }
+
+        cells.reset(new Cell[QUEUE_CAPACITY]);
+        for (size_t i = 0; i < QUEUE_CAPACITY; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_position.store(0);
+        dequeue_position = 0;
+        running.store(true, std::memory_order_release);
+        writer = std::thread(writeRecords);
+        return true;
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            wake_condition.notify_one();
+        }
+        writer.join();
+        fclose(file);
+        file = nullptr;
+    }
+
+    bool isEnabled() {
+        return running.load(std::memory_order_acquire);
+    }
+
+    std::filesystem::path getDefaultPath() {
+        const char* state_home = std::getenv("XDG_STATE_HOME");
+        if (state_home && *state_home) {
+            return std::filesystem::path(state_home) / "quickview" / "debug.log";
+        }
+#ifdef _WIN32
+        const char* home = std::getenv("LOCALAPPDATA");
+        if (home && *home) {
+            return std::filesystem::path(home) / "quickview" / "debug.log";
+        }
+#else
+        const char* home = std::getenv("HOME");
+        if (home && *home) {
+            return std::filesystem::path(home) / ".local" / "state" / "quickview" / "debug.log";
+        }
+#endif
+        return std::filesystem::path();
+    }
+
+    namespace Detail {
+        void push(Record& record) {
+            size_t position = enqueue_position.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells[position % QUEUE_CAPACITY];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence == position) {
+                    if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.record = record;
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        break;
+                    }
+                } else if (sequence < position) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                } else {
+                    position = enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+
+            // Pairs with the fence in writeRecords(): either the writer sees the record or we see it sleeping
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (writer_sleeping.load(std::memory_order_relaxed)) {
+                std::lock_guard<std::mutex> lock(wake_mutex);
+                wake_condition.notify_one();
+            }
+        }
+
+        uint64_t now() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        uint32_t threadNumber() {
+            thread_local uint32_t number = next_thread_number.fetch_add(1);
+            return number;
+        }
+    }
+}
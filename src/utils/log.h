@@ -0,0 +1,188 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+
+// Lowest level compiled in: 0 trace, 1 debug, 2 info, 3 warning, 4 error
+#ifndef QUICKVIEW_LOG_LEVEL
+#define QUICKVIEW_LOG_LEVEL 1
+#endif
+
+/**
+ * @brief Asynchronous logging to a rotating file
+ * A call copies its format pointer and arguments into a fixed-size record on a
+ * lock-free queue and returns; a writer thread formats the records printf-style
+ * and appends them to the log file, so the calling thread never formats or
+ * touches the disk and nothing is written to the terminal. Calls below
+ * QUICKVIEW_LOG_LEVEL are removed at compile time, and while logging is off a
+ * call costs one atomic load. Pass strings and paths as they are rather than
+ * calling c_str() or string() on them, so that disabled calls build nothing.
+ *
+ * Debug and trace messages, the ones on hot paths, are logged with the
+ * LOG_DEBUG and LOG_TRACE macros, which do not even evaluate their arguments
+ * when the level is compiled out or logging is off.
+ */
+namespace Log {
+    enum class Level : uint8_t { TRACE, DEBUG, INFO, WARNING, ERROR };
+
+    const Level MIN_LEVEL = static_cast<Level>(QUICKVIEW_LOG_LEVEL);
+
+    /**
+     * @brief Start the writer thread
+     * The file is rotated to FILE.1, FILE.2, ... once it grows past a few megabytes.
+     * @param path Log file; missing parent directories are created
+     * @param error Receives a description on failure
+     * @return true if the file could be opened
+     */
+    bool start(const std::filesystem::path& path, std::string& error);
+
+    /**
+     * @brief Write everything still queued and stop the writer thread
+     */
+    void stop();
+
+    /**
+     * @brief Check whether records are being written
+     */
+    bool isEnabled();
+
+    /**
+     * @brief Get the log file used when none is given
+     * @return $XDG_STATE_HOME/quickview/debug.log or the platform equivalent, or an empty path
+     */
+    std::filesystem::path getDefaultPath();
+
+    // Record encoding; use the level functions below instead
+    namespace Detail {
+        enum class Type : uint8_t { INT, UINT, DOUBLE, STRING, POINTER };
+
+        // Payload of one record; longer arguments are cut
+        const size_t RECORD_DATA = 224;
+
+        struct Record {
+            uint64_t time_ns;       // System clock
+            const char* format;
+            uint32_t thread;
+            Level level;
+            uint16_t size;
+            char data[RECORD_DATA];
+        };
+
+        /**
+         * @brief Queue a record; it is dropped and counted when the queue is full
+         */
+        void push(Record& record);
+
+        inline void putBytes(Record& record, const void* bytes, size_t size) {
+            size = std::min(size, RECORD_DATA - record.size);
+            memcpy(record.data + record.size, bytes, size);
+            record.size = static_cast<uint16_t>(record.size + size);
+        }
+
+        inline void putString(Record& record, const char* text, size_t length) {
+            if (record.size + 1 + sizeof(uint16_t) > RECORD_DATA) return;
+            Type type = Type::STRING;
+            putBytes(record, &type, 1);
+            uint16_t stored = static_cast<uint16_t>(
+                std::min(length, RECORD_DATA - record.size - sizeof(uint16_t)));
+            putBytes(record, &stored, sizeof(stored));
+            putBytes(record, text, stored);
+        }
+
+        template <typename T>
+        void put(Record& record, Type type, T value) {
+            if (record.size + 1 + sizeof(T) > RECORD_DATA) return;
+            putBytes(record, &type, 1);
+            putBytes(record, &value, sizeof(T));
+        }
+
+        inline void encode(Record& record, const char* text) {
+            if (!text) text = "(null)";
+            putString(record, text, strlen(text));
+        }
+
+        inline void encode(Record& record, const std::string& text) {
+            putString(record, text.data(), text.size());
+        }
+
+        inline void encode(Record& record, const std::filesystem::path& path) {
+            if constexpr (std::is_same<std::filesystem::path::value_type, char>::value) {
+                putString(record, path.native().data(), path.native().size());
+            } else {
+                encode(record, path.string());
+            }
+        }
+
+        template <typename T>
+        void encode(Record& record, T value) {
+            if constexpr (std::is_floating_point<T>::value) {
+                put(record, Type::DOUBLE, static_cast<double>(value));
+            } else if constexpr (std::is_pointer<T>::value) {
+                put(record, Type::POINTER, static_cast<const void*>(value));
+            } else if constexpr (std::is_signed<T>::value || std::is_enum<T>::value) {
+                put(record, Type::INT, static_cast<long long>(value));
+            } else {
+                static_assert(std::is_integral<T>::value, "Log arguments must be numbers, strings, paths or pointers");
+                put(record, Type::UINT, static_cast<unsigned long long>(value));
+            }
+        }
+
+        uint64_t now();
+        uint32_t threadNumber();
+
+        template <typename... Args>
+        void write(Level level, const char* format, const Args&... args) {
+            if (!isEnabled()) return;
+            Record record;
+            record.time_ns = now();
+            record.format = format;
+            record.thread = threadNumber();
+            record.level = level;
+            record.size = 0;
+            (encode(record, args), ...);
+            push(record);
+        }
+    }
+
+    /**
+     * @brief Log a printf-style message
+     * @param format String literal; only the pointer is queued. A trailing newline is optional
+     * @param args Numbers, strings, paths or pointers; they are copied, so temporaries are fine
+     */
+    template <typename... Args>
+    void info(const char* format, const Args&... args) {
+        if constexpr (MIN_LEVEL <= Level::INFO) Detail::write(Level::INFO, format, args...);
+    }
+
+    template <typename... Args>
+    void warning(const char* format, const Args&... args) {
+        if constexpr (MIN_LEVEL <= Level::WARNING) Detail::write(Level::WARNING, format, args...);
+    }
+
+    template <typename... Args>
+    void error(const char* format, const Args&... args) {
+        if constexpr (MIN_LEVEL <= Level::ERROR) Detail::write(Level::ERROR, format, args...);
+    }
+}
+
+// Same arguments as Log::info; they are evaluated only when the message is written
+#define LOG_TRACE(...)                                                                  \
+    do {                                                                                \
+        if constexpr (Log::MIN_LEVEL <= Log::Level::TRACE) {                            \
+            if (Log::isEnabled()) Log::Detail::write(Log::Level::TRACE, __VA_ARGS__);   \
+        }                                                                               \
+    } while (0)
+
+#define LOG_DEBUG(...)                                                                  \
+    do {                                                                                \
+        if constexpr (Log::MIN_LEVEL <= Log::Level::DEBUG) {                            \
+            if (Log::isEnabled()) Log::Detail::write(Log::Level::DEBUG, __VA_ARGS__);   \
+        }                                                                               \
+    } while (0)
+
+#endif // LOG_H
@@ -0,0 +1,133 @@
+#include "trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    // Spans kept per thread; about 0.75 MB each
+    const size_t RING_CAPACITY = 1 << 15;
+
+    struct Event {
+        const char* name;
+        uint64_t start_ns;
+        uint64_t duration_ns;
+    };
+
+    // Written only by its thread; written counts every span ever recorded
+    struct ThreadBuffer {
+        int thread_id;
+        std::unique_ptr<Event[]> events;
+        std::atomic<uint64_t> written;
+    };
+
+    std::atomic<bool> enabled(false);
+    std::chrono::steady_clock::time_point origin;
+    std::string output_path;
+
+    // Buffers outlive their threads so spans of finished threads can still be written
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> registry;
+    thread_local ThreadBuffer* thread_buffer = nullptr;
+
+    uint64_t nanosecondsSinceOrigin() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin).count());
+    }
+
+    ThreadBuffer* getThreadBuffer() {
+        if (!thread_buffer) {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->thread_id = static_cast<int>(registry.size()) + 1;
+            buffer->events.reset(new Event[RING_CAPACITY]);
+            buffer->written.store(0);
+            thread_buffer = buffer.get();
+            registry.push_back(std::move(buffer));
+        }
+        return thread_buffer;
+    }
+
+    void writeEscaped(FILE* file, const char* text) {
+        for (; *text; text++) {
+            if (*text == '"' || *text == '\\') fputc('\\', file);
+            fputc(*text, file);
+        }
+    }
+}
+
+namespace Trace {
+    void start(const std::string& path) {
+        output_path = path;
+        origin = std::chrono::steady_clock::now();
+        enabled.store(true, std::memory_order_release);
+    }
+
+    bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    const std::string& getOutputPath() {
+        return output_path;
+    }
+
+    bool write(std::string& error) {
+        if (!isEnabled()) {
+            error = "Tracing is off (start with --trace=FILE)";
+            return false;
+        }
+
+        FILE* file = fopen(output_path.c_str(), "w");
+        if (!file) {
+            error = "Cannot write " + output_path;
+            return false;
+        }
+
+        // Complete ("X") events with microsecond timestamps, one line each
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+        bool first = true;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (const auto& buffer : registry) {
+            uint64_t written = buffer->written.load(std::memory_order_acquire);
+            uint64_t begin = written > RING_CAPACITY ? written - RING_CAPACITY : 0;
+            for (uint64_t i = begin; i < written; i++) {
+                const Event& event = buffer->events[i % RING_CAPACITY];
+                fputs(first ? "" : ",\n", file);
+                fputs("{\"name\":\"", file);
+                writeEscaped(file, event.name);
+                fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        buffer->thread_id, event.start_ns / 1000.0, event.duration_ns / 1000.0);
+                first = false;
+            }
+        }
+        fputs("\n]}\n", file);
+
+        if (fclose(file) != 0) {
+            error = "Cannot write " + output_path;
+            return false;
+        }
+        return true;
+    }
+
+    Span::Span(const char* name)
+        : name_(nullptr)
+        , start_ns_(0)
+    {
+        if (enabled.load(std::memory_order_acquire)) {
+            name_ = name;
+            start_ns_ = nanosecondsSinceOrigin();
+        }
+    }
+
+    Span::~Span() {
+        if (!name_) return;
+
+        uint64_t end_ns = nanosecondsSinceOrigin();
+        ThreadBuffer* buffer = getThreadBuffer();
+        uint64_t index = buffer->written.load(std::memory_order_relaxed);
+        buffer->events[index % RING_CAPACITY] = {name_, start_ns_, end_ns - start_ns_};
+        buffer->written.store(index + 1, std::memory_order_release);
+    }
+}
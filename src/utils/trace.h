@@ -0,0 +1,64 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Scoped timing spans written as a Chrome trace
+ *
+ * Each thread records into its own fixed-size ring buffer, so recording takes
+ * no lock and never allocates after the thread's first span; when a buffer is
+ * full the oldest spans are overwritten. write() produces the Trace Event
+ * Format read by chrome://tracing and Perfetto. While tracing is off a span
+ * costs one atomic load.
+ */
+namespace Trace {
+    /**
+     * @brief Start recording spans
+     * @param output_path File that write() produces
+     */
+    void start(const std::string& output_path);
+
+    /**
+     * @brief Check whether spans are being recorded
+     */
+    bool isEnabled();
+
+    /**
+     * @brief Get the file write() produces
+     */
+    const std::string& getOutputPath();
+
+    /**
+     * @brief Write the spans recorded so far, replacing the output file
+     * Threads may keep recording meanwhile; a span overwritten while it is
+     * copied can come out garbled.
+     * @param error Receives a description on failure
+     * @return true if the file was written
+     */
+    bool write(std::string& error);
+
+    /**
+     * @brief Times the enclosing scope
+     * Declare one at the top of a function:
+     *     Trace::Span span("Display::drawFileBrowser");
+     */
+    class Span {
+    public:
+        /**
+         * @param name Static string naming the span; only the pointer is kept
+         */
+        explicit Span(const char* name);
+        ~Span();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* name_;      // nullptr when tracing was off at construction
+        uint64_t start_ns_;
+    };
+}
+
+#endif // TRACE_H
@@ -1,14 +1,14 @@
 #include "utils.h"
-#include <cstdarg>
-#include <cstdio>
 
 namespace Utils {
-    void debugPrint(bool debug_enabled, const char* format, ...) {
-        if (!debug_enabled) return;
-
-        va_list args;
-        va_start(args, format);
-        vfprintf(stderr, format, args);
-        va_end(args);
+    std::string formatSize(uint64_t bytes) {
+        if (bytes < 1024) {
+            return std::to_string(bytes) + " bytes";
+        } else if (bytes < 1024 * 1024) {
+            return std::to_string(bytes / 1024) + " KB";
+        } else if (bytes < 1024ull * 1024 * 1024) {
+            return std::to_string(bytes / (1024 * 1024)) + " MB";
+        }
+        return std::to_string(bytes / (1024ull * 1024 * 1024)) + " GB";
     }
 }
@@ -2,18 +2,25 @@
 #define UTILS_H
 
 #include <string>
+#include <cstdint>
 
 /**
  * @brief Utility functions for quickView application
  */
 namespace Utils {
     /**
-     * @brief Debug print function (only prints if debug enabled)
-     * @param debug_enabled Whether debug is enabled
-     * @param format Printf-style format string
-     * @param ... Arguments for format string
+     * @brief Format a byte count for display (bytes, KB, MB or GB)
+     * @param bytes Number of bytes
+     * @return Human readable size
      */
-    void debugPrint(bool debug_enabled, const char* format, ...);
+    std::string formatSize(uint64_t bytes);
+
+    /**
+     * @brief Get the number of heap allocations the calling thread has made
+     * Compare two readings to see what a piece of code allocates.
+     * @return Calls of operator new on this thread since it started
+     */
+    uint64_t getAllocationCount();
 }
 
 #endif // UTILS_H
@@ -0,0 +1,92 @@
+#ifndef WORK_STACK_H
+#define WORK_STACK_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Work shared by a group of threads, where processing an item can produce more items
+ * Suited to tree walks: each directory is an item and its subdirectories are
+ * pushed back for any idle thread to take. run() returns once the stack is
+ * empty and no thread is still processing, or when cancelled.
+ */
+template <typename Item>
+class WorkStack {
+public:
+    // Handles one item on worker thread `worker`; new items are appended to `more`
+    using Process = std::function<void(Item& item, size_t worker, std::vector<Item>& more)>;
+    // Returns true when the remaining work should be abandoned
+    using CancelCheck = std::function<bool()>;
+
+    /**
+     * @brief Process the initial items and everything they produce
+     * @param initial Items to start from
+     * @param thread_count Number of threads, including the calling one
+     * @param process Called once per item, from any of the threads
+     * @param cancelled Polled before each item
+     * @return true if all work was done, false if cancelled
+     */
+    bool run(std::vector<Item> initial, size_t thread_count, const Process& process, const CancelCheck& cancelled) {
+        pending_ = std::move(initial);
+        busy_ = 0;
+        stopped_ = false;
+
+        std::vector<std::thread> threads;
+        for (size_t worker = 1; worker < thread_count; worker++) {
+            threads.emplace_back(&WorkStack::work, this, worker, std::cref(process), std::cref(cancelled));
+        }
+        work(0, process, cancelled);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return !stopped_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::vector<Item> pending_;     // Items no thread has taken yet
+    size_t busy_ = 0;               // Threads currently processing an item
+    bool stopped_ = false;
+
+    void work(size_t worker, const Process& process, const CancelCheck& cancelled) {
+        std::vector<Item> more;
+        for (;;) {
+            Item item;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_available_.wait(lock, [this]() { return !pending_.empty() || busy_ == 0 || stopped_; });
+
+                // Nothing queued and nobody processing means the work is finished
+                if (pending_.empty() || stopped_) {
+                    work_available_.notify_all();
+                    return;
+                }
+                item = std::move(pending_.back());
+                pending_.pop_back();
+                busy_++;
+            }
+
+            bool cancel = cancelled && cancelled();
+            if (!cancel) {
+                process(item, worker, more);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (auto& next : more) {
+                    pending_.push_back(std::move(next));
+                }
+                busy_--;
+                if (cancel) stopped_ = true;
+            }
+            more.clear();
+            work_available_.notify_all();
+        }
+    }
+};
+
+#endif // WORK_STACK_H